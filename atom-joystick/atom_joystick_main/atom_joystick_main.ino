@@ -6,6 +6,7 @@
  * - WiFiアクセスポイント (IsolationSphere-Direct)
  * - 軽量MQTTブローカー (uMQTT)
  * - Joystick入力処理 (アナログ + ボタン)
+ * - Joystick状態UDPブロードキャスト (22byteバイナリフレーム)
  * - LCD状態表示 (デバイス管理UI)
  * - ESP32デバイス自動発見・統合制御
  * 
@@ -21,6 +22,7 @@
 #include "wifi_ap.h"
 #include "mqtt_broker.h"
 #include "joystick_input.h"
+#include "joystick_udp.h"
 #include "lcd_display.h"
 
 // システム設定
@@ -39,6 +41,11 @@ const int MQTT_PORT = 1884;
 const int MAX_CLIENTS = 8;
 const char* MQTT_CLIENT_ID = "atom-joystick-hub";
 
+// Joystick UDP設定 (atom_s3_receiver config.json communication.udp_port準拠)
+IPAddress JOYSTICK_UDP_BROADCAST(192, 168, 100, 255);
+const uint16_t JOYSTICK_UDP_PORT = 1884;
+const unsigned long JOYSTICK_UDP_INTERVAL_MS = 30; // 約33Hz
+
 // システム状態
 struct SystemState {
   bool wifi_ap_active;
@@ -132,6 +139,12 @@ void initializeSystem() {
   if (joystick_init()) {
     Serial.println("✅ Joystick input system ready");
     lcd_display_show_status("Joystick", "READY", true);
+    
+    // Joystick状態UDP送信開始
+    if (system_state.wifi_ap_active &&
+        !joystick_udp_init(JOYSTICK_UDP_BROADCAST, JOYSTICK_UDP_PORT, JOYSTICK_UDP_INTERVAL_MS)) {
+      Serial.println("❌ Joystick UDP initialization failed");
+    }
   } else {
     Serial.println("❌ Joystick initialization failed");
     lcd_display_show_status("Joystick", "FAILED", false);
@@ -151,6 +164,9 @@ void handleSystemTasks() {
   static JoystickState last_js_state;
   JoystickState current_js_state = joystick_get_state();
   
+  // 全受信機へ一定周期でバイナリフレームを一括ブロードキャスト
+  joystick_udp_loop(&current_js_state);
+  
   if (joystick_state_changed(&last_js_state, &current_js_state)) {
     // Joystick入力変化をMQTT配信
     mqtt_broker_publish_joystick_state(&current_js_state);
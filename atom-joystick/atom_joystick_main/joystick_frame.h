@@ -0,0 +1,129 @@
+/*
+ * Joystick バイナリUDPフレーム定義
+ * isolation-sphere分散MQTT制御システム
+ *
+ * atom_joystick_main (送信) と atom_s3_receiver (受信) で同一内容を使用する。
+ * Arduinoスケッチはフォルダ外のヘッダを参照できないため両フォルダに同じファイルを置く。
+ * 変更時は必ず両方を更新すること。
+ *
+ * フレーム構成 (22 bytes, リトルエンディアン, パディングなし):
+ *   offset  size  内容
+ *   0       2     マジック 'J' 'S'
+ *   2       1     バージョン (JOYSTICK_FRAME_VERSION)
+ *   3       1     ボタンビットフィールド (JOYSTICK_BUTTON_*)
+ *   4       2     シーケンス番号 (送信毎に+1, 16bitで周回)
+ *   6       2     バッテリー電圧 [mV]
+ *   8       4     送信側タイムスタンプ [ms]
+ *   12      8     軸値 int16 x4 (左X, 左Y, 右X, 右Y), -32767 ~ +32767
+ *   20      2     CRC-16/CCITT-FALSE (offset 0~19)
+ */
+
+#ifndef JOYSTICK_FRAME_H
+#define JOYSTICK_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JOYSTICK_FRAME_MAGIC0   'J'
+#define JOYSTICK_FRAME_MAGIC1   'S'
+#define JOYSTICK_FRAME_VERSION  1
+#define JOYSTICK_FRAME_SIZE     22
+#define JOYSTICK_AXIS_MAX       32767
+
+// ボタンビット
+#define JOYSTICK_BUTTON_LEFT_STICK   0x01  // 左スティック押し込み
+#define JOYSTICK_BUTTON_RIGHT_STICK  0x02  // 右スティック押し込み
+#define JOYSTICK_BUTTON_A            0x04  // 左ボタン (A / L)
+#define JOYSTICK_BUTTON_B            0x08  // 右ボタン (B / R)
+
+// フレーム解析結果
+enum JoystickFrameResult {
+  JOYSTICK_FRAME_OK,
+  JOYSTICK_FRAME_NOT_BINARY,   // マジック不一致（JSON等）
+  JOYSTICK_FRAME_BAD_VERSION,
+  JOYSTICK_FRAME_TOO_SHORT,
+  JOYSTICK_FRAME_BAD_CRC
+};
+
+// フレーム内容（ホスト表現）
+struct JoystickFrame {
+  uint16_t sequence;
+  uint8_t buttons;
+  uint16_t battery_mv;
+  uint32_t timestamp_ms;
+  int16_t left_x;
+  int16_t left_y;
+  int16_t right_x;
+  int16_t right_y;
+};
+
+static inline uint16_t joystick_frame_crc16(const uint8_t* data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static inline void joystick_frame_put_u16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline uint16_t joystick_frame_get_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/**
+ * @brief フレームを out (JOYSTICK_FRAME_SIZE bytes) に書き込む
+ */
+static inline void joystick_frame_encode(const JoystickFrame* frame, uint8_t* out) {
+  out[0] = JOYSTICK_FRAME_MAGIC0;
+  out[1] = JOYSTICK_FRAME_MAGIC1;
+  out[2] = JOYSTICK_FRAME_VERSION;
+  out[3] = frame->buttons;
+  joystick_frame_put_u16(out + 4, frame->sequence);
+  joystick_frame_put_u16(out + 6, frame->battery_mv);
+  joystick_frame_put_u16(out + 8, (uint16_t)(frame->timestamp_ms & 0xFFFF));
+  joystick_frame_put_u16(out + 10, (uint16_t)(frame->timestamp_ms >> 16));
+  joystick_frame_put_u16(out + 12, (uint16_t)frame->left_x);
+  joystick_frame_put_u16(out + 14, (uint16_t)frame->left_y);
+  joystick_frame_put_u16(out + 16, (uint16_t)frame->right_x);
+  joystick_frame_put_u16(out + 18, (uint16_t)frame->right_y);
+  joystick_frame_put_u16(out + 20, joystick_frame_crc16(out, JOYSTICK_FRAME_SIZE - 2));
+}
+
+/**
+ * @brief 受信データを解析する（ヒープ確保なし）
+ * @description 将来の拡張に備え、JOYSTICK_FRAME_SIZEより長いデータは先頭のみ解析する
+ */
+static inline JoystickFrameResult joystick_frame_decode(const uint8_t* data, size_t length,
+                                                        JoystickFrame* frame) {
+  if (length < 2 || data[0] != JOYSTICK_FRAME_MAGIC0 || data[1] != JOYSTICK_FRAME_MAGIC1) {
+    return JOYSTICK_FRAME_NOT_BINARY;
+  }
+  if (length < JOYSTICK_FRAME_SIZE) {
+    return JOYSTICK_FRAME_TOO_SHORT;
+  }
+  if (data[2] != JOYSTICK_FRAME_VERSION) {
+    return JOYSTICK_FRAME_BAD_VERSION;
+  }
+  if (joystick_frame_get_u16(data + 20) != joystick_frame_crc16(data, JOYSTICK_FRAME_SIZE - 2)) {
+    return JOYSTICK_FRAME_BAD_CRC;
+  }
+  frame->buttons = data[3];
+  frame->sequence = joystick_frame_get_u16(data + 4);
+  frame->battery_mv = joystick_frame_get_u16(data + 6);
+  frame->timestamp_ms = (uint32_t)joystick_frame_get_u16(data + 8) |
+                        ((uint32_t)joystick_frame_get_u16(data + 10) << 16);
+  frame->left_x = (int16_t)joystick_frame_get_u16(data + 12);
+  frame->left_y = (int16_t)joystick_frame_get_u16(data + 14);
+  frame->right_x = (int16_t)joystick_frame_get_u16(data + 16);
+  frame->right_y = (int16_t)joystick_frame_get_u16(data + 18);
+  return JOYSTICK_FRAME_OK;
+}
+
+#endif // JOYSTICK_FRAME_H
@@ -0,0 +1,126 @@
+/*
+ * Joystick UDPブロードキャスト送信実装
+ * isolation-sphere分散MQTT制御システム
+ */
+
+#include "joystick_udp.h"
+#include "joystick_frame.h"
+#include <M5Unified.h>
+#include <WiFiUdp.h>
+
+// JoystickState軸範囲 (-512〜+512) → フレーム軸範囲 (-32767〜+32767)
+#define AXIS_SCALE                 64
+#define BATTERY_REFRESH_INTERVAL   1000  // バッテリー電圧読み取り間隔[ms]
+
+// グローバル変数
+static WiFiUDP udp;
+static IPAddress target_ip;
+static uint16_t target_port = 0;
+static unsigned long send_interval_ms = 30;
+static unsigned long last_send_time = 0;
+static unsigned long last_battery_read = 0;
+static uint16_t battery_mv = 0;
+static uint16_t next_sequence = 0;
+static JoystickUDPStats stats = {0, 0, 0};
+static bool udp_active = false;
+
+// 内部関数プロトタイプ
+static int16_t scale_axis(int16_t value);
+static uint8_t pack_buttons(const JoystickState* state);
+
+bool joystick_udp_init(IPAddress broadcast_ip, uint16_t port, unsigned long interval_ms) {
+  target_ip = broadcast_ip;
+  target_port = port;
+  send_interval_ms = interval_ms;
+  next_sequence = 0;
+  stats = {0, 0, 0};
+
+  if (!udp.begin(port)) {
+    Serial.printf("❌ Joystick UDP: port %u open failed\n", port);
+    udp_active = false;
+    return false;
+  }
+
+  udp_active = true;
+  Serial.printf("✅ Joystick UDP: broadcasting %d-byte frames to %s:%u every %lums\n",
+                JOYSTICK_FRAME_SIZE, target_ip.toString().c_str(), target_port, send_interval_ms);
+  return true;
+}
+
+bool joystick_udp_send_state(const JoystickState* state) {
+  if (!udp_active || state == nullptr) return false;
+
+  // I2C読み取りを毎フレーム行わないようキャッシュ
+  unsigned long now = millis();
+  if (last_battery_read == 0 || now - last_battery_read >= BATTERY_REFRESH_INTERVAL) {
+    int32_t mv = M5.Power.getBatteryVoltage();
+    battery_mv = mv > 0 ? (uint16_t)mv : 0;
+    last_battery_read = now;
+  }
+
+  JoystickFrame frame;
+  frame.sequence = next_sequence;
+  frame.buttons = pack_buttons(state);
+  frame.battery_mv = battery_mv;
+  frame.timestamp_ms = (uint32_t)state->timestamp;
+  frame.left_x = scale_axis(state->left_x);
+  frame.left_y = scale_axis(state->left_y);
+  frame.right_x = scale_axis(state->right_x);
+  frame.right_y = scale_axis(state->right_y);
+
+  uint8_t buffer[JOYSTICK_FRAME_SIZE];
+  joystick_frame_encode(&frame, buffer);
+
+  // 送信失敗時も番号は進める（受信側でロスとして計上される）
+  next_sequence++;
+
+  if (!udp.beginPacket(target_ip, target_port) ||
+      udp.write(buffer, sizeof(buffer)) != sizeof(buffer) ||
+      !udp.endPacket()) {
+    stats.send_errors++;
+    return false;
+  }
+
+  stats.frames_sent++;
+  stats.last_sequence = frame.sequence;
+  return true;
+}
+
+void joystick_udp_loop(const JoystickState* state) {
+  // 入力変化の有無に関わらず一定周期で送信（受信側の無信号判定・ロス計測用）
+  if (!udp_active) return;
+
+  unsigned long now = millis();
+  if (now - last_send_time < send_interval_ms) return;
+  last_send_time = now;
+
+  joystick_udp_send_state(state);
+}
+
+void joystick_udp_stop() {
+  if (udp_active) {
+    udp.stop();
+    udp_active = false;
+    Serial.println("🛑 Joystick UDP stopped");
+  }
+}
+
+JoystickUDPStats joystick_udp_get_stats() {
+  return stats;
+}
+
+static int16_t scale_axis(int16_t value) {
+  int32_t scaled = (int32_t)value * AXIS_SCALE;
+  if (scaled > JOYSTICK_AXIS_MAX) return JOYSTICK_AXIS_MAX;
+  if (scaled < -JOYSTICK_AXIS_MAX) return -JOYSTICK_AXIS_MAX;
+  return (int16_t)scaled;
+}
+
+static uint8_t pack_buttons(const JoystickState* state) {
+  uint8_t buttons = 0;
+  if (state->left_pressed) buttons |= JOYSTICK_BUTTON_LEFT_STICK;
+  if (state->right_pressed) buttons |= JOYSTICK_BUTTON_RIGHT_STICK;
+  if (state->button_a) buttons |= JOYSTICK_BUTTON_A;
+  if (state->button_b) buttons |= JOYSTICK_BUTTON_B;
+  return buttons;
+}
@@ -0,0 +1,29 @@
+/*
+ * Joystick UDPブロードキャスト送信
+ * isolation-sphere分散MQTT制御システム
+ *
+ * JoystickStateを固定長バイナリフレーム (joystick_frame.h) に変換し、
+ * サブネットブロードキャストで全受信機へ一括送信する。
+ */
+
+#ifndef JOYSTICK_UDP_H
+#define JOYSTICK_UDP_H
+
+#include <IPAddress.h>
+#include "joystick_input.h"
+
+// UDP送信統計
+struct JoystickUDPStats {
+  unsigned long frames_sent;
+  unsigned long send_errors;
+  uint16_t last_sequence;
+};
+
+// 関数プロトタイプ
+bool joystick_udp_init(IPAddress broadcast_ip, uint16_t port, unsigned long interval_ms);
+bool joystick_udp_send_state(const JoystickState* state);
+void joystick_udp_loop(const JoystickState* state);
+void joystick_udp_stop();
+JoystickUDPStats joystick_udp_get_stats();
+
+#endif // JOYSTICK_UDP_H
@@ -5,7 +5,7 @@
  * 
  * Phase 4.9: AtomS3検証用受信システム
  * - WiFi Client: IsolationSphere-Direct接続
- * - UDP受信: ポート1884、JSON形式
+ * - UDP受信: ポート1884、22byteバイナリフレーム（JSONフォールバック）
  * - LED制御: GPIO35、WS2812制御
  * - 応答性: 15-30ms目標達成
  * 
@@ -1,6 +1,6 @@
 /**
  * @file udp_receiver.cpp
- * @brief UDP受信・JSON解析実装
+ * @brief UDP受信・バイナリ/JSON解析実装
  */
 
 #include "udp_receiver.h"
@@ -10,7 +10,9 @@
  */
 UDPReceiver::UDPReceiver() 
   : initialized_(false)
-  , stats_({0, 0, 0, 0, 0.0, 0.0}) {
+  , stats_()
+  , has_sequence_(false)
+  , last_sequence_(0) {
 }
 
 /**
@@ -89,12 +91,31 @@ bool UDPReceiver::receiveData(JoystickData& data) {
     Serial.printf("██   送信元: %s:%d\n", udp_.remoteIP().toString().c_str(), udp_.remotePort());
   }
   
-  // JSON解析
-  bool parse_success = parseJoystickJson(receive_buffer_, data);
+  // バイナリフレーム優先、マジック不一致時のみJSONとして解析
+  unsigned long parse_start = micros();
+  bool parse_success;
+  bool binary = bytes_read >= 2 &&
+                receive_buffer_[0] == JOYSTICK_FRAME_MAGIC0 &&
+                receive_buffer_[1] == JOYSTICK_FRAME_MAGIC1;
+  if (binary) {
+    parse_success = parseJoystickBinary(reinterpret_cast<const uint8_t*>(receive_buffer_), bytes_read, data);
+  } else {
+    parse_success = parseJoystickJson(receive_buffer_, data);
+  }
+  stats_.last_parse_us = micros() - parse_start;
+  if (stats_.last_parse_us > stats_.max_parse_us) {
+    stats_.max_parse_us = stats_.last_parse_us;
+  }
   
   // 統計更新
   updateStats(bytes_read, parse_success);
   
+  // 重複・順序逆転フレームは破棄（古い入力で状態を巻き戻さない）
+  if (parse_success && binary && !acceptSequence(data.sequence)) {
+    data.valid = false;
+    return false;
+  }
+  
   if (parse_success && validateJoystickData(data)) {
     data.valid = true;
     stats_.last_receive_time = millis();
@@ -116,7 +137,69 @@ bool UDPReceiver::isDataAvailable() {
 }
 
 /**
- * @brief JSON解析処理
+ * @brief バイナリフレーム解析処理（ヒープ確保なし）
+ */
+bool UDPReceiver::parseJoystickBinary(const uint8_t* buffer, size_t length, JoystickData& data) {
+  JoystickFrame frame;
+  JoystickFrameResult result = joystick_frame_decode(buffer, length, &frame);
+  if (result != JOYSTICK_FRAME_OK) {
+    if (result == JOYSTICK_FRAME_BAD_CRC) {
+      stats_.crc_errors++;
+    }
+    if (config_.getDebugConfig().serial_output) {
+      Serial.printf("❌ バイナリフレーム解析失敗: %d\n", (int)result);
+      printRawData(reinterpret_cast<const char*>(buffer), length);
+    }
+    return false;
+  }
+  stats_.binary_packets++;
+  
+  // int16軸値 → -1.0~1.0
+  const float axis_scale = 1.0f / JOYSTICK_AXIS_MAX;
+  data.left_x = frame.left_x * axis_scale;
+  data.left_y = frame.left_y * axis_scale;
+  data.right_x = frame.right_x * axis_scale;
+  data.right_y = frame.right_y * axis_scale;
+  
+  data.left_stick_button = (frame.buttons & JOYSTICK_BUTTON_LEFT_STICK) != 0;
+  data.right_stick_button = (frame.buttons & JOYSTICK_BUTTON_RIGHT_STICK) != 0;
+  data.button_left = (frame.buttons & JOYSTICK_BUTTON_A) != 0;
+  data.button_right = (frame.buttons & JOYSTICK_BUTTON_B) != 0;
+  
+  data.battery = frame.battery_mv / 1000.0f;
+  data.timestamp = frame.timestamp_ms;
+  data.sequence = frame.sequence;
+  
+  if (config_.getDebugConfig().serial_output) {
+    printParsedData(data);
+  }
+  
+  return true;
+}
+
+/**
+ * @brief シーケンス番号判定（16bit周回対応）
+ * @return 新しいフレームならtrue、重複・順序逆転ならfalse
+ */
+bool UDPReceiver::acceptSequence(uint16_t sequence) {
+  if (has_sequence_) {
+    int16_t diff = (int16_t)(uint16_t)(sequence - last_sequence_);
+    if (diff == 0 || (diff < 0 && diff > -SEQUENCE_RESYNC_DISTANCE)) {
+      stats_.frames_stale++;
+      return false;
+    }
+    if (diff > 1) {
+      stats_.frames_lost += diff - 1;
+    }
+    // 大きく後退した場合は送信側の再起動とみなして追従
+  }
+  has_sequence_ = true;
+  last_sequence_ = sequence;
+  return true;
+}
+
+/**
+ * @brief JSON解析処理（旧形式フォールバック）
  */
 bool UDPReceiver::parseJoystickJson(const char* json_str, JoystickData& data) {
   StaticJsonDocument<JSON_BUFFER_SIZE> doc;
@@ -131,6 +214,7 @@ bool UDPReceiver::parseJoystickJson(const char* json_str, JoystickData& data) {
     stats_.json_parse_errors++;
     return false;
   }
+  stats_.json_packets++;
   
   // データ抽出・正規化（raw値 → -1.0~1.0範囲）
   float raw_left_x = doc["left"]["x"] | 2048.0f;
@@ -154,6 +238,7 @@ bool UDPReceiver::parseJoystickJson(const char* json_str, JoystickData& data) {
   
   data.battery = doc["battery"] | 0.0f;
   data.timestamp = doc["timestamp"] | 0UL;
+  data.sequence = 0;
   
   // デバッグ出力
   if (config_.getDebugConfig().serial_output) {
@@ -202,19 +287,10 @@ void UDPReceiver::updateStats(size_t packet_size, bool parse_success) {
     stats_.packets_dropped++;
   }
   
-  // 平均パケットサイズ更新
-  static const int AVERAGE_SAMPLES = 10;
-  static float size_samples[AVERAGE_SAMPLES] = {0};
-  static int sample_index = 0;
-  
-  size_samples[sample_index] = (float)packet_size;
-  sample_index = (sample_index + 1) % AVERAGE_SAMPLES;
-  
-  float sum = 0;
-  for (int i = 0; i < AVERAGE_SAMPLES; i++) {
-    sum += size_samples[i];
-  }
-  stats_.avg_packet_size = sum / AVERAGE_SAMPLES;
+  // 平均パケットサイズ更新（累計から算出）
+  stats_.bytes_received += packet_size;
+  stats_.avg_packet_size = (float)stats_.bytes_received /
+                           (stats_.packets_received + stats_.packets_dropped);
   
   // パケットロス率計算
   stats_.packet_loss_rate = calculatePacketLossRate();
@@ -224,11 +300,13 @@ void UDPReceiver::updateStats(size_t packet_size, bool parse_success) {
  * @brief パケットロス率計算
  */
 float UDPReceiver::calculatePacketLossRate() const {
-  unsigned long total_packets = stats_.packets_received + stats_.packets_dropped;
+  // 解析失敗 + シーケンス欠番（未着）をロスとして計上
+  unsigned long lost = stats_.packets_dropped + stats_.frames_lost;
+  unsigned long total_packets = stats_.packets_received + lost;
   if (total_packets == 0) {
     return 0.0f;
   }
-  return (float)stats_.packets_dropped / total_packets * 100.0f;
+  return (float)lost / total_packets * 100.0f;
 }
 
 /**
@@ -239,6 +317,10 @@ void UDPReceiver::printStats() const {
   Serial.printf("受信パケット: %lu\n", stats_.packets_received);
   Serial.printf("ドロップパケット: %lu\n", stats_.packets_dropped);
   Serial.printf("JSON解析エラー: %lu\n", stats_.json_parse_errors);
+  Serial.printf("バイナリ/JSON: %lu / %lu\n", stats_.binary_packets, stats_.json_packets);
+  Serial.printf("CRCエラー: %lu\n", stats_.crc_errors);
+  Serial.printf("欠番/破棄(重複・逆転): %lu / %lu\n", stats_.frames_lost, stats_.frames_stale);
+  Serial.printf("解析時間: 最終 %luus / 最大 %luus\n", stats_.last_parse_us, stats_.max_parse_us);
   Serial.printf("平均パケットサイズ: %.1f bytes\n", stats_.avg_packet_size);
   Serial.printf("パケットロス率: %.2f%%\n", stats_.packet_loss_rate);
   
@@ -260,6 +342,15 @@ void UDPReceiver::resetStats() {
   stats_.last_receive_time = 0;
   stats_.avg_packet_size = 0.0f;
   stats_.packet_loss_rate = 0.0f;
+  stats_.binary_packets = 0;
+  stats_.json_packets = 0;
+  stats_.crc_errors = 0;
+  stats_.frames_lost = 0;
+  stats_.frames_stale = 0;
+  stats_.bytes_received = 0;
+  stats_.last_parse_us = 0;
+  stats_.max_parse_us = 0;
+  has_sequence_ = false;
   
   Serial.println("UDPReceiver: 統計リセット完了");
 }
@@ -291,5 +382,6 @@ void UDPReceiver::printParsedData(const JoystickData& data) const {
   Serial.printf("██   ボタン: L:%s R:%s\n", 
                 data.button_left ? "🔴" : "⚪", 
                 data.button_right ? "🔴" : "⚪");
-  Serial.printf("██   バッテリー: %.1fV | タイムスタンプ: %lu\n", data.battery, data.timestamp);
+  Serial.printf("██   バッテリー: %.1fV | タイムスタンプ: %lu | seq: %u\n",
+                data.battery, data.timestamp, data.sequence);
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 /**
  * @file udp_receiver.h
- * @brief UDP受信・JSON解析システム
+ * @brief UDP受信・解析システム
  * @description Joystickからのポート1884 UDP受信・解析
+ *              バイナリフレーム (joystick_frame.h) を優先し、旧形式のJSONはフォールバックで解析
  */
 
 #pragma once
@@ -9,6 +10,7 @@
 #include <WiFiUdp.h>
 #include <ArduinoJson.h>
 #include "config_manager.h"
+#include "joystick_frame.h"
 
 /**
  * @brief Joystickデータ構造体
@@ -29,6 +31,7 @@ struct JoystickData {
   // システム情報
   float battery;
   unsigned long timestamp;
+  uint16_t sequence;        // バイナリフレームのシーケンス番号（JSON時は0）
   
   // データ有効フラグ
   bool valid;
@@ -36,7 +39,7 @@ struct JoystickData {
   JoystickData() : left_x(0), left_y(0), right_x(0), right_y(0)
                  , left_stick_button(false), right_stick_button(false)
                  , button_left(false), button_right(false)
-                 , battery(0), timestamp(0), valid(false) {}
+                 , battery(0), timestamp(0), sequence(0), valid(false) {}
 };
 
 /**
@@ -49,6 +52,16 @@ struct UDPReceiveStats {
   unsigned long last_receive_time;
   float avg_packet_size;
   float packet_loss_rate;
+  
+  // バイナリフレーム統計
+  unsigned long binary_packets;
+  unsigned long json_packets;
+  unsigned long crc_errors;
+  unsigned long frames_lost;        // シーケンス欠番数
+  unsigned long frames_stale;       // 重複・順序逆転で破棄した数
+  unsigned long bytes_received;
+  unsigned long last_parse_us;
+  unsigned long max_parse_us;
 };
 
 /**
@@ -89,8 +102,15 @@ private:
   // 統計情報
   UDPReceiveStats stats_;
   
+  // シーケンス追跡（バイナリフレーム）
+  static const int16_t SEQUENCE_RESYNC_DISTANCE = 1024;
+  bool has_sequence_;
+  uint16_t last_sequence_;
+  
   // 内部処理メソッド
+  bool parseJoystickBinary(const uint8_t* buffer, size_t length, JoystickData& data);
   bool parseJoystickJson(const char* json_str, JoystickData& data);
+  bool acceptSequence(uint16_t sequence);
   bool validateJoystickData(const JoystickData& data) const;
   void updateStats(size_t packet_size, bool parse_success);
   float calculatePacketLossRate() const;
@@ -97,6 +97,36 @@ class ConfigManager {
     std::vector<std::uint8_t> stripGpios;
   };
 
+  struct UdpControlConfig {
+    bool enabled = false;
+    std::uint16_t port = 8001;
+    std::uint16_t joystickPort = 1884;  // Atom joystick frame broadcasts, 0 = off
+  };
+
+  // Multi-sphere frame sync over the mqtt sync topic (system/all/sync).
+  struct SyncConfig {
+    bool enabled = false;
+    bool master = false;
+    std::uint16_t fps = 30;
+    std::uint32_t beaconIntervalMs = 1000;
+  };
+
+  // Frame pack (.lfp, see FramePack.h) the render loop plays, locked to the
+  // sync timebase, until an image or remote pattern replaces it. Empty pack =
+  // no movie (the default pattern runs instead).
+  struct MovieConfig {
+    std::string pack;
+    bool loop = true;
+  };
+
+  // Batched metrics (see MetricsRegistry) published over MQTT. An empty
+  // topic means "<mqtt status topic>/metrics".
+  struct TelemetryConfig {
+    bool enabled = true;
+    std::uint32_t intervalMs = 10000;
+    std::string topic;
+  };
+
   struct OtaConfig {
     bool enabled = false;
     std::string username;
@@ -192,6 +222,10 @@ class ConfigManager {
     ImuConfig imu;
     LedConfig led;
     OtaConfig ota;
+    UdpControlConfig udpControl;
+    SyncConfig sync;
+    MovieConfig movie;
+    TelemetryConfig telemetry;
     UiConfig ui;
     SphereConfig sphere;
     JoystickConfig joystick;
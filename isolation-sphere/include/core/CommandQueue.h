@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Fixed-size command records and a bounded ring queue used by SharedState to
+// hand commands between the MQTT task, Core0 and Core1.
+//
+// Nothing here allocates: records carry their argument text inline and the
+// queue is a plain array, so pushing and popping is safe on hot paths. The
+// queue itself is not synchronized; SharedState guards it with its mutex.
+
+enum class UiCommandType : uint8_t {
+  kRaw = 0,      // Unrecognized command, text kept verbatim
+  kNextContent,  // "ui:x_pos"
+  kPlayPause,    // "ui:x_neg"
+  kModeOn,       // "ui:mode:on"
+  kModeOff,      // "ui:mode:off"
+};
+
+enum class SystemCommandType : uint8_t {
+  kCommand = 0,  // sphere/<id>/command, sphere/all/command
+  kSync,         // system/all/sync
+  kEmergency,    // system/all/emergency
+};
+
+// Command kind plus its argument bytes (NUL terminated). The argument holds the
+// original text so records can be forwarded without re-serializing.
+template <typename Type, size_t ArgCapacity>
+struct CommandRecord {
+  static_assert(ArgCapacity <= 255, "argument length is stored in one byte");
+  static constexpr size_t kArgCapacity = ArgCapacity;
+
+  Type type{};
+  uint8_t length = 0;
+  char arg[ArgCapacity + 1] = {};
+
+  // Returns false (leaving the record untouched) if the text does not fit.
+  bool assign(Type commandType, const char *text, size_t textLength) {
+    if (textLength > ArgCapacity || (text == nullptr && textLength != 0)) {
+      return false;
+    }
+    type = commandType;
+    length = static_cast<uint8_t>(textLength);
+    if (textLength != 0) {
+      std::memcpy(arg, text, textLength);
+    }
+    arg[textLength] = '\0';
+    return true;
+  }
+
+  const char *text() const { return arg; }
+};
+
+using UiCommand = CommandRecord<UiCommandType, 47>;
+using SystemCommand = CommandRecord<SystemCommandType, 255>;
+
+inline UiCommandType parseUiCommandType(const char *text, size_t length) {
+  struct Entry {
+    const char *name;
+    UiCommandType type;
+  };
+  static const Entry kEntries[] = {
+      {"ui:x_pos", UiCommandType::kNextContent},
+      {"ui:x_neg", UiCommandType::kPlayPause},
+      {"ui:mode:on", UiCommandType::kModeOn},
+      {"ui:mode:off", UiCommandType::kModeOff},
+  };
+  for (const Entry &entry : kEntries) {
+    if (std::strlen(entry.name) == length && std::memcmp(entry.name, text, length) == 0) {
+      return entry.type;
+    }
+  }
+  return UiCommandType::kRaw;
+}
+
+// Builds a UI record from command text; false if the text is too long.
+inline bool makeUiCommand(const char *text, size_t length, UiCommand &out) {
+  if (text == nullptr) {
+    return false;
+  }
+  return out.assign(parseUiCommandType(text, length), text, length);
+}
+
+// Bounded FIFO. push() on a full queue rejects the new item and counts it as
+// an overflow, so everything already queued is delivered in order.
+template <typename T, size_t Capacity>
+class RingQueue {
+  static_assert(Capacity > 0, "RingQueue capacity must be positive");
+
+ public:
+  bool push(const T &item) {
+    if (count_ == Capacity) {
+      ++overflowCount_;
+      return false;
+    }
+    items_[(head_ + count_) % Capacity] = item;
+    ++count_;
+    if (count_ > highWater_) {
+      highWater_ = count_;
+    }
+    return true;
+  }
+
+  bool pop(T &out) {
+    if (count_ == 0) {
+      return false;
+    }
+    out = items_[head_];
+    head_ = (head_ + 1) % Capacity;
+    --count_;
+    return true;
+  }
+
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+  }
+
+  size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  // Items rejected because the queue was full.
+  uint32_t overflowCount() const { return overflowCount_; }
+  // Deepest the queue has been since construction.
+  size_t highWater() const { return highWater_; }
+
+ private:
+  T items_[Capacity];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  size_t highWater_ = 0;
+  uint32_t overflowCount_ = 0;
+};
@@ -5,12 +5,15 @@
 #include "audio/BuzzerService.h"
 #include "config/ConfigManager.h"
 #include "core/CoreTask.h"
+#include "core/RenderLoop.h"
 #include "core/SharedState.h"
 #include "imu/ImuService.h"
 #include "mqtt/MqttBroker.h"
 #include "mqtt/MqttService.h"
 #include "ota/OtaService.h"
 #include "storage/StorageManager.h"
+#include "wifi/ConnectionManager.h"
+#include "wifi/UdpControlChannel.h"
 #include "wifi/WiFiManager.h"
 
 class Core0Task : public CoreTask {
@@ -27,16 +30,29 @@ class Core0Task : public CoreTask {
   StorageManager &storageManager_;
   SharedState &sharedState_;
   bool configLoaded_ = false;
+  std::uint32_t appliedConfigGeneration_ = 0;
+  ConnectionManager connection_;
+  std::string stationSsid_;
+  std::string stationPassword_;
+  static constexpr uint32_t kServiceRetryMs = 5000;
   OtaService otaService_;
   bool otaInitialized_ = false;
   uint32_t nextOtaRetryMs_ = 0;
   MqttService mqttService_;
   bool mqttConfigured_ = false;
+  UdpControlChannel udpControl_;
+  uint32_t lastUdpStatsLogMs_ = 0;
+  static constexpr uint32_t kUdpStatsLogIntervalMs = 10000;
+  void updateUdpControl(const ConfigManager::Config &cfg);
+  void applyConfig(const ConfigManager::Config &cfg);
+  void serviceConnections(uint32_t now);
+  void registerMetrics();
   // WiFi and MQTT members
   WiFiManager *wifiManager_ = nullptr;
   bool wifiConfigured_ = false;
   MqttBroker *mqttBroker_ = nullptr;
   bool mqttBrokerConfigured_ = false;
+  uint32_t nextBrokerRetryMs_ = 0;
 };
 
 class Core1Task : public CoreTask {
@@ -56,6 +72,9 @@ class Core1Task : public CoreTask {
   };
 
   SharedState &sharedState_;
+  RenderLoop renderLoop_;
+  SharedState::ConfigSnapshot configSnapshot_;
+  std::uint32_t appliedConfigGeneration_ = 0;
   bool displayedConfig_ = false;
   ImuService imuService_;
   bool imuInitialized_ = false;
@@ -67,6 +86,8 @@ class Core1Task : public CoreTask {
   std::uint32_t lastImuReadMs_ = 0;
   std::uint32_t nextImuRetryMs_ = 0;
   bool imuDebugLogging_ = false;
+  MetricsRegistry::Counter *imuReadsMetric_ = nullptr;
+  MetricsRegistry::Counter *imuFailuresMetric_ = nullptr;
   ConfigManager::ImuConfig imuConfig_{};
   bool gestureUiModeEnabled_ = false;
   bool uiModeActive_ = false;
@@ -83,11 +104,13 @@ class Core1Task : public CoreTask {
   void exitUiMode();
   void processUiMode(const ImuService::Reading &reading);
   void updateUiReference(const ImuService::Reading &reading);
-  void handleUiCommand(const std::string &command, bool external);
+  void handleUiCommand(const UiCommand &command, bool external);
   void triggerLocalUiCommand(const char *command);
   void applyUiBrightnessSettings(bool entering);
   void processIncomingUiCommands();
   void configureBuzzer(const ConfigManager::Config &cfg);
+  bool refreshConfig();
+  void applyConfig(const ConfigManager::Config &cfg);
 #ifdef UNIT_TEST
  public:
   void setImuHooksForTest(ImuService::Hooks hooks);
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Double-buffered landing area for image payloads received over MQTT. Owned
+// by SharedState so the Core0 writer and the Core1 consumer share it.
+//
+// The MQTT task streams each fragment straight into a preallocated slot
+// (PSRAM when available), so a frame costs exactly one copy out of the
+// network buffer and no heap growth. When the last fragment lands the slot is
+// published as ready and the frame listener (if any) is notified; the
+// consumer (RenderLoop on Core1) then acquire()s it, reads it in place and
+// release()s it.
+//
+// Threading: one writer (the MQTT callback) and one consumer. Slot ownership
+// is handed over with atomic state transitions, so neither side blocks. If the
+// consumer falls behind, an unconsumed ready frame is replaced by the newer
+// one and counted as dropped; a slot being read is never written.
+class ImageFrameBuffer {
+ public:
+  static constexpr size_t kSlotCount = 2;
+
+  struct Frame {
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    uint32_t sequence = 0;  // 1-based, increments per completed frame
+    uint8_t source = 0;     // caller-defined tag (e.g. which topic)
+    uint8_t slot = 0;
+  };
+
+  struct Stats {
+    uint32_t framesCompleted = 0;
+    uint32_t framesConsumed = 0;
+    uint32_t framesDropped = 0;    // replaced before the consumer took them
+    uint32_t framesOversize = 0;   // larger than the slot capacity
+    uint32_t framesAborted = 0;    // missing/out-of-order fragment or no free slot
+    uint32_t bytesReceived = 0;
+  };
+
+  using FrameListener = std::function<void(const Frame &frame)>;
+
+  ImageFrameBuffer() = default;
+  ~ImageFrameBuffer();
+
+  ImageFrameBuffer(const ImageFrameBuffer &) = delete;
+  ImageFrameBuffer &operator=(const ImageFrameBuffer &) = delete;
+
+  // Allocates both slots once. Calling again with the same capacity is a
+  // no-op; a different capacity reallocates (only while no frame is held).
+  bool allocate(size_t slotCapacity);
+  void release();
+  bool isAllocated() const { return slotCapacity_ != 0; }
+  size_t slotCapacity() const { return slotCapacity_; }
+
+  // Called from the frame writer (MQTT task) when the last fragment lands.
+  // Runs on the writer's thread; keep it short (e.g. notify a task).
+  void setFrameListener(FrameListener listener) { listener_ = std::move(listener); }
+
+  // --- Writer side -------------------------------------------------------
+  // Starts a frame of totalSize bytes. Returns false if it cannot be
+  // accepted (too large, no free slot); the remaining fragments are ignored.
+  bool beginFrame(size_t totalSize, uint8_t source = 0);
+  // Copies one fragment at its byte offset. Fragments must arrive in order.
+  // Completes the frame automatically when the last byte is written.
+  bool writeFragment(size_t offset, const uint8_t *data, size_t length);
+  bool receiving() const { return writeSlot_ >= 0; }
+
+  // --- Consumer side -----------------------------------------------------
+  // Takes the newest ready frame. The data stays valid until release().
+  bool acquire(Frame &out);
+  void release(const Frame &frame);
+  bool hasReadyFrame() const;
+
+  Stats stats() const;
+
+ private:
+  enum SlotState : uint8_t { kFree = 0, kWriting, kReady, kReading };
+
+  struct Slot {
+    uint8_t *data = nullptr;
+    size_t size = 0;
+    uint32_t sequence = 0;
+    uint8_t source = 0;
+    std::atomic<uint8_t> state{kFree};
+  };
+
+  void abortFrame();
+  void completeFrame();
+
+  Slot slots_[kSlotCount];
+  size_t slotCapacity_ = 0;
+  FrameListener listener_;
+
+  // Writer-only state
+  int writeSlot_ = -1;
+  size_t writeTotal_ = 0;
+  size_t writeOffset_ = 0;
+  uint8_t writeSource_ = 0;
+  uint32_t nextSequence_ = 1;
+
+  std::atomic<uint32_t> framesCompleted_{0};
+  std::atomic<uint32_t> framesConsumed_{0};
+  std::atomic<uint32_t> framesDropped_{0};
+  std::atomic<uint32_t> framesOversize_{0};
+  std::atomic<uint32_t> framesAborted_{0};
+  std::atomic<uint32_t> bytesReceived_{0};
+};
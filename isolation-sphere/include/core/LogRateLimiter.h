@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Allows at most `burst` log lines per `windowMs`; everything beyond that is
+// counted instead of printed. The caller reports the suppressed count with
+// the next line that gets through (takeSuppressed()).
+class LogRateLimiter {
+ public:
+  LogRateLimiter(std::uint16_t burst, std::uint32_t windowMs) : burst_(burst), windowMs_(windowMs) {}
+
+  bool allow(std::uint32_t nowMs) {
+    if (!started_ || nowMs - windowStartMs_ >= windowMs_) {
+      started_ = true;
+      windowStartMs_ = nowMs;
+      used_ = 0;
+    }
+    if (used_ < burst_) {
+      ++used_;
+      return true;
+    }
+    ++suppressed_;
+    return false;
+  }
+
+  // Lines dropped since the last call.
+  std::uint32_t takeSuppressed() {
+    const std::uint32_t count = suppressed_;
+    suppressed_ = 0;
+    return count;
+  }
+
+ private:
+  std::uint16_t burst_;
+  std::uint32_t windowMs_;
+  std::uint32_t windowStartMs_ = 0;
+  std::uint16_t used_ = 0;
+  std::uint32_t suppressed_ = 0;
+  bool started_ = false;
+};
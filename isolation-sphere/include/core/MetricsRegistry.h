@@ -0,0 +1,161 @@
+#pragma once
+
+#ifdef UNIT_TEST
+#include <mutex>
+#else
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Process-wide telemetry: subsystems register named counters, gauges and
+// histograms once at startup and update them from any core; the MQTT task
+// periodically batches everything into one compact JSON payload.
+//
+// Updates are single relaxed atomics (no locks, no allocation), so they are
+// safe on the render and IMU paths. Registration and serialization take a
+// mutex and may allocate; they belong in setup code and the publisher.
+//
+// Metric objects live in fixed pools inside the registry and never move, so
+// the pointers returned by counter()/gauge()/histogram() stay valid for the
+// registry's lifetime. Registering an existing name of the same kind returns
+// the existing metric; a full pool or a kind clash returns nullptr.
+class MetricsRegistry {
+ public:
+  static constexpr size_t kMaxCounters = 32;
+  static constexpr size_t kMaxGauges = 24;
+  static constexpr size_t kMaxHistograms = 8;
+  static constexpr size_t kMaxSamplers = 8;
+  static constexpr size_t kMaxNameLength = 15;
+
+  // Monotonic event count (frames, packets, drops).
+  class Counter {
+   public:
+    void add(uint32_t delta = 1) { value_.fetch_add(delta, std::memory_order_relaxed); }
+    // Mirrors a count some subsystem already maintains (e.g. from a sampler).
+    void set(uint32_t value) { value_.store(value, std::memory_order_relaxed); }
+    uint32_t value() const { return value_.load(std::memory_order_relaxed); }
+
+   private:
+    std::atomic<uint32_t> value_{0};
+  };
+
+  // Last-written level (free heap, queue depth, FPS).
+  class Gauge {
+   public:
+    void set(float value);
+    float value() const;
+
+   private:
+    std::atomic<uint32_t> bits_{0};
+  };
+
+  // Log-linear histogram: 4 buckets per power of two, so any recorded value
+  // is reported within 25% (exact below 8). Values at or above kRangeLimit
+  // land in the last bucket; max is tracked exactly. Intended for
+  // microsecond timings up to ~131 ms.
+  class Histogram {
+   public:
+    static constexpr size_t kBucketCount = 64;
+    static constexpr uint32_t kRangeLimit = 131072;
+
+    struct Summary {
+      uint32_t count = 0;
+      uint32_t avg = 0;
+      uint32_t p50 = 0;
+      uint32_t p95 = 0;
+      uint32_t p99 = 0;
+      uint32_t max = 0;
+    };
+
+    void record(uint32_t value);
+
+    // Summarizes and clears everything recorded since the previous drain.
+    // Values recorded concurrently are either in this window or the next.
+    Summary drain();
+
+    static size_t bucketIndex(uint32_t value);
+    static uint32_t bucketUpperBound(size_t index);
+
+   private:
+    std::atomic<uint32_t> buckets_[kBucketCount] = {};
+    std::atomic<uint32_t> sum_{0};
+    std::atomic<uint32_t> max_{0};
+  };
+
+  enum class CounterRate : uint8_t {
+    kNone = 0,
+    kPerSecond,  // additionally reported as events/s over the publish window
+  };
+
+  // Runs on the publisher right before serialization; lets subsystems that
+  // already keep their own stats mirror them into gauges/counters instead of
+  // touching the registry on their hot paths.
+  using Sampler = std::function<void()>;
+
+  MetricsRegistry();
+  ~MetricsRegistry();
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+
+  Counter *counter(const char *name, CounterRate rate = CounterRate::kNone);
+  Gauge *gauge(const char *name);
+  Histogram *histogram(const char *name);
+  bool addSampler(Sampler sampler);
+
+  size_t metricCount() const;
+
+  // Runs the samplers, then writes
+  //   {"t":<nowMs>,"dt":<ms since previous call>,
+  //    "c":{name:count,...},"r":{name:per_second,...},"g":{name:value,...},
+  //    "h":{name:[count,avg,p50,p95,p99,max],...}}
+  // into `out` (cleared first; its capacity is reused between calls).
+  // Histograms are drained, so each payload covers one publish window.
+  // Empty sections are omitted.
+  void serialize(std::string &out, uint32_t nowMs);
+
+ private:
+  enum class Kind : uint8_t { kCounter, kGauge, kHistogram };
+
+  struct Entry {
+    char name[kMaxNameLength + 1] = {};
+    Kind kind = Kind::kCounter;
+    uint8_t index = 0;
+  };
+
+  struct CounterSlot {
+    Counter counter;
+    CounterRate rate = CounterRate::kNone;
+    uint32_t lastValue = 0;  // value at the previous serialize, for rates
+  };
+
+  static constexpr size_t kMaxEntries = kMaxCounters + kMaxGauges + kMaxHistograms;
+
+  const Entry *find(const char *name) const;
+  void addEntry(const char *name, Kind kind, size_t index);
+  void lock() const;
+  void unlock() const;
+
+#ifndef UNIT_TEST
+  mutable SemaphoreHandle_t mutex_ = nullptr;
+#else
+  mutable std::mutex mutex_;
+#endif
+  Entry entries_[kMaxEntries];
+  size_t entryCount_ = 0;
+  CounterSlot counters_[kMaxCounters];
+  size_t counterCount_ = 0;
+  Gauge gauges_[kMaxGauges];
+  size_t gaugeCount_ = 0;
+  Histogram histograms_[kMaxHistograms];
+  size_t histogramCount_ = 0;
+  Sampler samplers_[kMaxSamplers];
+  size_t samplerCount_ = 0;
+  uint32_t lastSerializeMs_ = 0;
+  bool serialized_ = false;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// Transports that publish remote control values; each owns one SharedState
+// slot and is its only writer.
+enum class ControlSource : std::uint8_t { kMqtt = 0, kUdp, kCount };
+
+// Latest remote control values (posture offsets, brightness, pattern) as seen
+// by the render loop. Transport-neutral: the MQTT binary/JSON handlers and
+// the UDP channel (control records and joystick frames) decode into it.
+struct RemoteControl {
+  // Values received so far; same bits as control::FieldMask.
+  enum Field : std::uint8_t {
+    kPosture = 1u << 1,
+    kBrightness = 1u << 2,
+    kPattern = 1u << 3,
+  };
+
+  float latitudeOffsetDeg = 0.0f;
+  float longitudeOffsetDeg = 0.0f;
+  std::uint8_t brightness = 0;
+  std::uint8_t patternId = 0;
+  std::uint8_t fields = 0;
+  ControlSource source = ControlSource::kMqtt;
+  std::uint16_t sequence = 0;
+  std::uint32_t updatedMs = 0;
+
+  bool has(Field field) const { return (fields & field) != 0; }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+#include "config/ConfigManager.h"
+#include "core/ImageFrameBuffer.h"
+#include "core/MetricsRegistry.h"
+#include "core/RemoteControl.h"
+#include "core/SharedState.h"
+#include "core/SyncClock.h"
+#include "led/FramePackPlayer.h"
+#include "led/JpegLedDecoder.h"
+#include "led/LEDSphereManager.h"
+#include "pattern/ProceduralPatternGenerator.h"
+
+// LED render path, driven from Core1Task::loop(). Owns the sphere and
+// presents what Core0 publishes through SharedState: image and live frames
+// landed in SharedState::imageFrames(), the newest remote control values
+// (posture offsets, brightness, pattern), the IMU posture and the sync
+// timebase.
+//
+// tick() never blocks. It takes the newest ready frame, writes it into the
+// LED frame buffer (live frames copied as-is, JPEG panoramas sampled per LED
+// by JpegLedDecoder) and shows; a tick with nothing new leaves the LEDs
+// untouched. Live slots are released straight away. The last JPEG is held
+// until a newer frame arrives so a posture change (IMU or joystick) can
+// re-sample it; the MQTT task still has the other slot to write into.
+//
+// Content: whichever came last of an image frame and a remote pattern
+// selection is shown. A pattern is selected when the requested id changes;
+// until anything arrives the configured movie (or else the default pattern)
+// runs. Patterns and movies are timed by the shared SyncTimebase (plain
+// millis() at the sync fps when none is published), so side-by-side spheres
+// show the same frame; each is drawn once per timebase frame.
+//
+// System commands queued by the MQTT task are drained every tick. An
+// emergency message blanks the LEDs and holds them dark (frames are released
+// unshown, patterns and movies paused) until an emergency message carrying
+// "resume" arrives.
+class RenderLoop {
+ public:
+  enum class Content : uint8_t { kNone = 0, kImage, kPattern, kMovie };
+
+  static constexpr const char *kDefaultPattern = "spherical_wave";
+
+  struct Stats {
+    uint32_t framesShown = 0;
+    uint32_t liveFrames = 0;
+    uint32_t jpegFrames = 0;
+    uint32_t jpegResampled = 0;   // held JPEG re-decoded after a posture change
+    uint32_t patternFrames = 0;
+    uint32_t movieFrames = 0;
+    uint32_t rejectedFrames = 0;  // wrong size for the strips, or undecodable
+    uint32_t controlUpdates = 0;  // remote control records applied
+    uint32_t systemCommands = 0;  // popped from the incoming system queue
+    uint32_t emergencyStops = 0;
+  };
+
+  explicit RenderLoop(SharedState &sharedState);
+  ~RenderLoop();
+
+  RenderLoop(const RenderLoop &) = delete;
+  RenderLoop &operator=(const RenderLoop &) = delete;
+
+  // Brings up the strips from cfg.led, loads the LED layout and opens
+  // cfg.movie.pack. Runs once; returns false (and keeps the loop idle) while
+  // no LEDs are configured.
+  bool begin(const ConfigManager::Config &cfg, const char *layoutPath = "/led_layout.csv");
+  bool ready() const { return ready_; }
+
+  // Frame/stage timings and drops of the LED pipeline (see FrameProfiler);
+  // call during setup, before the first tick.
+  void attachMetrics(MetricsRegistry &registry);
+
+  // Default content; rejected unless the pack matches the strip LED count.
+  bool openMovie(LEDSphere::FramePackPlayer::Source source, bool loop);
+
+  void tick(uint32_t nowMs);
+
+  Content content() const { return content_; }
+  bool emergencyStopped() const { return emergencyStopped_; }
+  ProceduralPattern::PatternId patternId() const { return patternId_; }
+  const Stats &stats() const { return stats_; }
+  const LEDSphere::JpegLedDecoder::Stats &jpegStats() const { return jpegDecoder_.stats(); }
+  LEDSphere::LEDSphereManager &sphere() { return sphere_; }
+
+ private:
+  void setContent(Content content);
+  void processSystemCommands();
+  void handleEmergency(const SystemCommand &command);
+  void applyRemoteControl();
+  void applyImuPosture();
+  void selectPattern(ProceduralPattern::PatternId id);
+  void presentNewFrame(const ImageFrameBuffer::Frame &frame);
+  bool presentImageFrame(const ImageFrameBuffer::Frame &frame);
+  bool resampleHeldImage();
+  SyncTimebase timebase() const;
+  void renderPattern(uint32_t nowMs);
+  void renderMovie(uint32_t nowMs);
+  void releaseHeldImage();
+
+  SharedState &sharedState_;
+  LEDSphere::LEDSphereManager sphere_;
+  LEDSphere::JpegLedDecoder jpegDecoder_;
+  ProceduralPattern::PatternGenerator patterns_;
+  LEDSphere::FramePackPlayer movie_;
+  bool ready_ = false;
+  uint16_t syncFps_ = 30;
+  bool emergencyStopped_ = false;
+
+  Content content_ = Content::kNone;
+  ProceduralPattern::PatternId patternId_ = ProceduralPattern::kInvalidPatternId;
+  uint32_t patternFrame_ = 0;  // timebase frame last drawn
+  bool patternDrawn_ = false;
+
+  ImageFrameBuffer::Frame heldImage_;
+  bool holdingImage_ = false;
+  uint32_t heldUvGeneration_ = 0;
+
+  // Last applied remote control record and the values taken from it; the
+  // slot keeps every field it has ever carried, so changes are detected
+  // against these rather than against the field mask.
+  bool haveControl_ = false;
+  ControlSource controlSource_ = ControlSource::kMqtt;
+  uint16_t controlSequence_ = 0;
+  uint32_t controlUpdatedMs_ = 0;
+  int brightness_ = -1;  // -1 = never set remotely
+  ProceduralPattern::PatternId requestedPattern_ = ProceduralPattern::kInvalidPatternId;
+
+  Stats stats_;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer / multi-reader sequence lock for small trivially copyable
+// values (IMU samples etc.).
+//
+// - write() never blocks and never waits for readers.
+// - read() returns the newest fully written value; if the writer is in the
+//   middle of an update the reader retries, so a torn value is never returned.
+// - The payload is stored as relaxed atomic words, so concurrent access is
+//   race-free without a mutex.
+//
+// Only one thread may call write() at a time.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+ public:
+  SeqLock() {
+    for (auto &word : words_) {
+      word.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  SeqLock(const SeqLock &) = delete;
+  SeqLock &operator=(const SeqLock &) = delete;
+
+  void write(const T &value) {
+    std::uint32_t buffer[kWordCount] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+
+    const std::uint32_t seq = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(seq + 1, std::memory_order_relaxed);  // odd: write in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWordCount; ++i) {
+      words_[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    sequence_.store(seq + 2, std::memory_order_release);
+  }
+
+  // Returns false until the first write() has completed.
+  bool read(T &out) const {
+    std::uint32_t buffer[kWordCount];
+    std::uint32_t before;
+    std::uint32_t retries = 0;
+    while (true) {
+      before = sequence_.load(std::memory_order_acquire);
+      if (before == 0) {
+        return false;
+      }
+      if ((before & 1u) == 0) {
+        for (std::size_t i = 0; i < kWordCount; ++i) {
+          buffer[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == before) {
+          break;
+        }
+      }
+      ++retries;
+    }
+    if (retries != 0) {
+      readRetries_.fetch_add(retries, std::memory_order_relaxed);
+    }
+    std::memcpy(&out, buffer, sizeof(T));
+    return true;
+  }
+
+  bool hasValue() const { return sequence_.load(std::memory_order_acquire) != 0; }
+
+  // Number of completed writes.
+  std::uint32_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+  // Total reader retries caused by overlapping writes (diagnostics).
+  std::uint32_t readRetries() const { return readRetries_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr std::size_t kWordCount = (sizeof(T) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+
+  std::atomic<std::uint32_t> sequence_{0};
+  std::atomic<std::uint32_t> words_[kWordCount];
+  mutable std::atomic<std::uint32_t> readRetries_{0};
+};
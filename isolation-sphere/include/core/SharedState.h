@@ -8,8 +8,16 @@
 #endif
 
 #include "config/ConfigManager.h"
+#include "core/CommandQueue.h"
+#include "core/ImageFrameBuffer.h"
+#include "core/MetricsRegistry.h"
+#include "core/RemoteControl.h"
+#include "core/SeqLock.h"
+#include "core/SyncClock.h"
 #include "imu/ImuService.h"
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 class SharedState {
@@ -17,21 +25,85 @@ class SharedState {
   SharedState();
   ~SharedState();
 
+  // Config is published as an immutable, reference-counted snapshot tagged
+  // with a generation number (0 = nothing published yet). Consumers poll
+  // configGeneration() without locking and fetch the snapshot only when it
+  // differs from the generation they last applied; fetching shares the
+  // published object instead of deep-copying strings and vectors.
+  using ConfigSnapshot = std::shared_ptr<const ConfigManager::Config>;
+
   void updateConfig(const ConfigManager::Config &config);
   bool getConfigCopy(ConfigManager::Config &out) const;
+  bool getConfigSnapshot(ConfigSnapshot &out, std::uint32_t *generation = nullptr) const;
+  std::uint32_t configGeneration() const { return configGeneration_.load(std::memory_order_acquire); }
 
+  // Lock-free: the IMU writer never blocks, readers always get the newest
+  // complete sample (see SeqLock).
   void updateImuReading(const ImuService::Reading &reading);
   bool getImuReading(ImuService::Reading &out) const;
+  std::uint32_t imuReadRetries() const { return imuReading_.readRetries(); }
+
+  // Latest remote control values (see RemoteControl). Each transport owns
+  // one lock-free slot, selected by RemoteControl::source, and is its only
+  // writer; getRemoteControl() returns the most recently updated one.
+  void updateRemoteControl(const RemoteControl &control);
+  bool getRemoteControl(RemoteControl &out) const;
+
+  // Multi-sphere animation timebase (see SyncClock), written only by the
+  // MQTT task. Renderers derive PatternParams::time / movie frame indices
+  // from it; when nothing (or an invalid timebase) has been published they
+  // fall back to SyncTimebase::local(0, fps), i.e. plain millis().
+  void updateSyncTimebase(const SyncTimebase &timebase);
+  bool getSyncTimebase(SyncTimebase &out) const;
 
   void setUiMode(bool active);
   bool getUiMode(bool &active) const;
 
-  void pushUiCommand(const std::string &command, bool external);
+  // Bounded command queues, one per direction ("external" = arrived over
+  // MQTT, otherwise produced locally for publishing). Pushing onto a full
+  // queue drops the new command and bumps that queue's overflow counter;
+  // pushing text longer than the record capacity is rejected and counted as
+  // oversize. Neither path allocates.
+  static constexpr size_t kUiQueueDepth = 16;
+  static constexpr size_t kSystemQueueDepth = 8;
+
+  struct CommandQueueStats {
+    uint32_t uiIncomingOverflow = 0;
+    uint32_t uiOutgoingOverflow = 0;
+    uint32_t systemIncomingOverflow = 0;
+    uint32_t systemOutgoingOverflow = 0;
+    uint32_t oversizeRejected = 0;
+    uint8_t uiIncomingDepth = 0;
+    uint8_t systemIncomingDepth = 0;
+    uint8_t uiIncomingHighWater = 0;
+    uint8_t systemIncomingHighWater = 0;
+  };
+
+  bool pushUiCommand(const UiCommand &command, bool external);
+  bool pushUiCommand(const char *command, bool external);
+  bool pushUiCommand(const std::string &command, bool external);
+  bool popUiCommand(UiCommand &command, bool external);
   bool popUiCommand(std::string &command, bool external);
-  
-  void pushSystemCommand(const std::string &command, bool external);
+
+  bool pushSystemCommand(SystemCommandType type, const char *payload, size_t length, bool external);
+  bool pushSystemCommand(const std::string &command, bool external);
+  bool popSystemCommand(SystemCommand &command, bool external);
   bool popSystemCommand(std::string &command, bool external);
 
+  CommandQueueStats getCommandQueueStats() const;
+
+  // Image payloads landed by the MQTT task (image / image_individual /
+  // image_all topics and decoded live streams) for the Core1 render loop.
+  // Frame::source holds an ImageSource value; kLive frames are LED count x
+  // RGB in LED order, everything else is JPEG. The MQTT task allocates the
+  // slots once its config is applied.
+  enum class ImageSource : uint8_t { kLegacy = 0, kIndividual, kBroadcast, kLive };
+  ImageFrameBuffer &imageFrames() { return imageFrames_; }
+
+  // Telemetry shared by both cores: subsystems register their metrics here
+  // during setup and update them lock-free; MqttService publishes the batch.
+  MetricsRegistry &metrics() { return metrics_; }
+
  private:
   void lock() const;
   void unlock() const;
@@ -41,18 +113,18 @@ class SharedState {
 #else
   mutable std::mutex mutex_;
 #endif
-  ConfigManager::Config config_{};
-  bool hasConfig_ = false;
-  ImuService::Reading imuReading_{};
-  bool hasImuReading_ = false;
+  ConfigSnapshot config_;
+  std::atomic<std::uint32_t> configGeneration_{0};
+  SeqLock<ImuService::Reading> imuReading_;
+  SeqLock<RemoteControl> remoteControl_[static_cast<size_t>(ControlSource::kCount)];
+  SeqLock<SyncTimebase> syncTimebase_;
   bool uiModeActive_ = false;
   bool hasUiMode_ = false;
-  std::string uiCommandIncoming_;
-  bool hasUiCommandIncoming_ = false;
-  std::string uiCommandOutgoing_;
-  bool hasUiCommandOutgoing_ = false;
-  std::string systemCommandIncoming_;
-  bool hasSystemCommandIncoming_ = false;
-  std::string systemCommandOutgoing_;
-  bool hasSystemCommandOutgoing_ = false;
+  RingQueue<UiCommand, kUiQueueDepth> uiCommandsIncoming_;
+  RingQueue<UiCommand, kUiQueueDepth> uiCommandsOutgoing_;
+  RingQueue<SystemCommand, kSystemQueueDepth> systemCommandsIncoming_;
+  RingQueue<SystemCommand, kSystemQueueDepth> systemCommandsOutgoing_;
+  uint32_t oversizeRejected_ = 0;
+  ImageFrameBuffer imageFrames_;
+  MetricsRegistry metrics_;
 };
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Shared animation timebase for several spheres running side by side.
+//
+// One sphere (the sync master) periodically broadcasts a beacon with its
+// millis() clock and the frame number it is currently showing. Every sphere
+// maps its local millis() onto the master clock and derives the animation
+// time / movie frame index from that, so all units show the same frame.
+//
+// SyncTimebase is the small, trivially copyable result that is published
+// through SharedState; SyncClock is the estimator that produces it.
+struct SyncTimebase {
+  bool valid = false;
+  std::uint16_t fps = 30;
+  std::uint32_t anchorLocalMs = 0;
+  std::int32_t offsetMs = 0;        // master - local at anchorLocalMs
+  float drift = 0.0f;               // master ms gained per local ms
+  std::uint32_t epochMasterMs = 0;  // master time of animation frame 0
+  std::uint32_t lastBeaconMs = 0;   // local receive time of the newest beacon
+
+  // Timebase of a standalone (or master) sphere: master clock == local clock.
+  static SyncTimebase local(std::uint32_t epochMs, std::uint16_t fps) {
+    SyncTimebase timebase;
+    timebase.valid = true;
+    timebase.fps = fps == 0 ? 30 : fps;
+    timebase.epochMasterMs = epochMs;
+    return timebase;
+  }
+
+  std::uint32_t masterTimeMs(std::uint32_t localMs) const {
+    const std::int32_t elapsed = static_cast<std::int32_t>(localMs - anchorLocalMs);
+    const std::int32_t correction = static_cast<std::int32_t>(std::lroundf(drift * static_cast<float>(elapsed)));
+    return localMs + static_cast<std::uint32_t>(offsetMs + correction);
+  }
+
+  std::uint32_t elapsedMs(std::uint32_t localMs) const { return masterTimeMs(localMs) - epochMasterMs; }
+
+  // Animation time wraps every kAnimationWrapMs: a float holding ms since
+  // the epoch drops below millisecond resolution after ~4.6 h, the wrapped
+  // value never does. All spheres wrap on the same master instant; periods
+  // that divide an hour wrap seamlessly.
+  static constexpr std::uint32_t kAnimationWrapMs = 3600u * 1000u;
+
+  std::uint32_t animationTimeMs(std::uint32_t localMs) const { return elapsedMs(localMs) % kAnimationWrapMs; }
+
+  // ProceduralPattern::PatternParams::time
+  float animationTimeSec(std::uint32_t localMs) const {
+    return static_cast<float>(animationTimeMs(localMs)) * 0.001f;
+  }
+
+  // Movie frame index; fps == 0 uses the timebase rate.
+  std::uint32_t frameAt(std::uint32_t localMs, std::uint16_t frameRate = 0) const {
+    const std::uint32_t rate = frameRate != 0 ? frameRate : fps;
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(elapsedMs(localMs)) * rate / 1000u);
+  }
+};
+
+class SyncClock {
+ public:
+  // Timebase announcement from the master ("system/all/sync").
+  // frame * 1000 / fps (integer division) + frameOffsetMs is the exact
+  // animation time at masterMs, so receivers recover the master's epoch
+  // without the up-to-one-frame error of the frame number alone.
+  struct Beacon {
+    std::uint32_t masterMs = 0;       // master millis() when the beacon was sent
+    std::uint32_t frame = 0;          // master animation frame at masterMs
+    std::uint16_t frameOffsetMs = 0;  // ms since that frame started
+    std::uint16_t fps = 30;
+    std::uint16_t sequence = 0;
+
+    std::uint32_t epochMs() const;
+  };
+
+  struct Stats {
+    std::uint32_t beacons = 0;
+    std::uint32_t outliers = 0;  // dropped as delayed far beyond the others
+    std::uint32_t resyncs = 0;   // master restarted / clock jumped
+    float driftPpm = 0.0f;
+  };
+
+  // Offset samples kept for the estimate (~32 s at the default 1 Hz beacon).
+  static constexpr std::size_t kSampleCount = 32;
+  // Beacons needed before the timebase is published.
+  static constexpr std::size_t kMinSamples = 4;
+  // Drift is fitted through the best (least delayed) sample of each block of
+  // kBlockSize beacons, over the last kBlockCount blocks (~64 s at 1 Hz).
+  static constexpr std::size_t kBlockSize = 8;
+  static constexpr std::size_t kBlockCount = 8;
+  static constexpr std::uint32_t kMinDriftSpanMs = 15000;
+  // Crystal tolerance bound; larger estimates are clamped.
+  static constexpr float kMaxDrift = 0.0005f;
+  // A sample this far from the prediction is an outlier; several in a row
+  // mean the master restarted.
+  static constexpr std::int32_t kOutlierMs = 250;
+  static constexpr std::uint8_t kResyncAfterOutliers = 3;
+
+  static Beacon makeBeacon(std::uint32_t nowMs, std::uint32_t epochMs, std::uint16_t fps, std::uint16_t sequence);
+
+  void reset();
+
+  // Feeds one beacon received at local time `localRxMs`. Returns true when
+  // the timebase is (re)computed.
+  bool onBeacon(const Beacon &beacon, std::uint32_t localRxMs);
+
+  const SyncTimebase &timebase() const { return timebase_; }
+  bool locked(std::uint32_t nowMs, std::uint32_t timeoutMs) const {
+    return timebase_.valid && nowMs - timebase_.lastBeaconMs < timeoutMs;
+  }
+  Stats stats() const;
+
+ private:
+  struct Sample {
+    std::uint32_t localMs;
+    std::int32_t offsetMs;  // masterMs - localRxMs = true offset - network delay
+  };
+
+  void addSample(const Sample &sample);
+  void updateDrift();
+  void updateEstimate();
+
+  Sample samples_[kSampleCount] = {};
+  std::size_t head_ = 0;
+  std::size_t count_ = 0;
+  Sample blocks_[kBlockCount] = {};
+  std::size_t blockHead_ = 0;
+  std::size_t blockCount_ = 0;
+  Sample blockBest_ = {};
+  std::size_t blockFill_ = 0;
+  bool driftKnown_ = false;
+  std::uint8_t consecutiveOutliers_ = 0;
+  SyncTimebase timebase_{};
+  std::uint32_t beacons_ = 0;
+  std::uint32_t outliers_ = 0;
+  std::uint32_t resyncs_ = 0;
+};
@@ -0,0 +1,137 @@
+/**
+ * @file FramePack.h
+ * @brief LED順RGBフレームのパック形式（動画再生用）
+ *
+ * JPEG動画フレームをオフラインでLED順（faceID順）のRGB列に変換し、
+ * 1ファイルにまとめた形式。再生時はフレーム毎に1回の連続読み出しのみで、
+ * JPEGデコード・UV変換・サンプリングは不要。
+ *
+ * ファイル構成（リトルエンディアン）:
+ *   FramePackHeader（32バイト）
+ *   FramePackIndexEntry × frameCount（インデックス表）
+ *   フレームデータ（各フレームは下記いずれかの符号化）
+ *     kRaw   : ledCount × RGB
+ *     kRle   : [n-1 (0..127)] + RGB で同色n個 / [0x80|(n-1)] + RGB×n でリテラルn個
+ *     kDelta : 前フレーム基準。[n-1 (0..127)] で n個据え置き / [0x80|(n-1)] + RGB×n で n個更新
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LEDSphere {
+
+/**
+ * @brief フレームの符号化方式
+ */
+enum class FrameEncoding : uint8_t {
+    kRaw = 0,
+    kRle = 1,
+    kDelta = 2,
+};
+
+#pragma pack(push, 1)
+struct FramePackHeader {
+    char magic[4];          // "LFPK"
+    uint16_t version;
+    uint16_t ledCount;
+    uint32_t frameCount;
+    uint16_t fps;
+    uint16_t flags;         // 予約
+    uint32_t indexOffset;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+    uint32_t maxFrameSize;  // 最大符号化フレームサイズ（読み出しバッファ確保用）
+};
+
+struct FramePackIndexEntry {
+    uint32_t offset;        // ファイル先頭からのオフセット
+    uint32_t size;          // 符号化後のバイト数
+    uint8_t encoding;       // FrameEncoding
+    uint8_t keyframe;       // 1: 前フレームに依存しない
+    uint16_t reserved;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(FramePackHeader) == 32, "FramePackHeader must be 32 bytes");
+static_assert(sizeof(FramePackIndexEntry) == 12, "FramePackIndexEntry must be 12 bytes");
+
+namespace FramePack {
+
+constexpr char kMagic[4] = {'L', 'F', 'P', 'K'};
+constexpr uint16_t kVersion = 1;
+
+/**
+ * @brief 1フレームの符号化サイズ上限（全LEDが長さ1のランとなるRLE: LED毎に1 + RGB）
+ */
+constexpr size_t maxEncodedFrameSize(size_t ledCount) { return ledCount * 4; }
+
+/**
+ * @brief ヘッダ検証（マジック・バージョン・サイズ整合、maxFrameSizeの上限）
+ * @param fileSize ファイル全体のサイズ（0なら範囲検証を省略）
+ */
+bool validateHeader(const FramePackHeader& header, size_t fileSize = 0);
+
+/**
+ * @brief 1フレームをRLE符号化
+ */
+void encodeRle(const uint8_t* rgb, size_t ledCount, std::vector<uint8_t>& out);
+
+/**
+ * @brief 前フレームとの差分を符号化
+ */
+void encodeDelta(const uint8_t* prev, const uint8_t* rgb, size_t ledCount, std::vector<uint8_t>& out);
+
+/**
+ * @brief 符号化フレームを展開
+ * @param dst 出力（kDeltaの場合は前フレーム内容を保持していること）
+ * @return 入力が正しく展開できたか
+ */
+bool decodeFrame(FrameEncoding encoding, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t ledCount);
+
+} // namespace FramePack
+
+/**
+ * @brief パックファイル生成（オフライン変換ツール・テスト用）
+ */
+class FramePackWriter {
+public:
+    /**
+     * @param ledCount 1フレームのLED数
+     * @param fps 再生フレームレート
+     * @param keyframeInterval キーフレーム間隔（0なら先頭のみ）
+     */
+    FramePackWriter(uint16_t ledCount, uint16_t fps, uint32_t keyframeInterval = 30);
+
+    /**
+     * @brief 差分・RLEの使用可否（無効時は全フレームkRaw）
+     */
+    void setCompressionEnabled(bool enabled) { compression_ = enabled; }
+
+    /**
+     * @brief フレーム追加（ledCount × RGB）。最小サイズの符号化を自動選択
+     */
+    void addFrame(const uint8_t* rgb);
+
+    /**
+     * @brief パック全体をバイト列として出力
+     */
+    void finish(std::vector<uint8_t>& out) const;
+
+    uint32_t frameCount() const { return static_cast<uint32_t>(index_.size()); }
+    size_t encodedDataSize() const { return data_.size(); }
+
+private:
+    uint16_t ledCount_;
+    uint16_t fps_;
+    uint32_t keyframeInterval_;
+    bool compression_ = true;
+    std::vector<uint8_t> prev_;
+    std::vector<uint8_t> data_;
+    std::vector<FramePackIndexEntry> index_;
+    uint32_t maxFrameSize_ = 0;
+};
+
+} // namespace LEDSphere
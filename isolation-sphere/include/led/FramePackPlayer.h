@@ -0,0 +1,146 @@
+/**
+ * @file FramePackPlayer.h
+ * @brief フレームパック（FramePack.h）のダブルバッファ再生
+ *
+ * 表示中フレーム（front）とは別のバッファ（back）へ次フレームを先読みし、
+ * 表示タイミングで入れ替える。フレーム毎のコストは連続読み出し1回と
+ * RLE/差分の展開のみ。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "led/FramePack.h"
+
+#ifdef ARDUINO
+#include <FS.h>
+#endif
+
+namespace LEDSphere {
+
+class LEDSphereManager;
+class LayerCompositor;
+
+/**
+ * @brief フレームパックプレイヤー
+ */
+class FramePackPlayer {
+public:
+    /**
+     * @brief 読み出し元（LittleFSファイル・メモリ上のパックなど）
+     */
+    struct Source {
+        std::function<bool(uint32_t offset, uint8_t* dst, size_t length)> read;
+        size_t size = 0;
+    };
+
+    struct Stats {
+        uint32_t framesShown = 0;
+        uint32_t lateFrames = 0;     // 表示予定から1フレーム以上遅れた回数
+        uint32_t seeks = 0;          // showFrame()による非連続ジャンプ回数
+        uint32_t readErrors = 0;
+        uint32_t bytesRead = 0;
+    };
+
+    /**
+     * @brief メモリ上のパック（PSRAM展開済み・フラッシュマップ等）を読み出し元にする
+     */
+    static Source makeMemorySource(const uint8_t* data, size_t size);
+
+#ifdef ARDUINO
+    /**
+     * @brief ファイルを開いたまま保持し、オフセット指定で読み出す
+     */
+    static Source makeFileSource(fs::FS& fs, const char* path);
+#endif
+
+    /**
+     * @brief パックを開く（ヘッダ・インデックス表を読み込み、バッファ確保）
+     */
+    bool open(Source source);
+    void close();
+    bool isOpen() const { return open_; }
+
+    void setLoop(bool loop) { loop_ = loop; }
+    bool loop() const { return loop_; }
+
+    /**
+     * @brief 再生フレームレート上書き（0ならパックのfpsを使用）
+     */
+    void setFps(uint16_t fps);
+
+    /**
+     * @brief 再生開始（先頭フレームを先読み）
+     */
+    bool start(uint32_t nowMs);
+
+    /**
+     * @brief 表示タイミングなら先読み済みフレームをfrontに入れ替え、次フレームを先読み
+     * @return 新しいフレームがfrontになった場合true
+     */
+    bool update(uint32_t nowMs);
+
+    /**
+     * @brief 外部タイムベース（SyncTimebase::frameAt）が指定したフレームを表示する
+     * @description 複数球体の同期再生用。update()の自前スケジュールの代わりに使う。
+     *              次フレームなら先読み済みバッファを入れ替え、それ以外（遅延・ドリフト補正）は
+     *              直前のキーフレームから展開してジャンプする。
+     *              ループ時はframeCountで折り返し、非ループ時は最終フレームで止まる。
+     * @return 表示フレームが変わった場合true
+     */
+    bool showFrame(uint32_t frameIndex);
+
+    /**
+     * @brief 次フレームをbackバッファへ読み込み（update内で自動実行）
+     * @return 先読み成功（終端・読み出し失敗時false）
+     */
+    bool prefetch();
+
+    /**
+     * @brief 表示中フレーム（faceID順RGB、ledCount × 3バイト）
+     */
+    const uint8_t* frontFrame() const { return frontFrame_ >= 0 ? buffers_[front_].data() : nullptr; }
+    int32_t currentFrame() const { return frontFrame_; }
+    bool finished() const { return finished_; }
+
+    /**
+     * @brief 表示中フレームをLEDフレームバッファへ反映（show()は呼ばない）
+     */
+    void applyTo(LEDSphereManager& manager) const;
+
+    /**
+     * @brief 表示中フレームを合成レイヤーへ反映（上位のオーバーレイはそのまま重なる）
+     */
+    void applyTo(LayerCompositor& compositor, uint8_t layer) const;
+
+    const FramePackHeader& header() const { return header_; }
+    uint32_t frameCount() const { return header_.frameCount; }
+    uint16_t ledCount() const { return header_.ledCount; }
+    const Stats& stats() const { return stats_; }
+
+private:
+    bool loadFrame(uint32_t frameIndex, uint8_t* dst, const uint8_t* prev);
+    bool seek(uint32_t frameIndex);
+
+    Source source_;
+    FramePackHeader header_{};
+    std::vector<FramePackIndexEntry> index_;
+    std::vector<uint8_t> buffers_[2];
+    std::vector<uint8_t> readBuffer_;
+    uint8_t front_ = 0;
+    int32_t frontFrame_ = -1;   // frontに入っているフレーム番号
+    int32_t backFrame_ = -1;    // backに先読み済みのフレーム番号
+    bool open_ = false;
+    bool loop_ = true;
+    bool started_ = false;
+    bool finished_ = false;
+    uint32_t periodMs_ = 100;
+    uint32_t nextDueMs_ = 0;
+    Stats stats_;
+};
+
+} // namespace LEDSphere
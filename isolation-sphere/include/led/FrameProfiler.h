@@ -0,0 +1,147 @@
+/**
+ * @file FrameProfiler.h
+ * @brief フレーム時間の段階別計測（リングバッファ・パーセンタイル集計）
+ *
+ * LEDSphereManagerのframeStart()/frameEnd()間の処理時間を
+ * transform / sample / composite / show の段階に分けて記録する。
+ * 時刻源は差し替え可能（既定: micros()、ネイティブではsteady_clock）。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "core/MetricsRegistry.h"
+
+namespace LEDSphere {
+
+/**
+ * @brief フレーム内の処理段階
+ */
+enum class FrameStage : uint8_t {
+    kTransform = 0,   // 姿勢→UV変換
+    kSample,          // テクスチャ・画像サンプリング
+    kComposite,       // パターン合成・描画
+    kShow,            // LED送信
+};
+
+constexpr size_t kFrameStageCount = 4;
+
+/**
+ * @brief 時間集計（マイクロ秒）
+ */
+struct TimingSummary {
+    uint32_t minUs = 0;
+    uint32_t avgUs = 0;
+    uint32_t p95Us = 0;
+    uint32_t p99Us = 0;
+    uint32_t maxUs = 0;
+};
+
+/**
+ * @brief フレーム時間計測器
+ */
+class FrameProfiler {
+public:
+    static constexpr size_t kHistorySize = 120;   // 30fpsで約4秒分
+
+    using ClockFn = std::function<uint32_t()>;    // マイクロ秒（32bit折り返し可）
+
+    FrameProfiler();
+
+    /**
+     * @brief 時刻源差し替え（nullptrで既定に戻す）
+     */
+    void setClock(ClockFn clock);
+    uint32_t now() const;
+
+    /**
+     * @brief 目標FPS（ドロップ判定に使用、0で判定しない）
+     * @description 変更時は次のframeStartから間隔を測り直す（切替前の空白をドロップに数えない）
+     */
+    void setTargetFPS(uint8_t fps) {
+        if (fps != targetFPS_) {
+            hasLastFrameStart_ = false;
+        }
+        targetFPS_ = fps;
+    }
+
+    void frameStart();
+    void frameEnd();
+    bool inFrame() const { return inFrame_; }
+
+    /**
+     * @brief 段階計測（フレーム外の呼び出しは無視）
+     */
+    void beginStage(FrameStage stage);
+    void endStage(FrameStage stage);
+
+    /**
+     * @brief 計測値をMetricsRegistryへも流す（テレメトリ送信用）
+     *
+     * frame_us / xform_us / sample_us / comp_us / show_us のヒストグラムと
+     * frames（毎秒レート付き）/ frame_drops カウンタを登録し、frameEnd()毎に記録する。
+     */
+    void attachMetrics(MetricsRegistry &registry);
+
+    /**
+     * @brief 計測履歴・カウンタをリセット
+     */
+    void reset();
+
+    uint32_t frameCount() const { return frameCount_; }
+    uint32_t droppedFrames() const { return droppedFrames_; }
+    size_t sampleCount() const { return count_; }
+
+    /**
+     * @brief 履歴内のフレーム開始間隔から算出したFPS
+     */
+    float currentFPS() const;
+
+    /**
+     * @brief フレーム全体（frameStart〜frameEnd）の集計
+     */
+    TimingSummary frameSummary() const;
+
+    /**
+     * @brief 段階別の集計
+     */
+    TimingSummary stageSummary(FrameStage stage) const;
+
+private:
+    struct FrameSample {
+        uint32_t totalUs;
+        uint32_t intervalUs;   // 直前フレーム開始からの間隔（初回は0）
+        uint32_t stageUs[kFrameStageCount];
+    };
+
+    template <typename Getter>
+    TimingSummary summarize(Getter getter) const;
+
+    ClockFn clock_;
+    uint8_t targetFPS_ = 30;
+
+    FrameSample history_[kHistorySize];
+    size_t head_ = 0;
+    size_t count_ = 0;
+
+    FrameSample current_;
+    uint32_t frameStartUs_ = 0;
+    uint32_t lastFrameStartUs_ = 0;
+    bool hasLastFrameStart_ = false;
+    uint32_t stageStartUs_[kFrameStageCount] = {};
+    bool inFrame_ = false;
+
+    uint32_t frameCount_ = 0;
+    uint32_t droppedFrames_ = 0;
+
+    // attachMetrics()未呼び出し（または登録失敗）ならnullptr
+    MetricsRegistry::Histogram *frameMetric_ = nullptr;
+    MetricsRegistry::Histogram *stageMetrics_[kFrameStageCount] = {};
+    MetricsRegistry::Counter *framesMetric_ = nullptr;
+    MetricsRegistry::Counter *droppedMetric_ = nullptr;
+};
+
+} // namespace LEDSphere
@@ -0,0 +1,140 @@
+/**
+ * @file JpegLedDecoder.h
+ * @brief JPEGをLEDフレームバッファへ直接展開するストリーミングデコーダ
+ *
+ * 正距円筒JPEGをパノラマバッファに展開せず、TJpg_Decoderが出力する
+ * MCUブロックからLEDが参照するテクセルだけを拾ってバイリニア合成する。
+ * - LEDが参照しない行帯のブロックはRGB888展開・合成を行わずスキップ
+ *   （YCbCr→RGB565変換はTJpg_Decoder内で全MCUに対して行われる）
+ * - 最後に参照される行を過ぎた時点でデコードを打ち切り
+ * - 画像高さに余裕があればJPEG側の1/2〜1/8縮小デコードを使用
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "led/LEDSphereManager.h"
+
+namespace LEDSphere {
+
+/**
+ * @brief LED参照テクセル駆動のJPEGストリーミングデコーダ
+ */
+class JpegLedDecoder {
+public:
+    /**
+     * @brief デコード統計（直近1フレーム）
+     */
+    struct Stats {
+        uint32_t blocksConsumed = 0;     // RGB888展開・合成を行ったブロック数
+        uint32_t blocksSkipped = 0;      // 参照テクセルが無くスキップしたブロック数
+        uint32_t texelsSampled = 0;      // 合成したテクセル（タップ）数
+        bool terminatedEarly = false;    // 最終参照行以降を打ち切ったか
+        uint8_t scale = 1;               // 使用したJPEG縮小率
+        uint32_t decodeTimeUs = 0;
+    };
+
+    explicit JpegLedDecoder(LEDSphereManager& manager);
+    ~JpegLedDecoder();
+
+    JpegLedDecoder(const JpegLedDecoder&) = delete;
+    JpegLedDecoder& operator=(const JpegLedDecoder&) = delete;
+
+    /**
+     * @brief 縮小デコード時に確保する最小の出力高さ（既定160 = 320x160相当）
+     */
+    void setMinDecodedHeight(uint16_t height) { minDecodedHeight_ = height > 0 ? height : 1; }
+    uint16_t minDecodedHeight() const { return minDecodedHeight_; }
+
+#ifdef ARDUINO
+    /**
+     * @brief メモリ上のJPEGをデコードしてLEDへ反映（show()は呼ばない）
+     * @return デコード成功フラグ
+     */
+    bool decode(const uint8_t* jpeg, size_t size);
+
+    /**
+     * @brief LittleFS上のJPEGをデコードしてLEDへ反映（show()は呼ばない）
+     */
+    bool decodeFile(const char* path);
+#endif
+
+    // ========== ストリーミング処理本体（TJpgDecコールバックから使用、単体テスト可）==========
+
+    /**
+     * @brief 出力解像度に対するサンプリング計画を準備（姿勢・解像度変更時のみ再構築）
+     * @param decodedWidth,decodedHeight デコード後の画像サイズ
+     * @return 計画が有効か
+     */
+    bool preparePlan(uint16_t decodedWidth, uint16_t decodedHeight);
+
+    /**
+     * @brief フレーム開始（累積バッファと統計をリセット）
+     */
+    void beginFrame();
+
+    /**
+     * @brief デコード済みブロックを取り込み
+     * @param x,y,w,h ブロック矩形（デコード後の座標系）
+     * @param rgb565 ブロック画素（行優先、RGB565）
+     * @return デコード継続ならtrue（最終参照行を過ぎたらfalse）
+     */
+    bool consumeBlock(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* rgb565);
+
+    /**
+     * @brief フレーム終了（累積結果をLEDフレームバッファへ書き込み）
+     */
+    void finishFrame();
+
+    /**
+     * @brief 元画像高さと最小出力高さからJPEG縮小率（1/2/4/8）を選択
+     */
+    static uint8_t selectScale(uint16_t imageHeight, uint16_t minDecodedHeight);
+
+    const Stats& stats() const { return stats_; }
+    uint32_t planBuildCount() const { return planBuildCount_; }
+    uint16_t lastReferencedRow() const { return lastRow_; }
+
+private:
+    /**
+     * @brief 1テクセル分の参照（行ごとにx昇順で並べる）
+     */
+    struct TexelRef {
+        uint16_t x;
+        uint16_t led;        // レイアウト順のLED番号
+        uint32_t weight;     // バイリニアウェイト（Q16、合計65536）
+    };
+
+    void addRef(std::vector<std::vector<TexelRef>>& rows, uint16_t x, uint16_t y, uint16_t led, uint32_t weight);
+
+#ifdef ARDUINO
+    bool runDecode(bool fromFile, const uint8_t* jpeg, size_t size, const char* path);
+    static bool tjpgOutputCallback(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap);
+    static JpegLedDecoder* activeDecoder_;
+#endif
+
+    LEDSphereManager& manager_;
+    uint16_t minDecodedHeight_ = 160;
+
+    // サンプリング計画（CSR形式: rowStart_[y]..rowStart_[y+1] が行yの参照）
+    std::vector<TexelRef> refs_;
+    std::vector<uint32_t> rowStart_;
+    std::vector<TexelTap> taps_;
+    uint16_t planWidth_ = 0;
+    uint16_t planHeight_ = 0;
+    uint32_t planGeneration_ = 0;
+    size_t planLedCount_ = 0;
+    bool planValid_ = false;
+    uint16_t lastRow_ = 0;
+    uint32_t planBuildCount_ = 0;
+
+    // LEDごとのRGB累積（Q16ウェイト × 8bit）
+    std::vector<uint32_t> accum_;
+
+    Stats stats_;
+};
+
+} // namespace LEDSphere
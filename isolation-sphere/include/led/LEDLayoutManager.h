@@ -11,6 +11,7 @@
 #include <vector>
 #include <map>
 #include "led/LEDSphereManager.h"
+#include "led/SphereIndex.h"
 
 namespace LEDSphere {
 
@@ -24,24 +25,8 @@ private:
     std::vector<LEDPosition> positions_;        // 全LED位置データ
     std::map<uint16_t, size_t> faceIdToIndex_; // FaceID→インデックス高速マップ
     
-    // 検索最適化用空間分割データ
-    struct SpatialGrid {
-        static constexpr int GRID_SIZE = 32;    // 32×32グリッド
-        std::vector<std::vector<uint16_t>> grid_; // グリッド→LED IDリスト
-        
-        SpatialGrid() : grid_(GRID_SIZE * GRID_SIZE) {}
-        
-        int getGridIndex(float u, float v) const {
-            int gu = static_cast<int>(u * GRID_SIZE);
-            int gv = static_cast<int>(v * GRID_SIZE);
-            gu = constrain(gu, 0, GRID_SIZE - 1);
-            gv = constrain(gv, 0, GRID_SIZE - 1);
-            return gv * GRID_SIZE + gu;
-        }
-    };
-    
-    mutable SpatialGrid spatialGrid_;
-    mutable bool spatialGridBuilt_;
+    // 近傍・範囲検索用の球面k-d木（UVグリッドは極付近で歪むため不使用）
+    SphereIndex sphereIndex_;
     
 public:
     LEDLayoutManager();
@@ -146,9 +131,9 @@ public:
 
 private:
     /**
-     * @brief 空間分割グリッド構築（検索高速化）
+     * @brief 球面インデックス構築（読み込み完了時に1回）
      */
-    void buildSpatialGrid() const;
+    void buildSphereIndex();
     
     /**
      * @brief CSV行解析
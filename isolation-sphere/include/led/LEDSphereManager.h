@@ -14,6 +14,10 @@
 #include <map>
 #include <string>
 
+#include "led/FrameProfiler.h"
+#include "led/LatLonIndex.h"
+#include "led/SphereIndex.h"
+
 #if defined(UNIT_TEST) && !defined(USE_FASTLED)
 struct CRGB {
     uint8_t r;
@@ -28,6 +32,23 @@ struct CRGB {
         if (g > amount) g -= amount; else g = 0;
         if (b > amount) b -= amount; else b = 0;
     }
+
+    // ネイティブテスト用の簡易HSV→RGB変換（FastLED同様に色相は0-255）
+    void setHSV(uint8_t hue, uint8_t sat, uint8_t val) {
+        uint8_t region = hue / 43;
+        uint8_t remainder = static_cast<uint8_t>((hue - region * 43) * 6);
+        uint8_t p = static_cast<uint8_t>((val * (255 - sat)) >> 8);
+        uint8_t q = static_cast<uint8_t>((val * (255 - ((sat * remainder) >> 8))) >> 8);
+        uint8_t t = static_cast<uint8_t>((val * (255 - ((sat * (255 - remainder)) >> 8))) >> 8);
+        switch (region) {
+            case 0:  r = val; g = t;   b = p;   break;
+            case 1:  r = q;   g = val; b = p;   break;
+            case 2:  r = p;   g = val; b = t;   break;
+            case 3:  r = p;   g = q;   b = val; break;
+            case 4:  r = t;   g = p;   b = val; break;
+            default: r = val; g = p;   b = q;   break;
+        }
+    }
 };
 #else
 #include <Arduino.h>
@@ -50,11 +71,21 @@ struct LEDPosition {
         : faceID(id), strip(s), strip_num(sn), x(px), y(py), z(pz) {}
 };
 
+/**
+ * @brief フィールド評価用のLED幾何情報（レイアウト読込時に1度だけ算出）
+ */
+struct LedGeom {
+    uint16_t faceID;        // フレームバッファ上の添字
+    float x, y, z;          // 3D正規化座標（姿勢回転前）
+    float latitudeDeg;      // 緯度（度）[-90, 90]
+    float longitudeDeg;     // 経度（度）[-180, 180]
+};
+
 /**
  * @brief UV座標（球面座標系）
  */
 struct UVCoordinate {
-    float u, v;             // UV座標 [0.0, 1.0]
+    float u, v;             // UV座標（定義は生成元を参照: transformToUV はラジアン、toLatLonUV は [0.0, 1.0]）
     bool valid;             // 有効性フラグ
     
     UVCoordinate() : u(0), v(0), valid(false) {}
@@ -77,16 +108,59 @@ struct PostureParams {
  */
 struct PerformanceStats {
     float currentFPS;
-    float averageRenderTime;
+    float averageRenderTime;    // ミリ秒（frameStart〜frameEnd平均）
     uint32_t frameCount;
     uint16_t activeLEDCount;
     size_t memoryUsage;
+    uint32_t droppedFrames;     // 目標FPSに対して表示できなかったフレーム数
+    uint8_t targetFPS;
+    TimingSummary frameTime;                        // フレーム全体
+    TimingSummary stageTime[kFrameStageCount];      // FrameStage順
     
     PerformanceStats() : currentFPS(0), averageRenderTime(0), frameCount(0), 
-                        activeLEDCount(0), memoryUsage(0) {}
+                        activeLEDCount(0), memoryUsage(0), droppedFrames(0), targetFPS(0) {}
+};
+
+/**
+ * @brief UV座標キャッシュ統計（姿勢差分による再利用状況）
+ */
+struct UVCacheStats {
+    uint32_t hits;          // 変化なし：前フレームのUVを再利用
+    uint32_t shifts;        // 経度オフセットのみ変化：v配列を定数シフト
+    uint32_t rebuilds;      // 姿勢変化：全LEDを再計算
+
+    UVCacheStats() : hits(0), shifts(0), rebuilds(0) {}
+};
+
+/**
+ * @brief パノラマテクスチャのサンプリング方式
+ */
+enum class TextureFilter : uint8_t {
+    kNearest,
+    kBilinear,
+    kMipmap,    // LEDの角度フットプリントでレベル選択 + バイリニア
+};
+
+/**
+ * @brief LED→テクセル参照テーブルの1エントリ（4タップ + Q8補間ウェイト）
+ * 最近傍の場合は4タップ全て同じオフセット、ウェイトは0
+ */
+struct TexelTap {
+    uint32_t offset00;      // (x0,y0) のバイトオフセット（レベル先頭基準）
+    uint32_t offset10;      // (x1,y0)
+    uint32_t offset01;      // (x0,y1)
+    uint32_t offset11;      // (x1,y1)
+    uint16_t x0, y0;        // 参照レベルでのテクセル座標
+    uint8_t fx, fy;         // Q8補間ウェイト
+    uint8_t level;          // ミップレベル
+    uint8_t reserved;
+
+    TexelTap() : offset00(0), offset10(0), offset01(0), offset11(0), x0(0), y0(0),
+                 fx(0), fy(0), level(0), reserved(0) {}
 };
 
 // 前方宣言
+class PanoramaTexture;
 class LEDLayoutManager;
 class SphereCoordinateTransform; 
 class FastLEDController;
@@ -125,11 +199,53 @@ private:
     std::vector<LEDPosition> layoutPositions_;
     std::vector<float> latitudeCacheDeg_;
     std::vector<float> longitudeCacheDeg_;
+    std::vector<LedGeom> ledGeometry_;
+    LatLonIndex latLonIndex_;           // 緯度線・経度線描画用の整列インデックス
+    SphereIndex sphereIndex_;           // 近傍・範囲検索用の球面k-d木
+    std::vector<uint16_t> rangeScratch_;  // setLEDByUVの検索結果（フレーム毎の確保回避）
     bool layoutLoaded_ = false;
 
+    // 画像描画パイプライン用SoA配置（x[], y[], z[] を連続floatで保持）
+    std::vector<float> layoutX_;
+    std::vector<float> layoutY_;
+    std::vector<float> layoutZ_;
+    std::vector<float> rotatedX_;
+    std::vector<float> rotatedY_;
+    std::vector<float> rotatedZ_;
+    std::vector<float> uvU_;     // 回転後UV（CUBE-neon形式: 緯度成分）
+    std::vector<float> uvV_;     // 回転後UV（CUBE-neon形式: 経度成分）
+    bool imageDebugLogging_ = false;
+
+    // UV座標キャッシュ（姿勢差分が閾値未満なら前フレームのUVを再利用）
+    bool uvCacheValid_ = false;
+    PostureParams uvCachePosture_;      // UV計算に使用した姿勢
+    float uvCacheEpsilonDeg_ = 0.25f;   // 再計算を行う最小回転角（度）
+    float uvCacheCosHalfEpsilon_ = 0.0f;
+    UVCacheStats uvCacheStats_;
+
+    // 画像テクスチャ（非所有）とLED毎のフットプリント
+    const PanoramaTexture* panoramaTexture_ = nullptr;
+    TextureFilter textureFilter_ = TextureFilter::kMipmap;
+    std::vector<float> footprintRad_;   // 最近傍LEDとの角距離（ラジアン）
+    std::vector<uint8_t> mipLevel_;     // footprintRad_から選択したミップレベル
+    uint32_t mipLevelKey_ = 0;          // mipLevel_計算時のテクスチャ高さ・レベル数
+
+    // LED→テクセル参照テーブル（姿勢・テクスチャ形状が不変な間はギャザーのみで描画）
+    bool texelLookupEnabled_ = true;
+    std::vector<TexelTap> texelLookup_;
+    uint32_t uvGeneration_ = 0;         // UV配列が変化するたびに加算
+    uint32_t texelLookupGeneration_ = 0;
+    uint64_t texelLookupKey_ = 0;       // 0 = 未構築
+    uint32_t texelLookupBakeCount_ = 0;
+    uint32_t texelTapComputeCount_ = 0;
+
     float axisMarkerThresholdDeg_ = 10.0f;
     uint8_t axisMarkerMaxCount_ = 5;
 
+    // パフォーマンス計測
+    FrameProfiler profiler_;
+    uint16_t activeLEDCount_ = 0;       // 非黒LED数（フレームバッファ書き込み時に増減）
+
 public:
     LEDSphereManager();
     ~LEDSphereManager();
@@ -161,7 +277,7 @@ public:
      * @brief 目標FPS設定
      * @param fps 目標フレームレート
      */
-    void setTargetFPS(uint8_t fps) { targetFPS_ = fps; }
+    void setTargetFPS(uint8_t fps) { targetFPS_ = fps; profiler_.setTargetFPS(fps); }
     
     // ========== 姿勢・座標制御 ==========
     
@@ -192,12 +308,29 @@ public:
      * @param color RGB色
      */
     void setLED(uint16_t faceID, CRGB color);
+
+    /**
+     * @brief faceID順RGB列による一括設定（事前変換済みフレーム再生用）
+     * @param rgb RGB888（count × 3バイト）
+     * @param count LED数（総LED数を超えた分は無視）
+     */
+    void setAllLEDsRGB(const uint8_t* rgb, size_t count);
+
+    /**
+     * @brief faceID順CRGB列による一括設定（LayerCompositorの合成結果出力用）
+     * @param colors CRGB列（count個）
+     * @param count LED数（総LED数を超えた分は無視）
+     */
+    void setAllLEDs(const CRGB* colors, size_t count);
     
     /**
      * @brief UV座標によるLED設定
-     * @param u,v UV座標 [0.0-1.0]
+     * @param u,v UV座標 [0.0-1.0]（u: 経度 -180→180度、v: 緯度 -90→90度）
+     *            transformToUV() の戻り値（極角・方位角のラジアン）とは定義が異なるため、
+     *            そちらを渡す場合は toLatLonUV() で変換する
      * @param color RGB色
-     * @param radius 影響半径（近傍LEDも点灯）
+     * @param radius 影響半径（v方向の長さ単位、1.0 = 180度の中心角）。
+     *               範囲内にLEDが無ければ最寄りの1個を点灯
      */
     void setLEDByUV(float u, float v, CRGB color, float radius = 0.02f);
     
@@ -262,6 +395,29 @@ public:
     float axisMarkerThresholdDegrees() const { return axisMarkerThresholdDeg_; }
     uint8_t axisMarkerMaxCount() const { return axisMarkerMaxCount_; }
     
+    /**
+     * @brief フィールド評価による全LED描画
+     * @description レイアウト上の各LEDについて eval(const LedGeom&) -> CRGB を1回だけ呼び、
+     *              結果をそのまま書き込む（事前のclearAllLEDsは不要）。
+     *              線・リングを重ねる描画と違い、プリミティブ数によらずO(LED数)
+     */
+    template <typename EvalFn>
+    void fillByGeometry(EvalFn&& eval) {
+        if (!frameBuffer_) return;
+        if (ledGeometry_.size() < totalLeds_) {
+            // レイアウト外のLEDは評価されないので消灯しておく
+            clearAllLEDs();
+        }
+#ifdef UNIT_TEST
+        operationLog_.push_back("field");
+#endif
+        for (const LedGeom& led : ledGeometry_) {
+            if (led.faceID < totalLeds_) {
+                writeLED(led.faceID, eval(led));
+            }
+        }
+    }
+
     /**
      * @brief スパースパターン描画（高速）
      * @param points LED ID→色のマップ
@@ -271,26 +427,39 @@ public:
     // ========== 検索・クエリ機能 ==========
     
     /**
-     * @brief 最寄りLED検索（UV座標）
-     * @param u,v UV座標
+     * @brief 最寄りLED検索（UV座標、測地距離）
+     * @param u,v UV座標（setLEDByUVと同じ定義。transformToUV() の結果は toLatLonUV() で変換して渡す）
      * @return LED ID（見つからない場合は LED_COUNT）
      */
     uint16_t findClosestLED(float u, float v) const;
     
     /**
-     * @brief 範囲内LED検索
+     * @brief 範囲内LED検索（測地距離）
      * @param u,v 中心UV座標
-     * @param radius 検索半径
+     * @param radius 検索半径（1.0 = 180度の中心角）
      * @return LED IDリスト
      */
     std::vector<uint16_t> findLEDsInRange(float u, float v, float radius) const;
+
+    /**
+     * @brief 近傍・範囲検索インデックス（方向ベクトル・緯度経度での直接検索用）
+     * @description nearestK/within は出力vectorを再利用できるため、
+     *              1フレームに多数の問い合わせを行う場合はこちらを使う
+     */
+    const SphereIndex& sphereIndex() const { return sphereIndex_; }
     
     /**
-     * @brief 3D座標→UV座標変換
+     * @brief 3D座標→UV座標変換（IMU姿勢を適用）
      * @param x,y,z 3D座標
-     * @return UV座標
+     * @return u: +Y軸からの極角 [0, π]、v: 方位角 atan2(x, z) [-π, π]（ラジアン、画像パイプラインと同じ定義）。
+     *         setLEDByUV / findClosestLED / findLEDsInRange の正規化UV（経度・緯度 0..1）とは異なる
      */
     UVCoordinate transformToUV(float x, float y, float z) const;
+
+    /**
+     * @brief transformToUV() のUV（極角・方位角）を検索用の正規化UV（経度・緯度 0..1）へ変換
+     */
+    static UVCoordinate toLatLonUV(const UVCoordinate& polarAzimuth);
     
     /**
      * @brief LED位置情報取得
@@ -310,6 +479,27 @@ public:
      * @brief フレーム終了（性能測定用）
      */
     void frameEnd();
+
+    /**
+     * @brief 段階計測（transform/sample/showは内部で計測済み、compositeは呼び出し側で囲む）
+     */
+    void beginStage(FrameStage stage) { profiler_.beginStage(stage); }
+    void endStage(FrameStage stage) { profiler_.endStage(stage); }
+
+    /**
+     * @brief 計測用時刻源の差し替え（マイクロ秒、nullptrで既定）
+     */
+    void setPerformanceClock(FrameProfiler::ClockFn clock) { profiler_.setClock(std::move(clock)); }
+
+    /**
+     * @brief フレーム・段階時間をテレメトリ（MetricsRegistry）へ流す
+     */
+    void attachMetrics(MetricsRegistry &registry) { profiler_.attachMetrics(registry); }
+
+    /**
+     * @brief 計測履歴リセット
+     */
+    void resetPerformanceStats() { profiler_.reset(); }
     
     /**
      * @brief パフォーマンス統計取得
@@ -328,6 +518,11 @@ public:
      * @return 点灯LED数
      */
     uint16_t getActiveLEDCount() const;
+
+    /**
+     * @brief フレームバッファのLED数（initializeLedHardware前は0）
+     */
+    size_t ledCount() const { return totalLeds_; }
     
     // ========== デバッグ・ユーティリティ ==========
     
@@ -357,13 +552,107 @@ public:
     
     /**
      * @brief UV座標から画像色抽出
-     * @param u,v UV座標（CUBE-neon形式）
+     * テクスチャ設定時はバイリニアサンプリング、未設定時はHSVのプロシージャル色
+     * @param u,v UV座標（CUBE-neon形式: u=極角[0,π], v=経度[-π,π]）
      * @return RGB色
      */
     CRGB extractColorFromImageUV(float u, float v) const;
 
+    /**
+     * @brief 画像描画に使用するパノラマテクスチャ設定（所有権は移らない）
+     * ミップチェーンを再構築した場合もレベル選択は次フレームで自動更新される
+     * @param texture テクスチャ（nullptrで解除）
+     * @param filter サンプリング方式
+     */
+    void setPanoramaTexture(const PanoramaTexture* texture, TextureFilter filter = TextureFilter::kMipmap);
+    const PanoramaTexture* panoramaTexture() const { return panoramaTexture_; }
+
+    /**
+     * @brief LED→テクセル参照テーブルの使用切替
+     * 有効時、UV（姿勢）とテクスチャの解像度・ミップ構成・フィルタが前フレームと同じなら
+     * 焼き込み済みテーブルからのギャザーのみで描画する（画像内容の更新は再焼き込み不要）
+     */
+    void setTexelLookupEnabled(bool enabled) { texelLookupEnabled_ = enabled; }
+    bool texelLookupEnabled() const { return texelLookupEnabled_; }
+
+    /**
+     * @brief 現在の参照テーブル（未構築なら空）
+     */
+    const std::vector<TexelTap>& texelLookup() const { return texelLookup_; }
+
+    /**
+     * @brief 参照テーブルの焼き込み回数（統計用）
+     */
+    uint32_t texelLookupBakeCount() const { return texelLookupBakeCount_; }
+
+    /**
+     * @brief 実体化しない画像（ストリーミングデコード等）に対するバイリニアタップ算出
+     * 現在の姿勢でUVを更新した上で、レイアウト順に1LED1タップを出力する
+     * @param width,height 画像サイズ
+     * @param out 出力（レイアウトLED数に合わせてリサイズ）
+     */
+    void computeTexelTaps(uint16_t width, uint16_t height, std::vector<TexelTap>& out);
+
+    /**
+     * @brief computeTexelTaps() の実行回数（統計用）
+     */
+    uint32_t texelTapComputeCount() const { return texelTapComputeCount_; }
+
+    /**
+     * @brief UV配列の世代番号（姿勢変化でUVが更新されるたびに加算）
+     */
+    uint32_t uvGeneration() const { return uvGeneration_; }
+
+    /**
+     * @brief 現在の姿勢でUVを更新（回転が閾値未満なら再利用）
+     * @return 更新後のUV世代番号（保持中の画像を描き直すかの判定用）
+     */
+    uint32_t refreshUV() { updateUVCacheIfNeeded(); return uvGeneration_; }
+
+    /**
+     * @brief 読み込み済みLEDレイアウト
+     */
+    const std::vector<LEDPosition>& layoutPositions() const { return layoutPositions_; }
+
+    /**
+     * @brief レイアウト順のLED幾何情報（緯度・経度算出済み）
+     */
+    const std::vector<LedGeom>& ledGeometry() const { return ledGeometry_; }
+
+    /**
+     * @brief 緯度・経度の整列インデックス（帯状のLED検索用）
+     */
+    const LatLonIndex& latLonIndex() const { return latLonIndex_; }
+
+    /**
+     * @brief 画像描画のフレーム毎デバッグ出力（LED[0]の変換過程）切替
+     * @param enabled true:出力する（既定はfalse）
+     */
+    void setImageDebugLogging(bool enabled) { imageDebugLogging_ = enabled; }
+
+    /**
+     * @brief UVキャッシュの角度閾値設定
+     * @param degrees この角度未満の姿勢変化ではUVを再計算しない（度）
+     */
+    void setUVCacheEpsilonDegrees(float degrees);
+    float uvCacheEpsilonDegrees() const { return uvCacheEpsilonDeg_; }
+
+    /**
+     * @brief UVキャッシュ無効化（次フレームで全LED再計算）
+     */
+    void invalidateUVCache() { uvCacheValid_ = false; }
+
+    /**
+     * @brief UVキャッシュ統計取得
+     */
+    const UVCacheStats& getUVCacheStats() const { return uvCacheStats_; }
+
 #ifdef UNIT_TEST
 public:
+    void setLayoutForTest(const std::vector<LEDPosition>& positions);
+    const std::vector<float>& uvUForTest() const { return uvU_; }
+    const std::vector<float>& uvVForTest() const { return uvV_; }
+    const std::vector<float>& footprintRadForTest() const { return footprintRad_; }
     CRGB* frameBufferForTest() const { return frameBuffer_; }
     size_t totalLedsForTest() const { return totalLeds_; }
     void resetShowFlagForTest() { showCalledForTest_ = false; }
@@ -377,17 +666,37 @@ private:
     void buildLayoutCaches();
     static float computeLatitudeDeg(float x, float y, float z);
     static float computeLongitudeDeg(float x, float y, float z);
-    static float wrappedLongitudeDifference(float aDeg, float bDeg);
+    static void uvToDirection(float u, float v, float& x, float& y, float& z);
 
     // 内部初期化メソッド
+    /**
+     * @brief フレームバッファ書き込み（点灯LED数を差分更新）
+     */
+    void writeLED(size_t index, const CRGB& color) {
+        CRGB& slot = frameBuffer_[index];
+        const int wasLit = (slot.r | slot.g | slot.b) != 0;
+        const int lit = (color.r | color.g | color.b) != 0;
+        activeLEDCount_ = static_cast<uint16_t>(activeLEDCount_ + lit - wasLit);
+        slot = color;
+    }
+
     bool initializeFastLED();
     bool initializeComponents();
     
     // 姿勢変化検出
     bool hasPostureChanged(const PostureParams& params) const;
     
-    // UV座標更新制御
+    // UV座標更新制御（再利用・経度シフト・全再計算を選択）
     void updateUVCacheIfNeeded();
+    void shiftLongitudeUV(float deltaRad);
+
+    // LED毎の角度フットプリント算出とミップレベル更新
+    void buildFootprintCache();
+    void refreshMipLevelsIfNeeded();
+
+    // LED→テクセル参照テーブルの再焼き込み判定と実行
+    uint64_t currentTexelLookupKey() const;
+    void refreshTexelLookupIfNeeded();
     
     // ========== CUBE-neon実績実装: 座標変換ヘルパー ==========
     
@@ -398,6 +707,19 @@ private:
      */
     void applyQuaternionRotation(float x, float y, float z, 
                                 float& out_x, float& out_y, float& out_z) const;
+
+    /**
+     * @brief 姿勢から3x3回転行列を生成（正規化は1回のみ）
+     * @param posture 姿勢パラメータ
+     * @param m 出力行列（行優先）
+     */
+    static void buildRotationMatrix(const PostureParams& posture, float (&m)[9]);
+
+    /**
+     * @brief 全LEDの回転・UV変換をSoA配列上で一括実行
+     * 回転パスは分岐なしでベクトル化可能、UVパスはfast_math近似を使用
+     */
+    void transformLayoutToUV();
 };
 
 /**
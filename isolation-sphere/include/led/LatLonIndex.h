@@ -0,0 +1,93 @@
+/**
+ * @file LatLonIndex.h
+ * @brief 緯度・経度の整列インデックス（帯状クエリ用）
+ *
+ * レイアウト読込時に緯度順・経度順のLED配列を1度だけ作り、
+ * 「緯度 ±tolerance」「経度 ±tolerance」の問い合わせを
+ * 二分探索 + 連続区間の走査で答える（全LED走査・LED毎のfmodfが不要）。
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LEDSphere {
+
+class LatLonIndex {
+public:
+    /**
+     * @brief インデックス構築
+     * @param latitudeDeg 緯度（度）[-90, 90]
+     * @param longitudeDeg 経度（度）[-180, 180]
+     * @param ids 各要素のLED ID
+     * @param count 要素数
+     */
+    void build(const float* latitudeDeg, const float* longitudeDeg, const uint16_t* ids, size_t count);
+    void clear();
+
+    size_t size() const { return latIds_.size(); }
+    bool empty() const { return latIds_.empty(); }
+
+    /**
+     * @brief |緯度 - latitude| <= tolerance のLED IDを緯度順に列挙
+     */
+    template <typename Fn>
+    void forEachInLatitudeBand(float latitude, float tolerance, Fn&& fn) const {
+        forEachInRange(latKeys_, latIds_, latitude - tolerance, latitude + tolerance, fn);
+    }
+
+    /**
+     * @brief 経度差（±180度で折り返し）が tolerance 以下のLED IDを列挙
+     * @description 日付変更線をまたぐ帯は2区間に分けて走査する
+     */
+    template <typename Fn>
+    void forEachInLongitudeBand(float longitude, float tolerance, Fn&& fn) const {
+        if (tolerance >= 180.0f) {
+            forEachInRange(lonKeys_, lonIds_, -kHalfTurn, kHalfTurn, fn);
+            return;
+        }
+        const float center = normalizeLongitude(longitude);
+        const float lo = center - tolerance;
+        const float hi = center + tolerance;
+        if (lo < -kHalfTurn) {
+            forEachInRange(lonKeys_, lonIds_, lo + 2.0f * kHalfTurn, kHalfTurn, fn);
+            forEachInRange(lonKeys_, lonIds_, -kHalfTurn, hi, fn);
+        } else if (hi > kHalfTurn) {
+            forEachInRange(lonKeys_, lonIds_, lo, kHalfTurn, fn);
+            forEachInRange(lonKeys_, lonIds_, -kHalfTurn, hi - 2.0f * kHalfTurn, fn);
+        } else {
+            forEachInRange(lonKeys_, lonIds_, lo, hi, fn);
+        }
+    }
+
+    std::vector<uint16_t> latitudeBand(float latitude, float tolerance) const;
+    std::vector<uint16_t> longitudeBand(float longitude, float tolerance) const;
+
+    /**
+     * @brief 経度を [-180, 180) に正規化
+     */
+    static float normalizeLongitude(float longitude);
+
+private:
+    static constexpr float kHalfTurn = 180.0f;
+
+    template <typename Fn>
+    static void forEachInRange(const std::vector<float>& keys, const std::vector<uint16_t>& ids,
+                               float lo, float hi, Fn& fn) {
+        size_t i = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), lo) - keys.begin());
+        for (; i < keys.size() && keys[i] <= hi; ++i) {
+            fn(ids[i]);
+        }
+    }
+
+    // 同じ添字のkey/idが対応（キー昇順）
+    std::vector<float> latKeys_;
+    std::vector<uint16_t> latIds_;
+    std::vector<float> lonKeys_;
+    std::vector<uint16_t> lonIds_;
+};
+
+} // namespace LEDSphere
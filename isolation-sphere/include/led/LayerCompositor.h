@@ -0,0 +1,125 @@
+/**
+ * @file LayerCompositor.h
+ * @brief 複数レイヤー（動画・プロシージャル・UIオーバーレイ）の合成
+ *
+ * 各レイヤーはLED毎の色とアルファを持ち、下から順にブレンドモードで重ねる。
+ * レイヤー毎に合成途中結果を保持するため、変更の無い下位レイヤーは再ブレンドしない
+ * （動画の上でUIマーカーだけが変わるフレームは、動画レイヤーの結果を再利用する）。
+ * 最終結果はpresent()でLEDフレームバッファへ1回だけ書き込む。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "led/LEDSphereManager.h"
+
+namespace LEDSphere {
+
+/**
+ * @brief ブレンドモード（dst: 下位レイヤーの合成結果、src: このレイヤー）
+ */
+enum class BlendMode : uint8_t {
+    kAlphaOver,     // dst + (src - dst) × α
+    kAdd,           // dst + src × α（255で飽和）
+    kScreen,        // 1 - (1 - dst)(1 - src) を α で混合
+    kMultiply       // dst × src を α で混合
+};
+
+class LayerCompositor {
+public:
+    using LayerId = uint8_t;
+    static constexpr LayerId kInvalidLayer = 0xFF;
+    static constexpr size_t kMaxLayers = 8;
+
+    /**
+     * @brief レイヤーの格納方式
+     * @description kDense: 全LEDをブレンド（動画・全面パターン向け）
+     *              kSparse: 書き込まれたLEDのみをブレンド（マーカー・UI向け）
+     */
+    enum class Storage : uint8_t { kDense, kSparse };
+
+    struct Stats {
+        uint32_t composes = 0;        // 合成を実行した回数
+        uint32_t layersBlended = 0;   // 再ブレンドしたレイヤー数（累計）
+        uint32_t layersReused = 0;    // 途中結果を再利用したレイヤー数（累計）
+    };
+
+    explicit LayerCompositor(size_t ledCount = LEDSphereManager::LED_COUNT);
+
+    /**
+     * @brief レイヤー追加（追加順に下から重なる）
+     * @return レイヤーID（上限超過時 kInvalidLayer）
+     */
+    LayerId addLayer(Storage storage, BlendMode mode = BlendMode::kAlphaOver, uint8_t opacity = 255);
+    size_t layerCount() const { return layers_.size(); }
+    size_t ledCount() const { return ledCount_; }
+
+    // ========== レイヤー内容（いずれも対象レイヤーをdirtyにする）==========
+
+    /**
+     * @brief LED1個の色とアルファを設定（alpha 0 で透明）
+     */
+    void setPixel(LayerId layer, uint16_t index, const CRGB& color, uint8_t alpha = 255);
+
+    /**
+     * @brief faceID順RGB列で不透明に一括設定（動画フレーム用）
+     */
+    void setRGB(LayerId layer, const uint8_t* rgb, size_t count);
+
+    /**
+     * @brief レイヤーを全透明に戻す
+     */
+    void clearLayer(LayerId layer);
+
+    // ========== レイヤー属性 ==========
+
+    void setBlendMode(LayerId layer, BlendMode mode);
+    void setOpacity(LayerId layer, uint8_t opacity);
+    void setVisible(LayerId layer, bool visible);
+    bool isDirty(LayerId layer) const { return layer < layers_.size() && layers_[layer].dirty; }
+
+    /**
+     * @brief 最下位のdirtyレイヤーから上を再合成
+     * @return 出力が更新された場合true（dirtyなレイヤーが無ければ何もしない）
+     */
+    bool compose();
+
+    /**
+     * @brief 合成結果（ledCount個、レイヤーが無ければ nullptr）
+     */
+    const CRGB* output() const;
+
+    /**
+     * @brief 合成してLEDフレームバッファへ書き込む（show()は呼ばない）
+     * @param force 出力に変化が無くても書き込む（他の描画で上書きされた後など）
+     * @return 書き込んだ場合true
+     */
+    bool present(LEDSphereManager& manager, bool force = false);
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    struct Layer {
+        Storage storage = Storage::kDense;
+        BlendMode mode = BlendMode::kAlphaOver;
+        uint8_t opacity = 255;
+        bool visible = true;
+        bool dirty = true;
+        std::vector<CRGB> color;
+        std::vector<uint8_t> alpha;
+        std::vector<uint16_t> touched;   // kSparse: 書き込み済みLED（重複なし）
+        std::vector<uint8_t> listed;     // kSparse: touchedに含まれるか
+        std::vector<CRGB> composite;     // このレイヤーまでの合成結果
+    };
+
+    void blendLayer(const Layer& layer, const CRGB* below, CRGB* out) const;
+
+    size_t ledCount_;
+    std::vector<Layer> layers_;
+    Stats stats_;
+};
+
+} // namespace LEDSphere
@@ -0,0 +1,164 @@
+/**
+ * @file PanoramaTexture.h
+ * @brief 正距円筒パノラマ画像テクスチャ（RGB888・ミップマップ対応）
+ *
+ * LED球体の画像描画用サンプラー。バッファを所有し、最近傍・バイリニア・
+ * ミップマップ（LEDの角度フットプリントでレベル選択）の3方式を提供する。
+ * サンプリングは固定小数点（UV: Q16、補間ウェイト: Q8）で実行する。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "led/LEDSphereManager.h"
+
+namespace LEDSphere {
+
+/**
+ * @brief パノラマテクスチャ（u: 経度方向・折り返し、v: 緯度方向・クランプ）
+ */
+class PanoramaTexture {
+public:
+    static constexpr uint8_t kMaxMipLevels = 10;
+    static constexpr uint32_t kUVOne = 1u << 16;   // Q16の1.0
+
+    using Filter = TextureFilter;
+
+    /**
+     * @brief ミップレベル情報（レベル0がベース画像）
+     */
+    struct Level {
+        uint8_t* pixels = nullptr;
+        uint16_t width = 0;
+        uint16_t height = 0;
+        size_t stride = 0;      // 行バイト数
+    };
+
+    PanoramaTexture();
+    ~PanoramaTexture();
+
+    PanoramaTexture(const PanoramaTexture&) = delete;
+    PanoramaTexture& operator=(const PanoramaTexture&) = delete;
+
+    /**
+     * @brief ベース画像バッファ確保（PSRAM優先、内容は黒で初期化）
+     * @param width,height 画像サイズ
+     * @return 確保成功フラグ
+     */
+    bool allocate(uint16_t width, uint16_t height);
+
+    /**
+     * @brief RGB888画像をコピーして読み込み（ミップチェーンは破棄）
+     * @param pixels 入力画素
+     * @param width,height 画像サイズ
+     * @param srcStride 入力の行バイト数（0ならwidth*3）
+     */
+    bool loadRGB888(const uint8_t* pixels, uint16_t width, uint16_t height, size_t srcStride = 0);
+
+    /**
+     * @brief バッファ解放
+     */
+    void release();
+
+    /**
+     * @brief ミップチェーン構築（2x2ボックスフィルタ、経度方向は折り返し）
+     * @param maxLevels ベースを含む最大レベル数
+     * @return 構築成功フラグ
+     */
+    bool buildMipChain(uint8_t maxLevels = kMaxMipLevels);
+
+    /**
+     * @brief ベース画像変更後に呼ぶ（ミップチェーンを無効化）
+     */
+    void markBaseModified() { levelCount_ = isValid() ? 1 : 0; }
+
+    bool isValid() const { return levels_[0].pixels != nullptr; }
+    uint8_t* data() { return levels_[0].pixels; }
+    const uint8_t* data() const { return levels_[0].pixels; }
+    uint16_t width() const { return levels_[0].width; }
+    uint16_t height() const { return levels_[0].height; }
+    size_t stride() const { return levels_[0].stride; }
+    uint8_t mipLevelCount() const { return levelCount_; }
+    const Level& level(uint8_t index) const { return levels_[index < levelCount_ ? index : 0]; }
+
+    // ========== 固定小数点サンプリング（u,v: Q16, 0..65535 = 0..1）==========
+
+    CRGB sampleNearestQ16(uint32_t uQ16, uint32_t vQ16, uint8_t level = 0) const;
+    CRGB sampleBilinearQ16(uint32_t uQ16, uint32_t vQ16, uint8_t level = 0) const;
+
+    /**
+     * @brief Q16 UVからタップ（テクセルオフセット + ウェイト）を算出
+     * 結果はレベルのサイズ・strideが変わらない限り画像内容を差し替えても有効
+     */
+    TexelTap makeNearestTap(uint32_t uQ16, uint32_t vQ16) const;
+    TexelTap makeBilinearTap(uint32_t uQ16, uint32_t vQ16, uint8_t level = 0) const;
+
+    /**
+     * @brief 任意の画像サイズに対するバイリニアタップ算出（バッファ不要）
+     * ストリーミングデコードなどテクスチャを実体化しない用途向け
+     */
+    static TexelTap computeBilinearTap(uint32_t uQ16, uint32_t vQ16, uint16_t width, uint16_t height,
+                                       size_t stride, uint8_t level = 0);
+
+    /**
+     * @brief 焼き込み済みタップからのサンプリング（ギャザーのみ）
+     */
+    CRGB sampleTap(const TexelTap& tap) const {
+        const uint8_t* base = levels_[tap.level].pixels;
+        const uint8_t* p00 = base + tap.offset00;
+        if ((tap.fx | tap.fy) == 0) {
+            return CRGB(p00[0], p00[1], p00[2]);
+        }
+        const uint8_t* p10 = base + tap.offset10;
+        const uint8_t* p01 = base + tap.offset01;
+        const uint8_t* p11 = base + tap.offset11;
+        const uint32_t fx = tap.fx, fy = tap.fy;
+        const uint32_t w00 = (256 - fx) * (256 - fy);
+        const uint32_t w10 = fx * (256 - fy);
+        const uint32_t w01 = (256 - fx) * fy;
+        const uint32_t w11 = fx * fy;
+        return CRGB(static_cast<uint8_t>((p00[0] * w00 + p10[0] * w10 + p01[0] * w01 + p11[0] * w11 + 32768u) >> 16),
+                    static_cast<uint8_t>((p00[1] * w00 + p10[1] * w10 + p01[1] * w01 + p11[1] * w11 + 32768u) >> 16),
+                    static_cast<uint8_t>((p00[2] * w00 + p10[2] * w10 + p01[2] * w01 + p11[2] * w11 + 32768u) >> 16));
+    }
+
+    /**
+     * @brief フットプリント（ラジアン）から使用するミップレベルを選択
+     * @param footprintRad LEDが覆う角度幅
+     * @return レベル番号（ミップ未構築なら0）
+     */
+    uint8_t selectMipLevel(float footprintRad) const;
+
+    /**
+     * @brief 正規化UVでのサンプリング（内部でQ16に変換）
+     * @param u 経度方向 [0,1)（範囲外は折り返し）
+     * @param v 緯度方向 [0,1]（範囲外はクランプ）
+     * @param filter フィルタ種別
+     * @param level kMipmap時に使用するレベル
+     */
+    CRGB sample(float u, float v, Filter filter, uint8_t level = 0) const;
+
+    /**
+     * @brief 正規化UVをQ16に変換（uは折り返し、vはクランプ）
+     */
+    static uint32_t wrapUToQ16(float u);
+    static uint32_t clampVToQ16(float v);
+
+    /**
+     * @brief 使用メモリ量（全ミップレベル合計）
+     */
+    size_t memoryUsage() const;
+
+private:
+    static uint8_t* allocatePixels(size_t bytes);
+    static void freePixels(uint8_t* pixels);
+    void releaseMipLevels();
+
+    Level levels_[kMaxMipLevels];
+    uint8_t levelCount_ = 0;
+};
+
+} // namespace LEDSphere
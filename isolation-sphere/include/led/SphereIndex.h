@@ -0,0 +1,79 @@
+/**
+ * @file SphereIndex.h
+ * @brief 球面上のLED近傍検索インデックス（単位ベクトルのk-d木）
+ *
+ * LED位置を単位ベクトルに正規化し、配列上の暗黙k-d木（中央値分割）として保持する。
+ * 弦長は測地距離（中心角）に対して単調なので、最近傍・k近傍・半径検索は
+ * 弦長で行えば測地距離で正確に一致し、UVグリッドのような極付近の歪みが無い。
+ * データは座標・ID・分割軸のフラット配列のみ（ノード毎の確保なし）。
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LEDSphere {
+
+class SphereIndex {
+public:
+    static constexpr uint16_t kNone = 0xFFFF;
+
+    struct Neighbor {
+        uint16_t id;
+        float distanceRad;      // 中心角（ラジアン）
+    };
+
+    /**
+     * @brief インデックス構築（座標は内部で正規化、原点の点は除外）
+     * @param x,y,z 3D座標
+     * @param ids 各点のLED ID
+     * @param count 点数
+     */
+    void build(const float* x, const float* y, const float* z, const uint16_t* ids, size_t count);
+    void clear();
+
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+
+    /**
+     * @brief 最近傍LED（空なら kNone）
+     * @param x,y,z 問い合わせ方向（正規化不要）
+     */
+    uint16_t nearest(float x, float y, float z) const;
+
+    /**
+     * @brief k近傍（近い順、out は上書き）
+     * @return 見つかった個数（min(k, size())）
+     */
+    size_t nearestK(float x, float y, float z, size_t k, std::vector<Neighbor>& out) const;
+
+    /**
+     * @brief 中心角 angleRad 以内の全LED（順不同、out は上書き）
+     * @return 見つかった個数
+     */
+    size_t within(float x, float y, float z, float angleRad, std::vector<uint16_t>& out) const;
+
+    /**
+     * @brief 緯度・経度（度）→ 単位ベクトル（LEDSphereManagerの緯度・経度定義と同じ軸）
+     */
+    static void latLonToUnit(float latitudeDeg, float longitudeDeg, float& x, float& y, float& z);
+
+private:
+    struct Query;
+
+    void buildNode(size_t lo, size_t hi, std::vector<uint32_t>& order,
+                     const std::vector<float>& ux, const std::vector<float>& uy, const std::vector<float>& uz);
+    void searchNearest(size_t lo, size_t hi, Query& query) const;
+    void searchWithin(size_t lo, size_t hi, const float (&q)[3], float chord2, std::vector<uint16_t>& out) const;
+
+    // k-d木の節点 [lo, hi) の中央 mid = (lo + hi) / 2 に分割点を置く
+    std::vector<float> px_;
+    std::vector<float> py_;
+    std::vector<float> pz_;
+    std::vector<uint16_t> ids_;
+    std::vector<uint8_t> splitAxis_;    // 0:x 1:y 2:z
+};
+
+} // namespace LEDSphere
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/CommandQueue.h"
+#include "core/RemoteControl.h"
+
+// Compact binary UI/control messages, published on "<ui topic>/bin" next to
+// the JSON topics.
+//
+// Every message is a fixed 20-byte little-endian record, so parsing is a
+// bounds check plus a handful of loads instead of an ArduinoJson pass:
+//
+//   off size field
+//     0    2 magic "SC"
+//     2    1 version (kVersion)
+//     3    1 type (MessageType)
+//     4    2 sequence
+//     6    1 fields (FieldMask bits: which values below are present)
+//     7    1 command (UiCommandType)
+//     8    2 latitude offset, centi-degrees (int16)
+//    10    2 longitude offset, centi-degrees (int16)
+//    12    1 brightness
+//    13    1 pattern id
+//    14    2 reserved (0)
+//    16    4 timestamp ms
+//
+// Newer minor revisions may append bytes; decoders accept longer payloads
+// with the same version and ignore the tail. The status payload advertises
+// the supported version so controllers can pick binary or JSON.
+namespace control {
+
+constexpr uint8_t kMagic0 = 'S';
+constexpr uint8_t kMagic1 = 'C';
+constexpr uint8_t kVersion = 1;
+constexpr size_t kMessageSize = 20;
+constexpr const char *kBinaryTopicSuffix = "/bin";
+
+enum class MessageType : uint8_t {
+  kControl = 1,  // controller -> sphere
+  kUiEvent = 2,  // sphere -> controllers (gesture commands)
+};
+
+enum FieldMask : uint8_t {
+  kFieldCommand = 1u << 0,
+  // Value fields share RemoteControl's bits so they can be merged directly.
+  kFieldPosture = RemoteControl::kPosture,
+  kFieldBrightness = RemoteControl::kBrightness,
+  kFieldPattern = RemoteControl::kPattern,
+};
+
+struct Message {
+  MessageType type = MessageType::kControl;
+  uint16_t sequence = 0;
+  uint8_t fields = 0;
+  UiCommandType command = UiCommandType::kRaw;
+  float latitudeOffsetDeg = 0.0f;
+  float longitudeOffsetDeg = 0.0f;
+  uint8_t brightness = 0;
+  uint8_t patternId = 0;
+  uint32_t timestampMs = 0;
+
+  bool has(FieldMask field) const { return (fields & field) != 0; }
+};
+
+// Writes kMessageSize bytes; returns the number written (0 if out is too small).
+size_t encode(const Message &message, uint8_t *out, size_t capacity);
+
+// Returns false for short payloads, wrong magic or an unsupported version.
+bool decode(const uint8_t *data, size_t length, Message &out);
+
+// Merges the value fields present in the message into `control`; false if
+// it carried none (command-only messages).
+bool apply(const Message &message, RemoteControl &control, uint32_t nowMs);
+
+// Canonical text for a command enum ("ui:x_pos" ...), nullptr for kRaw.
+const char *commandName(UiCommandType command);
+
+}  // namespace control
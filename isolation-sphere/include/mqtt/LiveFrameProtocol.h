@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "led/FramePack.h"
+
+// Live LED-space frames for content generated on a PC (visualizations,
+// mirrored screens), published on "<image topic>/live" next to the JPEG
+// image topics.
+//
+// A frame is ledCount RGB triplets in LED order, so the sphere neither
+// decodes JPEG nor samples a panorama. Each message is a 12-byte
+// little-endian header followed by a FramePack-encoded body:
+//
+//   off size field
+//     0    2 magic "LV"
+//     2    1 version (kVersion)
+//     3    1 encoding (LEDSphere::FrameEncoding)
+//     4    2 sequence (increments every frame)
+//     6    2 keyframe sequence (== sequence for keyframes)
+//     8    2 LED count
+//    10    2 reserved (0)
+//    12    - body
+//
+// Keyframes are kRaw or kRle. All other frames are kDelta against the
+// keyframe they name rather than the previous frame: with QoS 0 a lost
+// delta only skips that frame. Only a lost keyframe stalls the stream; the
+// receiver then publishes a keyframe request on
+// "<live topic>" + kKeyframeRequestSuffix and the sender answers with a
+// keyframe ahead of schedule.
+namespace live {
+
+constexpr uint8_t kMagic0 = 'L';
+constexpr uint8_t kMagic1 = 'V';
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = 12;
+constexpr uint16_t kDefaultLedCount = 800;
+constexpr const char *kTopicSuffix = "/live";
+constexpr const char *kKeyframeRequestSuffix = "/keyframe";
+
+struct Header {
+  LEDSphere::FrameEncoding encoding = LEDSphere::FrameEncoding::kRaw;
+  uint16_t sequence = 0;
+  uint16_t keyframe = 0;
+  uint16_t ledCount = 0;
+
+  bool isKeyframe() const { return sequence == keyframe; }
+};
+
+// Writes kHeaderSize bytes; returns the number written (0 if out is too small).
+size_t writeHeader(const Header &header, uint8_t *out, size_t capacity);
+
+// Returns false for short payloads, wrong magic, an unsupported version or
+// a keyframe that claims kDelta.
+bool readHeader(const uint8_t *data, size_t length, Header &out);
+
+// Sender side (PC tools, tests).
+class Encoder {
+ public:
+  // keyframeInterval: frames between scheduled keyframes (0 = only on
+  // request and on scene cuts).
+  explicit Encoder(uint16_t ledCount, uint32_t keyframeInterval = 30);
+
+  // Encodes one ledCount x RGB frame into `out` (header + body). A keyframe
+  // is emitted when scheduled, requested, or when the delta would not be
+  // smaller than the keyframe itself (scene cut). Returns true for keyframes.
+  bool encode(const uint8_t *rgb, std::vector<uint8_t> &out);
+
+  // Answer to a receiver's keyframe request: the next frame is a keyframe.
+  void requestKeyframe() { forceKeyframe_ = true; }
+
+  uint16_t ledCount() const { return ledCount_; }
+  uint16_t nextSequence() const { return sequence_; }
+
+ private:
+  uint16_t ledCount_;
+  uint32_t keyframeInterval_;
+  uint32_t sinceKeyframe_ = 0;
+  uint16_t sequence_ = 0;
+  uint16_t keyframeSequence_ = 0;
+  bool forceKeyframe_ = true;
+  std::vector<uint8_t> keyframe_;
+  std::vector<uint8_t> delta_;
+  std::vector<uint8_t> rle_;
+};
+
+// Receiver side. Reconstructs full frames in LED order.
+class Decoder {
+ public:
+  enum class Result : uint8_t {
+    kFrame = 0,     // frame() holds a new frame
+    kStale,         // duplicate or older than the last accepted frame
+    kNeedKeyframe,  // delta against a keyframe we do not have
+    kInvalid,       // malformed, or LED count mismatch
+  };
+
+  struct Stats {
+    uint32_t frames = 0;
+    uint32_t keyframes = 0;
+    uint32_t lost = 0;             // sequence gaps
+    uint32_t stale = 0;
+    uint32_t missingKeyframe = 0;  // deltas dropped for lack of their keyframe
+    uint32_t invalid = 0;
+  };
+
+  // A sequence this far behind the last frame means the sender restarted.
+  static constexpr uint16_t kRestartDistance = 1024;
+
+  explicit Decoder(uint16_t ledCount = kDefaultLedCount);
+
+  void reset();
+  Result decode(const uint8_t *data, size_t length);
+
+  const uint8_t *frame() const { return frame_.data(); }
+  size_t frameBytes() const { return frame_.size(); }
+  uint16_t ledCount() const { return ledCount_; }
+  uint16_t lastSequence() const { return lastSequence_; }
+  Stats stats() const { return stats_; }
+
+ private:
+  bool acceptSequence(uint16_t sequence);
+
+  uint16_t ledCount_;
+  std::vector<uint8_t> frame_;
+  std::vector<uint8_t> keyframe_;
+  bool haveKeyframe_ = false;
+  uint16_t keyframeSequence_ = 0;
+  bool haveSequence_ = false;
+  uint16_t lastSequence_ = 0;
+  Stats stats_;
+};
+
+}  // namespace live
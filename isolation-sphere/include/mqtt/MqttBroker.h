@@ -1,62 +1,226 @@
 #pragma once
 
 #include "config/ConfigManager.h"
-#include <WiFi.h>
-#include <WiFiServer.h>
-#include <WiFiClient.h>
-#include <ArduinoJson.h>
+#include "mqtt/TopicTrie.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#if defined(ARDUINO)
+#include <WiFi.h>
+#include <WiFiServer.h>
+#endif
+
+// Small MQTT 3.1.1 broker for the sphere's own access point.
+//
+// Subscriptions live in a TopicTrie keyed by client slot, so routing a
+// publish is one walk over the topic levels. Every message is encoded once
+// into a reference-counted Packet and the same buffer is queued to each
+// matching client; an image sent to N subscribers is held in memory once.
+//
+// Each client has a bounded outbound queue drained with non-blocking writes.
+// When a client falls behind, the oldest packets that have not started
+// transmission are dropped (the newest frame wins, like ImageFrameBuffer);
+// a client that accepts no bytes for kStallTimeoutMs is disconnected.
+//
+// Delivery is QoS 0: inbound QoS 1 publishes are acknowledged with PUBACK;
+// inbound QoS 2 publishes are routed on receipt and complete the
+// PUBREC/PUBREL/PUBCOMP exchange with the sender, so a resend is not routed
+// twice. Subscriptions are granted QoS 0. Sessions are always clean and will
+// messages are ignored.
+//
+// The protocol core only sees the Connection interface; the device wraps
+// WiFiClient, native tests plug in fake sockets.
 class MqttBroker {
  public:
   static constexpr int kMaxClients = 8;
-  static constexpr int kMaxTopics = 50;
+  static constexpr int kMaxTopics = 50;  // retained topics
   static constexpr int kKeepAliveSeconds = 60;
 
+  // Largest accepted packet (an image payload plus its topic).
+  static constexpr size_t kMaxPacketBytes = 128 * 1024;
+  // Outbound queue limits per client. Queued packets are shared, so the
+  // byte limit bounds how much one slow client can keep alive.
+  static constexpr size_t kQueueDepth = 16;
+  static constexpr size_t kMaxQueuedBytes = 256 * 1024;
+  // Bytes read from one client per service pass, so a large upload does
+  // not starve the other clients.
+  static constexpr size_t kReadBudgetBytes = 16 * 1024;
+  static constexpr uint32_t kStallTimeoutMs = 5000;
+  static constexpr uint32_t kConnectTimeoutMs = 5000;
+  // Inbound QoS 2 ids awaiting PUBREL, per client.
+  static constexpr size_t kMaxQos2InFlight = 8;
+
+  static_assert(kMaxClients <= static_cast<int>(TopicTrie::kMaxSubscribers), "client slots must fit the trie mask");
+
+  // Non-blocking byte stream to one client.
+  class Connection {
+   public:
+    virtual ~Connection() = default;
+    virtual size_t available() = 0;
+    virtual size_t read(uint8_t *buffer, size_t length) = 0;
+    // Takes as many bytes as fit without blocking and returns the count.
+    virtual size_t write(const uint8_t *data, size_t length) = 0;
+    virtual bool connected() = 0;
+    virtual void close() = 0;
+  };
+
+  // One encoded MQTT packet. `begin` skips header space left over when a
+  // received packet was rewritten in place.
+  struct Packet {
+    std::vector<uint8_t> bytes;
+    size_t begin = 0;
+
+    const uint8_t *data() const { return bytes.data() + begin; }
+    size_t size() const { return bytes.size() - begin; }
+  };
+  using PacketRef = std::shared_ptr<const Packet>;
+
   struct Stats {
     bool brokerActive = false;
     int port = 1883;
     int connectedClients = 0;
     int maxClients = kMaxClients;
-    int totalMessages = 0;
-    int activeTopics = 0;
+    int totalMessages = 0;  // publishes routed (received + local)
+    int activeTopics = 0;   // retained topics
     unsigned long uptimeMs = 0;
     unsigned long startTime = 0;
-    std::string lastTopic;
-    std::string lastPayload;
+    uint32_t subscriptions = 0;
+    uint32_t deliveries = 0;         // PUBLISH packets fully written to subscribers
+    uint32_t dropped = 0;            // evicted by backpressure
+    uint32_t slowClientsClosed = 0;  // stalled past kStallTimeoutMs
+    uint32_t protocolErrors = 0;
+    uint64_t bufferedBytes = 0;  // bytes copied into packet buffers
+    uint64_t bytesSent = 0;
+    size_t queuedBytes = 0;      // currently referenced by client queues
+  };
+
+  struct ClientStats {
+    bool connected = false;
+    std::string clientId;
+    uint32_t delivered = 0;
+    uint32_t dropped = 0;
+    uint64_t bytesSent = 0;
+    size_t queuedPackets = 0;
+    size_t queuedBytes = 0;
   };
 
   MqttBroker();
   ~MqttBroker();
 
+  MqttBroker(const MqttBroker &) = delete;
+  MqttBroker &operator=(const MqttBroker &) = delete;
+
   // 初期化・設定
   bool applyConfig(const ConfigManager::Config &config);
   bool start(int port = 1883);
   void stop();
   void loop();
 
+  // Hands a new client to the broker. Returns false (and closes the
+  // connection) when every slot is taken or the broker is not running.
+  bool acceptConnection(std::unique_ptr<Connection> connection, uint32_t nowMs);
+  // Reads, dispatches and flushes every client once.
+  void service(uint32_t nowMs);
+
   // 状態確認
   bool isEnabled() const { return enabled_; }
   bool isActive() const { return brokerActive_; }
   int getConnectedClients() const { return connectedClients_; }
   Stats getStats() const;
+  bool getClientStats(size_t slot, ClientStats &out) const;
 
   // メッセージ配信
   bool publish(const char* topic, const char* payload, bool retain = false);
-  bool publishJoystickState(float leftX, float leftY, float rightX, float rightY, 
+  bool publish(const char *topic, const uint8_t *payload, size_t length, bool retain = false);
+  bool publishJoystickState(float leftX, float leftY, float rightX, float rightY,
                            bool buttonA, bool buttonB, bool leftClick, bool rightClick);
   bool publishSystemStatus(const char* status);
   bool publishWiFiClients(int clientCount);
 
  private:
+  struct Client {
+    std::unique_ptr<Connection> connection;
+    bool session = false;  // CONNECT accepted
+    std::string clientId;
+    uint16_t keepAliveSec = 0;
+    uint32_t acceptedMs = 0;
+    uint32_t lastRxMs = 0;
+
+    // Inbound packet being assembled. The buffer becomes the outbound
+    // packet for PUBLISH, so a received payload is copied exactly once.
+    uint8_t header[5] = {};
+    uint8_t headerLength = 0;
+    uint32_t remaining = 0;
+    bool lengthKnown = false;
+    std::shared_ptr<Packet> rx;
+    size_t rxFill = 0;
+
+    // Oldest first.
+    std::array<uint16_t, kMaxQos2InFlight> qos2Pending = {};
+    size_t qos2Count = 0;
+
+    // Outbound ring; the head packet may be partly written.
+    std::array<PacketRef, kQueueDepth> queue;
+    std::array<bool, kQueueDepth> control = {};  // never evicted
+    size_t head = 0;
+    size_t count = 0;
+    size_t queuedBytes = 0;
+    size_t headOffset = 0;
+    uint32_t lastProgressMs = 0;
+
+    uint32_t delivered = 0;
+    uint32_t dropped = 0;
+    uint64_t bytesSent = 0;
+  };
+
+  struct Retained {
+    std::string topic;
+    PacketRef packet;  // RETAIN flag set
+  };
+
+  void readClient(size_t slot, uint32_t nowMs);
+  bool handlePacket(size_t slot, const std::shared_ptr<Packet> &packet, size_t headerLength);
+  bool handleConnect(size_t slot, const uint8_t *body, size_t length);
+  bool handlePublish(size_t slot, const std::shared_ptr<Packet> &packet, size_t headerLength);
+  bool handlePubRel(size_t slot, uint16_t packetId);
+  bool handleSubscribe(size_t slot, const uint8_t *body, size_t length);
+  bool handleUnsubscribe(size_t slot, const uint8_t *body, size_t length);
+  void flushClient(size_t slot, uint32_t nowMs);
+  void closeClient(size_t slot, const char *reason);
+
+  // Routes an encoded QoS 0 PUBLISH (RETAIN clear) to every subscriber.
+  void route(const PacketRef &packet, const char *topic, size_t topicLength, size_t payloadLength, bool retain);
+  void storeRetained(const char *topic, size_t topicLength, const PacketRef &packet, size_t payloadLength);
+  bool enqueue(size_t slot, const PacketRef &packet, bool control);
+  bool evictOldest(Client &client);
+  void popFront(Client &client);
+  bool protocolError(size_t slot, const char *reason);
+  // Records an inbound QoS 2 id; false if it is already awaiting PUBREL.
+  static bool holdQos2Id(Client &client, uint16_t packetId);
+
+  static PacketRef encodePublish(const char *topic, size_t topicLength, const uint8_t *payload, size_t length,
+                                 bool retain);
+  static PacketRef controlPacket(uint8_t type, uint16_t packetId);
+
   bool enabled_ = false;
   bool brokerActive_ = false;
   int brokerPort_ = 1883;
   int connectedClients_ = 0;
-  
+
+#if defined(ARDUINO)
   WiFiServer *server_ = nullptr;
+#endif
   uint32_t lastLogMs_ = 0;
   int totalMessages_ = 0;
   Stats stats_;
+
+  std::array<Client, kMaxClients> clients_;
+  TopicTrie subscriptions_;
+  std::vector<Retained> retained_;
+  PacketRef connAck_;
+  PacketRef pingResp_;
 };
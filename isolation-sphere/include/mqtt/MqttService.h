@@ -2,33 +2,62 @@
 
 #include "config/ConfigManager.h"
 #include "core/SharedState.h"
+#include "core/SyncClock.h"
+#include "mqtt/ControlProtocol.h"
+#include "core/LogRateLimiter.h"
+#include "mqtt/LiveFrameProtocol.h"
+#include "mqtt/TopicRouter.h"
 
 #include <AsyncMqttClient.h>
 #include <WiFi.h>
 
+#include <atomic>
+#include <functional>
 #include <string>
-#include <vector>
+#include <utility>
 
 class MqttService {
  public:
   explicit MqttService(SharedState &sharedState);
 
+  // Call only when the config changes: compares every topic and restarts
+  // the session if the broker or topics moved.
   bool applyConfig(const ConfigManager::Config &config);
   void loop();
+  // Starts one connection attempt; retry pacing belongs to the caller
+  // (ConnectionManager). The listener hears every connect/disconnect and
+  // runs on the AsyncMqttClient task.
+  bool connect();
+  void setConnectionListener(std::function<void(bool)> listener) { connectionListener_ = std::move(listener); }
   bool isEnabled() const { return enabled_; }
   bool isConnected() const { return connected_; }
 
   bool publishStatus();
+  // Serializes SharedState::metrics() into one payload on the telemetry
+  // topic (QoS 0, not retained). Called from loop() every
+  // telemetry.interval_ms; each call closes a histogram window.
+  bool publishMetrics();
   bool publishImage(const uint8_t *data, size_t length, bool retain = false, uint8_t qos = 0);
-  bool publishUiEvent(const std::string &command, const char *source = "gesture");
+  bool publishUiEvent(const char *command, const char *source = "gesture");
   void stop();
 
  private:
-  void ensureWifi();
-  void connectIfNeeded();
-  void handleIncomingMessage(const char *topic, const std::string &payload);
-  void resetIncomingBuffer(size_t totalLength);
+  enum class TopicRoute : uint8_t { kUnhandled = 0, kUi, kUiBinary, kCommand, kSync, kEmergency, kImage, kLive };
+
+  void handleIncomingMessage(TopicRoute route, const std::string &payload);
+  void beginIncomingMessage(const char *topic, size_t totalLength);
+  void rebuildTopicRoutes();
+  bool shouldLog();
   bool tryParseUiMessage(const std::string &payload);
+  void handleBinaryControl(const std::string &payload);
+  void applyControl(const control::Message &message);
+  void pushSystemCommand(SystemCommandType type, const std::string &payload);
+  bool tryParseSyncBeacon(const std::string &payload);
+  void updateSync(uint32_t now);
+  bool publishSyncBeacon(uint32_t now);
+  void handleLiveFrame(const std::string &payload);
+  void requestLiveKeyframe();
+  void registerMetrics();
 
   SharedState &sharedState_;
   AsyncMqttClient client_;
@@ -60,16 +89,73 @@ class MqttService {
   std::string topicSync_;
   std::string topicEmergency_;
 
-  ConfigManager::WifiConfig wifiConfig_{};
+  // Binary control topics: "<ui topic>" + control::kBinaryTopicSuffix
+  std::string topicUiBinary_;
+  std::string topicUiIndividualBinary_;
+  std::string topicUiAllBinary_;
+
+  // Live LED frames: "<image topic>" + live::kTopicSuffix
+  std::string topicLiveIndividual_;
+  std::string topicLiveAll_;
+  live::Decoder liveDecoder_;
+  uint32_t lastKeyframeRequestMs_ = 0;
+  RemoteControl remoteControl_{};
+  uint16_t uiEventSequence_ = 0;
+
+  // Written by the AsyncMqttClient callback task, read by publishStatus()
+  // and the metrics sampler on Core0: the decoder stats are republished
+  // through a SeqLock after each live frame, counters are relaxed atomics.
+  SeqLock<live::Decoder::Stats> liveStats_;
+  std::atomic<uint32_t> keyframeRequests_{0};
+  std::atomic<bool> binaryPeerSeen_{false};
+  std::atomic<uint32_t> binaryMessages_{0};
+  std::atomic<uint32_t> jsonMessages_{0};
+  live::Decoder::Stats liveStats() const;
+
+  // Frame sync: the MQTT callback only records the beacon and its receive
+  // time; loop() feeds the estimator and is the only SharedState writer.
+  struct PendingBeacon {
+    SyncClock::Beacon beacon;
+    uint32_t receivedMs = 0;
+    uint32_t serial = 0;
+  };
+  ConfigManager::SyncConfig syncConfig_{};
+  SyncClock syncClock_;
+  SeqLock<PendingBeacon> pendingBeacon_;
+  uint32_t pendingBeaconSerial_ = 0;
+  uint32_t consumedBeaconSerial_ = 0;
+  uint32_t lastBeaconSentMs_ = 0;
+  uint16_t beaconSequence_ = 0;
+  bool syncTimebasePublished_ = false;
 
-  std::vector<uint8_t> incomingBuffer_;
+  enum class IncomingKind : uint8_t { kIgnored, kControl, kImage };
+
+  // SharedState::imageFrames(); image topics and live frames land here.
+  using ImageSource = SharedState::ImageSource;
+  ImageFrameBuffer &imageFrames_;
+  std::string incomingPayload_;
   std::string incomingTopic_;
+  IncomingKind incomingKind_ = IncomingKind::kIgnored;
+  TopicRoute incomingRoute_ = TopicRoute::kUnhandled;
+
+  TopicRouter topicRouter_;
+  uint32_t routeSignature_ = 0;
+  bool routesBuilt_ = false;
+  // Message-path logging: at most 10 lines per second
+  LogRateLimiter logLimiter_{10, 1000};
 
-  uint32_t lastWifiAttemptMs_ = 0;
-  uint32_t lastReconnectMs_ = 0;
+  std::function<void(bool)> connectionListener_;
   uint32_t lastStatusMs_ = 0;
 
-  static constexpr uint32_t kWifiRetryIntervalMs = 10000;
-  static constexpr uint32_t kReconnectIntervalMs = 5000;
+  ConfigManager::TelemetryConfig telemetryConfig_{};
+  std::string topicMetrics_;
+  std::string metricsPayload_;  // reused between publishes
+  uint32_t lastMetricsMs_ = 0;
+
   static constexpr uint32_t kStatusIntervalMs = 10000;
+  static constexpr uint32_t kMinMetricsIntervalMs = 1000;
+  static constexpr size_t kMaxControlPayloadBytes = 4096;
+  static constexpr size_t kImageSlotBytes = 96 * 1024;
+  static constexpr uint32_t kSyncLockTimeoutMs = 10000;
+  static constexpr uint32_t kKeyframeRequestIntervalMs = 250;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Maps incoming MQTT topics to small route ids.
+//
+// Exact topics are kept sorted by FNV-1a hash, so a lookup is one hash of the
+// incoming topic, a binary search and a single string compare on the hit.
+// Filters containing MQTT wildcards ("sphere/+/ui", "system/#") are checked
+// afterwards in registration order. The table is built once per config
+// change (MqttService::applyConfig), never on the message path.
+class TopicRouter {
+ public:
+  struct Match {
+    uint8_t route = 0;
+    uint8_t tag = 0;
+  };
+
+  void clear();
+
+  // Registers a topic or wildcard filter. Empty filters are ignored; the
+  // first registration of an identical exact topic wins.
+  bool add(const std::string &filter, uint8_t route, uint8_t tag = 0);
+
+  bool match(const char *topic, Match &out) const;
+
+  size_t exactCount() const { return exact_.size(); }
+  size_t wildcardCount() const { return wildcard_.size(); }
+
+  static uint32_t hash(const char *data, size_t length);
+  static bool isWildcard(const std::string &filter);
+  // MQTT 3.1.1 filter matching ('+' = one level, '#' = remaining levels).
+  static bool matchesFilter(const std::string &filter, const char *topic, size_t topicLength);
+
+ private:
+  struct Entry {
+    uint32_t hash;
+    std::string topic;
+    Match match;
+  };
+
+  std::vector<Entry> exact_;     // sorted by hash
+  std::vector<Entry> wildcard_;  // registration order
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Subscription index for the embedded broker.
+//
+// Filters are stored level by level ("sphere" -> "+" -> "image"), each node
+// holding a bitmask of the subscriber slots whose filter ends there and a
+// second mask for "<node>/#". Matching a topic walks its levels once and
+// returns the union of the masks it passes, so the cost depends on the topic
+// depth (plus one extra branch per '+' node on the way), not on how many
+// subscriptions exist. A subscriber that matches through several filters
+// appears once in the result.
+//
+// Subscriber ids are broker client slots (0..kMaxSubscribers-1).
+class TopicTrie {
+ public:
+  using Mask = uint32_t;
+  static constexpr size_t kMaxSubscribers = 32;
+
+  TopicTrie();
+
+  void clear();
+
+  // Returns false for malformed filters ('#' not last, wildcard mixed into a
+  // level, empty filter) or an out-of-range subscriber.
+  bool subscribe(const std::string &filter, uint8_t subscriber);
+  // Returns true if the subscription existed. Empty branches are pruned.
+  bool unsubscribe(const std::string &filter, uint8_t subscriber);
+  // Drops every subscription of a slot (client disconnected).
+  void removeSubscriber(uint8_t subscriber);
+
+  Mask match(const char *topic, size_t length) const;
+  Mask match(const std::string &topic) const { return match(topic.data(), topic.size()); }
+
+  size_t subscriptionCount() const { return subscriptions_; }
+  size_t nodeCount() const { return nodes_.size() - free_.size(); }
+
+  static bool isValidFilter(const char *filter, size_t length);
+  // Topic names used in PUBLISH must not contain wildcards.
+  static bool isValidTopic(const char *topic, size_t length);
+  // Same rules as match(), for a single filter (retained message lookup).
+  static bool matches(const std::string &filter, const char *topic, size_t length);
+
+ private:
+  static constexpr uint16_t kNone = 0xFFFF;
+  static constexpr uint16_t kRoot = 0;
+
+  struct Node {
+    uint32_t hash = 0;
+    std::string level;
+    uint16_t parent = kNone;
+    uint16_t plus = kNone;
+    std::vector<uint16_t> children;
+    Mask exact = 0;  // filter ends at this node
+    Mask rest = 0;   // filter is "<this node>/#"
+  };
+
+  uint16_t allocateNode(uint16_t parent, const char *level, size_t length, uint32_t hash);
+  uint16_t findChild(uint16_t node, const char *level, size_t length, uint32_t hash) const;
+  // Walks (and optionally creates) the node for the filter's levels before
+  // any trailing '#'. Returns kNone if a level is missing.
+  uint16_t locate(const std::string &filter, bool create, bool &multiLevel);
+  void prune(uint16_t node);
+  void collect(uint16_t node, const char *topic, size_t length, size_t start, Mask &mask) const;
+
+  std::vector<Node> nodes_;
+  std::vector<uint16_t> free_;
+  size_t subscriptions_ = 0;
+};
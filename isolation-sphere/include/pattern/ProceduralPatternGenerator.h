@@ -1,10 +1,14 @@
 #pragma once
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "core/SyncClock.h"
+
 #if !defined(UNIT_TEST)
 #include <Arduino.h>
 #include <M5Unified.h>
@@ -17,6 +21,7 @@ struct CRGB;
 namespace LEDSphere {
     class LEDSphereManager;
     struct PostureParams;
+    struct LedGeom;
 }
 
 /**
@@ -58,6 +63,18 @@ struct PatternParams {
         speed(1.0f), brightness(1.0f), enableFlicker(true) {}
 };
 
+/**
+ * @brief LCD上の描画領域（空 = LCDに描かない）
+ */
+struct DisplayRect {
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+
+    bool empty() const { return w <= 0 || h <= 0; }
+};
+
 /**
  * @brief パターンの基底インターフェース
  */
@@ -83,6 +100,13 @@ public:
     virtual const char* getName() const = 0;
     virtual const char* getDescription() const = 0;
     virtual float getDuration() const { return 3.0f; } // デフォルト3秒
+
+    /**
+     * @brief 毎フレーム書き換えるLCD領域
+     * @description PatternGeneratorは前フレームのこの領域だけを消去する。
+     *              LEDのみに描くパターンは空を返し、LCDには一切触れない
+     */
+    virtual DisplayRect displayFootprint(const PatternParams& /*params*/) const { return DisplayRect(); }
     
     // パラメータ調整
     virtual void setSpeed(float speed) {}
@@ -241,21 +265,66 @@ private:
     float calculateRingBrightness(const Ring& ring, const PatternParams& params) const;
 };
 
+/**
+ * @brief フィールド評価時のフレーム共通値
+ */
+struct FrameCtx {
+    float progress;       // 進行度 [0.0 - 1.0]
+    float time;           // 経過時間 (秒)
+    float speed;          // PatternParams::speed
+    float brightness;     // PatternParams::brightness
+};
+
+/**
+ * @brief LED毎のフィールド評価で描画するパターン（シェーダ方式）
+ *
+ * drawLatitudeLine等を重ねる方式はプリミティブ毎に全LEDを走査するが、
+ * こちらは LEDSphereManager::fillByGeometry で各LEDを1回だけ評価する。
+ * フレーム内で不変な値は prepareFrame() で求めてメンバに保持し、eval() は
+ * その値とLED幾何情報だけから色を返す
+ */
+class FieldPattern : public IPattern {
+public:
+    void render(const PatternParams& params) override;
+
+    /**
+     * @brief 1LED分の色を返す
+     * @param led 緯度・経度・3D座標（姿勢回転前）
+     * @param ctx フレーム共通値
+     */
+    virtual CRGB eval(const LEDSphere::LedGeom& led, const FrameCtx& ctx) const = 0;
+
+protected:
+    /**
+     * @brief フレーム毎の前計算（全LEDの評価前に1回）
+     */
+    virtual void prepareFrame(const FrameCtx& /*ctx*/) {}
+};
+
 /**
  * @brief 螺旋軌道パターン
+ * @description 南極から北極へ spiralTurns_ 周する螺旋を先頭から trailLength_ 度（緯度）
+ *              の尾を引いて描く。色相は螺旋上の位置で変化
  */
-class SpiralTrajectoryPattern : public IPattern {
+class SpiralTrajectoryPattern : public FieldPattern {
 private:
     float speed_;
     float brightness_;
     float spiralTurns_;
-    int trailLength_;
+    int trailLength_;       // 尾の長さ（緯度・度）
+
+    // prepareFrameで算出
+    float headT_ = 0.0f;    // 先頭位置 [0, 1]（0:南極, 1:北極）
+    float trailT_ = 0.0f;   // 尾の長さ [0, 1]
+    float scale_ = 0.0f;    // 最終輝度
     
 public:
+    static constexpr float kHalfWidthDeg = 12.0f;  // 螺旋の半幅（球面上の度）
+
     SpiralTrajectoryPattern();
     ~SpiralTrajectoryPattern() = default;
     
-    void render(const PatternParams& params) override;
+    CRGB eval(const LEDSphere::LedGeom& led, const FrameCtx& ctx) const override;
     const char* getName() const override { return "Spiral Trajectory"; }
     const char* getDescription() const override { return "Spiral path from South to North Pole"; }
     
@@ -264,22 +333,30 @@ public:
     
     void setSpiralTurns(float turns) { spiralTurns_ = turns; }
     void setTrailLength(int length) { trailLength_ = length; }
+
+protected:
+    void prepareFrame(const FrameCtx& ctx) override;
 };
 
 /**
  * @brief 球面波動パターン
+ * @description 北極を波源とする同心円状の波が南極へ進む（北極からの角距離の余弦波）
  */
-class SphericalWavePattern : public IPattern {
+class SphericalWavePattern : public FieldPattern {
 private:
     float speed_;
     float brightness_;
-    int waveCount_;
+    int waveCount_;         // 北極〜南極間の波の数
+
+    // prepareFrameで算出
+    float phase_ = 0.0f;    // 波の位相（ラジアン）
+    float scale_ = 0.0f;    // 最終輝度
     
 public:
     SphericalWavePattern();
     ~SphericalWavePattern() = default;
     
-    void render(const PatternParams& params) override;
+    CRGB eval(const LEDSphere::LedGeom& led, const FrameCtx& ctx) const override;
     const char* getName() const override { return "Spherical Wave"; }
     const char* getDescription() const override { return "Concentric waves on sphere surface"; }
     
@@ -287,6 +364,9 @@ public:
     void setBrightness(float brightness) override { brightness_ = brightness; }
     
     void setWaveCount(int count) { waveCount_ = count; }
+
+protected:
+    void prepareFrame(const FrameCtx& ctx) override;
 };
 
 /**
@@ -309,6 +389,7 @@ public:
     void render(const PatternParams& params) override;
     const char* getName() const override { return "Coordinate Axis"; }
     const char* getDescription() const override { return "XYZ axis indicators with grid and labels (LED Sphere compatible)"; }
+    DisplayRect displayFootprint(const PatternParams& params) const override;
     
     void setBrightness(float brightness) override { brightness_ = brightness; }
     
@@ -332,23 +413,70 @@ private:
 };
 
 /**
- * @brief パターン生成・管理クラス（ファクトリーパターン使用）
+ * @brief パターンID（名前をインターンした添字）
+ */
+using PatternId = uint8_t;
+constexpr PatternId kInvalidPatternId = 0xFF;
+
+/**
+ * @brief パターン生成・管理クラス（レジストリ）
+ * @description 各パターンは初回描画時に1度だけ生成して保持し、以後のフレームは
+ *              同じインスタンスを再利用する（毎フレームのnew/deleteでPSRAMヒープが
+ *              断片化するのを防ぐ）。パターン毎の設定・状態はフレームを跨いで残る
  */
 class PatternGenerator {
 private:
+    static constexpr size_t kPatternCount = 7;
+
     std::string currentPatternName_;
+    PatternId currentPatternId_;
     PatternParams defaultParams_;
+    LEDSphere::LEDSphereManager* sphereManager_;
+    std::array<std::unique_ptr<IPattern>, kPatternCount> patterns_;
+    DisplayRect lastFootprint_;   // 前フレームでLCDに描いた領域
     
 public:
     PatternGenerator();
     ~PatternGenerator() = default;
     
-    // ファクトリーメソッド
+    // ファクトリーメソッド（レジストリを介さない新規インスタンス）
     std::unique_ptr<IPattern> createPattern(const std::string& patternName);
+
+    /**
+     * @brief パターン名をIDに変換（未知の名前は kInvalidPatternId）
+     * @description 毎フレーム描画する呼び出し側は1度だけ解決してIDで描画する
+     */
+    static PatternId findPatternId(const std::string& patternName);
+    static const char* patternName(PatternId id);
+
+    /**
+     * @brief レジストリ内のインスタンス取得（未生成なら生成）
+     * @description 返したポインタはPatternGeneratorの寿命の間有効。
+     *              setSpeed等の設定は以後の描画に引き継がれる
+     */
+    IPattern* getPattern(PatternId id);
+    IPattern* getPattern(const std::string& patternName) { return getPattern(findPatternId(patternName)); }
+
+    /**
+     * @brief 生成済み・今後生成する全パターンにLED球体制御を設定
+     */
+    void setSphereManager(LEDSphere::LEDSphereManager* manager);
     
     // 描画実行
+    void renderPattern(PatternId id, float progress, float time = 0.0f,
+                      const PatternParams* customParams = nullptr);
     void renderPattern(const std::string& patternName, float progress, float time = 0.0f,
                       const PatternParams* customParams = nullptr);
+
+    /**
+     * @brief 共有タイムベース基準で描画（複数球体の同期表示用）
+     * @description PatternParams::timeをtimebase.animationTimeSec(localMs)から求めるため、
+     *              同じタイムベースを受信している全球体が同じ位相を描画する
+     */
+    void renderPatternAt(PatternId id, float progress, const SyncTimebase& timebase,
+                         uint32_t localMs, const PatternParams* customParams = nullptr);
+    void renderPatternAt(const std::string& patternName, float progress, const SyncTimebase& timebase,
+                         uint32_t localMs, const PatternParams* customParams = nullptr);
     
     // パラメータ管理
     PatternParams getDefaultParams() const;
@@ -359,6 +487,26 @@ public:
     
     // 現在のパターン名
     const std::string& getCurrentPatternName() const { return currentPatternName_; }
+    PatternId getCurrentPatternId() const { return currentPatternId_; }
+
+#ifdef UNIT_TEST
+    // ネイティブテスト用: LCDパターンはリンクされないため生成処理を差し替える
+    using FactoryForTest = std::function<std::unique_ptr<IPattern>(PatternId)>;
+    void setFactoryForTest(FactoryForTest factory) { factoryForTest_ = std::move(factory); }
+    size_t screenClearsForTest() const { return screenClears_; }
+    const std::vector<DisplayRect>& rectClearsForTest() const { return rectClears_; }
+#endif
+
+private:
+    std::unique_ptr<IPattern> instantiate(PatternId id) const;
+    void clearDisplay();
+    void clearDisplayRect(const DisplayRect& rect);
+
+#ifdef UNIT_TEST
+    FactoryForTest factoryForTest_;
+    size_t screenClears_ = 0;
+    std::vector<DisplayRect> rectClears_;
+#endif
 };
 
 /**
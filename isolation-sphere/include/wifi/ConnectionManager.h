@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Exponential backoff with jitter. Each delay is drawn from [d/2, d] where d
+// doubles from initialMs up to maxMs; the jitter keeps a fleet of spheres
+// from reconnecting in lock-step after the access point restarts.
+class ExponentialBackoff {
+ public:
+  ExponentialBackoff(uint32_t initialMs, uint32_t maxMs, uint32_t seed = 1);
+
+  uint32_t next();
+  void reset() { attempt_ = 0; }
+  void seed(uint32_t seed) { rng_ = seed != 0 ? seed : 1; }
+  uint32_t attempt() const { return attempt_; }
+
+ private:
+  uint32_t initialMs_;
+  uint32_t maxMs_;
+  uint32_t attempt_ = 0;
+  uint32_t rng_;
+};
+
+// Event-driven reconnection policy for the station link and the MQTT
+// session on top of it. Owns no radios or sockets: event callbacks (WiFi
+// driver task, AsyncMqttClient task) report link changes through
+// onWifiEvent()/onMqttEvent(), which only touch atomics, and Core0 calls
+// poll() once per loop. poll() returns the attempts to start now; between
+// attempts the loop does no WiFi or MQTT work at all.
+//
+// Per link: kWaiting --(backoff due)--> kConnecting --(up event)--> kUp.
+// A down event or attempt timeout goes back to kWaiting with the next
+// backoff delay; reaching kUp resets the backoff. MQTT is only attempted
+// while WiFi is up and restarts with a fresh backoff whenever WiFi returns.
+class ConnectionManager {
+ public:
+  enum class LinkState : uint8_t { kDisabled = 0, kWaiting, kConnecting, kUp };
+
+  enum Action : uint8_t {
+    kNone = 0,
+    kStartWifi = 1 << 0,  // WiFi.begin(ssid, password)
+    kStartMqtt = 1 << 1,  // MqttService::connect()
+  };
+
+  struct Options {
+    // false: WiFi is brought up elsewhere (or not at all); only its events
+    // are tracked to gate MQTT.
+    bool manageWifi = false;
+    bool mqttEnabled = false;
+    uint32_t seed = 1;  // jitter seed, e.g. a hash of the device name
+  };
+
+  struct Stats {
+    uint32_t wifiAttempts = 0;
+    uint32_t wifiDrops = 0;  // up -> down transitions
+    uint32_t mqttAttempts = 0;
+    uint32_t mqttDrops = 0;
+  };
+
+  static constexpr uint32_t kWifiBackoffInitialMs = 1000;
+  static constexpr uint32_t kWifiBackoffMaxMs = 30000;
+  static constexpr uint32_t kWifiAttemptTimeoutMs = 15000;
+  static constexpr uint32_t kMqttBackoffInitialMs = 500;
+  static constexpr uint32_t kMqttBackoffMaxMs = 30000;
+  static constexpr uint32_t kMqttAttemptTimeoutMs = 10000;
+
+  ConnectionManager();
+
+  // Restarts both links from kWaiting (first attempts are due immediately).
+  void configure(const Options &options);
+
+  // Thread-safe; callable from any task.
+  void onWifiEvent(bool up);
+  void onMqttEvent(bool up);
+
+  // Returns Action bits to perform now.
+  uint8_t poll(uint32_t nowMs);
+
+  LinkState wifiState() const { return wifi_.state; }
+  LinkState mqttState() const { return mqtt_.state; }
+  bool wifiUp() const { return wifi_.state == LinkState::kUp; }
+  bool mqttUp() const { return mqtt_.state == LinkState::kUp; }
+  // Delay until the next scheduled attempt of a waiting link (0 otherwise).
+  uint32_t wifiRetryInMs(uint32_t nowMs) const { return retryIn(wifi_, nowMs); }
+  uint32_t mqttRetryInMs(uint32_t nowMs) const { return retryIn(mqtt_, nowMs); }
+  Stats stats() const { return stats_; }
+
+ private:
+  struct Link {
+    Link(uint32_t initialMs, uint32_t maxMs) : backoff(initialMs, maxMs) {}
+    LinkState state = LinkState::kDisabled;
+    ExponentialBackoff backoff;
+    uint32_t deadlineMs = 0;  // next attempt (kWaiting) or attempt timeout (kConnecting)
+    uint32_t seenDowns = 0;
+  };
+
+  struct Observed {
+    std::atomic<bool> up{false};
+    std::atomic<uint32_t> downs{0};  // down events, so a bounce between polls is not missed
+  };
+
+  // Returns true when an attempt should start.
+  static bool step(Link &link, bool enabled, bool mayAttempt, const Observed &observed, uint32_t nowMs,
+                   uint32_t timeoutMs, uint32_t &drops);
+  static uint32_t retryIn(const Link &link, uint32_t nowMs);
+
+  Options options_;
+  Link wifi_;
+  Link mqtt_;
+  Observed wifiObserved_;
+  Observed mqttObserved_;
+  Stats stats_;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+// Sequence and delay bookkeeping for a datagram control link.
+//
+// - Sequence numbers are 16-bit and compared with wrap-around. Packets older
+//   than the newest accepted one (reordered or duplicated) are rejected so a
+//   late packet can never roll the posture back. A jump of more than
+//   kResyncDistance backwards is treated as a sender restart.
+// - Gaps count as lost; a late packet that fills a gap is moved from "lost"
+//   to "reordered".
+// - Sender and receiver clocks are not synchronized, so absolute one-way
+//   latency is unknown. Instead the monitor tracks the transit time
+//   (receive - send timestamp) relative to the best one seen recently; the
+//   excess is the queueing delay the packet picked up (delay variation).
+class ControlLinkMonitor {
+ public:
+  enum class Verdict : uint8_t { kAccept, kDuplicate, kStale };
+
+  struct Stats {
+    uint32_t accepted = 0;
+    uint32_t duplicates = 0;
+    uint32_t reordered = 0;
+    uint32_t lost = 0;
+    uint32_t resyncs = 0;
+    uint32_t delayAvgMs = 0;  // mean excess transit over the current window
+    uint32_t delayMaxMs = 0;
+    uint32_t lastAcceptMs = 0;
+    uint16_t lastSequence = 0;
+  };
+
+  static constexpr int32_t kResyncDistance = 1024;
+  static constexpr uint32_t kDelayWindow = 256;  // ~8 s at 30 Hz
+
+  Verdict onPacket(uint16_t sequence, uint32_t senderTimestampMs, uint32_t nowMs);
+  void reset();
+
+  Stats stats() const;
+  float lossRatio() const;
+
+ private:
+  void recordDelay(uint32_t senderTimestampMs, uint32_t nowMs);
+
+  bool started_ = false;
+  uint16_t lastSequence_ = 0;
+  uint32_t lastAcceptMs_ = 0;
+  uint32_t accepted_ = 0;
+  uint32_t duplicates_ = 0;
+  uint32_t reordered_ = 0;
+  uint32_t lost_ = 0;
+  uint32_t resyncs_ = 0;
+
+  bool hasBaseline_ = false;
+  int32_t baselineTransit_ = 0;  // best transit of the previous window
+  int32_t windowMinTransit_ = 0;
+  uint32_t windowCount_ = 0;
+  uint64_t windowDelaySum_ = 0;
+  uint32_t windowDelayMax_ = 0;
+  uint32_t delayAvgMs_ = 0;
+  uint32_t delayMaxMs_ = 0;
+};
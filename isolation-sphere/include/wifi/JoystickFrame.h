@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/RemoteControl.h"
+
+// Binary joystick frames broadcast by the Atom joystick (UDP port 1884).
+// Same layout as atom-joystick/atom_joystick_main/joystick_frame.h; keep the
+// two in step.
+//
+//   off size field
+//     0    2 magic "JS"
+//     2    1 version (kVersion)
+//     3    1 buttons (kButton* bits)
+//     4    2 sequence
+//     6    2 battery mV
+//     8    4 sender timestamp ms
+//    12    8 axes int16 x4 (left X, left Y, right X, right Y), +-32767
+//    20    2 CRC-16/CCITT-FALSE over bytes 0..19
+namespace joystick {
+
+constexpr uint8_t kMagic0 = 'J';
+constexpr uint8_t kMagic1 = 'S';
+constexpr uint8_t kVersion = 1;
+constexpr size_t kFrameSize = 22;
+constexpr uint16_t kDefaultPort = 1884;
+
+enum Button : uint8_t {
+  kButtonLeftStick = 0x01,
+  kButtonRightStick = 0x02,
+  kButtonA = 0x04,
+  kButtonB = 0x08,
+};
+
+struct Frame {
+  uint16_t sequence = 0;
+  uint8_t buttons = 0;
+  uint16_t batteryMv = 0;
+  uint32_t timestampMs = 0;
+  int16_t leftX = 0;
+  int16_t leftY = 0;
+  int16_t rightX = 0;
+  int16_t rightY = 0;
+};
+
+// True if the payload starts with the joystick magic (cheap dispatch check).
+inline bool isFrame(const uint8_t *data, size_t length) {
+  return data != nullptr && length >= 2 && data[0] == kMagic0 && data[1] == kMagic1;
+}
+
+// Writes kFrameSize bytes; returns the number written (0 if out is too small).
+size_t encode(const Frame &frame, uint8_t *out, size_t capacity);
+
+// Returns false for short payloads, wrong magic/version or a CRC mismatch.
+// Longer payloads are accepted; the tail is ignored.
+bool decode(const uint8_t *data, size_t length, Frame &out);
+
+// Left stick steers the posture offsets at up to kRateDegPerSec (X:
+// longitude, Y: latitude), integrated over the sender's frame interval.
+// Pressing the left stick recenters both offsets.
+constexpr float kRateDegPerSec = 90.0f;
+constexpr float kDeadzone = 0.1f;
+constexpr uint32_t kMaxStepMs = 100;  // cap after gaps so a lost burst doesn't jump
+
+// Applies one accepted frame; elapsedMs is the sender time since the previous
+// accepted frame. Returns false if the posture did not change.
+bool apply(const Frame &frame, uint32_t elapsedMs, RemoteControl &control, uint32_t nowMs);
+
+}  // namespace joystick
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "core/RemoteControl.h"
+#include "core/SeqLock.h"
+#include "core/SharedState.h"
+#include "mqtt/ControlProtocol.h"
+#include "wifi/ControlLinkMonitor.h"
+#include "wifi/JoystickFrame.h"
+
+#ifdef ARDUINO
+#include <AsyncUDP.h>
+#endif
+
+// Low-latency control path over UDP. Two datagram formats are accepted:
+// - control::Message records (the same 20-byte binary record as the MQTT
+//   "/bin" topics) on the control port;
+// - joystick::Frame broadcasts from the Atom joystick on the joystick port.
+//   The left stick steers the posture offsets (see joystick::apply).
+//
+// Packets are handled in the UDP receive callback and written straight into
+// SharedState's lock-free RemoteControl slot (ControlSource::kUdp), so the
+// render loop sees a new posture on its next frame without going through
+// TCP or a polling loop. Stale or reordered packets (by sequence number) are
+// dropped; loss and delay variation are tracked by ControlLinkMonitor, one
+// per sender format.
+//
+// Threading: all receive-side state belongs to the AsyncUDP task. Counters
+// are published through a SeqLock after each packet, so stats() is safe to
+// call from other tasks (Core0 logging, the metrics sampler).
+class UdpControlChannel {
+ public:
+  struct Stats {
+    ControlLinkMonitor::Stats link;      // control records
+    ControlLinkMonitor::Stats joystick;  // joystick frames
+    uint32_t packets = 0;
+    uint32_t malformed = 0;
+    uint32_t commands = 0;
+  };
+
+  explicit UdpControlChannel(SharedState &sharedState) : sharedState_(sharedState) {}
+
+  // joystickPort 0 (or equal to port) listens on a single socket; both
+  // formats are accepted on every listening port.
+  bool begin(uint16_t port, uint16_t joystickPort = 0);
+  void stop();
+  bool isListening() const { return listening_; }
+  uint16_t port() const { return port_; }
+  uint16_t joystickPort() const { return joystickPort_; }
+
+  // Processes one datagram. Called from the UDP callback; public for tests.
+  void handlePacket(const uint8_t *data, size_t length, uint32_t nowMs);
+
+  Stats stats() const;
+
+ private:
+  void handleControl(const uint8_t *data, size_t length, uint32_t nowMs);
+  void handleJoystick(const uint8_t *data, size_t length, uint32_t nowMs);
+
+  SharedState &sharedState_;
+  // Receive side (AsyncUDP task only).
+  ControlLinkMonitor monitor_;
+  ControlLinkMonitor joystickMonitor_;
+  RemoteControl control_{};
+  Stats counters_{};
+  bool hasJoystickTime_ = false;
+  uint32_t lastJoystickMs_ = 0;
+  // Published copy of counters_ and the monitors.
+  SeqLock<Stats> stats_;
+
+  uint16_t port_ = 0;
+  uint16_t joystickPort_ = 0;
+  bool listening_ = false;
+#ifdef ARDUINO
+  AsyncUDP udp_;
+  AsyncUDP joystickUdp_;
+#endif
+};
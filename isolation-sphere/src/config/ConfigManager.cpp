@@ -233,6 +233,46 @@ bool ConfigManager::load(const char *path) {
     config_.ota = ConfigManager::OtaConfig{};
   }
 
+  const JsonVariantConst udpControl = doc["udp_control"];
+  if (!udpControl.isNull()) {
+    config_.udpControl.enabled = safeBool(udpControl["enabled"], config_.udpControl.enabled);
+    config_.udpControl.port = safeUint16(udpControl["port"], config_.udpControl.port);
+    config_.udpControl.joystickPort = safeUint16(udpControl["joystick_port"], config_.udpControl.joystickPort);
+  } else {
+    config_.udpControl = ConfigManager::UdpControlConfig{};
+  }
+
+  const JsonVariantConst sync = doc["sync"];
+  if (!sync.isNull()) {
+    config_.sync.enabled = safeBool(sync["enabled"], config_.sync.enabled);
+    config_.sync.master = safeBool(sync["master"], config_.sync.master);
+    config_.sync.fps = safeUint16(sync["fps"], config_.sync.fps);
+    if (config_.sync.fps == 0) {
+      config_.sync.fps = ConfigManager::SyncConfig{}.fps;
+    }
+    config_.sync.beaconIntervalMs = safeUint32(sync["beacon_interval_ms"], config_.sync.beaconIntervalMs);
+  } else {
+    config_.sync = ConfigManager::SyncConfig{};
+  }
+
+  const JsonVariantConst movie = doc["movie"];
+  if (!movie.isNull()) {
+    config_.movie.pack = safeString(movie["pack"]);
+    const std::string playMode = safeString(movie["play_mode"]);
+    config_.movie.loop = playMode.empty() || playMode == "loop";
+  } else {
+    config_.movie = ConfigManager::MovieConfig{};
+  }
+
+  const JsonVariantConst telemetry = doc["telemetry"];
+  if (!telemetry.isNull()) {
+    config_.telemetry.enabled = safeBool(telemetry["enabled"], config_.telemetry.enabled);
+    config_.telemetry.intervalMs = safeUint32(telemetry["interval_ms"], config_.telemetry.intervalMs);
+    config_.telemetry.topic = safeString(telemetry["topic"]);
+  } else {
+    config_.telemetry = ConfigManager::TelemetryConfig{};
+  }
+
   JsonVariantConst uiContainer = getObjectMember(sphere, "ui");
   if (uiContainer.isNull()) {
     uiContainer = doc["ui"];
@@ -6,6 +6,7 @@
 #include <M5Unified.h>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <utility>
 
 namespace {
@@ -63,7 +64,8 @@ Core0Task::Core0Task(const TaskConfig &config,
       configManager_(configManager),
       storageManager_(storageManager),
       sharedState_(sharedState),
-      mqttService_(sharedState) {}
+      mqttService_(sharedState),
+      udpControl_(sharedState) {}
 
 Core0Task::~Core0Task() {
   if (wifiManager_) {
@@ -102,9 +104,62 @@ void Core0Task::setup() {
     Serial.println("[Core0] MqttBroker allocated");
   }
   
+  // Link events only record state; serviceConnections() reacts on this task
+  WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t /*info*/) {
+    switch (event) {
+      case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        connection_.onWifiEvent(true);
+        break;
+      case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+      case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+        connection_.onWifiEvent(false);
+        break;
+      default:
+        break;
+    }
+  });
+  mqttService_.setConnectionListener([this](bool connected) { connection_.onMqttEvent(connected); });
+
+  registerMetrics();
   Serial.println("[Core0] Task setup complete");
 }
 
+void Core0Task::registerMetrics() {
+  // Sampled by MqttService::publishMetrics(), which runs on this task, so
+  // the broker and UDP stats are read from their owning thread.
+  MetricsRegistry &metrics = sharedState_.metrics();
+  MetricsRegistry::Gauge *heapFree = metrics.gauge("heap_free");
+  MetricsRegistry::Gauge *heapMin = metrics.gauge("heap_min");
+  MetricsRegistry::Gauge *psramFree = metrics.gauge("psram_free");
+  MetricsRegistry::Gauge *brokerClients = metrics.gauge("brk_clients");
+  MetricsRegistry::Counter *brokerDropped = metrics.counter("brk_drop");
+  MetricsRegistry::Counter *brokerSlow = metrics.counter("brk_slow");
+  MetricsRegistry::Counter *udpPackets = metrics.counter("udp_rx", MetricsRegistry::CounterRate::kPerSecond);
+  MetricsRegistry::Counter *udpLost = metrics.counter("udp_lost");
+  MetricsRegistry::Gauge *imuRetries = metrics.gauge("imu_retries");
+  MetricsRegistry::Counter *wifiDrops = metrics.counter("wifi_drops");
+  MetricsRegistry::Counter *mqttDrops = metrics.counter("mqtt_drops");
+
+  metrics.addSampler([=]() {
+    if (heapFree) heapFree->set(static_cast<float>(ESP.getFreeHeap()));
+    if (heapMin) heapMin->set(static_cast<float>(ESP.getMinFreeHeap()));
+    if (psramFree) psramFree->set(static_cast<float>(ESP.getFreePsram()));
+    if (mqttBroker_ && mqttBrokerConfigured_) {
+      const MqttBroker::Stats broker = mqttBroker_->getStats();
+      if (brokerClients) brokerClients->set(static_cast<float>(broker.connectedClients));
+      if (brokerDropped) brokerDropped->set(broker.dropped);
+      if (brokerSlow) brokerSlow->set(broker.slowClientsClosed);
+    }
+    const UdpControlChannel::Stats udp = udpControl_.stats();
+    if (udpPackets) udpPackets->set(udp.packets);
+    if (udpLost) udpLost->set(udp.link.lost + udp.joystick.lost);
+    if (imuRetries) imuRetries->set(static_cast<float>(sharedState_.imuReadRetries()));
+    const ConnectionManager::Stats links = connection_.stats();
+    if (wifiDrops) wifiDrops->set(links.wifiDrops);
+    if (mqttDrops) mqttDrops->set(links.mqttDrops);
+  });
+}
+
 void Core0Task::loop() {
   if (!configLoaded_) {
     // StorageManagerをバイパスして直接LittleFSからconfig.jsonを読み込み
@@ -120,31 +175,33 @@ void Core0Task::loop() {
       Serial.println("[Core0] Config file not found: /config.json");
     }
   }
-  
+
   if (configLoaded_) {
     const auto &cfg = configManager_.config();
-    
-    // WiFiManager設定（1回だけ実行）
-    if (wifiManager_ && !wifiConfigured_) {
-      if (wifiManager_->initialize(cfg)) {
-        wifiConfigured_ = true;
-        Serial.println("[Core0] WiFiManager initialized successfully");
-      } else {
-        Serial.println("[Core0] WiFiManager initialization failed");
-      }
+    const uint32_t now = millis();
+
+    // Services are (re)configured only when a new config is published
+    const std::uint32_t generation = sharedState_.configGeneration();
+    if (generation != appliedConfigGeneration_) {
+      appliedConfigGeneration_ = generation;
+      applyConfig(cfg);
     }
-    
+
+    serviceConnections(now);
+
     // WiFiManagerループ処理
     if (wifiManager_ && wifiConfigured_) {
       wifiManager_->loop();
     }
-    
-    // MqttBroker設定（WiFi初期化後、1回だけ実行）
-    if (mqttBroker_ && !mqttBrokerConfigured_ && wifiConfigured_) {
+
+    // MqttBroker設定（WiFi初期化後、失敗時は間隔を空けて再試行）
+    if (mqttBroker_ && !mqttBrokerConfigured_ && wifiConfigured_ &&
+        static_cast<int32_t>(now - nextBrokerRetryMs_) >= 0) {
       if (mqttBroker_->applyConfig(cfg)) {
         mqttBrokerConfigured_ = true;
         Serial.println("[Core0] MqttBroker initialized successfully");
       } else {
+        nextBrokerRetryMs_ = now + kServiceRetryMs;
         Serial.println("[Core0] MqttBroker initialization failed");
       }
     }
@@ -155,13 +212,13 @@ void Core0Task::loop() {
     }
     
     if (!otaInitialized_) {
-      uint32_t now = millis();
-      if (now >= nextOtaRetryMs_) {
+      // OTAはWiFi接続済みのときだけ試行する
+      if (connection_.wifiUp() && static_cast<int32_t>(now - nextOtaRetryMs_) >= 0) {
         if (otaService_.begin(cfg)) {
           otaInitialized_ = true;
           Serial.println("[Core0] OTA service initialized");
         } else {
-          nextOtaRetryMs_ = now + 5000;
+          nextOtaRetryMs_ = now + kServiceRetryMs;
           Serial.println("[Core0] OTA initialization failed, retrying in 5s");
         }
       }
@@ -174,12 +231,13 @@ void Core0Task::loop() {
       }
     }
 
-    mqttConfigured_ = mqttService_.applyConfig(cfg);
+    updateUdpControl(cfg);
+
     mqttService_.loop();
     if (mqttConfigured_) {
-      std::string outgoingCommand;
-      if (sharedState_.popUiCommand(outgoingCommand, false)) {
-        mqttService_.publishUiEvent(outgoingCommand);
+      UiCommand outgoingCommand;
+      while (sharedState_.popUiCommand(outgoingCommand, false)) {
+        mqttService_.publishUiEvent(outgoingCommand.text());
       }
     }
   } else {
@@ -188,8 +246,92 @@ void Core0Task::loop() {
   sleep(config().loopIntervalMs);
 }
 
+void Core0Task::applyConfig(const ConfigManager::Config &cfg) {
+  // WiFiManager設定（1回だけ実行）
+  if (wifiManager_ && !wifiConfigured_) {
+    if (wifiManager_->initialize(cfg)) {
+      wifiConfigured_ = true;
+      Serial.println("[Core0] WiFiManager initialized successfully");
+    } else {
+      Serial.println("[Core0] WiFiManager initialization failed");
+    }
+  }
+
+  mqttConfigured_ = mqttService_.applyConfig(cfg);
+  mqttBrokerConfigured_ = false;
+  nextBrokerRetryMs_ = millis();
+
+  ConnectionManager::Options options;
+  options.manageWifi = cfg.wifi.enabled && !cfg.wifi.ssid.empty();
+  options.mqttEnabled = mqttConfigured_;
+  // Per-device jitter seed so spheres sharing an AP do not retry in step
+  options.seed = TopicRouter::hash(cfg.system.name.data(), cfg.system.name.size()) ^
+                 static_cast<uint32_t>(ESP.getEfuseMac());
+  connection_.configure(options);
+  stationSsid_ = cfg.wifi.ssid;
+  stationPassword_ = cfg.wifi.password;
+  Serial.printf("[Core0] Config generation %lu applied (wifi %s, mqtt %s)\n",
+                static_cast<unsigned long>(appliedConfigGeneration_), options.manageWifi ? "managed" : "external",
+                options.mqttEnabled ? "on" : "off");
+}
+
+void Core0Task::serviceConnections(uint32_t now) {
+  const ConnectionManager::Stats before = connection_.stats();
+  const uint8_t actions = connection_.poll(now);
+  const ConnectionManager::Stats after = connection_.stats();
+  if (after.wifiDrops != before.wifiDrops) {
+    Serial.printf("[Core0][Net] WiFi lost, retry in %lu ms\n",
+                  static_cast<unsigned long>(connection_.wifiRetryInMs(now)));
+  }
+  if (after.mqttDrops != before.mqttDrops) {
+    Serial.printf("[Core0][Net] MQTT lost, retry in %lu ms\n",
+                  static_cast<unsigned long>(connection_.mqttRetryInMs(now)));
+  }
+  if (actions & ConnectionManager::kStartWifi) {
+    Serial.printf("[Core0][Net] WiFi connect attempt %lu to %s\n", static_cast<unsigned long>(after.wifiAttempts),
+                  stationSsid_.c_str());
+    WiFi.mode(WIFI_STA);
+    // The connection manager owns retries; the driver's own reconnect loop
+    // would race it after an AP restart.
+    WiFi.setAutoReconnect(false);
+    WiFi.begin(stationSsid_.c_str(), stationPassword_.c_str());
+  }
+  if (actions & ConnectionManager::kStartMqtt) {
+    mqttService_.connect();
+  }
+}
+
+void Core0Task::updateUdpControl(const ConfigManager::Config &cfg) {
+  if (!cfg.udpControl.enabled || !connection_.wifiUp()) {
+    if (udpControl_.isListening()) {
+      udpControl_.stop();
+    }
+    return;
+  }
+  const uint16_t joystickPort = cfg.udpControl.joystickPort == cfg.udpControl.port ? 0 : cfg.udpControl.joystickPort;
+  if (!udpControl_.isListening() || udpControl_.port() != cfg.udpControl.port ||
+      udpControl_.joystickPort() != joystickPort) {
+    udpControl_.begin(cfg.udpControl.port, joystickPort);
+  }
+
+  const uint32_t now = millis();
+  if (now - lastUdpStatsLogMs_ >= kUdpStatsLogIntervalMs) {
+    lastUdpStatsLogMs_ = now;
+    const UdpControlChannel::Stats stats = udpControl_.stats();
+    if (stats.packets != 0) {
+      Serial.printf("[Core0][UDP] packets=%lu accepted=%lu joystick=%lu lost=%lu reordered=%lu delay avg/max=%lu/%lu ms\n",
+                    static_cast<unsigned long>(stats.packets), static_cast<unsigned long>(stats.link.accepted),
+                    static_cast<unsigned long>(stats.joystick.accepted),
+                    static_cast<unsigned long>(stats.link.lost + stats.joystick.lost),
+                    static_cast<unsigned long>(stats.link.reordered + stats.joystick.reordered),
+                    static_cast<unsigned long>(std::max(stats.link.delayAvgMs, stats.joystick.delayAvgMs)),
+                    static_cast<unsigned long>(std::max(stats.link.delayMaxMs, stats.joystick.delayMaxMs)));
+    }
+  }
+}
+
 Core1Task::Core1Task(const TaskConfig &config, SharedState &sharedState)
-    : CoreTask(config), sharedState_(sharedState) {}
+    : CoreTask(config), sharedState_(sharedState), renderLoop_(sharedState) {}
 
 Core1Task::~Core1Task() {
   if (buzzerService_) {
@@ -274,11 +416,12 @@ void Core1Task::configureBuzzer(const ConfigManager::Config &cfg) {
 
 void Core1Task::setup() {
   Serial.println("[Core1] Task setup starting...");
+
+  imuReadsMetric_ = sharedState_.metrics().counter("imu_reads", MetricsRegistry::CounterRate::kPerSecond);
+  imuFailuresMetric_ = sharedState_.metrics().counter("imu_fail");
+  renderLoop_.attachMetrics(sharedState_.metrics());
   
-  ConfigManager::Config cfg;
-  if (sharedState_.getConfigCopy(cfg)) {
-    configureBuzzer(cfg);
-  } else {
+  if (!refreshConfig()) {
     Serial.println("[Core1] Config not available for BuzzerService initialization");
   }
   
@@ -286,50 +429,93 @@ void Core1Task::setup() {
   sharedState_.setUiMode(false);
 }
 
+bool Core1Task::refreshConfig() {
+  // Lock-free check; the snapshot is only fetched (and settings re-derived)
+  // when Core0 has published a new config.
+  if (sharedState_.configGeneration() == appliedConfigGeneration_) {
+    return configSnapshot_ != nullptr;
+  }
+  std::uint32_t generation = 0;
+  SharedState::ConfigSnapshot snapshot;
+  if (!sharedState_.getConfigSnapshot(snapshot, &generation)) {
+    return false;
+  }
+  configSnapshot_ = std::move(snapshot);
+  appliedConfigGeneration_ = generation;
+  applyConfig(*configSnapshot_);
+  return true;
+}
+
+void Core1Task::applyConfig(const ConfigManager::Config &cfg) {
+  configureBuzzer(cfg);
+
+  uiConfig_ = cfg.ui;
+  uiGestureEnabled_ = cfg.ui.gestureEnabled;
+
+  if (!renderLoop_.ready() && !renderLoop_.begin(cfg)) {
+    Serial.println("[Core1] LED strips not configured, render loop idle");
+  }
+
+  if (!displayedConfig_) {
+    Serial.printf("[Core1] Config name=%s\n", cfg.system.name.c_str());
+    displayedConfig_ = true;
+  }
+
+  if (cfg.imu.enabled) {
+    if (!imuEnabled_) {
+      Serial.println("[Core1] IMU enabled via config");
+      imuEnabled_ = true;
+      imuInitialized_ = false;
+      nextImuRetryMs_ = 0;
+    }
+
+    imuIntervalMs_ = cfg.imu.updateIntervalMs == 0 ? 0 : cfg.imu.updateIntervalMs;
+    imuDebugLogging_ = cfg.imu.gestureDebugLog;
+    imuConfig_ = cfg.imu;
+    gestureUiModeEnabled_ = cfg.imu.gestureUiMode;
+    gestureThresholdMps2_ = (cfg.imu.gestureThresholdMps2 > 0.0f)
+                                ? cfg.imu.gestureThresholdMps2
+                                : kDefaultShakeThresholdMps2_;
+    gestureWindowMs_ = (cfg.imu.gestureWindowMs > 0)
+                           ? cfg.imu.gestureWindowMs
+                           : kDefaultShakeWindowMs_;
+    if (!gestureUiModeEnabled_) {
+      shakeEventCount_ = 0;
+      shakeFirstEventMs_ = 0;
+      shakeLastPeakMs_ = 0;
+    }
+  } else {
+    if (imuEnabled_) {
+      Serial.println("[Core1] IMU disabled via config");
+    }
+    imuEnabled_ = false;
+    imuInitialized_ = false;
+    nextImuRetryMs_ = 0;
+    imuDebugLogging_ = false;
+    gestureUiModeEnabled_ = false;
+    shakeEventCount_ = 0;
+    shakeFirstEventMs_ = 0;
+    shakeLastPeakMs_ = 0;
+  }
+}
+
 void Core1Task::loop() {
-  ConfigManager::Config cfg;
-  const bool haveConfig = sharedState_.getConfigCopy(cfg);
+  const bool haveConfig = refreshConfig();
   const std::uint32_t now = millis();
   if (haveConfig) {
-    configureBuzzer(cfg);
+    // Retry a buzzer that failed to start with the current config
+    if (buzzerEnabled_ && !buzzerInitialized_) {
+      configureBuzzer(*configSnapshot_);
+    }
 
-    uiConfig_ = cfg.ui;
-    uiGestureEnabled_ = cfg.ui.gestureEnabled;
     if (!uiGestureEnabled_ && uiModeActive_) {
       exitUiMode();
     }
 
-    if (!displayedConfig_) {
-      Serial.printf("[Core1] Config name=%s\n", cfg.system.name.c_str());
-      displayedConfig_ = true;
-    }
-
-    if (cfg.imu.enabled) {
-      if (!imuEnabled_) {
-        Serial.println("[Core1] IMU enabled via config");
-        imuEnabled_ = true;
-        imuInitialized_ = false;
-        nextImuRetryMs_ = 0;
-      }
-
-      imuIntervalMs_ = cfg.imu.updateIntervalMs == 0 ? 0 : cfg.imu.updateIntervalMs;
-      imuDebugLogging_ = cfg.imu.gestureDebugLog;
-      imuConfig_ = cfg.imu;
-      gestureUiModeEnabled_ = cfg.imu.gestureUiMode;
-      gestureThresholdMps2_ = (cfg.imu.gestureThresholdMps2 > 0.0f)
-                                  ? cfg.imu.gestureThresholdMps2
-                                  : kDefaultShakeThresholdMps2_;
-      gestureWindowMs_ = (cfg.imu.gestureWindowMs > 0)
-                             ? cfg.imu.gestureWindowMs
-                             : kDefaultShakeWindowMs_;
-      if (!gestureUiModeEnabled_) {
-        shakeEventCount_ = 0;
-        shakeFirstEventMs_ = 0;
-        shakeLastPeakMs_ = 0;
-        if (uiModeActive_) {
-          uiModeActive_ = false;
-          sharedState_.setUiMode(uiModeActive_);
-        }
+    if (imuEnabled_) {
+      if (!gestureUiModeEnabled_ && uiModeActive_) {
+        uiModeActive_ = false;
+        sharedState_.setUiMode(uiModeActive_);
       }
 
       if (!imuInitialized_ && now >= nextImuRetryMs_) {
@@ -344,18 +530,6 @@ void Core1Task::loop() {
           Serial.println("[Core1] IMU initialization failed, retry scheduled");
         }
       }
-    } else {
-      if (imuEnabled_) {
-        Serial.println("[Core1] IMU disabled via config");
-      }
-      imuEnabled_ = false;
-      imuInitialized_ = false;
-      nextImuRetryMs_ = 0;
-      imuDebugLogging_ = false;
-      gestureUiModeEnabled_ = false;
-      shakeEventCount_ = 0;
-      shakeFirstEventMs_ = 0;
-      shakeLastPeakMs_ = 0;
     }
   }
 
@@ -365,6 +539,9 @@ void Core1Task::loop() {
       if (imuService_.read(reading)) {
         lastImuReading_ = reading;
         sharedState_.updateImuReading(reading);
+        if (imuReadsMetric_) {
+          imuReadsMetric_->add();
+        }
         if (gestureUiModeEnabled_) {
           handleShakeGesture(reading);
         }
@@ -379,8 +556,13 @@ void Core1Task::loop() {
                         reading.qz,
                         static_cast<unsigned long>(reading.timestampMs));
         }
-      } else if (imuDebugLogging_) {
-        Serial.println("[Core1][IMU] read failed");
+      } else {
+        if (imuFailuresMetric_) {
+          imuFailuresMetric_->add();
+        }
+        if (imuDebugLogging_) {
+          Serial.println("[Core1][IMU] read failed");
+        }
       }
       lastImuReadMs_ = now;
     }
@@ -389,6 +571,7 @@ void Core1Task::loop() {
     }
   }
   processIncomingUiCommands();
+  renderLoop_.tick(now);
   sleep(config().loopIntervalMs);
 }
 
@@ -510,28 +693,38 @@ void Core1Task::updateUiReference(const ImuService::Reading &reading) {
   uiReferenceYaw_ = quaternionToYaw(reading);
 }
 
-void Core1Task::handleUiCommand(const std::string &command, bool external) {
-  if (command == "ui:x_pos") {
-    Serial.printf("[Core1][UI] Next content requested (%s)\n", external ? "external" : "local");
-  } else if (command == "ui:x_neg") {
-    Serial.printf("[Core1][UI] Play/Pause toggle (%s)\n", external ? "external" : "local");
-  } else if (command == "ui:mode:on") {
-    if (!uiModeActive_) {
-      enterUiMode();
-    }
-  } else if (command == "ui:mode:off") {
-    if (uiModeActive_) {
-      exitUiMode();
-    }
+void Core1Task::handleUiCommand(const UiCommand &command, bool external) {
+  switch (command.type) {
+    case UiCommandType::kNextContent:
+      Serial.printf("[Core1][UI] Next content requested (%s)\n", external ? "external" : "local");
+      break;
+    case UiCommandType::kPlayPause:
+      Serial.printf("[Core1][UI] Play/Pause toggle (%s)\n", external ? "external" : "local");
+      break;
+    case UiCommandType::kModeOn:
+      if (!uiModeActive_) {
+        enterUiMode();
+      }
+      break;
+    case UiCommandType::kModeOff:
+      if (uiModeActive_) {
+        exitUiMode();
+      }
+      break;
+    case UiCommandType::kRaw:
+      break;
   }
 }
 
 void Core1Task::triggerLocalUiCommand(const char *command) {
-  if (command == nullptr) {
+  UiCommand record;
+  if (command == nullptr || !makeUiCommand(command, std::strlen(command), record)) {
     return;
   }
-  sharedState_.pushUiCommand(command, false);
-  handleUiCommand(command, false);
+  if (!sharedState_.pushUiCommand(record, false)) {
+    Serial.printf("[Core1][UI] Outgoing UI queue full, dropped %s\n", command);
+  }
+  handleUiCommand(record, false);
 }
 
 void Core1Task::applyUiBrightnessSettings(bool entering) {
@@ -551,8 +744,10 @@ void Core1Task::applyUiBrightnessSettings(bool entering) {
 }
 
 void Core1Task::processIncomingUiCommands() {
-  std::string command;
-  if (sharedState_.popUiCommand(command, true)) {
+  // Drain everything queued since the last loop so bursts are not spread
+  // over several frames.
+  UiCommand command;
+  while (sharedState_.popUiCommand(command, true)) {
     handleUiCommand(command, true);
   }
 }
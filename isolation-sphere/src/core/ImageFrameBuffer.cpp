@@ -0,0 +1,206 @@
+#include "core/ImageFrameBuffer.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "esp_heap_caps.h"
+#endif
+
+namespace {
+
+uint8_t *allocateSlot(size_t bytes) {
+  void *p = nullptr;
+#ifdef ARDUINO_ARCH_ESP32
+  p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+#endif
+  if (p == nullptr) {
+    p = malloc(bytes);
+  }
+  return static_cast<uint8_t *>(p);
+}
+
+}  // namespace
+
+ImageFrameBuffer::~ImageFrameBuffer() { release(); }
+
+bool ImageFrameBuffer::allocate(size_t slotCapacity) {
+  if (slotCapacity == 0) {
+    return false;
+  }
+  if (slotCapacity == slotCapacity_) {
+    return true;
+  }
+  for (const Slot &slot : slots_) {
+    if (slot.state.load(std::memory_order_acquire) == kReading) {
+      return false;
+    }
+  }
+  release();
+  for (Slot &slot : slots_) {
+    slot.data = allocateSlot(slotCapacity);
+    if (slot.data == nullptr) {
+      release();
+      return false;
+    }
+  }
+  slotCapacity_ = slotCapacity;
+  return true;
+}
+
+void ImageFrameBuffer::release() {
+  for (Slot &slot : slots_) {
+    free(slot.data);
+    slot.data = nullptr;
+    slot.size = 0;
+    slot.state.store(kFree, std::memory_order_release);
+  }
+  slotCapacity_ = 0;
+  writeSlot_ = -1;
+}
+
+bool ImageFrameBuffer::beginFrame(size_t totalSize, uint8_t source) {
+  if (writeSlot_ >= 0) {
+    // The previous frame never received its last fragment
+    abortFrame();
+  }
+  if (!isAllocated() || totalSize == 0) {
+    return false;
+  }
+  if (totalSize > slotCapacity_) {
+    framesOversize_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  int chosen = -1;
+  for (size_t i = 0; i < kSlotCount && chosen < 0; ++i) {
+    uint8_t expected = kFree;
+    if (slots_[i].state.compare_exchange_strong(expected, kWriting, std::memory_order_acq_rel)) {
+      chosen = static_cast<int>(i);
+    }
+  }
+  // No free slot: the other one is being read, so replace the unconsumed frame
+  for (size_t i = 0; i < kSlotCount && chosen < 0; ++i) {
+    uint8_t expected = kReady;
+    if (slots_[i].state.compare_exchange_strong(expected, kWriting, std::memory_order_acq_rel)) {
+      framesDropped_.fetch_add(1, std::memory_order_relaxed);
+      chosen = static_cast<int>(i);
+    }
+  }
+  if (chosen < 0) {
+    framesAborted_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  writeSlot_ = chosen;
+  writeTotal_ = totalSize;
+  writeOffset_ = 0;
+  writeSource_ = source;
+  return true;
+}
+
+bool ImageFrameBuffer::writeFragment(size_t offset, const uint8_t *data, size_t length) {
+  if (writeSlot_ < 0) {
+    return false;
+  }
+  if (offset != writeOffset_ || length > writeTotal_ - writeOffset_ || (data == nullptr && length != 0)) {
+    abortFrame();
+    return false;
+  }
+  if (length != 0) {
+    std::memcpy(slots_[writeSlot_].data + offset, data, length);
+    writeOffset_ += length;
+    bytesReceived_.fetch_add(static_cast<uint32_t>(length), std::memory_order_relaxed);
+  }
+  if (writeOffset_ == writeTotal_) {
+    completeFrame();
+  }
+  return true;
+}
+
+void ImageFrameBuffer::abortFrame() {
+  if (writeSlot_ < 0) {
+    return;
+  }
+  slots_[writeSlot_].state.store(kFree, std::memory_order_release);
+  writeSlot_ = -1;
+  framesAborted_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ImageFrameBuffer::completeFrame() {
+  Slot &slot = slots_[writeSlot_];
+  slot.size = writeTotal_;
+  slot.sequence = nextSequence_++;
+  slot.source = writeSource_;
+
+  // Keep at most one ready frame so the consumer never sees them out of order
+  for (size_t i = 0; i < kSlotCount; ++i) {
+    if (static_cast<int>(i) == writeSlot_) {
+      continue;
+    }
+    uint8_t expected = kReady;
+    if (slots_[i].state.compare_exchange_strong(expected, kFree, std::memory_order_acq_rel)) {
+      framesDropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  slot.state.store(kReady, std::memory_order_release);
+  framesCompleted_.fetch_add(1, std::memory_order_relaxed);
+
+  Frame frame;
+  frame.data = slot.data;
+  frame.size = slot.size;
+  frame.sequence = slot.sequence;
+  frame.source = slot.source;
+  frame.slot = static_cast<uint8_t>(writeSlot_);
+  writeSlot_ = -1;
+
+  if (listener_) {
+    listener_(frame);
+  }
+}
+
+bool ImageFrameBuffer::acquire(Frame &out) {
+  for (size_t i = 0; i < kSlotCount; ++i) {
+    uint8_t expected = kReady;
+    if (slots_[i].state.compare_exchange_strong(expected, kReading, std::memory_order_acq_rel)) {
+      const Slot &slot = slots_[i];
+      out.data = slot.data;
+      out.size = slot.size;
+      out.sequence = slot.sequence;
+      out.source = slot.source;
+      out.slot = static_cast<uint8_t>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ImageFrameBuffer::release(const Frame &frame) {
+  if (frame.slot >= kSlotCount) {
+    return;
+  }
+  uint8_t expected = kReading;
+  if (slots_[frame.slot].state.compare_exchange_strong(expected, kFree, std::memory_order_acq_rel)) {
+    framesConsumed_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+bool ImageFrameBuffer::hasReadyFrame() const {
+  for (const Slot &slot : slots_) {
+    if (slot.state.load(std::memory_order_acquire) == kReady) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ImageFrameBuffer::Stats ImageFrameBuffer::stats() const {
+  Stats s;
+  s.framesCompleted = framesCompleted_.load(std::memory_order_relaxed);
+  s.framesConsumed = framesConsumed_.load(std::memory_order_relaxed);
+  s.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+  s.framesOversize = framesOversize_.load(std::memory_order_relaxed);
+  s.framesAborted = framesAborted_.load(std::memory_order_relaxed);
+  s.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+  return s;
+}
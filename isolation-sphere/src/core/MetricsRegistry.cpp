@@ -0,0 +1,350 @@
+#include "core/MetricsRegistry.h"
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Names are emitted unescaped as JSON keys.
+bool isValidName(const char *name) {
+  if (name == nullptr || name[0] == '\0') {
+    return false;
+  }
+  size_t length = 0;
+  for (const char *p = name; *p != '\0'; ++p, ++length) {
+    const char c = *p;
+    const bool ok = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '.';
+    if (!ok || length >= MetricsRegistry::kMaxNameLength) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void appendf(std::string &out, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+void appendf(std::string &out, const char *format, ...) {
+  char buffer[96];
+  va_list args;
+  va_start(args, format);
+  const int written = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (written > 0) {
+    out.append(buffer, static_cast<size_t>(written) < sizeof(buffer) ? static_cast<size_t>(written)
+                                                                      : sizeof(buffer) - 1);
+  }
+}
+
+void appendNumber(std::string &out, float value) {
+  if (!std::isfinite(value)) {
+    out += "null";
+  } else if (std::fabs(value) < 2.0e9f && value == std::floor(value)) {
+    appendf(out, "%ld", static_cast<long>(value));
+  } else {
+    appendf(out, "%.2f", static_cast<double>(value));
+  }
+}
+
+// Opens `"section":{` lazily so empty sections are left out.
+void appendKey(std::string &out, const char *section, bool &opened, const char *name) {
+  if (!opened) {
+    if (out.size() > 1) {
+      out += ',';
+    }
+    out += '"';
+    out += section;
+    out += "\":{";
+    opened = true;
+  } else {
+    out += ',';
+  }
+  out += '"';
+  out += name;
+  out += "\":";
+}
+
+void closeSection(std::string &out, bool opened) {
+  if (opened) {
+    out += '}';
+  }
+}
+
+}  // namespace
+
+void MetricsRegistry::Gauge::set(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits_.store(bits, std::memory_order_relaxed);
+}
+
+float MetricsRegistry::Gauge::value() const {
+  const uint32_t bits = bits_.load(std::memory_order_relaxed);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+size_t MetricsRegistry::Histogram::bucketIndex(uint32_t value) {
+  if (value < 8) {
+    return value;
+  }
+  if (value >= kRangeLimit) {
+    return kBucketCount - 1;
+  }
+  uint32_t octave = 0;
+  for (uint32_t v = value; v > 1; v >>= 1) {
+    ++octave;
+  }
+  const uint32_t sub = (value >> (octave - 2)) & 3u;
+  return 4u * (octave - 1u) + sub;
+}
+
+uint32_t MetricsRegistry::Histogram::bucketUpperBound(size_t index) {
+  if (index < 8) {
+    return static_cast<uint32_t>(index);
+  }
+  const uint32_t octave = static_cast<uint32_t>(index / 4) + 1u;
+  const uint32_t sub = static_cast<uint32_t>(index % 4);
+  const uint32_t width = 1u << (octave - 2);
+  return ((4u + sub) << (octave - 2)) + width - 1u;
+}
+
+void MetricsRegistry::Histogram::record(uint32_t value) {
+  buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  uint32_t seen = max_.load(std::memory_order_relaxed);
+  while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+MetricsRegistry::Histogram::Summary MetricsRegistry::Histogram::drain() {
+  uint32_t counts[kBucketCount];
+  Summary summary;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    counts[i] = buckets_[i].exchange(0, std::memory_order_relaxed);
+    summary.count += counts[i];
+  }
+  const uint32_t sum = sum_.exchange(0, std::memory_order_relaxed);
+  summary.max = max_.exchange(0, std::memory_order_relaxed);
+  if (summary.count == 0) {
+    return summary;
+  }
+  summary.avg = sum / summary.count;
+
+  // Nearest-rank percentiles, reported as the bucket's upper bound (capped
+  // at the exact max so a single sample reads back as itself).
+  auto percentile = [&](uint32_t p) {
+    const uint64_t rank = (static_cast<uint64_t>(p) * summary.count + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += counts[i];
+      if (seen >= rank && counts[i] != 0) {
+        const uint32_t bound = bucketUpperBound(i);
+        return bound < summary.max ? bound : summary.max;
+      }
+    }
+    return summary.max;
+  };
+  summary.p50 = percentile(50);
+  summary.p95 = percentile(95);
+  summary.p99 = percentile(99);
+  return summary;
+}
+
+MetricsRegistry::MetricsRegistry() {
+#ifndef UNIT_TEST
+  mutex_ = xSemaphoreCreateMutex();
+#endif
+}
+
+MetricsRegistry::~MetricsRegistry() {
+#ifndef UNIT_TEST
+  if (mutex_ != nullptr) {
+    vSemaphoreDelete(mutex_);
+    mutex_ = nullptr;
+  }
+#endif
+}
+
+void MetricsRegistry::lock() const {
+#ifndef UNIT_TEST
+  if (mutex_ != nullptr) {
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+  }
+#else
+  mutex_.lock();
+#endif
+}
+
+void MetricsRegistry::unlock() const {
+#ifndef UNIT_TEST
+  if (mutex_ != nullptr) {
+    xSemaphoreGive(mutex_);
+  }
+#else
+  mutex_.unlock();
+#endif
+}
+
+const MetricsRegistry::Entry *MetricsRegistry::find(const char *name) const {
+  for (size_t i = 0; i < entryCount_; ++i) {
+    if (std::strcmp(entries_[i].name, name) == 0) {
+      return &entries_[i];
+    }
+  }
+  return nullptr;
+}
+
+void MetricsRegistry::addEntry(const char *name, Kind kind, size_t index) {
+  Entry &entry = entries_[entryCount_++];
+  std::strncpy(entry.name, name, kMaxNameLength);
+  entry.kind = kind;
+  entry.index = static_cast<uint8_t>(index);
+}
+
+MetricsRegistry::Counter *MetricsRegistry::counter(const char *name, CounterRate rate) {
+  if (!isValidName(name)) {
+    return nullptr;
+  }
+  Counter *result = nullptr;
+  lock();
+  const Entry *existing = find(name);
+  if (existing != nullptr) {
+    if (existing->kind == Kind::kCounter) {
+      result = &counters_[existing->index].counter;
+    }
+  } else if (counterCount_ < kMaxCounters) {
+    CounterSlot &slot = counters_[counterCount_];
+    slot.rate = rate;
+    addEntry(name, Kind::kCounter, counterCount_++);
+    result = &slot.counter;
+  }
+  unlock();
+  return result;
+}
+
+MetricsRegistry::Gauge *MetricsRegistry::gauge(const char *name) {
+  if (!isValidName(name)) {
+    return nullptr;
+  }
+  Gauge *result = nullptr;
+  lock();
+  const Entry *existing = find(name);
+  if (existing != nullptr) {
+    if (existing->kind == Kind::kGauge) {
+      result = &gauges_[existing->index];
+    }
+  } else if (gaugeCount_ < kMaxGauges) {
+    addEntry(name, Kind::kGauge, gaugeCount_);
+    result = &gauges_[gaugeCount_++];
+  }
+  unlock();
+  return result;
+}
+
+MetricsRegistry::Histogram *MetricsRegistry::histogram(const char *name) {
+  if (!isValidName(name)) {
+    return nullptr;
+  }
+  Histogram *result = nullptr;
+  lock();
+  const Entry *existing = find(name);
+  if (existing != nullptr) {
+    if (existing->kind == Kind::kHistogram) {
+      result = &histograms_[existing->index];
+    }
+  } else if (histogramCount_ < kMaxHistograms) {
+    addEntry(name, Kind::kHistogram, histogramCount_);
+    result = &histograms_[histogramCount_++];
+  }
+  unlock();
+  return result;
+}
+
+bool MetricsRegistry::addSampler(Sampler sampler) {
+  if (!sampler) {
+    return false;
+  }
+  lock();
+  const bool added = samplerCount_ < kMaxSamplers;
+  if (added) {
+    samplers_[samplerCount_++] = std::move(sampler);
+  }
+  unlock();
+  return added;
+}
+
+size_t MetricsRegistry::metricCount() const {
+  lock();
+  const size_t count = entryCount_;
+  unlock();
+  return count;
+}
+
+void MetricsRegistry::serialize(std::string &out, uint32_t nowMs) {
+  lock();
+  for (size_t i = 0; i < samplerCount_; ++i) {
+    samplers_[i]();
+  }
+  const uint32_t windowMs = serialized_ ? nowMs - lastSerializeMs_ : 0;
+  lastSerializeMs_ = nowMs;
+  serialized_ = true;
+
+  out.clear();
+  appendf(out, "{\"t\":%lu,\"dt\":%lu", static_cast<unsigned long>(nowMs), static_cast<unsigned long>(windowMs));
+
+  // Entries are visited per section so each kind stays in registration order.
+  bool opened = false;
+  for (size_t i = 0; i < entryCount_; ++i) {
+    const Entry &entry = entries_[i];
+    if (entry.kind == Kind::kCounter) {
+      appendKey(out, "c", opened, entry.name);
+      appendf(out, "%lu", static_cast<unsigned long>(counters_[entry.index].counter.value()));
+    }
+  }
+  closeSection(out, opened);
+
+  opened = false;
+  for (size_t i = 0; i < entryCount_; ++i) {
+    const Entry &entry = entries_[i];
+    if (entry.kind != Kind::kCounter) {
+      continue;
+    }
+    CounterSlot &slot = counters_[entry.index];
+    const uint32_t value = slot.counter.value();
+    if (slot.rate == CounterRate::kPerSecond && windowMs != 0) {
+      appendKey(out, "r", opened, entry.name);
+      appendNumber(out, std::round(static_cast<float>(value - slot.lastValue) * 10000.0f / windowMs) / 10.0f);
+    }
+    slot.lastValue = value;
+  }
+  closeSection(out, opened);
+
+  opened = false;
+  for (size_t i = 0; i < entryCount_; ++i) {
+    const Entry &entry = entries_[i];
+    if (entry.kind == Kind::kGauge) {
+      appendKey(out, "g", opened, entry.name);
+      appendNumber(out, gauges_[entry.index].value());
+    }
+  }
+  closeSection(out, opened);
+
+  opened = false;
+  for (size_t i = 0; i < entryCount_; ++i) {
+    const Entry &entry = entries_[i];
+    if (entry.kind != Kind::kHistogram) {
+      continue;
+    }
+    const Histogram::Summary s = histograms_[entry.index].drain();
+    appendKey(out, "h", opened, entry.name);
+    appendf(out, "[%lu,%lu,%lu,%lu,%lu,%lu]", static_cast<unsigned long>(s.count),
+            static_cast<unsigned long>(s.avg), static_cast<unsigned long>(s.p50), static_cast<unsigned long>(s.p95),
+            static_cast<unsigned long>(s.p99), static_cast<unsigned long>(s.max));
+  }
+  closeSection(out, opened);
+  out += '}';
+  unlock();
+}
@@ -0,0 +1,305 @@
+#include "core/RenderLoop.h"
+
+#include <cstring>
+#include <utility>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <LittleFS.h>
+#endif
+
+using LEDSphere::FramePackPlayer;
+using ProceduralPattern::PatternGenerator;
+using ProceduralPattern::PatternId;
+
+RenderLoop::RenderLoop(SharedState &sharedState) : sharedState_(sharedState), jpegDecoder_(sphere_) {}
+
+RenderLoop::~RenderLoop() {
+  releaseHeldImage();
+}
+
+bool RenderLoop::begin(const ConfigManager::Config &cfg, const char *layoutPath) {
+  if (ready_) {
+    return true;
+  }
+  if (cfg.led.ledsPerStrip.empty() || cfg.led.stripGpios.empty()) {
+    return false;
+  }
+  if (!sphere_.initializeLedHardware(cfg.led.numStrips, cfg.led.ledsPerStrip, cfg.led.stripGpios)) {
+    return false;
+  }
+  sphere_.initialize(layoutPath);
+  patterns_.setSphereManager(&sphere_);
+  syncFps_ = cfg.sync.fps;
+  ready_ = true;
+#ifdef ARDUINO
+  Serial.printf("[Render] LED render loop ready (%u LEDs)\n", static_cast<unsigned>(sphere_.ledCount()));
+  if (!cfg.movie.pack.empty() &&
+      !openMovie(FramePackPlayer::makeFileSource(LittleFS, cfg.movie.pack.c_str()), cfg.movie.loop)) {
+    Serial.printf("[Render] Movie %s not playable, using the default pattern\n", cfg.movie.pack.c_str());
+  }
+#endif
+  return true;
+}
+
+void RenderLoop::attachMetrics(MetricsRegistry &registry) {
+  sphere_.attachMetrics(registry);
+}
+
+bool RenderLoop::openMovie(FramePackPlayer::Source source, bool loop) {
+  if (!movie_.open(std::move(source))) {
+    return false;
+  }
+  if (movie_.ledCount() != sphere_.ledCount()) {
+    movie_.close();
+    return false;
+  }
+  movie_.setLoop(loop);
+  return true;
+}
+
+void RenderLoop::tick(uint32_t nowMs) {
+  if (!ready_) {
+    return;
+  }
+  processSystemCommands();
+  applyRemoteControl();
+  applyImuPosture();
+  if (emergencyStopped_) {
+    // Keep the MQTT task's slots moving; nothing is shown until resumed.
+    ImageFrameBuffer::Frame dropped;
+    if (sharedState_.imageFrames().acquire(dropped)) {
+      sharedState_.imageFrames().release(dropped);
+    }
+    return;
+  }
+  if (content_ == Content::kNone) {
+    if (movie_.isOpen()) {
+      setContent(Content::kMovie);
+    } else {
+      selectPattern(PatternGenerator::findPatternId(kDefaultPattern));
+    }
+  }
+
+  ImageFrameBuffer::Frame frame;
+  if (sharedState_.imageFrames().acquire(frame)) {
+    presentNewFrame(frame);
+  } else if (content_ == Content::kImage) {
+    resampleHeldImage();
+  } else if (content_ == Content::kPattern) {
+    renderPattern(nowMs);
+  } else if (content_ == Content::kMovie) {
+    renderMovie(nowMs);
+  }
+}
+
+void RenderLoop::setContent(Content content) {
+  content_ = content;
+  // frame_drops counts missed frames against the rate the content is drawn
+  // at; image frames arrive whenever the sender publishes, so gaps between
+  // them are not drops.
+  uint16_t fps = 0;
+  if (content == Content::kPattern) {
+    fps = syncFps_;
+  } else if (content == Content::kMovie) {
+    fps = movie_.header().fps;
+  }
+  sphere_.setTargetFPS(static_cast<uint8_t>(fps < 255 ? fps : 255));
+}
+
+void RenderLoop::processSystemCommands() {
+  // Drained every tick so the bounded queue never fills up behind Core1.
+  SystemCommand command;
+  while (sharedState_.popSystemCommand(command, true)) {
+    ++stats_.systemCommands;
+    switch (command.type) {
+      case SystemCommandType::kEmergency:
+        handleEmergency(command);
+        break;
+      case SystemCommandType::kCommand:
+      case SystemCommandType::kSync:
+#ifdef ARDUINO
+        Serial.printf("[Render] Unhandled system %s: %s\n",
+                      command.type == SystemCommandType::kSync ? "sync" : "command", command.text());
+#endif
+        break;
+    }
+  }
+}
+
+void RenderLoop::handleEmergency(const SystemCommand &command) {
+  if (std::strstr(command.text(), "resume") != nullptr) {
+    if (emergencyStopped_) {
+      emergencyStopped_ = false;
+      // Redraw whatever was selected before the stop; a stale generation
+      // makes resampleHeldImage() decode the held JPEG again.
+      patternDrawn_ = false;
+      heldUvGeneration_ = sphere_.uvGeneration() - 1;
+    }
+    return;
+  }
+  ++stats_.emergencyStops;
+  emergencyStopped_ = true;
+  sphere_.clearAllLEDs();
+  sphere_.show();
+}
+
+void RenderLoop::applyRemoteControl() {
+  RemoteControl control;
+  if (!sharedState_.getRemoteControl(control)) {
+    return;
+  }
+  if (haveControl_ && control.source == controlSource_ && control.sequence == controlSequence_ &&
+      control.updatedMs == controlUpdatedMs_) {
+    return;
+  }
+  haveControl_ = true;
+  controlSource_ = control.source;
+  controlSequence_ = control.sequence;
+  controlUpdatedMs_ = control.updatedMs;
+  ++stats_.controlUpdates;
+
+  if (control.has(RemoteControl::kPosture)) {
+    sphere_.setUIOffset(control.latitudeOffsetDeg, control.longitudeOffsetDeg);
+  }
+  if (control.has(RemoteControl::kBrightness) && control.brightness != brightness_) {
+    brightness_ = control.brightness;
+    sphere_.setBrightness(control.brightness);
+  }
+  if (control.has(RemoteControl::kPattern) && control.patternId != requestedPattern_) {
+    requestedPattern_ = control.patternId;
+    selectPattern(control.patternId);
+  }
+}
+
+void RenderLoop::applyImuPosture() {
+  ImuService::Reading reading;
+  if (sharedState_.getImuReading(reading)) {
+    sphere_.setIMUPosture(reading.qw, reading.qx, reading.qy, reading.qz);
+  }
+}
+
+void RenderLoop::selectPattern(PatternId id) {
+  if (patterns_.getPattern(id) == nullptr) {
+#ifdef ARDUINO
+    Serial.printf("[Render] Unknown pattern id %u\n", static_cast<unsigned>(id));
+#endif
+    return;
+  }
+  releaseHeldImage();
+  setContent(Content::kPattern);
+  patternId_ = id;
+  patternDrawn_ = false;
+}
+
+void RenderLoop::presentNewFrame(const ImageFrameBuffer::Frame &frame) {
+  releaseHeldImage();
+  sphere_.frameStart();
+  const bool presented = presentImageFrame(frame);
+  if (presented) {
+    setContent(Content::kImage);
+    sphere_.show();
+    ++stats_.framesShown;
+  } else {
+    ++stats_.rejectedFrames;
+  }
+  sphere_.frameEnd();
+
+  if (presented && frame.source != static_cast<uint8_t>(SharedState::ImageSource::kLive)) {
+    heldImage_ = frame;
+    holdingImage_ = true;
+    heldUvGeneration_ = sphere_.uvGeneration();
+  } else {
+    sharedState_.imageFrames().release(frame);
+  }
+}
+
+bool RenderLoop::presentImageFrame(const ImageFrameBuffer::Frame &frame) {
+  switch (static_cast<SharedState::ImageSource>(frame.source)) {
+    case SharedState::ImageSource::kLive:
+      // Already in LED order; anything but one RGB triple per LED means the
+      // sender and this sphere disagree on the strip layout.
+      if (frame.size != sphere_.ledCount() * 3) {
+        return false;
+      }
+      sphere_.setAllLEDsRGB(frame.data, sphere_.ledCount());
+      ++stats_.liveFrames;
+      return true;
+    default:
+#ifdef ARDUINO
+      // Equirectangular JPEG: decoded straight into the LED frame buffer,
+      // touching only the MCU rows the LEDs sample.
+      if (!jpegDecoder_.decode(frame.data, frame.size)) {
+        return false;
+      }
+      ++stats_.jpegFrames;
+      return true;
+#else
+      // TJpg_Decoder is device-only; native builds only exercise live frames.
+      return false;
+#endif
+  }
+}
+
+bool RenderLoop::resampleHeldImage() {
+  // refreshUV() only moves the generation once the posture has turned past
+  // the UV cache epsilon, so IMU noise does not trigger a decode per tick.
+  if (!holdingImage_ || sphere_.refreshUV() == heldUvGeneration_) {
+    return false;
+  }
+  sphere_.frameStart();
+  const bool presented = presentImageFrame(heldImage_);
+  if (presented) {
+    sphere_.show();
+    ++stats_.framesShown;
+    ++stats_.jpegResampled;
+  }
+  sphere_.frameEnd();
+  heldUvGeneration_ = sphere_.uvGeneration();
+  return presented;
+}
+
+SyncTimebase RenderLoop::timebase() const {
+  SyncTimebase timebase;
+  if (!sharedState_.getSyncTimebase(timebase)) {
+    timebase = SyncTimebase::local(0, syncFps_);
+  }
+  return timebase;
+}
+
+void RenderLoop::renderPattern(uint32_t nowMs) {
+  const SyncTimebase tb = timebase();
+  const uint32_t frame = tb.frameAt(nowMs);
+  if (patternDrawn_ && frame == patternFrame_) {
+    return;
+  }
+  patternFrame_ = frame;
+  patternDrawn_ = true;
+  // Patterns show() themselves.
+  sphere_.frameStart();
+  patterns_.renderPatternAt(patternId_, 0.0f, tb, nowMs);
+  sphere_.frameEnd();
+  ++stats_.framesShown;
+  ++stats_.patternFrames;
+}
+
+void RenderLoop::renderMovie(uint32_t nowMs) {
+  // The pack's own rate on the shared clock; showFrame() swaps in the
+  // prefetched next frame or seeks after a late tick / timebase correction.
+  if (!movie_.showFrame(timebase().frameAt(nowMs, movie_.header().fps))) {
+    return;
+  }
+  sphere_.frameStart();
+  movie_.applyTo(sphere_);
+  sphere_.show();
+  sphere_.frameEnd();
+  ++stats_.framesShown;
+  ++stats_.movieFrames;
+}
+
+void RenderLoop::releaseHeldImage() {
+  if (holdingImage_) {
+    sharedState_.imageFrames().release(heldImage_);
+    holdingImage_ = false;
+  }
+}
@@ -1,5 +1,10 @@
 #include "core/SharedState.h"
+
+#ifdef ARDUINO
 #include <Arduino.h>
+#endif
+
+#include <cstring>
 
 SharedState::SharedState() {
 #ifndef UNIT_TEST
@@ -37,45 +42,80 @@ void SharedState::unlock() const {
 }
 
 void SharedState::updateConfig(const ConfigManager::Config &config) {
+  // Build the new snapshot outside the lock; readers holding the previous
+  // one keep it alive until they drop it.
+  ConfigSnapshot snapshot = std::make_shared<const ConfigManager::Config>(config);
   lock();
-  config_ = config;
-  hasConfig_ = true;
+  config_.swap(snapshot);
+  configGeneration_.fetch_add(1, std::memory_order_release);
   unlock();
 }
 
 bool SharedState::getConfigCopy(ConfigManager::Config &out) const {
+  ConfigSnapshot snapshot;
+  if (!getConfigSnapshot(snapshot)) {
+    return false;
+  }
+  out = *snapshot;
+  return true;
+}
+
+bool SharedState::getConfigSnapshot(ConfigSnapshot &out, std::uint32_t *generation) const {
   lock();
-  bool available = hasConfig_;
-  if (available) {
-    out = config_;
+  out = config_;
+  if (generation != nullptr) {
+    *generation = configGeneration_.load(std::memory_order_relaxed);
   }
   unlock();
-  return available;
+  return out != nullptr;
 }
 
 void SharedState::updateImuReading(const ImuService::Reading &reading) {
-  lock();
-  imuReading_ = reading;
-  hasImuReading_ = true;
-  unlock();
+  imuReading_.write(reading);
 }
 
 bool SharedState::getImuReading(ImuService::Reading &out) const {
-  lock();
-  bool available = hasImuReading_;
-  if (available) {
-    out = imuReading_;
+  return imuReading_.read(out);
+}
+
+void SharedState::updateRemoteControl(const RemoteControl &control) {
+  const size_t index = static_cast<size_t>(control.source);
+  if (index < static_cast<size_t>(ControlSource::kCount)) {
+    remoteControl_[index].write(control);
   }
-  unlock();
-  return available;
+}
+
+bool SharedState::getRemoteControl(RemoteControl &out) const {
+  bool found = false;
+  for (const auto &slot : remoteControl_) {
+    RemoteControl candidate;
+    if (!slot.read(candidate)) {
+      continue;
+    }
+    if (!found || static_cast<std::int32_t>(candidate.updatedMs - out.updatedMs) > 0) {
+      out = candidate;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void SharedState::updateSyncTimebase(const SyncTimebase &timebase) {
+  syncTimebase_.write(timebase);
+}
+
+bool SharedState::getSyncTimebase(SyncTimebase &out) const {
+  return syncTimebase_.read(out) && out.valid;
 }
 
 void SharedState::setUiMode(bool active) {
   lock();
   uiModeActive_ = active;
   hasUiMode_ = true;
+#ifdef ARDUINO
   // Debug log so we can trace who toggles UI mode on the device
   Serial.printf("[SharedState] setUiMode -> %s\n", active ? "ON" : "OFF");
+#endif
   unlock();
 }
 
@@ -89,60 +129,93 @@ bool SharedState::getUiMode(bool &active) const {
   return available;
 }
 
-void SharedState::pushUiCommand(const std::string &command, bool external) {
+bool SharedState::pushUiCommand(const UiCommand &command, bool external) {
   lock();
-  if (external) {
-    uiCommandIncoming_ = command;
-    hasUiCommandIncoming_ = true;
-  } else {
-    uiCommandOutgoing_ = command;
-    hasUiCommandOutgoing_ = true;
-  }
+  bool accepted = external ? uiCommandsIncoming_.push(command) : uiCommandsOutgoing_.push(command);
   unlock();
+  return accepted;
 }
 
-bool SharedState::popUiCommand(std::string &command, bool external) {
-  lock();
-  bool available = external ? hasUiCommandIncoming_ : hasUiCommandOutgoing_;
-  if (available) {
-    command = external ? uiCommandIncoming_ : uiCommandOutgoing_;
-    if (external) {
-      hasUiCommandIncoming_ = false;
-      uiCommandIncoming_.clear();
-    } else {
-      hasUiCommandOutgoing_ = false;
-      uiCommandOutgoing_.clear();
-    }
+bool SharedState::pushUiCommand(const char *command, bool external) {
+  if (command == nullptr) {
+    return false;
   }
+  UiCommand record;
+  if (!makeUiCommand(command, std::strlen(command), record)) {
+    lock();
+    ++oversizeRejected_;
+    unlock();
+    return false;
+  }
+  return pushUiCommand(record, external);
+}
+
+bool SharedState::pushUiCommand(const std::string &command, bool external) {
+  return pushUiCommand(command.c_str(), external);
+}
+
+bool SharedState::popUiCommand(UiCommand &command, bool external) {
+  lock();
+  bool available = external ? uiCommandsIncoming_.pop(command) : uiCommandsOutgoing_.pop(command);
   unlock();
   return available;
 }
 
-void SharedState::pushSystemCommand(const std::string &command, bool external) {
+bool SharedState::popUiCommand(std::string &command, bool external) {
+  UiCommand record;
+  if (!popUiCommand(record, external)) {
+    return false;
+  }
+  command.assign(record.text(), record.length);
+  return true;
+}
+
+bool SharedState::pushSystemCommand(SystemCommandType type, const char *payload, size_t length, bool external) {
+  SystemCommand record;
+  const bool fits = record.assign(type, payload, length);
   lock();
-  if (external) {
-    systemCommandIncoming_ = command;
-    hasSystemCommandIncoming_ = true;
+  bool accepted = false;
+  if (!fits) {
+    ++oversizeRejected_;
   } else {
-    systemCommandOutgoing_ = command;
-    hasSystemCommandOutgoing_ = true;
+    accepted = external ? systemCommandsIncoming_.push(record) : systemCommandsOutgoing_.push(record);
   }
   unlock();
+  return accepted;
 }
 
-bool SharedState::popSystemCommand(std::string &command, bool external) {
+bool SharedState::pushSystemCommand(const std::string &command, bool external) {
+  return pushSystemCommand(SystemCommandType::kCommand, command.data(), command.size(), external);
+}
+
+bool SharedState::popSystemCommand(SystemCommand &command, bool external) {
   lock();
-  bool available = external ? hasSystemCommandIncoming_ : hasSystemCommandOutgoing_;
-  if (available) {
-    command = external ? systemCommandIncoming_ : systemCommandOutgoing_;
-    if (external) {
-      hasSystemCommandIncoming_ = false;
-      systemCommandIncoming_.clear();
-    } else {
-      hasSystemCommandOutgoing_ = false;
-      systemCommandOutgoing_.clear();
-    }
-  }
+  bool available = external ? systemCommandsIncoming_.pop(command) : systemCommandsOutgoing_.pop(command);
   unlock();
   return available;
 }
+
+bool SharedState::popSystemCommand(std::string &command, bool external) {
+  SystemCommand record;
+  if (!popSystemCommand(record, external)) {
+    return false;
+  }
+  command.assign(record.text(), record.length);
+  return true;
+}
+
+SharedState::CommandQueueStats SharedState::getCommandQueueStats() const {
+  CommandQueueStats stats;
+  lock();
+  stats.uiIncomingOverflow = uiCommandsIncoming_.overflowCount();
+  stats.uiOutgoingOverflow = uiCommandsOutgoing_.overflowCount();
+  stats.systemIncomingOverflow = systemCommandsIncoming_.overflowCount();
+  stats.systemOutgoingOverflow = systemCommandsOutgoing_.overflowCount();
+  stats.oversizeRejected = oversizeRejected_;
+  stats.uiIncomingDepth = static_cast<uint8_t>(uiCommandsIncoming_.size());
+  stats.systemIncomingDepth = static_cast<uint8_t>(systemCommandsIncoming_.size());
+  stats.uiIncomingHighWater = static_cast<uint8_t>(uiCommandsIncoming_.highWater());
+  stats.systemIncomingHighWater = static_cast<uint8_t>(systemCommandsIncoming_.highWater());
+  unlock();
+  return stats;
+}
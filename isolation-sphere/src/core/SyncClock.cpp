@@ -0,0 +1,159 @@
+#include "core/SyncClock.h"
+
+namespace {
+
+std::uint32_t frameStartMs(std::uint32_t frame, std::uint16_t fps) {
+  return static_cast<std::uint32_t>(static_cast<std::uint64_t>(frame) * 1000u / fps);
+}
+
+}  // namespace
+
+std::uint32_t SyncClock::Beacon::epochMs() const {
+  const std::uint16_t rate = fps == 0 ? 30 : fps;
+  return masterMs - (frameStartMs(frame, rate) + frameOffsetMs);
+}
+
+SyncClock::Beacon SyncClock::makeBeacon(std::uint32_t nowMs, std::uint32_t epochMs, std::uint16_t fps,
+                                        std::uint16_t sequence) {
+  Beacon beacon;
+  beacon.fps = fps == 0 ? 30 : fps;
+  beacon.masterMs = nowMs;
+  beacon.sequence = sequence;
+  const std::uint32_t elapsed = nowMs - epochMs;
+  beacon.frame = static_cast<std::uint32_t>(static_cast<std::uint64_t>(elapsed) * beacon.fps / 1000u);
+  beacon.frameOffsetMs = static_cast<std::uint16_t>(elapsed - frameStartMs(beacon.frame, beacon.fps));
+  return beacon;
+}
+
+void SyncClock::reset() {
+  *this = SyncClock();
+}
+
+bool SyncClock::onBeacon(const Beacon &beacon, std::uint32_t localRxMs) {
+  ++beacons_;
+  const Sample sample{localRxMs, static_cast<std::int32_t>(beacon.masterMs - localRxMs)};
+
+  if (timebase_.valid) {
+    // Network delay only ever lowers a sample, but a beacon stuck behind a
+    // retransmission (or a restarted master) is far off the prediction.
+    const std::int32_t predicted = static_cast<std::int32_t>(timebase_.masterTimeMs(localRxMs) - localRxMs);
+    const std::int32_t residual = sample.offsetMs - predicted;
+    if (residual > kOutlierMs || residual < -kOutlierMs) {
+      ++outliers_;
+      if (++consecutiveOutliers_ < kResyncAfterOutliers) {
+        return false;
+      }
+      // The master clock really moved: start over from this beacon but keep
+      // the timebase valid so rendering does not fall back to local time.
+      ++resyncs_;
+      count_ = 0;
+      head_ = 0;
+      blockCount_ = 0;
+      blockHead_ = 0;
+      blockFill_ = 0;
+    }
+  }
+  consecutiveOutliers_ = 0;
+
+  addSample(sample);
+  timebase_.fps = beacon.fps == 0 ? 30 : beacon.fps;
+  timebase_.epochMasterMs = beacon.epochMs();
+  timebase_.lastBeaconMs = localRxMs;
+  if (!timebase_.valid && count_ < kMinSamples) {
+    return false;
+  }
+  updateEstimate();
+  return true;
+}
+
+void SyncClock::addSample(const Sample &sample) {
+  samples_[head_] = sample;
+  head_ = (head_ + 1) % kSampleCount;
+  if (count_ < kSampleCount) {
+    ++count_;
+  }
+
+  if (blockFill_ == 0 || sample.offsetMs > blockBest_.offsetMs) {
+    blockBest_ = sample;
+  }
+  if (++blockFill_ == kBlockSize) {
+    blocks_[blockHead_] = blockBest_;
+    blockHead_ = (blockHead_ + 1) % kBlockCount;
+    if (blockCount_ < kBlockCount) {
+      ++blockCount_;
+    }
+    blockFill_ = 0;
+    updateDrift();
+  }
+}
+
+void SyncClock::updateDrift() {
+  // Least-squares slope through the per-block best samples. Network delay
+  // only lowers a sample, so each block's maximum sits close to the true
+  // offset line; fitting several of them over a long span keeps the
+  // millisecond quantization and residual jitter well below 100 ppm.
+  if (blockCount_ < 3) {
+    return;
+  }
+  const Sample &newest = blocks_[(blockHead_ + kBlockCount - 1) % kBlockCount];
+  const Sample &oldest = blocks_[(blockHead_ + kBlockCount - blockCount_) % kBlockCount];
+  if (newest.localMs - oldest.localMs < kMinDriftSpanMs) {
+    return;
+  }
+  double sumX = 0.0;
+  double sumY = 0.0;
+  double sumXX = 0.0;
+  double sumXY = 0.0;
+  for (std::size_t i = 0; i < blockCount_; ++i) {
+    const Sample &block = blocks_[i];
+    const double x = static_cast<double>(static_cast<std::int32_t>(block.localMs - newest.localMs));
+    const double y = static_cast<double>(block.offsetMs - newest.offsetMs);
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+  const double n = static_cast<double>(blockCount_);
+  const double denominator = n * sumXX - sumX * sumX;
+  if (denominator <= 0.0) {
+    return;
+  }
+  float drift = static_cast<float>((n * sumXY - sumX * sumY) / denominator);
+  if (drift > kMaxDrift) {
+    drift = kMaxDrift;
+  } else if (drift < -kMaxDrift) {
+    drift = -kMaxDrift;
+  }
+  timebase_.drift = drift;
+  driftKnown_ = true;
+}
+
+void SyncClock::updateEstimate() {
+  // Project every sample in the window onto the newest one along the drift
+  // line and take the largest: that is the least delayed path through the
+  // window, anchored at the most recent beacon. Until a drift estimate
+  // exists only the last block is used so unmodelled drift stays small.
+  const Sample &newest = samples_[(head_ + kSampleCount - 1) % kSampleCount];
+  const std::size_t window = driftKnown_ ? count_ : (count_ < kBlockSize ? count_ : kBlockSize);
+  float best = 0.0f;
+  for (std::size_t i = 0; i < window; ++i) {
+    const Sample &sample = samples_[(head_ + kSampleCount - 1 - i) % kSampleCount];
+    const float age = static_cast<float>(static_cast<std::int32_t>(newest.localMs - sample.localMs));
+    const float projected = static_cast<float>(sample.offsetMs - newest.offsetMs) + timebase_.drift * age;
+    if (i == 0 || projected > best) {
+      best = projected;
+    }
+  }
+  timebase_.anchorLocalMs = newest.localMs;
+  timebase_.offsetMs = newest.offsetMs + static_cast<std::int32_t>(std::lroundf(best));
+  timebase_.valid = true;
+}
+
+SyncClock::Stats SyncClock::stats() const {
+  Stats s;
+  s.beacons = beacons_;
+  s.outliers = outliers_;
+  s.resyncs = resyncs_;
+  s.driftPpm = timebase_.drift * 1e6f;
+  return s;
+}
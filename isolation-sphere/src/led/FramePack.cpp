@@ -0,0 +1,217 @@
+/**
+ * @file FramePack.cpp
+ * @brief LED順RGBフレームパック形式の符号化・展開
+ */
+
+#include "led/FramePack.h"
+
+#include <cstring>
+
+namespace LEDSphere {
+
+namespace {
+constexpr size_t kMaxRun = 128;
+constexpr uint8_t kLiteralFlag = 0x80;
+
+inline bool sameColor(const uint8_t* a, const uint8_t* b) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+}
+
+namespace FramePack {
+
+bool validateHeader(const FramePackHeader& header, size_t fileSize) {
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        return false;
+    }
+    if (header.ledCount == 0 || header.frameCount == 0) {
+        return false;
+    }
+    if (header.maxFrameSize > maxEncodedFrameSize(header.ledCount)) {
+        return false;
+    }
+    const uint64_t indexEnd = static_cast<uint64_t>(header.indexOffset) +
+                              static_cast<uint64_t>(header.frameCount) * sizeof(FramePackIndexEntry);
+    if (header.indexOffset < sizeof(FramePackHeader) || indexEnd > header.dataOffset) {
+        return false;
+    }
+    if (fileSize != 0 && static_cast<uint64_t>(header.dataOffset) + header.dataSize > fileSize) {
+        return false;
+    }
+    return true;
+}
+
+void encodeRle(const uint8_t* rgb, size_t ledCount, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < ledCount) {
+        size_t run = 1;
+        while (i + run < ledCount && run < kMaxRun && sameColor(rgb + i * 3, rgb + (i + run) * 3)) {
+            ++run;
+        }
+        if (run >= 2) {
+            out.push_back(static_cast<uint8_t>(run - 1));
+            out.insert(out.end(), rgb + i * 3, rgb + i * 3 + 3);
+            i += run;
+            continue;
+        }
+
+        // 次の同色連続が始まるまでリテラルとしてまとめる
+        size_t literal = 1;
+        while (i + literal < ledCount && literal < kMaxRun) {
+            const size_t j = i + literal;
+            if (j + 1 < ledCount && sameColor(rgb + j * 3, rgb + (j + 1) * 3)) {
+                break;
+            }
+            ++literal;
+        }
+        out.push_back(static_cast<uint8_t>(kLiteralFlag | (literal - 1)));
+        out.insert(out.end(), rgb + i * 3, rgb + (i + literal) * 3);
+        i += literal;
+    }
+}
+
+void encodeDelta(const uint8_t* prev, const uint8_t* rgb, size_t ledCount, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < ledCount) {
+        size_t run = 0;
+        if (sameColor(prev + i * 3, rgb + i * 3)) {
+            while (i + run < ledCount && run < kMaxRun && sameColor(prev + (i + run) * 3, rgb + (i + run) * 3)) {
+                ++run;
+            }
+            out.push_back(static_cast<uint8_t>(run - 1));
+        } else {
+            while (i + run < ledCount && run < kMaxRun && !sameColor(prev + (i + run) * 3, rgb + (i + run) * 3)) {
+                ++run;
+            }
+            out.push_back(static_cast<uint8_t>(kLiteralFlag | (run - 1)));
+            out.insert(out.end(), rgb + i * 3, rgb + (i + run) * 3);
+        }
+        i += run;
+    }
+}
+
+bool decodeFrame(FrameEncoding encoding, const uint8_t* src, size_t srcSize, uint8_t* dst, size_t ledCount) {
+    if (!src || !dst) {
+        return false;
+    }
+    const size_t frameBytes = ledCount * 3;
+
+    switch (encoding) {
+        case FrameEncoding::kRaw:
+            if (srcSize != frameBytes) {
+                return false;
+            }
+            memcpy(dst, src, frameBytes);
+            return true;
+
+        case FrameEncoding::kRle:
+        case FrameEncoding::kDelta: {
+            const bool delta = encoding == FrameEncoding::kDelta;
+            size_t pos = 0;
+            size_t led = 0;
+            while (pos < srcSize && led < ledCount) {
+                const uint8_t control = src[pos++];
+                const size_t n = static_cast<size_t>(control & 0x7F) + 1;
+                if (led + n > ledCount) {
+                    return false;
+                }
+                if (control & kLiteralFlag) {
+                    if (pos + n * 3 > srcSize) {
+                        return false;
+                    }
+                    memcpy(dst + led * 3, src + pos, n * 3);
+                    pos += n * 3;
+                } else if (delta) {
+                    // 据え置き: dstに残っている前フレームの値を使う
+                } else {
+                    if (pos + 3 > srcSize) {
+                        return false;
+                    }
+                    for (size_t k = 0; k < n; ++k) {
+                        memcpy(dst + (led + k) * 3, src + pos, 3);
+                    }
+                    pos += 3;
+                }
+                led += n;
+            }
+            return led == ledCount && pos == srcSize;
+        }
+    }
+    return false;
+}
+
+} // namespace FramePack
+
+FramePackWriter::FramePackWriter(uint16_t ledCount, uint16_t fps, uint32_t keyframeInterval)
+    : ledCount_(ledCount), fps_(fps), keyframeInterval_(keyframeInterval) {}
+
+void FramePackWriter::addFrame(const uint8_t* rgb) {
+    const size_t frameBytes = static_cast<size_t>(ledCount_) * 3;
+    const uint32_t frameIndex = frameCount();
+    const bool keyframe = frameIndex == 0 || (keyframeInterval_ != 0 && frameIndex % keyframeInterval_ == 0);
+
+    FrameEncoding encoding = FrameEncoding::kRaw;
+    const uint8_t* payload = rgb;
+    size_t payloadSize = frameBytes;
+
+    std::vector<uint8_t> rle;
+    std::vector<uint8_t> delta;
+    if (compression_) {
+        FramePack::encodeRle(rgb, ledCount_, rle);
+        if (rle.size() < payloadSize) {
+            encoding = FrameEncoding::kRle;
+            payload = rle.data();
+            payloadSize = rle.size();
+        }
+        if (!keyframe) {
+            FramePack::encodeDelta(prev_.data(), rgb, ledCount_, delta);
+            if (delta.size() < payloadSize) {
+                encoding = FrameEncoding::kDelta;
+                payload = delta.data();
+                payloadSize = delta.size();
+            }
+        }
+    }
+
+    FramePackIndexEntry entry;
+    entry.offset = static_cast<uint32_t>(data_.size());  // finish()でファイル先頭基準に補正
+    entry.size = static_cast<uint32_t>(payloadSize);
+    entry.encoding = static_cast<uint8_t>(encoding);
+    entry.keyframe = encoding == FrameEncoding::kDelta ? 0 : 1;
+    entry.reserved = 0;
+    index_.push_back(entry);
+    data_.insert(data_.end(), payload, payload + payloadSize);
+    if (payloadSize > maxFrameSize_) {
+        maxFrameSize_ = static_cast<uint32_t>(payloadSize);
+    }
+    prev_.assign(rgb, rgb + frameBytes);
+}
+
+void FramePackWriter::finish(std::vector<uint8_t>& out) const {
+    FramePackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, FramePack::kMagic, sizeof(header.magic));
+    header.version = FramePack::kVersion;
+    header.ledCount = ledCount_;
+    header.frameCount = frameCount();
+    header.fps = fps_;
+    header.indexOffset = sizeof(FramePackHeader);
+    header.dataOffset = static_cast<uint32_t>(sizeof(FramePackHeader) + index_.size() * sizeof(FramePackIndexEntry));
+    header.dataSize = static_cast<uint32_t>(data_.size());
+    header.maxFrameSize = maxFrameSize_;
+
+    out.clear();
+    out.reserve(header.dataOffset + data_.size());
+    const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    out.insert(out.end(), headerBytes, headerBytes + sizeof(header));
+    for (FramePackIndexEntry entry : index_) {
+        entry.offset += header.dataOffset;
+        const uint8_t* entryBytes = reinterpret_cast<const uint8_t*>(&entry);
+        out.insert(out.end(), entryBytes, entryBytes + sizeof(entry));
+    }
+    out.insert(out.end(), data_.begin(), data_.end());
+}
+
+} // namespace LEDSphere
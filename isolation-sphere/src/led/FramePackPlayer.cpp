@@ -0,0 +1,296 @@
+/**
+ * @file FramePackPlayer.cpp
+ * @brief フレームパックのダブルバッファ再生実装
+ */
+
+#include "led/FramePackPlayer.h"
+#include "led/LEDSphereManager.h"
+#include "led/LayerCompositor.h"
+
+#include <cstring>
+#include <memory>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+namespace LEDSphere {
+
+FramePackPlayer::Source FramePackPlayer::makeMemorySource(const uint8_t* data, size_t size) {
+    Source source;
+    source.size = data ? size : 0;
+    source.read = [data, size](uint32_t offset, uint8_t* dst, size_t length) {
+        if (!data || static_cast<uint64_t>(offset) + length > size) {
+            return false;
+        }
+        memcpy(dst, data + offset, length);
+        return true;
+    };
+    return source;
+}
+
+#ifdef ARDUINO
+FramePackPlayer::Source FramePackPlayer::makeFileSource(fs::FS& fs, const char* path) {
+    Source source;
+    auto file = std::make_shared<File>(fs.open(path, FILE_READ));
+    if (!*file || file->isDirectory()) {
+        Serial.printf("[FramePackPlayer] Failed to open %s\n", path);
+        return source;
+    }
+    source.size = file->size();
+    source.read = [file](uint32_t offset, uint8_t* dst, size_t length) {
+        if (file->position() != offset && !file->seek(offset)) {
+            return false;
+        }
+        return file->read(dst, length) == length;
+    };
+    return source;
+}
+#endif
+
+bool FramePackPlayer::open(Source source) {
+    close();
+    if (!source.read || source.size < sizeof(FramePackHeader)) {
+        return false;
+    }
+
+    FramePackHeader header;
+    if (!source.read(0, reinterpret_cast<uint8_t*>(&header), sizeof(header)) ||
+        !FramePack::validateHeader(header, source.size)) {
+        return false;
+    }
+
+    index_.resize(header.frameCount);
+    if (!source.read(header.indexOffset, reinterpret_cast<uint8_t*>(index_.data()),
+                     index_.size() * sizeof(FramePackIndexEntry))) {
+        index_.clear();
+        return false;
+    }
+    const size_t frameBytes = static_cast<size_t>(header.ledCount) * 3;
+    for (const FramePackIndexEntry& entry : index_) {
+        if (static_cast<uint64_t>(entry.offset) + entry.size > source.size || entry.size > header.maxFrameSize) {
+            index_.clear();
+            return false;
+        }
+        // 非圧縮フレームはbackバッファへ直接読み込むため、サイズはフレーム長と一致すること
+        if (static_cast<FrameEncoding>(entry.encoding) == FrameEncoding::kRaw && entry.size != frameBytes) {
+            index_.clear();
+            return false;
+        }
+    }
+    if (!index_[0].keyframe) {
+        index_.clear();
+        return false;
+    }
+
+    buffers_[0].assign(frameBytes, 0);
+    buffers_[1].assign(frameBytes, 0);
+    readBuffer_.resize(header.maxFrameSize);
+
+    source_ = std::move(source);
+    header_ = header;
+    open_ = true;
+    setFps(0);
+    return true;
+}
+
+void FramePackPlayer::close() {
+    source_ = Source();
+    header_ = FramePackHeader();
+    index_.clear();
+    buffers_[0].clear();
+    buffers_[1].clear();
+    readBuffer_.clear();
+    front_ = 0;
+    frontFrame_ = -1;
+    backFrame_ = -1;
+    open_ = false;
+    started_ = false;
+    finished_ = false;
+    stats_ = Stats();
+}
+
+void FramePackPlayer::setFps(uint16_t fps) {
+    if (fps == 0) {
+        fps = header_.fps;
+    }
+    periodMs_ = fps > 0 ? 1000u / fps : 100u;
+    if (periodMs_ == 0) {
+        periodMs_ = 1;
+    }
+}
+
+bool FramePackPlayer::start(uint32_t nowMs) {
+    if (!open_) {
+        return false;
+    }
+    frontFrame_ = -1;
+    backFrame_ = -1;
+    finished_ = false;
+    started_ = prefetch();
+    nextDueMs_ = nowMs;
+    return started_;
+}
+
+bool FramePackPlayer::loadFrame(uint32_t frameIndex, uint8_t* dst, const uint8_t* prev) {
+    const FramePackIndexEntry& entry = index_[frameIndex];
+    const FrameEncoding encoding = static_cast<FrameEncoding>(entry.encoding);
+    const size_t frameBytes = static_cast<size_t>(header_.ledCount) * 3;
+
+    if (encoding == FrameEncoding::kRaw) {
+        // 非圧縮フレームはbackバッファへ直接読み込む
+        if (entry.size != frameBytes) {
+            return false;
+        }
+        if (!source_.read(entry.offset, dst, entry.size)) {
+            ++stats_.readErrors;
+            return false;
+        }
+        stats_.bytesRead += entry.size;
+        return true;
+    }
+
+    if (entry.size > readBuffer_.size()) {
+        return false;
+    }
+    if (!source_.read(entry.offset, readBuffer_.data(), entry.size)) {
+        ++stats_.readErrors;
+        return false;
+    }
+    stats_.bytesRead += entry.size;
+    if (encoding == FrameEncoding::kDelta) {
+        if (!prev) {
+            return false;
+        }
+        if (prev != dst) {
+            memcpy(dst, prev, frameBytes);
+        }
+    }
+    return FramePack::decodeFrame(encoding, readBuffer_.data(), entry.size, dst, header_.ledCount);
+}
+
+bool FramePackPlayer::prefetch() {
+    if (!open_ || backFrame_ >= 0) {
+        return backFrame_ >= 0;
+    }
+
+    uint32_t next = static_cast<uint32_t>(frontFrame_ + 1);
+    if (next >= header_.frameCount) {
+        if (!loop_) {
+            return false;
+        }
+        next = 0;
+    }
+
+    // 差分フレームはfrontに入っている直前フレームを基準にする
+    const uint8_t* prev = (frontFrame_ >= 0 && static_cast<uint32_t>(frontFrame_) + 1 == next)
+                              ? buffers_[front_].data()
+                              : nullptr;
+    const uint8_t back = front_ ^ 1;
+    if (!loadFrame(next, buffers_[back].data(), prev)) {
+        return false;
+    }
+    backFrame_ = static_cast<int32_t>(next);
+    return true;
+}
+
+bool FramePackPlayer::update(uint32_t nowMs) {
+    if (!open_ || !started_ || finished_) {
+        return false;
+    }
+    if (static_cast<int32_t>(nowMs - nextDueMs_) < 0) {
+        return false;
+    }
+    if (backFrame_ < 0 && !prefetch()) {
+        if (!loop_ && static_cast<uint32_t>(frontFrame_ + 1) >= header_.frameCount) {
+            finished_ = true;
+        }
+        return false;
+    }
+
+    front_ ^= 1;
+    frontFrame_ = backFrame_;
+    backFrame_ = -1;
+    ++stats_.framesShown;
+
+    nextDueMs_ += periodMs_;
+    if (static_cast<int32_t>(nowMs - nextDueMs_) >= 0) {
+        // 1フレーム以上遅延: 追いつこうとせず現在時刻から再スケジュール
+        ++stats_.lateFrames;
+        nextDueMs_ = nowMs + periodMs_;
+    }
+
+    prefetch();
+    return true;
+}
+
+bool FramePackPlayer::showFrame(uint32_t frameIndex) {
+    if (!open_ || header_.frameCount == 0) {
+        return false;
+    }
+    if (loop_) {
+        frameIndex %= header_.frameCount;
+    } else if (frameIndex >= header_.frameCount) {
+        frameIndex = header_.frameCount - 1;
+        finished_ = true;
+    }
+    started_ = true;
+    if (frontFrame_ == static_cast<int32_t>(frameIndex)) {
+        return false;
+    }
+
+    if (backFrame_ != static_cast<int32_t>(frameIndex) && !seek(frameIndex)) {
+        return false;
+    }
+    front_ ^= 1;
+    frontFrame_ = backFrame_;
+    backFrame_ = -1;
+    ++stats_.framesShown;
+    prefetch();
+    return true;
+}
+
+bool FramePackPlayer::seek(uint32_t frameIndex) {
+    // 差分フレームは直前フレームに依存するため、frontから辿れなければ
+    // 直前のキーフレームからbackバッファ上で順に展開する
+    const uint8_t back = front_ ^ 1;
+    uint8_t* dst = buffers_[back].data();
+    backFrame_ = -1;
+    ++stats_.seeks;
+
+    uint32_t start = frameIndex;
+    while (start > 0 && !index_[start].keyframe) {
+        --start;
+    }
+    const uint8_t* prev = nullptr;
+    if (frontFrame_ >= 0 && static_cast<uint32_t>(frontFrame_) < frameIndex &&
+        static_cast<uint32_t>(frontFrame_) >= start) {
+        // frontの続きから展開する方が短い
+        start = static_cast<uint32_t>(frontFrame_) + 1;
+        prev = buffers_[front_].data();
+    }
+    for (uint32_t f = start; f <= frameIndex; ++f) {
+        if (!loadFrame(f, dst, prev)) {
+            return false;
+        }
+        prev = dst;
+    }
+    backFrame_ = static_cast<int32_t>(frameIndex);
+    return true;
+}
+
+void FramePackPlayer::applyTo(LEDSphereManager& manager) const {
+    const uint8_t* frame = frontFrame();
+    if (frame) {
+        manager.setAllLEDsRGB(frame, header_.ledCount);
+    }
+}
+
+void FramePackPlayer::applyTo(LayerCompositor& compositor, uint8_t layer) const {
+    const uint8_t* frame = frontFrame();
+    if (frame) {
+        compositor.setRGB(layer, frame, header_.ledCount);
+    }
+}
+
+} // namespace LEDSphere
@@ -0,0 +1,182 @@
+/**
+ * @file FrameProfiler.cpp
+ * @brief フレーム時間計測実装
+ */
+
+#include "led/FrameProfiler.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+namespace LEDSphere {
+
+namespace {
+uint32_t defaultClockUs() {
+#ifdef ARDUINO
+    return micros();
+#else
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+}
+
+FrameProfiler::FrameProfiler() {
+    reset();
+}
+
+void FrameProfiler::setClock(ClockFn clock) {
+    clock_ = std::move(clock);
+    // 時刻源が変わったら間隔計測をやり直す
+    hasLastFrameStart_ = false;
+    inFrame_ = false;
+}
+
+void FrameProfiler::attachMetrics(MetricsRegistry &registry) {
+    static const char *const kStageNames[kFrameStageCount] = {"xform_us", "sample_us", "comp_us", "show_us"};
+    frameMetric_ = registry.histogram("frame_us");
+    for (size_t i = 0; i < kFrameStageCount; ++i) {
+        stageMetrics_[i] = registry.histogram(kStageNames[i]);
+    }
+    framesMetric_ = registry.counter("frames", MetricsRegistry::CounterRate::kPerSecond);
+    droppedMetric_ = registry.counter("frame_drops");
+}
+
+uint32_t FrameProfiler::now() const {
+    return clock_ ? clock_() : defaultClockUs();
+}
+
+void FrameProfiler::reset() {
+    memset(history_, 0, sizeof(history_));
+    memset(&current_, 0, sizeof(current_));
+    head_ = 0;
+    count_ = 0;
+    hasLastFrameStart_ = false;
+    inFrame_ = false;
+    frameCount_ = 0;
+    droppedFrames_ = 0;
+}
+
+void FrameProfiler::frameStart() {
+    const uint32_t t = now();
+    memset(&current_, 0, sizeof(current_));
+
+    if (hasLastFrameStart_) {
+        const uint32_t interval = t - lastFrameStartUs_;
+        current_.intervalUs = interval;
+        if (targetFPS_ > 0) {
+            // 目標周期の1.5倍を超えた間隔は、その間に表示できなかったフレームを数える
+            const uint32_t periodUs = 1000000u / targetFPS_;
+            if (interval > periodUs + periodUs / 2) {
+                const uint32_t dropped = (interval + periodUs / 2) / periodUs - 1;
+                droppedFrames_ += dropped;
+                if (droppedMetric_) {
+                    droppedMetric_->add(dropped);
+                }
+            }
+        }
+    }
+    lastFrameStartUs_ = t;
+    hasLastFrameStart_ = true;
+    frameStartUs_ = t;
+    inFrame_ = true;
+}
+
+void FrameProfiler::frameEnd() {
+    if (!inFrame_) {
+        return;
+    }
+    current_.totalUs = now() - frameStartUs_;
+    history_[head_] = current_;
+    head_ = (head_ + 1) % kHistorySize;
+    if (count_ < kHistorySize) {
+        ++count_;
+    }
+    ++frameCount_;
+    inFrame_ = false;
+
+    if (frameMetric_) {
+        frameMetric_->record(current_.totalUs);
+    }
+    for (size_t i = 0; i < kFrameStageCount; ++i) {
+        if (stageMetrics_[i]) {
+            stageMetrics_[i]->record(current_.stageUs[i]);
+        }
+    }
+    if (framesMetric_) {
+        framesMetric_->add();
+    }
+}
+
+void FrameProfiler::beginStage(FrameStage stage) {
+    if (!inFrame_) {
+        return;
+    }
+    stageStartUs_[static_cast<size_t>(stage)] = now();
+}
+
+void FrameProfiler::endStage(FrameStage stage) {
+    if (!inFrame_) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(stage);
+    current_.stageUs[index] += now() - stageStartUs_[index];
+}
+
+float FrameProfiler::currentFPS() const {
+    uint64_t total = 0;
+    uint32_t intervals = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        if (history_[i].intervalUs > 0) {
+            total += history_[i].intervalUs;
+            ++intervals;
+        }
+    }
+    if (intervals == 0 || total == 0) {
+        return 0.0f;
+    }
+    return 1000000.0f * static_cast<float>(intervals) / static_cast<float>(total);
+}
+
+template <typename Getter>
+TimingSummary FrameProfiler::summarize(Getter getter) const {
+    TimingSummary summary;
+    if (count_ == 0) {
+        return summary;
+    }
+    uint32_t values[kHistorySize];
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        values[i] = getter(history_[i]);
+        sum += values[i];
+    }
+    std::sort(values, values + count_);
+    // 最近傍順位法: ceil(p * n) 番目
+    auto percentile = [&](uint32_t p) {
+        size_t rank = (p * count_ + 99) / 100;
+        return values[rank > 0 ? rank - 1 : 0];
+    };
+    summary.minUs = values[0];
+    summary.maxUs = values[count_ - 1];
+    summary.avgUs = static_cast<uint32_t>(sum / count_);
+    summary.p95Us = percentile(95);
+    summary.p99Us = percentile(99);
+    return summary;
+}
+
+TimingSummary FrameProfiler::frameSummary() const {
+    return summarize([](const FrameSample& s) { return s.totalUs; });
+}
+
+TimingSummary FrameProfiler::stageSummary(FrameStage stage) const {
+    const size_t index = static_cast<size_t>(stage);
+    return summarize([index](const FrameSample& s) { return s.stageUs[index]; });
+}
+
+} // namespace LEDSphere
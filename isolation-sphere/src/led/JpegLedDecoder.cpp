@@ -0,0 +1,242 @@
+/**
+ * @file JpegLedDecoder.cpp
+ * @brief JPEG→LEDストリーミングデコーダ実装
+ */
+
+#include "led/JpegLedDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <TJpg_Decoder.h>
+#endif
+
+namespace LEDSphere {
+
+namespace {
+inline void expandRGB565(uint16_t pixel, uint32_t& r, uint32_t& g, uint32_t& b) {
+    r = (pixel >> 11) & 0x1F;
+    g = (pixel >> 5) & 0x3F;
+    b = pixel & 0x1F;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+}
+}
+
+#ifdef ARDUINO
+JpegLedDecoder* JpegLedDecoder::activeDecoder_ = nullptr;
+#endif
+
+JpegLedDecoder::JpegLedDecoder(LEDSphereManager& manager)
+    : manager_(manager) {}
+
+JpegLedDecoder::~JpegLedDecoder() {
+#ifdef ARDUINO
+    if (activeDecoder_ == this) {
+        activeDecoder_ = nullptr;
+    }
+#endif
+}
+
+uint8_t JpegLedDecoder::selectScale(uint16_t imageHeight, uint16_t minDecodedHeight) {
+    uint8_t scale = 1;
+    while (scale < 8 && imageHeight / (scale * 2) >= minDecodedHeight) {
+        scale *= 2;
+    }
+    return scale;
+}
+
+void JpegLedDecoder::addRef(std::vector<std::vector<TexelRef>>& rows, uint16_t x, uint16_t y,
+                            uint16_t led, uint32_t weight) {
+    if (weight == 0) {
+        return;  // 寄与しないタップはデコード対象から外す
+    }
+    rows[y].push_back(TexelRef{x, led, weight});
+}
+
+bool JpegLedDecoder::preparePlan(uint16_t decodedWidth, uint16_t decodedHeight) {
+    if (decodedWidth == 0 || decodedHeight == 0) {
+        planValid_ = false;
+        return false;
+    }
+
+    // UVだけ先に更新し、世代番号で計画の再利用可否を判定（タップ算出は再構築時のみ）
+    const uint32_t generation = manager_.refreshUV();
+    const size_t ledCount = manager_.layoutPositions().size();
+    if (planValid_ && planWidth_ == decodedWidth && planHeight_ == decodedHeight &&
+        planGeneration_ == generation && planLedCount_ == ledCount) {
+        return true;
+    }
+
+    manager_.computeTexelTaps(decodedWidth, decodedHeight, taps_);
+
+    const size_t stride = static_cast<size_t>(decodedWidth) * 3;
+    std::vector<std::vector<TexelRef>> rows(decodedHeight);
+    for (size_t i = 0; i < ledCount; ++i) {
+        const TexelTap& tap = taps_[i];
+        const uint16_t led = static_cast<uint16_t>(i);
+        const uint16_t x1 = static_cast<uint16_t>((tap.offset10 % stride) / 3);
+        const uint16_t y1 = static_cast<uint16_t>(tap.offset01 / stride);
+        const uint32_t fx = tap.fx, fy = tap.fy;
+        addRef(rows, tap.x0, tap.y0, led, (256 - fx) * (256 - fy));
+        addRef(rows, x1, tap.y0, led, fx * (256 - fy));
+        addRef(rows, tap.x0, y1, led, (256 - fx) * fy);
+        addRef(rows, x1, y1, led, fx * fy);
+    }
+
+    refs_.clear();
+    rowStart_.assign(static_cast<size_t>(decodedHeight) + 1, 0);
+    lastRow_ = 0;
+    for (uint16_t y = 0; y < decodedHeight; ++y) {
+        std::vector<TexelRef>& row = rows[y];
+        std::sort(row.begin(), row.end(), [](const TexelRef& a, const TexelRef& b) { return a.x < b.x; });
+        rowStart_[y] = static_cast<uint32_t>(refs_.size());
+        refs_.insert(refs_.end(), row.begin(), row.end());
+        if (!row.empty()) {
+            lastRow_ = y;
+        }
+    }
+    rowStart_[decodedHeight] = static_cast<uint32_t>(refs_.size());
+
+    planWidth_ = decodedWidth;
+    planHeight_ = decodedHeight;
+    planGeneration_ = generation;
+    planLedCount_ = ledCount;
+    planValid_ = true;
+    ++planBuildCount_;
+    return true;
+}
+
+void JpegLedDecoder::beginFrame() {
+    accum_.assign(planLedCount_ * 3, 0);
+    const uint8_t scale = stats_.scale;
+    stats_ = Stats();
+    stats_.scale = scale;
+}
+
+bool JpegLedDecoder::consumeBlock(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t* rgb565) {
+    if (!planValid_ || !rgb565 || x < 0 || y < 0) {
+        return planValid_;
+    }
+    if (y > lastRow_) {
+        // 以降のブロックはどのLEDからも参照されない
+        stats_.terminatedEarly = true;
+        return false;
+    }
+
+    const uint16_t yBegin = static_cast<uint16_t>(y);
+    const uint16_t yEnd = static_cast<uint16_t>(std::min<uint32_t>(yBegin + h, planHeight_));
+    if (rowStart_[yEnd] == rowStart_[yBegin]) {
+        ++stats_.blocksSkipped;
+        return true;
+    }
+
+    const uint16_t xBegin = static_cast<uint16_t>(x);
+    const uint32_t xEnd = static_cast<uint32_t>(xBegin) + w;
+    uint32_t sampled = 0;
+    for (uint16_t row = yBegin; row < yEnd; ++row) {
+        const TexelRef* it = refs_.data() + rowStart_[row];
+        const TexelRef* end = refs_.data() + rowStart_[row + 1];
+        while (it != end && it->x < xBegin) {
+            ++it;
+        }
+        const uint16_t* src = rgb565 + static_cast<size_t>(row - yBegin) * w;
+        for (; it != end && it->x < xEnd; ++it) {
+            uint32_t r, g, b;
+            expandRGB565(src[it->x - xBegin], r, g, b);
+            uint32_t* acc = &accum_[static_cast<size_t>(it->led) * 3];
+            acc[0] += r * it->weight;
+            acc[1] += g * it->weight;
+            acc[2] += b * it->weight;
+            ++sampled;
+        }
+    }
+
+    if (sampled == 0) {
+        ++stats_.blocksSkipped;
+    } else {
+        ++stats_.blocksConsumed;
+        stats_.texelsSampled += sampled;
+    }
+    return true;
+}
+
+void JpegLedDecoder::finishFrame() {
+    if (!planValid_) {
+        return;
+    }
+    const std::vector<LEDPosition>& layout = manager_.layoutPositions();
+    const size_t count = std::min(planLedCount_, layout.size());
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t* acc = &accum_[i * 3];
+        manager_.setLED(layout[i].faceID,
+                        CRGB(static_cast<uint8_t>((acc[0] + 32768u) >> 16),
+                             static_cast<uint8_t>((acc[1] + 32768u) >> 16),
+                             static_cast<uint8_t>((acc[2] + 32768u) >> 16)));
+    }
+}
+
+#ifdef ARDUINO
+bool JpegLedDecoder::tjpgOutputCallback(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* bitmap) {
+    if (!activeDecoder_) {
+        return false;
+    }
+    return activeDecoder_->consumeBlock(x, y, w, h, bitmap);
+}
+
+bool JpegLedDecoder::decode(const uint8_t* jpeg, size_t size) {
+    if (!jpeg || size == 0) {
+        return false;
+    }
+    return runDecode(false, jpeg, size, nullptr);
+}
+
+bool JpegLedDecoder::decodeFile(const char* path) {
+    if (!path || !LittleFS.exists(path)) {
+        Serial.printf("[JpegLedDecoder] File not found: %s\n", path ? path : "(null)");
+        return false;
+    }
+    return runDecode(true, nullptr, 0, path);
+}
+
+bool JpegLedDecoder::runDecode(bool fromFile, const uint8_t* jpeg, size_t size, const char* path) {
+    const uint32_t startUs = micros();
+
+    uint16_t imageWidth = 0, imageHeight = 0;
+    JRESULT sizeResult = fromFile ? TJpgDec.getFsJpgSize(&imageWidth, &imageHeight, path, LittleFS)
+                                  : TJpgDec.getJpgSize(&imageWidth, &imageHeight, jpeg, size);
+    if (sizeResult != JDR_OK || imageWidth == 0 || imageHeight == 0) {
+        Serial.printf("[JpegLedDecoder] Failed to read JPEG header (%d)\n", static_cast<int>(sizeResult));
+        return false;
+    }
+
+    const uint8_t scale = selectScale(imageHeight, minDecodedHeight_);
+    if (!preparePlan(imageWidth / scale, imageHeight / scale)) {
+        return false;
+    }
+    stats_.scale = scale;
+    beginFrame();
+
+    TJpgDec.setJpgScale(scale);
+    TJpgDec.setSwapBytes(false);
+    TJpgDec.setCallback(tjpgOutputCallback);
+    activeDecoder_ = this;
+    JRESULT result = fromFile ? TJpgDec.drawFsJpg(0, 0, path, LittleFS)
+                              : TJpgDec.drawJpg(0, 0, jpeg, size);
+    activeDecoder_ = nullptr;
+
+    // コールバックからの打ち切り（JDR_INTR）は正常終了扱い
+    if (result != JDR_OK && !(result == JDR_INTR && stats_.terminatedEarly)) {
+        Serial.printf("[JpegLedDecoder] Decode failed (%d)\n", static_cast<int>(result));
+        return false;
+    }
+    finishFrame();
+    stats_.decodeTimeUs = micros() - startUs;
+    return true;
+}
+#endif
+
+} // namespace LEDSphere
@@ -4,6 +4,7 @@
  */
 
 #include "led/LEDSphereManager.h"
+#include "led/PanoramaTexture.h"
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
@@ -62,6 +63,8 @@ LEDSphereManager::LEDSphereManager()
     lastPosture_.quaternionZ = 0.0f;
     lastPosture_.latitudeOffset = 0.0f;
     lastPosture_.longitudeOffset = 0.0f;
+
+    setUVCacheEpsilonDegrees(uvCacheEpsilonDeg_);
     
     Serial.println("[LEDSphereManager] Constructor called");
 }
@@ -76,6 +79,16 @@ LEDSphereManager::~LEDSphereManager() {
     layoutPositions_.clear();
     latitudeCacheDeg_.clear();
     longitudeCacheDeg_.clear();
+    latLonIndex_.clear();
+    sphereIndex_.clear();
+    layoutX_.clear();
+    layoutY_.clear();
+    layoutZ_.clear();
+    rotatedX_.clear();
+    rotatedY_.clear();
+    rotatedZ_.clear();
+    uvU_.clear();
+    uvV_.clear();
     layoutLoaded_ = false;
 }
 
@@ -125,6 +138,7 @@ bool LEDSphereManager::initializeLedHardware(uint8_t numStrips, const std::vecto
     }
     memset(frameBuffer_, 0, sizeof(CRGB) * total);
     totalLeds_ = total;
+    activeLEDCount_ = 0;
 
     // Register each strip with FastLED using offsets into the single framebuffer
     size_t offset = 0;
@@ -232,20 +246,139 @@ bool LEDSphereManager::loadLayoutFromCSV(const char* csvPath) {
 }
 
 void LEDSphereManager::buildLayoutCaches() {
-    latitudeCacheDeg_.resize(layoutPositions_.size());
-    longitudeCacheDeg_.resize(layoutPositions_.size());
-    for (size_t i = 0; i < layoutPositions_.size(); ++i) {
+    const size_t count = layoutPositions_.size();
+    latitudeCacheDeg_.resize(count);
+    longitudeCacheDeg_.resize(count);
+    layoutX_.resize(count);
+    layoutY_.resize(count);
+    layoutZ_.resize(count);
+    rotatedX_.assign(count, 0.0f);
+    rotatedY_.assign(count, 0.0f);
+    rotatedZ_.assign(count, 0.0f);
+    uvU_.assign(count, 0.0f);
+    uvV_.assign(count, 0.0f);
+    ledGeometry_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
         const auto& pos = layoutPositions_[i];
         latitudeCacheDeg_[i] = computeLatitudeDeg(pos.x, pos.y, pos.z);
         longitudeCacheDeg_[i] = computeLongitudeDeg(pos.x, pos.y, pos.z);
+        layoutX_[i] = pos.x;
+        layoutY_[i] = pos.y;
+        layoutZ_[i] = pos.z;
+        ledGeometry_[i] = {pos.faceID, pos.x, pos.y, pos.z, latitudeCacheDeg_[i], longitudeCacheDeg_[i]};
+    }
+    std::vector<uint16_t> faceIDs(count);
+    for (size_t i = 0; i < count; ++i) {
+        faceIDs[i] = layoutPositions_[i].faceID;
+    }
+    latLonIndex_.build(latitudeCacheDeg_.data(), longitudeCacheDeg_.data(), faceIDs.data(), count);
+    sphereIndex_.build(layoutX_.data(), layoutY_.data(), layoutZ_.data(), faceIDs.data(), count);
+    buildFootprintCache();
+    uvCacheValid_ = false;
+}
+
+void LEDSphereManager::buildFootprintCache() {
+    // 最近傍LEDとの角距離をLEDの覆う角度幅とみなす（レイアウト読込時に1回のみ）
+    // 自身は距離0で必ず先頭に来るため、k=2の2番目が最近傍（sphereIndex_構築後に呼ぶこと）
+    const size_t count = layoutX_.size();
+    footprintRad_.assign(count, 0.0f);
+    mipLevelKey_ = 0;
+    std::vector<SphereIndex::Neighbor> neighbors;
+    for (size_t i = 0; i < count; ++i) {
+        const float xi = layoutX_[i], yi = layoutY_[i], zi = layoutZ_[i];
+        if (xi * xi + yi * yi + zi * zi <= 0.0001f * 0.0001f) {
+            continue;
+        }
+        if (sphereIndex_.nearestK(xi, yi, zi, 2, neighbors) == 2) {
+            footprintRad_[i] = neighbors[1].distanceRad;
+        }
+    }
+}
+
+void LEDSphereManager::refreshMipLevelsIfNeeded() {
+    if (!panoramaTexture_) {
+        return;
+    }
+    const uint32_t key = (static_cast<uint32_t>(panoramaTexture_->height()) << 8) | panoramaTexture_->mipLevelCount();
+    if (key == mipLevelKey_ && mipLevel_.size() == footprintRad_.size()) {
+        return;
+    }
+    mipLevel_.resize(footprintRad_.size());
+    for (size_t i = 0; i < footprintRad_.size(); ++i) {
+        mipLevel_[i] = panoramaTexture_->selectMipLevel(footprintRad_[i]);
+    }
+    mipLevelKey_ = key;
+}
+
+void LEDSphereManager::setPanoramaTexture(const PanoramaTexture* texture, TextureFilter filter) {
+    panoramaTexture_ = texture;
+    textureFilter_ = filter;
+    mipLevelKey_ = 0;
+    texelLookupKey_ = 0;
+}
+
+uint64_t LEDSphereManager::currentTexelLookupKey() const {
+    // 解像度・ミップ構成・フィルタが同じならオフセットは画像内容に依存しない
+    return (static_cast<uint64_t>(panoramaTexture_->width()) << 40) |
+           (static_cast<uint64_t>(panoramaTexture_->height()) << 24) |
+           (static_cast<uint64_t>(panoramaTexture_->mipLevelCount()) << 16) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(textureFilter_)) << 8) | 1u;
+}
+
+void LEDSphereManager::computeTexelTaps(uint16_t width, uint16_t height, std::vector<TexelTap>& out) {
+    updateUVCacheIfNeeded();
+    const size_t count = uvU_.size();
+    out.resize(count);
+    const float invPi = 1.0f / static_cast<float>(M_PI);
+    const float invTwoPi = 0.5f * invPi;
+    const size_t stride = static_cast<size_t>(width) * 3;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t texU = PanoramaTexture::wrapUToQ16((uvV_[i] + static_cast<float>(M_PI)) * invTwoPi);
+        const uint32_t texV = PanoramaTexture::clampVToQ16(uvU_[i] * invPi);
+        out[i] = PanoramaTexture::computeBilinearTap(texU, texV, width, height, stride);
+    }
+    ++texelTapComputeCount_;
+}
+
+void LEDSphereManager::refreshTexelLookupIfNeeded() {
+    const uint64_t key = currentTexelLookupKey();
+    const size_t count = uvU_.size();
+    if (key == texelLookupKey_ && texelLookupGeneration_ == uvGeneration_ && texelLookup_.size() == count) {
+        return;
     }
+
+    texelLookup_.resize(count);
+    const float invPi = 1.0f / static_cast<float>(M_PI);
+    const float invTwoPi = 0.5f * invPi;
+    const bool useMip = textureFilter_ == TextureFilter::kMipmap;
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t texU = PanoramaTexture::wrapUToQ16((uvV_[i] + static_cast<float>(M_PI)) * invTwoPi);
+        const uint32_t texV = PanoramaTexture::clampVToQ16(uvU_[i] * invPi);
+        if (textureFilter_ == TextureFilter::kNearest) {
+            texelLookup_[i] = panoramaTexture_->makeNearestTap(texU, texV);
+        } else {
+            texelLookup_[i] = panoramaTexture_->makeBilinearTap(texU, texV, useMip ? mipLevel_[i] : 0);
+        }
+    }
+    texelLookupKey_ = key;
+    texelLookupGeneration_ = uvGeneration_;
+    ++texelLookupBakeCount_;
 }
 
+#ifdef UNIT_TEST
+void LEDSphereManager::setLayoutForTest(const std::vector<LEDPosition>& positions) {
+    layoutPositions_ = positions;
+    buildLayoutCaches();
+    layoutLoaded_ = !layoutPositions_.empty();
+}
+#endif
+
 float LEDSphereManager::computeLatitudeDeg(float x, float y, float z) {
     (void)x;
     (void)z;
     float clampedY = clampValue(y, -1.0f, 1.0f);
-    return radToDeg(fast_asin(clampedY));
+    // レイアウト読込時のみ実行。fast_asin（Taylor 5次）は極付近で十数度ずれるため標準関数を使う
+    return radToDeg(asinf(clampedY));
 }
 
 float LEDSphereManager::computeLongitudeDeg(float x, float y, float z) {
@@ -253,11 +386,6 @@ float LEDSphereManager::computeLongitudeDeg(float x, float y, float z) {
     return radToDeg(fast_atan2(z, x));
 }
 
-float LEDSphereManager::wrappedLongitudeDifference(float aDeg, float bDeg) {
-    float diff = fmodf(aDeg - bDeg + 540.0f, 360.0f) - 180.0f;
-    return fabsf(diff);
-}
-
 // ========== 姿勢・座標制御 ==========
 
 void LEDSphereManager::setIMUPosture(float qw, float qx, float qy, float qz) {
@@ -265,18 +393,28 @@ void LEDSphereManager::setIMUPosture(float qw, float qx, float qy, float qz) {
     lastPosture_.quaternionX = qx;
     lastPosture_.quaternionY = qy;
     lastPosture_.quaternionZ = qz;
-    Serial.printf("[LEDSphereManager] IMU Posture set: (%.3f, %.3f, %.3f, %.3f)\n", qw, qx, qy, qz);
+    if (imageDebugLogging_) {
+        Serial.printf("[LEDSphereManager] IMU Posture set: (%.3f, %.3f, %.3f, %.3f)\n", qw, qx, qy, qz);
+    }
 }
 
 void LEDSphereManager::setUIOffset(float latOffset, float lonOffset) {
     lastPosture_.latitudeOffset = latOffset;
     lastPosture_.longitudeOffset = lonOffset;
-    Serial.printf("[LEDSphereManager] UI Offset set: (lat=%.1f, lon=%.1f)\n", latOffset, lonOffset);
+    if (imageDebugLogging_) {
+        Serial.printf("[LEDSphereManager] UI Offset set: (lat=%.1f, lon=%.1f)\n", latOffset, lonOffset);
+    }
 }
 
 void LEDSphereManager::setPostureParams(const PostureParams& params) {
     lastPosture_ = params;
-    Serial.println("[LEDSphereManager] Posture params set");
+}
+
+void LEDSphereManager::setUVCacheEpsilonDegrees(float degrees) {
+    uvCacheEpsilonDeg_ = std::max(0.0f, degrees);
+    // |q1・q2| >= cos(θ/2) なら回転差は θ 未満
+    uvCacheCosHalfEpsilon_ = cosf(degToRad(uvCacheEpsilonDeg_) * 0.5f);
+    uvCacheValid_ = false;
 }
 
 // ========== LED制御 ==========
@@ -286,16 +424,45 @@ void LEDSphereManager::setLED(uint16_t faceID, CRGB color) {
         Serial.printf("[LEDSphereManager] Invalid faceID: %d\n", faceID);
         return;
     }
-    frameBuffer_[faceID] = color;
+    writeLED(faceID, color);
+}
+
+void LEDSphereManager::setAllLEDsRGB(const uint8_t* rgb, size_t count) {
+    if (!frameBuffer_ || !rgb) return;
+    if (count > totalLeds_) {
+        count = totalLeds_;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        writeLED(i, CRGB(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]));
+    }
+}
+
+void LEDSphereManager::setAllLEDs(const CRGB* colors, size_t count) {
+    if (!frameBuffer_ || !colors) return;
+    if (count > totalLeds_) {
+        count = totalLeds_;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        writeLED(i, colors[i]);
+    }
 }
 
 void LEDSphereManager::setLEDByUV(float u, float v, CRGB color, float radius) {
-    Serial.printf("[LEDSphereManager] UV LED set: (%.3f, %.3f) RGB(%d,%d,%d) r=%.3f\n", 
-                  u, v, color.r, color.g, color.b, radius);
     if (!frameBuffer_) return;
-    float clampedU = clampValue(u, 0.0f, 1.0f);
-    size_t index = static_cast<size_t>(clampedU * (totalLeds_ - 1));
-    frameBuffer_[index] = color;
+    float x, y, z;
+    uvToDirection(u, v, x, y, z);
+    sphereIndex_.within(x, y, z, radius * static_cast<float>(M_PI), rangeScratch_);
+    if (rangeScratch_.empty()) {
+        const uint16_t closest = sphereIndex_.nearest(x, y, z);
+        if (closest != SphereIndex::kNone) {
+            rangeScratch_.push_back(closest);
+        }
+    }
+    for (uint16_t id : rangeScratch_) {
+        if (id < totalLeds_) {
+            writeLED(id, color);
+        }
+    }
 }
 
 void LEDSphereManager::clearAllLEDs() {
@@ -308,6 +475,7 @@ void LEDSphereManager::clearAllLEDs() {
     for (size_t i = 0; i < totalLeds_; ++i) {
         frameBuffer_[i] = CRGB(0, 0, 0);
     }
+    activeLEDCount_ = 0;
 }
 
 void LEDSphereManager::setBrightness(uint8_t brightness) {
@@ -324,9 +492,11 @@ void LEDSphereManager::show() {
     showCalledForTest_ = true;
     operationLog_.push_back("show");
 #endif
+    profiler_.beginStage(FrameStage::kShow);
 #if defined(USE_FASTLED)
     FastLED.show();
 #endif
+    profiler_.endStage(FrameStage::kShow);
 }
 
 // ========== 高速パターン描画 ==========
@@ -341,16 +511,13 @@ void LEDSphereManager::drawCoordinateAxis(bool showGrid, float brightness) {
 void LEDSphereManager::drawLatitudeLine(float latitude, CRGB color, uint8_t lineWidth) {
     if (!frameBuffer_) return;
 
-    if (layoutLoaded_ && layoutPositions_.size() == latitudeCacheDeg_.size()) {
+    if (layoutLoaded_ && latLonIndex_.size() == layoutPositions_.size()) {
         float tolerance = std::max(1.0f, static_cast<float>(lineWidth) * 2.0f);
-        for (size_t i = 0; i < layoutPositions_.size(); ++i) {
-            if (fabsf(latitudeCacheDeg_[i] - latitude) <= tolerance) {
-                uint16_t id = layoutPositions_[i].faceID;
-                if (id < totalLeds_) {
-                    frameBuffer_[id] = color;
-                }
+        latLonIndex_.forEachInLatitudeBand(latitude, tolerance, [&](uint16_t id) {
+            if (id < totalLeds_) {
+                writeLED(id, color);
             }
-        }
+        });
         return;
     }
 
@@ -360,7 +527,7 @@ void LEDSphereManager::drawLatitudeLine(float latitude, CRGB color, uint8_t line
     size_t start = (center > bandWidth) ? center - bandWidth : 0;
     size_t end = std::min(totalLeds_, center + bandWidth + 1);
     for (size_t i = start; i < end; ++i) {
-        frameBuffer_[i] = color;
+        writeLED(i, color);
     }
 #ifdef UNIT_TEST
     char buffer[48];
@@ -372,17 +539,13 @@ void LEDSphereManager::drawLatitudeLine(float latitude, CRGB color, uint8_t line
 void LEDSphereManager::drawLongitudeLine(float longitude, CRGB color, uint8_t lineWidth) {
     if (!frameBuffer_) return;
 
-    if (layoutLoaded_ && layoutPositions_.size() == longitudeCacheDeg_.size()) {
+    if (layoutLoaded_ && latLonIndex_.size() == layoutPositions_.size()) {
         float tolerance = std::max(2.0f, static_cast<float>(lineWidth) * 4.0f);
-        for (size_t i = 0; i < layoutPositions_.size(); ++i) {
-            float diff = wrappedLongitudeDifference(longitudeCacheDeg_[i], longitude);
-            if (diff <= tolerance) {
-                uint16_t id = layoutPositions_[i].faceID;
-                if (id < totalLeds_) {
-                    frameBuffer_[id] = color;
-                }
+        latLonIndex_.forEachInLongitudeBand(longitude, tolerance, [&](uint16_t id) {
+            if (id < totalLeds_) {
+                writeLED(id, color);
             }
-        }
+        });
         return;
     }
 
@@ -395,7 +558,7 @@ void LEDSphereManager::drawLongitudeLine(float longitude, CRGB color, uint8_t li
     size_t start = (center > bandWidth) ? center - bandWidth : 0;
     size_t end = std::min(totalLeds_, center + bandWidth + 1);
     for (size_t i = start; i < end; ++i) {
-        frameBuffer_[i] = color;
+        writeLED(i, color);
     }
 #ifdef UNIT_TEST
     char buffer[48];
@@ -409,7 +572,7 @@ void LEDSphereManager::drawSparsePattern(const std::map<uint16_t, CRGB>& points)
     if (!frameBuffer_) return;
     for (const auto& entry : points) {
         if (entry.first < totalLeds_) {
-            frameBuffer_[entry.first] = entry.second;
+            writeLED(entry.first, entry.second);
         }
     }
 }
@@ -472,7 +635,7 @@ void LEDSphereManager::drawAxisMarkers() {
 
         for (const auto& marker : selected) {
             if (marker.faceID < totalLeds_) {
-                frameBuffer_[marker.faceID] = color;
+                writeLED(marker.faceID, color);
             }
         }
     };
@@ -485,17 +648,26 @@ void LEDSphereManager::drawAxisMarkers() {
 // ========== 検索・クエリ機能 ==========
 
 uint16_t LEDSphereManager::findClosestLED(float u, float v) const {
-    Serial.printf("[LEDSphereManager] Finding closest LED for UV(%.3f, %.3f)\n", u, v);
-    
-    // TODO: 実際の最寄りLED検索
-    return LED_COUNT; // 見つからない場合
+    float x, y, z;
+    uvToDirection(u, v, x, y, z);
+    const uint16_t closest = sphereIndex_.nearest(x, y, z);
+    return closest == SphereIndex::kNone ? LED_COUNT : closest;
 }
 
 std::vector<uint16_t> LEDSphereManager::findLEDsInRange(float u, float v, float radius) const {
-    Serial.printf("[LEDSphereManager] Finding LEDs in range UV(%.3f, %.3f) r=%.3f\n", u, v, radius);
-    
-    // TODO: 範囲内LED検索
-    return std::vector<uint16_t>();
+    std::vector<uint16_t> result;
+    float x, y, z;
+    uvToDirection(u, v, x, y, z);
+    sphereIndex_.within(x, y, z, radius * static_cast<float>(M_PI), result);
+    return result;
+}
+
+void LEDSphereManager::uvToDirection(float u, float v, float& x, float& y, float& z) {
+    // u は経度方向に周回、v は極で飽和
+    const float wrappedU = u - floorf(u);
+    const float latitude = clampValue(v, 0.0f, 1.0f) * 180.0f - 90.0f;
+    const float longitude = wrappedU * 360.0f - 180.0f;
+    SphereIndex::latLonToUnit(latitude, longitude, x, y, z);
 }
 
 UVCoordinate LEDSphereManager::transformToUV(float x, float y, float z) const {
@@ -519,6 +691,14 @@ UVCoordinate LEDSphereManager::transformToUV(float x, float y, float z) const {
     return result;
 }
 
+UVCoordinate LEDSphereManager::toLatLonUV(const UVCoordinate& polarAzimuth) {
+    // 緯度 = 90度 - 極角、経度 atan2(z, x) = 90度 - 方位角 atan2(x, z)
+    const float invPi = 1.0f / static_cast<float>(M_PI);
+    const float v = 1.0f - polarAzimuth.u * invPi;
+    const float u = 0.75f - polarAzimuth.v * 0.5f * invPi;
+    return UVCoordinate(u - floorf(u), v);
+}
+
 const LEDPosition* LEDSphereManager::getLEDPosition(uint16_t faceID) const {
     if (faceID >= LED_COUNT) {
         Serial.printf("[LEDSphereManager] Invalid faceID for position query: %d\n", faceID);
@@ -532,36 +712,35 @@ const LEDPosition* LEDSphereManager::getLEDPosition(uint16_t faceID) const {
 // ========== パフォーマンス監視 ==========
 
 void LEDSphereManager::frameStart() {
-    // TODO: フレーム開始時刻記録
-    Serial.println("[LEDSphereManager] Frame start");
+    profiler_.frameStart();
 }
 
 void LEDSphereManager::frameEnd() {
-    // TODO: フレーム終了時刻記録とFPS計算
-    Serial.println("[LEDSphereManager] Frame end");
+    profiler_.frameEnd();
 }
 
 PerformanceStats LEDSphereManager::getPerformanceStats() const {
     PerformanceStats stats;
-    
-    // TODO: 実際の統計情報取得
-    stats.currentFPS = 30.0f;
-    stats.averageRenderTime = 33.3f;
-    stats.frameCount = 0;
-    stats.activeLEDCount = 0;
-    stats.memoryUsage = sizeof(*this);
-    
+    stats.frameTime = profiler_.frameSummary();
+    for (size_t i = 0; i < kFrameStageCount; ++i) {
+        stats.stageTime[i] = profiler_.stageSummary(static_cast<FrameStage>(i));
+    }
+    stats.currentFPS = profiler_.currentFPS();
+    stats.averageRenderTime = static_cast<float>(stats.frameTime.avgUs) / 1000.0f;
+    stats.frameCount = profiler_.frameCount();
+    stats.droppedFrames = profiler_.droppedFrames();
+    stats.targetFPS = targetFPS_;
+    stats.activeLEDCount = activeLEDCount_;
+    stats.memoryUsage = sizeof(*this) + sizeof(CRGB) * totalLeds_;
     return stats;
 }
 
 float LEDSphereManager::getCurrentFPS() const {
-    // TODO: 実際のFPS計算
-    return 30.0f;
+    return profiler_.currentFPS();
 }
 
 uint16_t LEDSphereManager::getActiveLEDCount() const {
-    // TODO: アクティブLED数カウント
-    return 0;
+    return activeLEDCount_;
 }
 
 // ========== デバッグ・ユーティリティ ==========
@@ -574,6 +753,20 @@ void LEDSphereManager::printSystemStatus() const {
     
     PerformanceStats stats = getPerformanceStats();
     Serial.printf("Current FPS: %.2f\n", stats.currentFPS);
+    Serial.printf("Frames: %lu (dropped %lu)\n",
+                  static_cast<unsigned long>(stats.frameCount), static_cast<unsigned long>(stats.droppedFrames));
+    static const char* const kStageNames[kFrameStageCount] = {"transform", "sample", "composite", "show"};
+    Serial.printf("  %-9s min/avg/p95/p99/max = %lu/%lu/%lu/%lu/%lu us\n", "frame",
+                  static_cast<unsigned long>(stats.frameTime.minUs), static_cast<unsigned long>(stats.frameTime.avgUs),
+                  static_cast<unsigned long>(stats.frameTime.p95Us), static_cast<unsigned long>(stats.frameTime.p99Us),
+                  static_cast<unsigned long>(stats.frameTime.maxUs));
+    for (size_t i = 0; i < kFrameStageCount; ++i) {
+        const TimingSummary& t = stats.stageTime[i];
+        Serial.printf("  %-9s min/avg/p95/p99/max = %lu/%lu/%lu/%lu/%lu us\n", kStageNames[i],
+                      static_cast<unsigned long>(t.minUs), static_cast<unsigned long>(t.avgUs),
+                      static_cast<unsigned long>(t.p95Us), static_cast<unsigned long>(t.p99Us),
+                      static_cast<unsigned long>(t.maxUs));
+    }
     Serial.printf("Active LEDs: %d\n", stats.activeLEDCount);
     Serial.printf("Memory Usage: %zu bytes\n", stats.memoryUsage);
     
@@ -619,12 +812,12 @@ bool LEDSphereManager::initializeComponents() {
 bool LEDSphereManager::hasPostureChanged(const PostureParams& params) const {
     const float epsilon = 0.001f;
     
-    return (abs(params.quaternionW - lastPosture_.quaternionW) > epsilon) ||
-           (abs(params.quaternionX - lastPosture_.quaternionX) > epsilon) ||
-           (abs(params.quaternionY - lastPosture_.quaternionY) > epsilon) ||
-           (abs(params.quaternionZ - lastPosture_.quaternionZ) > epsilon) ||
-           (abs(params.latitudeOffset - lastPosture_.latitudeOffset) > epsilon) ||
-           (abs(params.longitudeOffset - lastPosture_.longitudeOffset) > epsilon);
+    return (fabsf(params.quaternionW - lastPosture_.quaternionW) > epsilon) ||
+           (fabsf(params.quaternionX - lastPosture_.quaternionX) > epsilon) ||
+           (fabsf(params.quaternionY - lastPosture_.quaternionY) > epsilon) ||
+           (fabsf(params.quaternionZ - lastPosture_.quaternionZ) > epsilon) ||
+           (fabsf(params.latitudeOffset - lastPosture_.latitudeOffset) > epsilon) ||
+           (fabsf(params.longitudeOffset - lastPosture_.longitudeOffset) > epsilon);
 }
 
 void LEDSphereManager::updateAllLEDsFromImage() {
@@ -632,82 +825,224 @@ void LEDSphereManager::updateAllLEDsFromImage() {
         Serial.println("[LEDSphereManager] Cannot update LEDs: framebuffer or layout not ready");
         return;
     }
-    
-    Serial.printf("[LEDSphereManager] Updating %zu LEDs from image using CUBE-neon method\n", layoutPositions_.size());
-    
-    // CUBE-neon実績実装: 全LEDループでIMU変換→UV変換→色抽出
-    for (size_t i = 0; i < layoutPositions_.size(); ++i) {
-        const auto& pos = layoutPositions_[i];
-        
-        // 1. LED座標取得
-        float x = pos.x;
-        float y = pos.y;
-        float z = pos.z;
-        
-        // 2. IMUクォータニオンで回転適用
-        float rotated_x, rotated_y, rotated_z;
-        applyQuaternionRotation(x, y, z, rotated_x, rotated_y, rotated_z);
-        
-        // 3. UV座標変換（CUBE-neon方式）
-        float u = fast_atan2(fast_sqrt(rotated_x * rotated_x + rotated_z * rotated_z), rotated_y);
-        float v = fast_atan2(rotated_x, rotated_z);
-        
-        // 4. 画像から色抽出
-        CRGB color = extractColorFromImageUV(u, v);
-        
-        // 5. LED色設定
-        uint16_t faceID = pos.faceID;
-        if (faceID < totalLeds_) {
-            frameBuffer_[faceID] = color;
+
+    // 1. 姿勢変化時のみ回転行列を生成し、全LEDのUVを一括計算
+    profiler_.beginStage(FrameStage::kTransform);
+    updateUVCacheIfNeeded();
+    profiler_.endStage(FrameStage::kTransform);
+
+    // 2. UV配列から色抽出してLED色設定
+    profiler_.beginStage(FrameStage::kSample);
+    const size_t count = layoutPositions_.size();
+    const float* uArr = uvU_.data();
+    const float* vArr = uvV_.data();
+    if (panoramaTexture_ && panoramaTexture_->isValid()) {
+        const bool useMip = textureFilter_ == TextureFilter::kMipmap;
+        if (useMip) {
+            refreshMipLevelsIfNeeded();
         }
-        
-        // デバッグ出力（最初のLEDのみ）
-        if (i == 0) {
-            Serial.printf("[LEDSphereManager] LED[0]: pos(%.3f,%.3f,%.3f) → rot(%.3f,%.3f,%.3f) → uv(%.3f,%.3f) → RGB(%d,%d,%d)\n",
-                         x, y, z, rotated_x, rotated_y, rotated_z, u, v, color.r, color.g, color.b);
+        if (texelLookupEnabled_) {
+            // 参照テーブル経由: 姿勢・テクスチャ形状が不変ならギャザーのみ
+            refreshTexelLookupIfNeeded();
+            const TexelTap* taps = texelLookup_.data();
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t faceID = layoutPositions_[i].faceID;
+                if (faceID < totalLeds_) {
+                    writeLED(faceID, panoramaTexture_->sampleTap(taps[i]));
+                }
+            }
+        } else {
+            // 極角[0,π]→テクスチャv[0,1]、経度[-π,π]→テクスチャu[0,1)（以降は固定小数点）
+            const float invPi = 1.0f / static_cast<float>(M_PI);
+            const float invTwoPi = 0.5f * invPi;
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t faceID = layoutPositions_[i].faceID;
+                if (faceID >= totalLeds_) continue;
+                const uint32_t texU = PanoramaTexture::wrapUToQ16((vArr[i] + static_cast<float>(M_PI)) * invTwoPi);
+                const uint32_t texV = PanoramaTexture::clampVToQ16(uArr[i] * invPi);
+                if (textureFilter_ == TextureFilter::kNearest) {
+                    writeLED(faceID, panoramaTexture_->sampleNearestQ16(texU, texV));
+                } else {
+                    writeLED(faceID, panoramaTexture_->sampleBilinearQ16(texU, texV, useMip ? mipLevel_[i] : 0));
+                }
+            }
         }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t faceID = layoutPositions_[i].faceID;
+            if (faceID < totalLeds_) {
+                writeLED(faceID, extractColorFromImageUV(uArr[i], vArr[i]));
+            }
+        }
+    }
+    profiler_.endStage(FrameStage::kSample);
+
+    // デバッグ出力（最初のLEDのみ、フラグ有効時）
+    if (imageDebugLogging_ && count > 0) {
+        const CRGB color = extractColorFromImageUV(uArr[0], vArr[0]);
+        Serial.printf("[LEDSphereManager] LED[0]: pos(%.3f,%.3f,%.3f) → rot(%.3f,%.3f,%.3f) → uv(%.3f,%.3f) → RGB(%d,%d,%d)\n",
+                     layoutX_[0], layoutY_[0], layoutZ_[0], rotatedX_[0], rotatedY_[0], rotatedZ_[0],
+                     uArr[0], vArr[0], color.r, color.g, color.b);
     }
 }
 
+void LEDSphereManager::transformLayoutToUV() {
+    float m[9];
+    buildRotationMatrix(lastPosture_, m);
+
+    // 緯度オフセット: IMU回転後にX軸回りで傾ける（R_x(lat) * R_q）
+    if (lastPosture_.latitudeOffset != 0.0f) {
+        const float latRad = degToRad(lastPosture_.latitudeOffset);
+        const float c = cosf(latRad);
+        const float s = sinf(latRad);
+        for (int col = 0; col < 3; ++col) {
+            const float r1 = m[3 + col];
+            const float r2 = m[6 + col];
+            m[3 + col] = c * r1 - s * r2;
+            m[6 + col] = s * r1 + c * r2;
+        }
+    }
+
+    const size_t count = layoutX_.size();
+    const float* __restrict px = layoutX_.data();
+    const float* __restrict py = layoutY_.data();
+    const float* __restrict pz = layoutZ_.data();
+    float* __restrict rx = rotatedX_.data();
+    float* __restrict ry = rotatedY_.data();
+    float* __restrict rz = rotatedZ_.data();
+
+    // 回転パス: 分岐なしの積和のみ（コンパイラがベクトル化可能）
+    for (size_t i = 0; i < count; ++i) {
+        const float x = px[i];
+        const float y = py[i];
+        const float z = pz[i];
+        rx[i] = m[0] * x + m[1] * y + m[2] * z;
+        ry[i] = m[3] * x + m[4] * y + m[5] * z;
+        rz[i] = m[6] * x + m[7] * y + m[8] * z;
+    }
+
+    // UVパス（CUBE-neon方式）
+    // u = atan2(sqrt(x^2 + z^2), y)  // 緯度成分
+    // v = atan2(x, z)                // 経度成分
+    float* __restrict uOut = uvU_.data();
+    float* __restrict vOut = uvV_.data();
+    for (size_t i = 0; i < count; ++i) {
+        const float x = rx[i];
+        const float y = ry[i];
+        const float z = rz[i];
+        uOut[i] = fast_atan2(fast_sqrt(x * x + z * z), y);
+        vOut[i] = fast_atan2(x, z);
+    }
+
+    // 経度オフセットはY軸回りの回転なのでv方向の定数シフトで表現できる
+    uvCachePosture_ = lastPosture_;
+    uvCachePosture_.longitudeOffset = 0.0f;
+    uvCacheValid_ = true;
+    ++uvGeneration_;
+    shiftLongitudeUV(degToRad(lastPosture_.longitudeOffset));
+    uvCachePosture_.longitudeOffset = lastPosture_.longitudeOffset;
+}
+
 void LEDSphereManager::updateUVCacheIfNeeded() {
-    // TODO: UV座標キャッシュ更新判定と実行
-    Serial.println("[LEDSphereManager] UV cache update check");
+    if (uvCacheValid_ && uvU_.size() == layoutX_.size()) {
+        const PostureParams& cur = lastPosture_;
+        const PostureParams& cached = uvCachePosture_;
+
+        // クォータニオン間の回転角: θ = 2·acos(|q1・q2| / (|q1||q2|))
+        float dot = cur.quaternionW * cached.quaternionW + cur.quaternionX * cached.quaternionX +
+                    cur.quaternionY * cached.quaternionY + cur.quaternionZ * cached.quaternionZ;
+        float normCur = cur.quaternionW * cur.quaternionW + cur.quaternionX * cur.quaternionX +
+                        cur.quaternionY * cur.quaternionY + cur.quaternionZ * cur.quaternionZ;
+        float normCached = cached.quaternionW * cached.quaternionW + cached.quaternionX * cached.quaternionX +
+                           cached.quaternionY * cached.quaternionY + cached.quaternionZ * cached.quaternionZ;
+        float denom = fast_sqrt(normCur * normCached);
+        bool rotationStable = denom > 0.0001f && fabsf(dot) / denom >= uvCacheCosHalfEpsilon_;
+        bool latitudeStable = fabsf(cur.latitudeOffset - cached.latitudeOffset) < uvCacheEpsilonDeg_;
+
+        if (rotationStable && latitudeStable) {
+            float lonDelta = cur.longitudeOffset - cached.longitudeOffset;
+            if (fabsf(lonDelta) < uvCacheEpsilonDeg_) {
+                ++uvCacheStats_.hits;
+                return;
+            }
+            shiftLongitudeUV(degToRad(lonDelta));
+            uvCachePosture_.longitudeOffset = cur.longitudeOffset;
+            ++uvCacheStats_.shifts;
+            return;
+        }
+    }
+
+    transformLayoutToUV();
+    ++uvCacheStats_.rebuilds;
+}
+
+void LEDSphereManager::shiftLongitudeUV(float deltaRad) {
+    if (deltaRad == 0.0f) {
+        return;
+    }
+    ++uvGeneration_;
+    const float pi = static_cast<float>(M_PI);
+    const float twoPi = 2.0f * pi;
+    float* v = uvV_.data();
+    const size_t count = uvV_.size();
+    for (size_t i = 0; i < count; ++i) {
+        float shifted = v[i] + deltaRad;
+        // [-π, π) へ巻き戻し
+        shifted -= twoPi * floorf((shifted + pi) / twoPi);
+        v[i] = shifted;
+    }
 }
 
 // ========== CUBE-neon実績実装: 座標変換ヘルパー関数 ==========
 
 void LEDSphereManager::applyQuaternionRotation(float x, float y, float z, 
                                              float& out_x, float& out_y, float& out_z) const {
-    // CUBE-neonからの移植: クォータニオン回転適用
-    // q * v * q^(-1) の計算
-    float qw = lastPosture_.quaternionW;
-    float qx = lastPosture_.quaternionX;
-    float qy = lastPosture_.quaternionY;
-    float qz = lastPosture_.quaternionZ;
+    // CUBE-neonからの移植: クォータニオン回転適用（回転行列経由）
+    float m[9];
+    buildRotationMatrix(lastPosture_, m);
+    out_x = m[0] * x + m[1] * y + m[2] * z;
+    out_y = m[3] * x + m[4] * y + m[5] * z;
+    out_z = m[6] * x + m[7] * y + m[8] * z;
+}
+
+void LEDSphereManager::buildRotationMatrix(const PostureParams& posture, float (&m)[9]) {
+    // q * v * q^(-1) を3x3行列に展開
+    float qw = posture.quaternionW;
+    float qx = posture.quaternionX;
+    float qy = posture.quaternionY;
+    float qz = posture.quaternionZ;
     
-    // クォータニオンの正規化
+    // クォータニオンの正規化（フレームあたり1回）
     float norm = fast_sqrt(qw*qw + qx*qx + qy*qy + qz*qz);
     if (norm > 0.0001f) {
         qw /= norm; qx /= norm; qy /= norm; qz /= norm;
     }
     
-    // ベクトル回転: v' = q * v * q^(-1)
-    // 展開形での高速計算
     float qw2 = qw * qw;
     float qx2 = qx * qx;
     float qy2 = qy * qy;
     float qz2 = qz * qz;
     
-    out_x = (qw2 + qx2 - qy2 - qz2) * x + 2.0f * (qx*qy - qw*qz) * y + 2.0f * (qx*qz + qw*qy) * z;
-    out_y = 2.0f * (qx*qy + qw*qz) * x + (qw2 - qx2 + qy2 - qz2) * y + 2.0f * (qy*qz - qw*qx) * z;
-    out_z = 2.0f * (qx*qz - qw*qy) * x + 2.0f * (qy*qz + qw*qx) * y + (qw2 - qx2 - qy2 + qz2) * z;
+    m[0] = qw2 + qx2 - qy2 - qz2;
+    m[1] = 2.0f * (qx*qy - qw*qz);
+    m[2] = 2.0f * (qx*qz + qw*qy);
+    m[3] = 2.0f * (qx*qy + qw*qz);
+    m[4] = qw2 - qx2 + qy2 - qz2;
+    m[5] = 2.0f * (qy*qz - qw*qx);
+    m[6] = 2.0f * (qx*qz - qw*qy);
+    m[7] = 2.0f * (qy*qz + qw*qx);
+    m[8] = qw2 - qx2 - qy2 + qz2;
 }
 
 CRGB LEDSphereManager::extractColorFromImageUV(float u, float v) const {
     // CUBE-neon実績実装: UV座標から画像色抽出
-    // TODO: 画像データの実装が必要（half-grad-160-80.hスタイル）
+    if (panoramaTexture_ && panoramaTexture_->isValid()) {
+        const float texU = (v + static_cast<float>(M_PI)) / (2.0f * static_cast<float>(M_PI));
+        const float texV = u / static_cast<float>(M_PI);
+        return panoramaTexture_->sample(texU, texV, TextureFilter::kBilinear);
+    }
     
-    // 暫定実装: プロシージャル色生成
+    // テクスチャ未設定時: プロシージャル色生成
     // u: 緯度系（-π/2 〜 π/2） → 0〜1に正規化
     // v: 経度系（-π 〜 π） → 0〜1に正規化
     float norm_u = (u + M_PI/2.0f) / M_PI;
@@ -0,0 +1,69 @@
+/**
+ * @file LatLonIndex.cpp
+ * @brief 緯度・経度の整列インデックス実装
+ */
+
+#include "led/LatLonIndex.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace LEDSphere {
+
+namespace {
+
+void buildSorted(const float* values, const uint16_t* ids, size_t count,
+                 std::vector<float>& keys, std::vector<uint16_t>& sortedIds) {
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [values](uint32_t a, uint32_t b) {
+        return values[a] < values[b];
+    });
+    keys.resize(count);
+    sortedIds.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        keys[i] = values[order[i]];
+        sortedIds[i] = ids[order[i]];
+    }
+}
+
+} // namespace
+
+void LatLonIndex::build(const float* latitudeDeg, const float* longitudeDeg, const uint16_t* ids, size_t count) {
+    buildSorted(latitudeDeg, ids, count, latKeys_, latIds_);
+
+    std::vector<float> normalized(count);
+    for (size_t i = 0; i < count; ++i) {
+        normalized[i] = normalizeLongitude(longitudeDeg[i]);
+    }
+    buildSorted(normalized.data(), ids, count, lonKeys_, lonIds_);
+}
+
+void LatLonIndex::clear() {
+    latKeys_.clear();
+    latIds_.clear();
+    lonKeys_.clear();
+    lonIds_.clear();
+}
+
+std::vector<uint16_t> LatLonIndex::latitudeBand(float latitude, float tolerance) const {
+    std::vector<uint16_t> result;
+    forEachInLatitudeBand(latitude, tolerance, [&result](uint16_t id) { result.push_back(id); });
+    return result;
+}
+
+std::vector<uint16_t> LatLonIndex::longitudeBand(float longitude, float tolerance) const {
+    std::vector<uint16_t> result;
+    forEachInLongitudeBand(longitude, tolerance, [&result](uint16_t id) { result.push_back(id); });
+    return result;
+}
+
+float LatLonIndex::normalizeLongitude(float longitude) {
+    float normalized = fmodf(longitude + kHalfTurn, 2.0f * kHalfTurn);
+    if (normalized < 0.0f) {
+        normalized += 2.0f * kHalfTurn;
+    }
+    return normalized - kHalfTurn;
+}
+
+} // namespace LEDSphere
@@ -0,0 +1,221 @@
+/**
+ * @file LayerCompositor.cpp
+ * @brief レイヤー合成の実装
+ */
+
+#include "led/LayerCompositor.h"
+
+#include <algorithm>
+
+namespace LEDSphere {
+
+namespace {
+
+// a × b / 255（四捨五入、8bit範囲で厳密）
+inline uint8_t mul255(uint32_t a, uint32_t b) {
+    const uint32_t t = a * b + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+inline uint8_t lerp8(uint8_t dst, uint8_t src, uint8_t alpha) {
+    return src >= dst ? static_cast<uint8_t>(dst + mul255(src - dst, alpha))
+                      : static_cast<uint8_t>(dst - mul255(dst - src, alpha));
+}
+
+template <BlendMode Mode>
+inline uint8_t blendChannel(uint8_t dst, uint8_t src, uint8_t alpha) {
+    switch (Mode) {
+        case BlendMode::kAdd:
+            return static_cast<uint8_t>(std::min<uint32_t>(255, dst + mul255(src, alpha)));
+        case BlendMode::kScreen:
+            return lerp8(dst, static_cast<uint8_t>(255 - mul255(255 - dst, 255 - src)), alpha);
+        case BlendMode::kMultiply:
+            return lerp8(dst, mul255(dst, src), alpha);
+        case BlendMode::kAlphaOver:
+        default:
+            return lerp8(dst, src, alpha);
+    }
+}
+
+template <BlendMode Mode>
+inline void blendPixel(CRGB& out, const CRGB& src, uint8_t alpha) {
+    out.r = blendChannel<Mode>(out.r, src.r, alpha);
+    out.g = blendChannel<Mode>(out.g, src.g, alpha);
+    out.b = blendChannel<Mode>(out.b, src.b, alpha);
+}
+
+// outには下位レイヤーの結果が入っている前提で、このレイヤーを重ねる
+template <BlendMode Mode>
+void blendInto(CRGB* out, const CRGB* color, const uint8_t* alpha, uint8_t opacity,
+               const uint16_t* indices, size_t indexCount, size_t ledCount) {
+    if (indices) {
+        for (size_t n = 0; n < indexCount; ++n) {
+            const uint16_t i = indices[n];
+            const uint8_t a = opacity == 255 ? alpha[i] : mul255(alpha[i], opacity);
+            if (a) blendPixel<Mode>(out[i], color[i], a);
+        }
+        return;
+    }
+    for (size_t i = 0; i < ledCount; ++i) {
+        const uint8_t a = opacity == 255 ? alpha[i] : mul255(alpha[i], opacity);
+        if (a) blendPixel<Mode>(out[i], color[i], a);
+    }
+}
+
+} // namespace
+
+LayerCompositor::LayerCompositor(size_t ledCount) : ledCount_(ledCount) {
+    layers_.reserve(kMaxLayers);
+}
+
+LayerCompositor::LayerId LayerCompositor::addLayer(Storage storage, BlendMode mode, uint8_t opacity) {
+    if (layers_.size() >= kMaxLayers) {
+        return kInvalidLayer;
+    }
+    layers_.emplace_back();
+    Layer& layer = layers_.back();
+    layer.storage = storage;
+    layer.mode = mode;
+    layer.opacity = opacity;
+    layer.color.assign(ledCount_, CRGB(0, 0, 0));
+    layer.alpha.assign(ledCount_, 0);
+    layer.composite.assign(ledCount_, CRGB(0, 0, 0));
+    if (storage == Storage::kSparse) {
+        layer.listed.assign(ledCount_, 0);
+    }
+    return static_cast<LayerId>(layers_.size() - 1);
+}
+
+void LayerCompositor::setPixel(LayerId id, uint16_t index, const CRGB& color, uint8_t alpha) {
+    if (id >= layers_.size() || index >= ledCount_) return;
+    Layer& layer = layers_[id];
+    if (layer.storage == Storage::kSparse && !layer.listed[index]) {
+        if (alpha == 0) return;  // 未使用LEDを透明にするだけなら変化なし
+        layer.listed[index] = 1;
+        layer.touched.push_back(index);
+    }
+    layer.color[index] = color;
+    layer.alpha[index] = alpha;
+    layer.dirty = true;
+}
+
+void LayerCompositor::setRGB(LayerId id, const uint8_t* rgb, size_t count) {
+    if (id >= layers_.size() || !rgb) return;
+    count = std::min(count, ledCount_);
+    Layer& layer = layers_[id];
+    if (layer.storage == Storage::kSparse) {
+        for (size_t i = 0; i < count; ++i) {
+            setPixel(id, static_cast<uint16_t>(i), CRGB(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]));
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        layer.color[i] = CRGB(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        layer.alpha[i] = 255;
+    }
+    layer.dirty = true;
+}
+
+void LayerCompositor::clearLayer(LayerId id) {
+    if (id >= layers_.size()) return;
+    Layer& layer = layers_[id];
+    if (layer.storage == Storage::kSparse) {
+        if (layer.touched.empty()) return;
+        for (uint16_t i : layer.touched) {
+            layer.alpha[i] = 0;
+            layer.listed[i] = 0;
+        }
+        layer.touched.clear();
+    } else {
+        std::fill(layer.alpha.begin(), layer.alpha.end(), 0);
+    }
+    layer.dirty = true;
+}
+
+void LayerCompositor::setBlendMode(LayerId id, BlendMode mode) {
+    if (id >= layers_.size() || layers_[id].mode == mode) return;
+    layers_[id].mode = mode;
+    layers_[id].dirty = true;
+}
+
+void LayerCompositor::setOpacity(LayerId id, uint8_t opacity) {
+    if (id >= layers_.size() || layers_[id].opacity == opacity) return;
+    layers_[id].opacity = opacity;
+    layers_[id].dirty = true;
+}
+
+void LayerCompositor::setVisible(LayerId id, bool visible) {
+    if (id >= layers_.size() || layers_[id].visible == visible) return;
+    layers_[id].visible = visible;
+    layers_[id].dirty = true;
+}
+
+void LayerCompositor::blendLayer(const Layer& layer, const CRGB* below, CRGB* out) const {
+    if (below) {
+        std::copy(below, below + ledCount_, out);
+    } else {
+        std::fill(out, out + ledCount_, CRGB(0, 0, 0));
+    }
+    if (!layer.visible || layer.opacity == 0) return;
+
+    const bool sparse = layer.storage == Storage::kSparse;
+    const uint16_t* indices = sparse ? layer.touched.data() : nullptr;
+    const size_t indexCount = sparse ? layer.touched.size() : 0;
+    const CRGB* color = layer.color.data();
+    const uint8_t* alpha = layer.alpha.data();
+    switch (layer.mode) {
+        case BlendMode::kAdd:
+            blendInto<BlendMode::kAdd>(out, color, alpha, layer.opacity, indices, indexCount, ledCount_);
+            break;
+        case BlendMode::kScreen:
+            blendInto<BlendMode::kScreen>(out, color, alpha, layer.opacity, indices, indexCount, ledCount_);
+            break;
+        case BlendMode::kMultiply:
+            blendInto<BlendMode::kMultiply>(out, color, alpha, layer.opacity, indices, indexCount, ledCount_);
+            break;
+        case BlendMode::kAlphaOver:
+        default:
+            blendInto<BlendMode::kAlphaOver>(out, color, alpha, layer.opacity, indices, indexCount, ledCount_);
+            break;
+    }
+}
+
+bool LayerCompositor::compose() {
+    size_t first = 0;
+    while (first < layers_.size() && !layers_[first].dirty) {
+        ++first;
+    }
+    if (first == layers_.size()) {
+        return false;
+    }
+
+    // firstより下の途中結果はそのまま使い、first以降を積み直す
+    stats_.layersReused += static_cast<uint32_t>(first);
+    for (size_t i = first; i < layers_.size(); ++i) {
+        const CRGB* below = i > 0 ? layers_[i - 1].composite.data() : nullptr;
+        blendLayer(layers_[i], below, layers_[i].composite.data());
+        layers_[i].dirty = false;
+    }
+    stats_.layersBlended += static_cast<uint32_t>(layers_.size() - first);
+    ++stats_.composes;
+    return true;
+}
+
+const CRGB* LayerCompositor::output() const {
+    return layers_.empty() ? nullptr : layers_.back().composite.data();
+}
+
+bool LayerCompositor::present(LEDSphereManager& manager, bool force) {
+    const bool changed = compose();
+    if (!changed && !force) {
+        return false;
+    }
+    const CRGB* result = output();
+    if (!result) {
+        return false;
+    }
+    manager.setAllLEDs(result, ledCount_);
+    return true;
+}
+
+} // namespace LEDSphere
@@ -0,0 +1,288 @@
+/**
+ * @file PanoramaTexture.cpp
+ * @brief 正距円筒パノラマ画像テクスチャ実装
+ */
+
+#include "led/PanoramaTexture.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "esp_heap_caps.h"
+#endif
+
+namespace LEDSphere {
+
+namespace {
+// Q16座標の乗算がuint32に収まる上限（65536 * 8192 = 2^29）
+constexpr uint16_t kMaxDimension = 8192;
+constexpr int32_t kHalfTexelQ16 = 1 << 15;
+}
+
+PanoramaTexture::PanoramaTexture() {}
+
+PanoramaTexture::~PanoramaTexture() { release(); }
+
+uint8_t* PanoramaTexture::allocatePixels(size_t bytes) {
+    void* p = nullptr;
+#ifdef ARDUINO_ARCH_ESP32
+    p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+#endif
+    if (!p) {
+        p = malloc(bytes);
+    }
+    return static_cast<uint8_t*>(p);
+}
+
+void PanoramaTexture::freePixels(uint8_t* pixels) {
+    // ESP-IDFのfree()はheap_caps_malloc確保領域も解放できる
+    free(pixels);
+}
+
+bool PanoramaTexture::allocate(uint16_t width, uint16_t height) {
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension) {
+        return false;
+    }
+    if (isValid() && width == levels_[0].width && height == levels_[0].height) {
+        releaseMipLevels();
+        memset(levels_[0].pixels, 0, levels_[0].stride * height);
+        return true;
+    }
+
+    release();
+    const size_t stride = static_cast<size_t>(width) * 3;
+    uint8_t* pixels = allocatePixels(stride * height);
+    if (!pixels) {
+        return false;
+    }
+    memset(pixels, 0, stride * height);
+    levels_[0].pixels = pixels;
+    levels_[0].width = width;
+    levels_[0].height = height;
+    levels_[0].stride = stride;
+    levelCount_ = 1;
+    return true;
+}
+
+bool PanoramaTexture::loadRGB888(const uint8_t* pixels, uint16_t width, uint16_t height, size_t srcStride) {
+    if (!pixels || !allocate(width, height)) {
+        return false;
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * 3;
+    if (srcStride == 0) {
+        srcStride = rowBytes;
+    }
+    for (uint16_t y = 0; y < height; ++y) {
+        memcpy(levels_[0].pixels + y * levels_[0].stride, pixels + y * srcStride, rowBytes);
+    }
+    return true;
+}
+
+void PanoramaTexture::release() {
+    releaseMipLevels();
+    if (levels_[0].pixels) {
+        freePixels(levels_[0].pixels);
+    }
+    levels_[0] = Level();
+    levelCount_ = 0;
+}
+
+void PanoramaTexture::releaseMipLevels() {
+    for (uint8_t i = 1; i < kMaxMipLevels; ++i) {
+        if (levels_[i].pixels) {
+            freePixels(levels_[i].pixels);
+        }
+        levels_[i] = Level();
+    }
+    levelCount_ = isValid() ? 1 : 0;
+}
+
+bool PanoramaTexture::buildMipChain(uint8_t maxLevels) {
+    if (!isValid()) {
+        return false;
+    }
+    releaseMipLevels();
+    if (maxLevels > kMaxMipLevels) {
+        maxLevels = kMaxMipLevels;
+    }
+
+    while (levelCount_ < maxLevels) {
+        const Level& src = levels_[levelCount_ - 1];
+        if (src.width == 1 && src.height == 1) {
+            break;
+        }
+        Level dst;
+        dst.width = src.width > 1 ? src.width / 2 : 1;
+        dst.height = src.height > 1 ? src.height / 2 : 1;
+        dst.stride = static_cast<size_t>(dst.width) * 3;
+        dst.pixels = allocatePixels(dst.stride * dst.height);
+        if (!dst.pixels) {
+            return false;
+        }
+
+        for (uint16_t y = 0; y < dst.height; ++y) {
+            const uint16_t sy0 = static_cast<uint16_t>(y * 2 < src.height ? y * 2 : src.height - 1);
+            const uint16_t sy1 = static_cast<uint16_t>(sy0 + 1 < src.height ? sy0 + 1 : sy0);
+            const uint8_t* row0 = src.pixels + sy0 * src.stride;
+            const uint8_t* row1 = src.pixels + sy1 * src.stride;
+            uint8_t* out = dst.pixels + y * dst.stride;
+            for (uint16_t x = 0; x < dst.width; ++x) {
+                const uint16_t sx0 = static_cast<uint16_t>(x * 2 < src.width ? x * 2 : src.width - 1);
+                const uint16_t sx1 = static_cast<uint16_t>((sx0 + 1) % src.width);  // 経度方向は折り返し
+                const uint8_t* p00 = row0 + sx0 * 3;
+                const uint8_t* p10 = row0 + sx1 * 3;
+                const uint8_t* p01 = row1 + sx0 * 3;
+                const uint8_t* p11 = row1 + sx1 * 3;
+                for (int c = 0; c < 3; ++c) {
+                    out[x * 3 + c] = static_cast<uint8_t>((p00[c] + p10[c] + p01[c] + p11[c] + 2) >> 2);
+                }
+            }
+        }
+        levels_[levelCount_++] = dst;
+    }
+    return true;
+}
+
+TexelTap PanoramaTexture::makeNearestTap(uint32_t uQ16, uint32_t vQ16) const {
+    TexelTap tap;
+    if (!isValid()) {
+        return tap;
+    }
+    const Level& lv = levels_[0];
+    uint32_t x = ((uQ16 & (kUVOne - 1)) * lv.width) >> 16;
+    uint32_t y = (vQ16 * lv.height) >> 16;
+    if (y >= lv.height) {
+        y = lv.height - 1;
+    }
+    tap.x0 = static_cast<uint16_t>(x);
+    tap.y0 = static_cast<uint16_t>(y);
+    tap.offset00 = static_cast<uint32_t>(y * lv.stride + x * 3);
+    tap.offset10 = tap.offset01 = tap.offset11 = tap.offset00;
+    return tap;
+}
+
+TexelTap PanoramaTexture::makeBilinearTap(uint32_t uQ16, uint32_t vQ16, uint8_t levelIndex) const {
+    if (!isValid()) {
+        return TexelTap();
+    }
+    if (levelIndex >= levelCount_) {
+        levelIndex = 0;
+    }
+    const Level& lv = levels_[levelIndex];
+    return computeBilinearTap(uQ16, vQ16, lv.width, lv.height, lv.stride, levelIndex);
+}
+
+TexelTap PanoramaTexture::computeBilinearTap(uint32_t uQ16, uint32_t vQ16, uint16_t width, uint16_t height,
+                                             size_t stride, uint8_t levelIndex) {
+    TexelTap tap;
+    if (width == 0 || height == 0) {
+        return tap;
+    }
+
+    // テクセル中心基準の座標（Q16）: x = u*W - 0.5
+    // 負方向の折り返しを避けるため1周分（W<<16）を加算してから剰余を取る
+    const uint32_t px = (uQ16 & (kUVOne - 1)) * width + (static_cast<uint32_t>(width) << 16) - kHalfTexelQ16;
+    const uint32_t x0 = (px >> 16) % width;
+    const uint32_t x1 = (x0 + 1 == width) ? 0 : x0 + 1;
+    const uint32_t fx = (px >> 8) & 0xFF;
+
+    const int32_t py = static_cast<int32_t>(vQ16 * height) - kHalfTexelQ16;
+    uint32_t y0, y1, fy;
+    if (py <= 0) {
+        y0 = y1 = 0;
+        fy = 0;
+    } else {
+        y0 = static_cast<uint32_t>(py) >> 16;
+        fy = (static_cast<uint32_t>(py) >> 8) & 0xFF;
+        if (y0 >= static_cast<uint32_t>(height - 1)) {
+            y0 = y1 = height - 1;
+            fy = 0;
+        } else {
+            y1 = y0 + 1;
+        }
+    }
+
+    tap.x0 = static_cast<uint16_t>(x0);
+    tap.y0 = static_cast<uint16_t>(y0);
+    tap.offset00 = static_cast<uint32_t>(y0 * stride + x0 * 3);
+    tap.offset10 = static_cast<uint32_t>(y0 * stride + x1 * 3);
+    tap.offset01 = static_cast<uint32_t>(y1 * stride + x0 * 3);
+    tap.offset11 = static_cast<uint32_t>(y1 * stride + x1 * 3);
+    tap.fx = static_cast<uint8_t>(fx);
+    tap.fy = static_cast<uint8_t>(fy);
+    tap.level = levelIndex;
+    return tap;
+}
+
+CRGB PanoramaTexture::sampleNearestQ16(uint32_t uQ16, uint32_t vQ16, uint8_t levelIndex) const {
+    if (!isValid()) {
+        return CRGB(0, 0, 0);
+    }
+    const Level& lv = level(levelIndex);
+    uint32_t x = ((uQ16 & (kUVOne - 1)) * lv.width) >> 16;
+    uint32_t y = (vQ16 * lv.height) >> 16;
+    if (y >= lv.height) {
+        y = lv.height - 1;
+    }
+    const uint8_t* p = lv.pixels + y * lv.stride + x * 3;
+    return CRGB(p[0], p[1], p[2]);
+}
+
+CRGB PanoramaTexture::sampleBilinearQ16(uint32_t uQ16, uint32_t vQ16, uint8_t levelIndex) const {
+    if (!isValid()) {
+        return CRGB(0, 0, 0);
+    }
+    return sampleTap(makeBilinearTap(uQ16, vQ16, levelIndex));
+}
+
+uint8_t PanoramaTexture::selectMipLevel(float footprintRad) const {
+    if (levelCount_ <= 1 || footprintRad <= 0.0f) {
+        return 0;
+    }
+    // 緯度方向のテクセル密度（H / π）で換算したフットプリント
+    float texels = footprintRad * static_cast<float>(levels_[0].height) / static_cast<float>(M_PI);
+    uint8_t levelIndex = 0;
+    while (texels >= 2.0f && levelIndex + 1 < levelCount_) {
+        texels *= 0.5f;
+        ++levelIndex;
+    }
+    return levelIndex;
+}
+
+uint32_t PanoramaTexture::wrapUToQ16(float u) {
+    u -= floorf(u);
+    uint32_t q = static_cast<uint32_t>(u * static_cast<float>(kUVOne));
+    return q & (kUVOne - 1);
+}
+
+uint32_t PanoramaTexture::clampVToQ16(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return kUVOne;
+    return static_cast<uint32_t>(v * static_cast<float>(kUVOne));
+}
+
+CRGB PanoramaTexture::sample(float u, float v, Filter filter, uint8_t levelIndex) const {
+    const uint32_t uQ16 = wrapUToQ16(u);
+    const uint32_t vQ16 = clampVToQ16(v);
+    switch (filter) {
+        case Filter::kNearest:
+            return sampleNearestQ16(uQ16, vQ16, 0);
+        case Filter::kBilinear:
+            return sampleBilinearQ16(uQ16, vQ16, 0);
+        case Filter::kMipmap:
+        default:
+            return sampleBilinearQ16(uQ16, vQ16, levelIndex);
+    }
+}
+
+size_t PanoramaTexture::memoryUsage() const {
+    size_t total = 0;
+    for (uint8_t i = 0; i < levelCount_; ++i) {
+        total += levels_[i].stride * levels_[i].height;
+    }
+    return total;
+}
+
+} // namespace LEDSphere
@@ -0,0 +1,230 @@
+/**
+ * @file SphereIndex.cpp
+ * @brief 球面k-d木インデックス実装
+ */
+
+#include "led/SphereIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace LEDSphere {
+
+namespace {
+
+constexpr float kDegToRad = static_cast<float>(M_PI) / 180.0f;
+
+// 中心角 → 弦長の2乗（単位球）
+float chordSquaredForAngle(float angleRad) {
+    if (angleRad >= static_cast<float>(M_PI)) {
+        return 4.0f;
+    }
+    return 2.0f - 2.0f * cosf(std::max(angleRad, 0.0f));
+}
+
+float angleForChordSquared(float chord2) {
+    const float halfChord = std::min(sqrtf(std::max(chord2, 0.0f)) * 0.5f, 1.0f);
+    return 2.0f * asinf(halfChord);
+}
+
+bool normalize(float& x, float& y, float& z) {
+    const float length = sqrtf(x * x + y * y + z * z);
+    if (length <= 1e-6f) {
+        return false;
+    }
+    x /= length;
+    y /= length;
+    z /= length;
+    return true;
+}
+
+bool byChord(const SphereIndex::Neighbor& a, const SphereIndex::Neighbor& b) {
+    return a.distanceRad < b.distanceRad;
+}
+
+} // namespace
+
+// 探索中の候補（heap==nullptr なら最近傍1点のみ保持）
+struct SphereIndex::Query {
+    float q[3];
+    size_t k;
+    std::vector<Neighbor>* heap;    // distanceRad に弦長の2乗を入れた最大ヒープ
+    float worst;                    // これより遠い枝は探索不要
+    uint16_t bestId;
+
+    void offer(float chord2, uint16_t id) {
+        if (!heap) {
+            if (chord2 < worst) {
+                worst = chord2;
+                bestId = id;
+            }
+            return;
+        }
+        if (heap->size() < k) {
+            heap->push_back({id, chord2});
+            std::push_heap(heap->begin(), heap->end(), byChord);
+            if (heap->size() == k) {
+                worst = heap->front().distanceRad;
+            }
+        } else if (chord2 < heap->front().distanceRad) {
+            std::pop_heap(heap->begin(), heap->end(), byChord);
+            heap->back() = {id, chord2};
+            std::push_heap(heap->begin(), heap->end(), byChord);
+            worst = heap->front().distanceRad;
+        }
+    }
+};
+
+void SphereIndex::build(const float* x, const float* y, const float* z, const uint16_t* ids, size_t count) {
+    clear();
+    std::vector<float> ux(count), uy(count), uz(count);
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ux[i] = x[i];
+        uy[i] = y[i];
+        uz[i] = z[i];
+        if (normalize(ux[i], uy[i], uz[i])) {
+            order.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    splitAxis_.assign(order.size(), 0);
+    buildNode(0, order.size(), order, ux, uy, uz);
+
+    px_.resize(order.size());
+    py_.resize(order.size());
+    pz_.resize(order.size());
+    ids_.resize(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        px_[i] = ux[order[i]];
+        py_[i] = uy[order[i]];
+        pz_[i] = uz[order[i]];
+        ids_[i] = ids[order[i]];
+    }
+}
+
+void SphereIndex::buildNode(size_t lo, size_t hi, std::vector<uint32_t>& order,
+                            const std::vector<float>& ux, const std::vector<float>& uy, const std::vector<float>& uz) {
+    if (lo >= hi) {
+        return;
+    }
+    // 広がりが最大の軸で分割
+    float minV[3] = {2.0f, 2.0f, 2.0f};
+    float maxV[3] = {-2.0f, -2.0f, -2.0f};
+    for (size_t i = lo; i < hi; ++i) {
+        const float v[3] = {ux[order[i]], uy[order[i]], uz[order[i]]};
+        for (int a = 0; a < 3; ++a) {
+            minV[a] = std::min(minV[a], v[a]);
+            maxV[a] = std::max(maxV[a], v[a]);
+        }
+    }
+    uint8_t axis = 0;
+    for (uint8_t a = 1; a < 3; ++a) {
+        if (maxV[a] - minV[a] > maxV[axis] - minV[axis]) {
+            axis = a;
+        }
+    }
+    const std::vector<float>& key = axis == 0 ? ux : (axis == 1 ? uy : uz);
+
+    const size_t mid = (lo + hi) / 2;
+    std::nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+                     [&key](uint32_t a, uint32_t b) { return key[a] < key[b]; });
+    splitAxis_[mid] = axis;
+    buildNode(lo, mid, order, ux, uy, uz);
+    buildNode(mid + 1, hi, order, ux, uy, uz);
+}
+
+void SphereIndex::clear() {
+    px_.clear();
+    py_.clear();
+    pz_.clear();
+    ids_.clear();
+    splitAxis_.clear();
+}
+
+void SphereIndex::searchNearest(size_t lo, size_t hi, Query& query) const {
+    if (lo >= hi) {
+        return;
+    }
+    const size_t mid = (lo + hi) / 2;
+    const float p[3] = {px_[mid], py_[mid], pz_[mid]};
+    const float dx = query.q[0] - p[0];
+    const float dy = query.q[1] - p[1];
+    const float dz = query.q[2] - p[2];
+    query.offer(dx * dx + dy * dy + dz * dz, ids_[mid]);
+
+    const uint8_t axis = splitAxis_[mid];
+    const float diff = query.q[axis] - p[axis];
+    if (diff < 0.0f) {
+        searchNearest(lo, mid, query);
+        if (diff * diff < query.worst) searchNearest(mid + 1, hi, query);
+    } else {
+        searchNearest(mid + 1, hi, query);
+        if (diff * diff < query.worst) searchNearest(lo, mid, query);
+    }
+}
+
+void SphereIndex::searchWithin(size_t lo, size_t hi, const float (&q)[3], float chord2,
+                               std::vector<uint16_t>& out) const {
+    if (lo >= hi) {
+        return;
+    }
+    const size_t mid = (lo + hi) / 2;
+    const float dx = q[0] - px_[mid];
+    const float dy = q[1] - py_[mid];
+    const float dz = q[2] - pz_[mid];
+    if (dx * dx + dy * dy + dz * dz <= chord2) {
+        out.push_back(ids_[mid]);
+    }
+
+    const uint8_t axis = splitAxis_[mid];
+    const float diff = axis == 0 ? dx : (axis == 1 ? dy : dz);
+    if (diff < 0.0f || diff * diff <= chord2) searchWithin(lo, mid, q, chord2, out);
+    if (diff >= 0.0f || diff * diff <= chord2) searchWithin(mid + 1, hi, q, chord2, out);
+}
+
+uint16_t SphereIndex::nearest(float x, float y, float z) const {
+    if (empty() || !normalize(x, y, z)) {
+        return kNone;
+    }
+    Query query{{x, y, z}, 1, nullptr, std::numeric_limits<float>::infinity(), kNone};
+    searchNearest(0, ids_.size(), query);
+    return query.bestId;
+}
+
+size_t SphereIndex::nearestK(float x, float y, float z, size_t k, std::vector<Neighbor>& out) const {
+    out.clear();
+    if (empty() || k == 0 || !normalize(x, y, z)) {
+        return 0;
+    }
+    Query query{{x, y, z}, std::min(k, ids_.size()), &out, std::numeric_limits<float>::infinity(), kNone};
+    searchNearest(0, ids_.size(), query);
+    std::sort_heap(out.begin(), out.end(), byChord);
+    for (auto& neighbor : out) {
+        neighbor.distanceRad = angleForChordSquared(neighbor.distanceRad);
+    }
+    return out.size();
+}
+
+size_t SphereIndex::within(float x, float y, float z, float angleRad, std::vector<uint16_t>& out) const {
+    out.clear();
+    if (empty() || angleRad < 0.0f || !normalize(x, y, z)) {
+        return 0;
+    }
+    const float q[3] = {x, y, z};
+    searchWithin(0, ids_.size(), q, chordSquaredForAngle(angleRad), out);
+    return out.size();
+}
+
+void SphereIndex::latLonToUnit(float latitudeDeg, float longitudeDeg, float& x, float& y, float& z) {
+    const float lat = latitudeDeg * kDegToRad;
+    const float lon = longitudeDeg * kDegToRad;
+    x = cosf(lat) * cosf(lon);
+    y = sinf(lat);
+    z = cosf(lat) * sinf(lon);
+}
+
+} // namespace LEDSphere
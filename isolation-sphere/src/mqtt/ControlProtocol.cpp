@@ -0,0 +1,114 @@
+#include "mqtt/ControlProtocol.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace control {
+
+namespace {
+
+void putU16(uint8_t *p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void putU32(uint8_t *p, uint32_t v) {
+  putU16(p, static_cast<uint16_t>(v));
+  putU16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t getU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t getU32(const uint8_t *p) {
+  return static_cast<uint32_t>(getU16(p)) | (static_cast<uint32_t>(getU16(p + 2)) << 16);
+}
+
+int16_t toCentiDegrees(float degrees) {
+  float scaled = std::round(degrees * 100.0f);
+  if (scaled > 32767.0f) scaled = 32767.0f;
+  if (scaled < -32768.0f) scaled = -32768.0f;
+  return static_cast<int16_t>(scaled);
+}
+
+}  // namespace
+
+size_t encode(const Message &message, uint8_t *out, size_t capacity) {
+  if (out == nullptr || capacity < kMessageSize) {
+    return 0;
+  }
+  std::memset(out, 0, kMessageSize);
+  out[0] = kMagic0;
+  out[1] = kMagic1;
+  out[2] = kVersion;
+  out[3] = static_cast<uint8_t>(message.type);
+  putU16(out + 4, message.sequence);
+  out[6] = message.fields;
+  out[7] = static_cast<uint8_t>(message.command);
+  putU16(out + 8, static_cast<uint16_t>(toCentiDegrees(message.latitudeOffsetDeg)));
+  putU16(out + 10, static_cast<uint16_t>(toCentiDegrees(message.longitudeOffsetDeg)));
+  out[12] = message.brightness;
+  out[13] = message.patternId;
+  putU32(out + 16, message.timestampMs);
+  return kMessageSize;
+}
+
+bool decode(const uint8_t *data, size_t length, Message &out) {
+  if (data == nullptr || length < kMessageSize) {
+    return false;
+  }
+  if (data[0] != kMagic0 || data[1] != kMagic1 || data[2] != kVersion) {
+    return false;
+  }
+  out.type = static_cast<MessageType>(data[3]);
+  out.sequence = getU16(data + 4);
+  out.fields = data[6];
+  out.command = data[7] <= static_cast<uint8_t>(UiCommandType::kModeOff) ? static_cast<UiCommandType>(data[7])
+                                                                          : UiCommandType::kRaw;
+  out.latitudeOffsetDeg = static_cast<int16_t>(getU16(data + 8)) / 100.0f;
+  out.longitudeOffsetDeg = static_cast<int16_t>(getU16(data + 10)) / 100.0f;
+  out.brightness = data[12];
+  out.patternId = data[13];
+  out.timestampMs = getU32(data + 16);
+  return true;
+}
+
+bool apply(const Message &message, RemoteControl &control, uint32_t nowMs) {
+  const uint8_t values = message.fields & (kFieldPosture | kFieldBrightness | kFieldPattern);
+  if (values == 0) {
+    return false;
+  }
+  if (message.has(kFieldPosture)) {
+    control.latitudeOffsetDeg = message.latitudeOffsetDeg;
+    control.longitudeOffsetDeg = message.longitudeOffsetDeg;
+  }
+  if (message.has(kFieldBrightness)) {
+    control.brightness = message.brightness;
+  }
+  if (message.has(kFieldPattern)) {
+    control.patternId = message.patternId;
+  }
+  control.fields |= values;
+  control.sequence = message.sequence;
+  control.updatedMs = nowMs;
+  return true;
+}
+
+const char *commandName(UiCommandType command) {
+  switch (command) {
+    case UiCommandType::kNextContent:
+      return "ui:x_pos";
+    case UiCommandType::kPlayPause:
+      return "ui:x_neg";
+    case UiCommandType::kModeOn:
+      return "ui:mode:on";
+    case UiCommandType::kModeOff:
+      return "ui:mode:off";
+    case UiCommandType::kRaw:
+      break;
+  }
+  return nullptr;
+}
+
+}  // namespace control
@@ -0,0 +1,174 @@
+#include "mqtt/LiveFrameProtocol.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace live {
+
+using LEDSphere::FrameEncoding;
+
+namespace {
+
+void putU16(uint8_t *p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t getU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+}  // namespace
+
+size_t writeHeader(const Header &header, uint8_t *out, size_t capacity) {
+  if (out == nullptr || capacity < kHeaderSize) {
+    return 0;
+  }
+  out[0] = kMagic0;
+  out[1] = kMagic1;
+  out[2] = kVersion;
+  out[3] = static_cast<uint8_t>(header.encoding);
+  putU16(out + 4, header.sequence);
+  putU16(out + 6, header.keyframe);
+  putU16(out + 8, header.ledCount);
+  putU16(out + 10, 0);
+  return kHeaderSize;
+}
+
+bool readHeader(const uint8_t *data, size_t length, Header &out) {
+  if (data == nullptr || length < kHeaderSize) {
+    return false;
+  }
+  if (data[0] != kMagic0 || data[1] != kMagic1 || data[2] != kVersion) {
+    return false;
+  }
+  if (data[3] > static_cast<uint8_t>(FrameEncoding::kDelta)) {
+    return false;
+  }
+  out.encoding = static_cast<FrameEncoding>(data[3]);
+  out.sequence = getU16(data + 4);
+  out.keyframe = getU16(data + 6);
+  out.ledCount = getU16(data + 8);
+  return !(out.isKeyframe() && out.encoding == FrameEncoding::kDelta);
+}
+
+Encoder::Encoder(uint16_t ledCount, uint32_t keyframeInterval)
+    : ledCount_(ledCount), keyframeInterval_(keyframeInterval), keyframe_(static_cast<size_t>(ledCount) * 3) {}
+
+bool Encoder::encode(const uint8_t *rgb, std::vector<uint8_t> &out) {
+  const size_t frameBytes = keyframe_.size();
+  bool keyframe = forceKeyframe_ || (keyframeInterval_ != 0 && sinceKeyframe_ >= keyframeInterval_);
+  if (!keyframe) {
+    LEDSphere::FramePack::encodeDelta(keyframe_.data(), rgb, ledCount_, delta_);
+    // Far from the keyframe: a fresh keyframe is no larger and resets the
+    // reference for the frames that follow.
+    if (delta_.size() > frameBytes / 2) {
+      LEDSphere::FramePack::encodeRle(rgb, ledCount_, rle_);
+      keyframe = std::min(rle_.size(), frameBytes) <= delta_.size();
+    }
+  }
+
+  Header header;
+  header.sequence = sequence_++;
+  header.ledCount = ledCount_;
+  const uint8_t *body = delta_.data();
+  size_t bodySize = delta_.size();
+  if (keyframe) {
+    LEDSphere::FramePack::encodeRle(rgb, ledCount_, rle_);
+    if (rle_.size() < frameBytes) {
+      header.encoding = FrameEncoding::kRle;
+      body = rle_.data();
+      bodySize = rle_.size();
+    } else {
+      header.encoding = FrameEncoding::kRaw;
+      body = rgb;
+      bodySize = frameBytes;
+    }
+    std::memcpy(keyframe_.data(), rgb, frameBytes);
+    keyframeSequence_ = header.sequence;
+    sinceKeyframe_ = 0;
+    forceKeyframe_ = false;
+  } else {
+    header.encoding = FrameEncoding::kDelta;
+  }
+  header.keyframe = keyframeSequence_;
+  ++sinceKeyframe_;
+
+  out.resize(kHeaderSize + bodySize);
+  writeHeader(header, out.data(), out.size());
+  if (bodySize > 0) {
+    std::memcpy(out.data() + kHeaderSize, body, bodySize);
+  }
+  return keyframe;
+}
+
+Decoder::Decoder(uint16_t ledCount)
+    : ledCount_(ledCount), frame_(static_cast<size_t>(ledCount) * 3), keyframe_(static_cast<size_t>(ledCount) * 3) {}
+
+void Decoder::reset() {
+  haveKeyframe_ = false;
+  haveSequence_ = false;
+  stats_ = Stats();
+}
+
+bool Decoder::acceptSequence(uint16_t sequence) {
+  if (!haveSequence_) {
+    return true;
+  }
+  const uint16_t ahead = static_cast<uint16_t>(sequence - lastSequence_);
+  const uint16_t behind = static_cast<uint16_t>(lastSequence_ - sequence);
+  if (ahead == 0 || (behind != 0 && behind < kRestartDistance)) {
+    ++stats_.stale;
+    return false;
+  }
+  if (ahead < kRestartDistance) {
+    stats_.lost += ahead - 1u;
+  }
+  return true;
+}
+
+Decoder::Result Decoder::decode(const uint8_t *data, size_t length) {
+  Header header;
+  if (!readHeader(data, length, header) || header.ledCount != ledCount_) {
+    ++stats_.invalid;
+    return Result::kInvalid;
+  }
+  if (!acceptSequence(header.sequence)) {
+    return Result::kStale;
+  }
+  haveSequence_ = true;
+  lastSequence_ = header.sequence;
+  const uint8_t *body = data + kHeaderSize;
+  const size_t bodySize = length - kHeaderSize;
+
+  if (header.isKeyframe()) {
+    if (!LEDSphere::FramePack::decodeFrame(header.encoding, body, bodySize, frame_.data(), ledCount_)) {
+      ++stats_.invalid;
+      return Result::kInvalid;
+    }
+    std::memcpy(keyframe_.data(), frame_.data(), frame_.size());
+    haveKeyframe_ = true;
+    keyframeSequence_ = header.sequence;
+    ++stats_.keyframes;
+  } else {
+    if (header.encoding != FrameEncoding::kDelta) {
+      ++stats_.invalid;
+      return Result::kInvalid;
+    }
+    if (!haveKeyframe_ || header.keyframe != keyframeSequence_) {
+      ++stats_.missingKeyframe;
+      return Result::kNeedKeyframe;
+    }
+    // Deltas are relative to the keyframe, so every one starts from it;
+    // a corrupt delta cannot leak into the next frame.
+    std::memcpy(frame_.data(), keyframe_.data(), frame_.size());
+    if (!LEDSphere::FramePack::decodeFrame(FrameEncoding::kDelta, body, bodySize, frame_.data(), ledCount_)) {
+      ++stats_.invalid;
+      return Result::kInvalid;
+    }
+  }
+  ++stats_.frames;
+  return Result::kFrame;
+}
+
+}  // namespace live
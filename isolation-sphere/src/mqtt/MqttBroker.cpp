@@ -1,7 +1,132 @@
 #include "mqtt/MqttBroker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(ARDUINO)
 #include <Arduino.h>
+#include <WiFiClient.h>
+#include <cerrno>
+#include <lwip/sockets.h>
+#else
+#include <chrono>
+struct DummySerial {
+  template <typename... Args>
+  void printf(const char *, Args...) {}
+  void println(const char *) {}
+};
+static DummySerial Serial;
+#endif
+
+namespace {
+
+enum PacketType : uint8_t {
+  kConnect = 1,
+  kConnAck = 2,
+  kPublish = 3,
+  kPubAck = 4,
+  kPubRec = 5,
+  kPubRel = 6,
+  kPubComp = 7,
+  kSubscribe = 8,
+  kSubAck = 9,
+  kUnsubscribe = 10,
+  kUnsubAck = 11,
+  kPingReq = 12,
+  kPingResp = 13,
+  kDisconnect = 14,
+};
+
+uint32_t brokerMillis() {
+#if defined(ARDUINO)
+  return millis();
+#else
+  using namespace std::chrono;
+  return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// MQTT "remaining length" varint; returns the number of bytes written (1-4).
+size_t encodeLength(uint32_t value, uint8_t *out) {
+  size_t n = 0;
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value != 0) {
+      byte |= 0x80;
+    }
+    out[n++] = byte;
+  } while (value != 0);
+  return n;
+}
+
+uint16_t readU16(const uint8_t *p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+
+// Reads a length-prefixed field at `pos`; false if it overruns the body.
+bool readField(const uint8_t *body, size_t length, size_t &pos, const uint8_t *&field, size_t &fieldLength) {
+  if (pos + 2 > length) {
+    return false;
+  }
+  fieldLength = readU16(body + pos);
+  pos += 2;
+  if (pos + fieldLength > length) {
+    return false;
+  }
+  field = body + pos;
+  pos += fieldLength;
+  return true;
+}
+
+#if defined(ARDUINO)
+// WiFiClient::write() keeps retrying until the whole buffer is on the wire,
+// which would let one slow client stall the broker task. Writes go straight
+// to the socket with MSG_DONTWAIT instead and report what lwIP accepted.
+class WiFiConnection : public MqttBroker::Connection {
+ public:
+  explicit WiFiConnection(const WiFiClient &client) : client_(client) {}
+
+  size_t available() override {
+    const int n = client_.available();
+    return n > 0 ? static_cast<size_t>(n) : 0;
+  }
+
+  size_t read(uint8_t *buffer, size_t length) override {
+    const int n = client_.read(buffer, length);
+    return n > 0 ? static_cast<size_t>(n) : 0;
+  }
+
+  size_t write(const uint8_t *data, size_t length) override {
+    const int sent = ::send(client_.fd(), data, length, MSG_DONTWAIT);
+    if (sent > 0) {
+      return static_cast<size_t>(sent);
+    }
+    if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      failed_ = true;
+    }
+    return 0;
+  }
+
+  bool connected() override { return !failed_ && client_.connected(); }
+  void close() override { client_.stop(); }
 
-MqttBroker::MqttBroker() {}
+ private:
+  WiFiClient client_;
+  bool failed_ = false;
+};
+#endif
+
+}  // namespace
+
+MqttBroker::MqttBroker() {
+  // CONNACK: session present = 0, return code = accepted
+  auto connAck = std::make_shared<Packet>();
+  connAck->bytes = {static_cast<uint8_t>(kConnAck << 4), 2, 0, 0};
+  connAck_ = connAck;
+  auto pingResp = std::make_shared<Packet>();
+  pingResp->bytes = {static_cast<uint8_t>(kPingResp << 4), 0};
+  pingResp_ = pingResp;
+}
 
 MqttBroker::~MqttBroker() {
   stop();
@@ -9,7 +134,7 @@ MqttBroker::~MqttBroker() {
 
 bool MqttBroker::applyConfig(const ConfigManager::Config &config) {
   const auto &mqttConfig = config.mqtt;
-  
+
   enabled_ = mqttConfig.enabled;
   if (!enabled_) {
     Serial.println("[MQTT] MQTT broker disabled in config");
@@ -20,7 +145,7 @@ bool MqttBroker::applyConfig(const ConfigManager::Config &config) {
   }
 
   brokerPort_ = mqttConfig.port == 0 ? 1883 : mqttConfig.port;
-  
+
   // Start broker if not already active
   if (!brokerActive_) {
     return start(brokerPort_);
@@ -35,20 +160,23 @@ bool MqttBroker::start(int port) {
     return true;
   }
 
+#if defined(ARDUINO)
   // Check WiFi AP is active
   if (WiFi.getMode() != WIFI_AP && WiFi.getMode() != WIFI_AP_STA) {
     Serial.println("[MQTT] WiFi AP must be active before starting MQTT broker");
     return false;
   }
 
-  server_ = new WiFiServer(port);
+  server_ = new WiFiServer(port, kMaxClients);
   server_->begin();
+  server_->setNoDelay(true);
+#endif
   brokerActive_ = true;
   brokerPort_ = port;
   stats_.brokerActive = true;
   stats_.port = port;
-  stats_.startTime = millis();
-  
+  stats_.startTime = brokerMillis();
+
   Serial.printf("[MQTT] Broker started on port %d\n", port);
   return true;
 }
@@ -56,11 +184,19 @@ bool MqttBroker::start(int port) {
 void MqttBroker::stop() {
   if (!brokerActive_) return;
 
+  for (size_t slot = 0; slot < clients_.size(); ++slot) {
+    closeClient(slot, nullptr);
+  }
+  subscriptions_.clear();
+  retained_.clear();
+
+#if defined(ARDUINO)
   if (server_) {
     server_->end();
     delete server_;
     server_ = nullptr;
   }
+#endif
 
   brokerActive_ = false;
   stats_.brokerActive = false;
@@ -72,47 +208,660 @@ void MqttBroker::loop() {
     return;
   }
 
-  const uint32_t now = millis();
-  
+  const uint32_t now = brokerMillis();
+
+#if defined(ARDUINO)
+  for (int i = 0; i < kMaxClients && server_; ++i) {
+    WiFiClient client = server_->available();
+    if (!client) {
+      break;
+    }
+    client.setNoDelay(true);
+    acceptConnection(std::unique_ptr<Connection>(new WiFiConnection(client)), now);
+  }
+#endif
+
+  service(now);
+
   if (now - lastLogMs_ >= 60000) { // 60秒間隔
-    Serial.printf("[MQTT] Broker Status: Port %d, Messages: %d\n", 
-                 brokerPort_, totalMessages_);
+    Serial.printf("[MQTT] Broker Status: Port %d, Clients: %d, Messages: %d, Dropped: %u\n",
+                 brokerPort_, connectedClients_, totalMessages_, static_cast<unsigned>(stats_.dropped));
     lastLogMs_ = now;
   }
 }
 
+bool MqttBroker::acceptConnection(std::unique_ptr<Connection> connection, uint32_t nowMs) {
+  if (!connection) {
+    return false;
+  }
+  if (brokerActive_) {
+    for (Client &client : clients_) {
+      if (client.connection) {
+        continue;
+      }
+      client = Client();
+      client.connection = std::move(connection);
+      client.acceptedMs = nowMs;
+      client.lastRxMs = nowMs;
+      client.lastProgressMs = nowMs;
+      return true;
+    }
+    Serial.printf("[MQTT] Client rejected: all %d slots in use\n", kMaxClients);
+  }
+  connection->close();
+  return false;
+}
+
+void MqttBroker::service(uint32_t nowMs) {
+  if (!brokerActive_) {
+    return;
+  }
+
+  for (size_t slot = 0; slot < clients_.size(); ++slot) {
+    Client &client = clients_[slot];
+    if (!client.connection) {
+      continue;
+    }
+    if (!client.connection->connected()) {
+      closeClient(slot, "connection lost");
+      continue;
+    }
+    readClient(slot, nowMs);
+    if (!client.connection) {
+      continue;
+    }
+    if (!client.session && nowMs - client.acceptedMs >= kConnectTimeoutMs) {
+      closeClient(slot, "no CONNECT");
+    } else if (client.session && client.keepAliveSec != 0 &&
+               nowMs - client.lastRxMs > static_cast<uint32_t>(client.keepAliveSec) * 1500u) {
+      closeClient(slot, "keep-alive timeout");
+    }
+  }
+
+  // Flush after every client has been read so messages routed in this pass
+  // go out in the same pass.
+  for (size_t slot = 0; slot < clients_.size(); ++slot) {
+    if (clients_[slot].connection) {
+      flushClient(slot, nowMs);
+    }
+  }
+}
+
+void MqttBroker::readClient(size_t slot, uint32_t nowMs) {
+  Client &client = clients_[slot];
+  size_t budget = kReadBudgetBytes;
+  while (budget > 0 && client.connection) {
+    const size_t available = client.connection->available();
+    if (available == 0) {
+      return;
+    }
+
+    if (!client.lengthKnown) {
+      uint8_t byte = 0;
+      if (client.connection->read(&byte, 1) != 1) {
+        return;
+      }
+      --budget;
+      client.lastRxMs = nowMs;
+      client.header[client.headerLength++] = byte;
+      if (client.headerLength == 1) {
+        continue;
+      }
+      if (byte & 0x80) {
+        if (client.headerLength == sizeof(client.header)) {
+          protocolError(slot, "bad remaining length");
+          return;
+        }
+        continue;
+      }
+      client.remaining = 0;
+      for (size_t i = client.headerLength - 1; i >= 1; --i) {
+        client.remaining = (client.remaining << 7) | (client.header[i] & 0x7F);
+      }
+      if (client.remaining > kMaxPacketBytes) {
+        protocolError(slot, "packet too large");
+        return;
+      }
+      client.lengthKnown = true;
+      client.rx = std::make_shared<Packet>();
+      client.rx->bytes.resize(client.headerLength + client.remaining);
+      std::memcpy(client.rx->bytes.data(), client.header, client.headerLength);
+      client.rxFill = client.headerLength;
+    }
+
+    const size_t total = client.rx->bytes.size();
+    if (client.rxFill < total) {
+      const size_t want = std::min(std::min(total - client.rxFill, budget), available);
+      const size_t got = client.connection->read(client.rx->bytes.data() + client.rxFill, want);
+      if (got == 0) {
+        return;
+      }
+      client.rxFill += got;
+      budget -= std::min(got, budget);
+      client.lastRxMs = nowMs;
+    }
+
+    if (client.rxFill == total) {
+      std::shared_ptr<Packet> packet = std::move(client.rx);
+      const size_t headerLength = client.headerLength;
+      client.rx.reset();
+      client.rxFill = 0;
+      client.headerLength = 0;
+      client.lengthKnown = false;
+      if (!handlePacket(slot, packet, headerLength)) {
+        return;
+      }
+    }
+  }
+}
+
+bool MqttBroker::protocolError(size_t slot, const char *reason) {
+  ++stats_.protocolErrors;
+  closeClient(slot, reason);
+  return false;
+}
+
+bool MqttBroker::handlePacket(size_t slot, const std::shared_ptr<Packet> &packet, size_t headerLength) {
+  Client &client = clients_[slot];
+  const uint8_t type = packet->bytes[0] >> 4;
+  const uint8_t flags = packet->bytes[0] & 0x0F;
+  const uint8_t *body = packet->bytes.data() + headerLength;
+  const size_t length = packet->bytes.size() - headerLength;
+
+  if (!client.session && type != kConnect) {
+    return protocolError(slot, "expected CONNECT");
+  }
+
+  switch (type) {
+    case kConnect:
+      if (client.session) {
+        return protocolError(slot, "second CONNECT");
+      }
+      return handleConnect(slot, body, length);
+    case kPublish:
+      return handlePublish(slot, packet, headerLength);
+    case kSubscribe:
+      if (flags != 0x02) {
+        return protocolError(slot, "bad SUBSCRIBE flags");
+      }
+      return handleSubscribe(slot, body, length);
+    case kUnsubscribe:
+      if (flags != 0x02) {
+        return protocolError(slot, "bad UNSUBSCRIBE flags");
+      }
+      return handleUnsubscribe(slot, body, length);
+    case kPingReq:
+      return enqueue(slot, pingResp_, true);
+    case kDisconnect:
+      closeClient(slot, nullptr);
+      return false;
+    case kPubRel:
+      if (flags != 0x02 || length != 2) {
+        return protocolError(slot, "bad PUBREL");
+      }
+      return handlePubRel(slot, readU16(body));
+    case kPubAck:
+      // Only sent if a client misreads our QoS 0 deliveries; harmless.
+      return true;
+    default:
+      return protocolError(slot, "unsupported packet");
+  }
+}
+
+bool MqttBroker::handleConnect(size_t slot, const uint8_t *body, size_t length) {
+  Client &client = clients_[slot];
+  size_t pos = 0;
+  const uint8_t *name = nullptr;
+  size_t nameLength = 0;
+  if (!readField(body, length, pos, name, nameLength) || pos + 4 > length) {
+    return protocolError(slot, "short CONNECT");
+  }
+  const uint8_t level = body[pos++];
+  const bool mqtt311 = nameLength == 4 && std::memcmp(name, "MQTT", 4) == 0 && level == 4;
+  const bool mqtt31 = nameLength == 6 && std::memcmp(name, "MQIsdp", 6) == 0 && level == 3;
+  if (!mqtt311 && !mqtt31) {
+    return protocolError(slot, "unsupported protocol");
+  }
+  const uint8_t connectFlags = body[pos++];
+  const uint16_t keepAlive = readU16(body + pos);
+  pos += 2;
+
+  const uint8_t *id = nullptr;
+  size_t idLength = 0;
+  if (!readField(body, length, pos, id, idLength)) {
+    return protocolError(slot, "bad client id");
+  }
+  // Will topic/message, user name and password are accepted but unused.
+  const uint8_t *skipped = nullptr;
+  size_t skippedLength = 0;
+  if ((connectFlags & 0x04) && (!readField(body, length, pos, skipped, skippedLength) ||
+                                !readField(body, length, pos, skipped, skippedLength))) {
+    return protocolError(slot, "bad will");
+  }
+  if ((connectFlags & 0x80) && !readField(body, length, pos, skipped, skippedLength)) {
+    return protocolError(slot, "bad user name");
+  }
+  if ((connectFlags & 0x40) && !readField(body, length, pos, skipped, skippedLength)) {
+    return protocolError(slot, "bad password");
+  }
+
+  std::string clientId(reinterpret_cast<const char *>(id), idLength);
+  if (clientId.empty()) {
+    char generated[16];
+    std::snprintf(generated, sizeof(generated), "client-%u", static_cast<unsigned>(slot));
+    clientId = generated;
+  }
+  // A reconnecting client takes over its old session.
+  for (size_t other = 0; other < clients_.size(); ++other) {
+    if (other != slot && clients_[other].session && clients_[other].clientId == clientId) {
+      closeClient(other, "taken over");
+    }
+  }
+
+  client.session = true;
+  client.clientId = std::move(clientId);
+  client.keepAliveSec = keepAlive;
+  ++connectedClients_;
+  Serial.printf("[MQTT] Client %u connected: %s\n", static_cast<unsigned>(slot), client.clientId.c_str());
+  return enqueue(slot, connAck_, true);
+}
+
+bool MqttBroker::handlePublish(size_t slot, const std::shared_ptr<Packet> &packet, size_t headerLength) {
+  std::vector<uint8_t> &bytes = packet->bytes;
+  const uint8_t flags = bytes[0] & 0x0F;
+  const uint8_t qos = (flags >> 1) & 0x03;
+  const bool retain = (flags & 0x01) != 0;
+  if (qos == 3) {
+    return protocolError(slot, "bad QoS");
+  }
+
+  const size_t length = bytes.size() - headerLength;
+  const size_t idLength = qos == 0 ? 0 : 2;
+  if (length < 2) {
+    return protocolError(slot, "short PUBLISH");
+  }
+  const size_t topicLength = readU16(bytes.data() + headerLength);
+  if (2 + topicLength + idLength > length) {
+    return protocolError(slot, "short PUBLISH");
+  }
+  if (!TopicTrie::isValidTopic(reinterpret_cast<const char *>(bytes.data() + headerLength + 2), topicLength)) {
+    return protocolError(slot, "bad topic");
+  }
+  const size_t payloadLength = length - 2 - topicLength - idLength;
+
+  size_t topicOffset = headerLength + 2;
+  if (qos != 0) {
+    const uint16_t packetId = readU16(bytes.data() + headerLength + 2 + topicLength);
+    // QoS 2 is delivered on receipt; the id is held until PUBREL so a
+    // PUBLISH resent after a lost PUBREC is acknowledged again but not
+    // routed twice.
+    const bool duplicate = qos == 2 && !holdQos2Id(clients_[slot], packetId);
+    if (!enqueue(slot, controlPacket(qos == 2 ? kPubRec : kPubAck, packetId), true)) {
+      return false;
+    }
+    if (duplicate) {
+      return true;
+    }
+    // Turn the buffer into a QoS 0 PUBLISH in place: slide the topic over
+    // the packet id and write the shorter header just in front of it. The
+    // payload (the bulk of the packet) does not move.
+    std::memmove(bytes.data() + headerLength + 2, bytes.data() + headerLength, 2 + topicLength);
+    uint8_t lengthBytes[4];
+    const size_t lengthSize = encodeLength(static_cast<uint32_t>(length - 2), lengthBytes);
+    packet->begin = headerLength + 2 - 1 - lengthSize;
+    std::memcpy(bytes.data() + packet->begin + 1, lengthBytes, lengthSize);
+    topicOffset += 2;
+  }
+  // Live deliveries carry RETAIN = 0 and DUP = 0.
+  bytes[packet->begin] = static_cast<uint8_t>(kPublish << 4);
+  stats_.bufferedBytes += bytes.size();
+
+  route(packet, reinterpret_cast<const char *>(bytes.data() + topicOffset), topicLength, payloadLength, retain);
+  return true;
+}
+
+bool MqttBroker::handlePubRel(size_t slot, uint16_t packetId) {
+  Client &client = clients_[slot];
+  for (size_t i = 0; i < client.qos2Count; ++i) {
+    if (client.qos2Pending[i] == packetId) {
+      std::move(client.qos2Pending.begin() + i + 1, client.qos2Pending.begin() + client.qos2Count,
+                client.qos2Pending.begin() + i);
+      --client.qos2Count;
+      break;
+    }
+  }
+  // PUBCOMP even for an unknown id: it may be a PUBREL resent after our
+  // PUBCOMP was lost.
+  return enqueue(slot, controlPacket(kPubComp, packetId), true);
+}
+
+bool MqttBroker::holdQos2Id(Client &client, uint16_t packetId) {
+  for (size_t i = 0; i < client.qos2Count; ++i) {
+    if (client.qos2Pending[i] == packetId) {
+      return false;
+    }
+  }
+  if (client.qos2Count == kMaxQos2InFlight) {
+    // A client that never releases: forget the oldest id rather than
+    // refuse the message.
+    std::move(client.qos2Pending.begin() + 1, client.qos2Pending.end(), client.qos2Pending.begin());
+    --client.qos2Count;
+  }
+  client.qos2Pending[client.qos2Count++] = packetId;
+  return true;
+}
+
+bool MqttBroker::handleSubscribe(size_t slot, const uint8_t *body, size_t length) {
+  if (length < 2) {
+    return protocolError(slot, "short SUBSCRIBE");
+  }
+  const uint16_t packetId = readU16(body);
+  std::vector<uint8_t> codes;
+  std::vector<std::string> accepted;
+  size_t pos = 2;
+  while (pos < length) {
+    const uint8_t *filter = nullptr;
+    size_t filterLength = 0;
+    if (!readField(body, length, pos, filter, filterLength) || pos >= length) {
+      return protocolError(slot, "bad SUBSCRIBE");
+    }
+    ++pos;  // requested QoS; everything is granted QoS 0
+    std::string text(reinterpret_cast<const char *>(filter), filterLength);
+    if (subscriptions_.subscribe(text, static_cast<uint8_t>(slot))) {
+      codes.push_back(0x00);
+      accepted.push_back(std::move(text));
+    } else {
+      codes.push_back(0x80);
+    }
+  }
+  if (codes.empty()) {
+    return protocolError(slot, "empty SUBSCRIBE");
+  }
+
+  auto subAck = std::make_shared<Packet>();
+  uint8_t lengthBytes[4];
+  const size_t lengthSize = encodeLength(static_cast<uint32_t>(2 + codes.size()), lengthBytes);
+  subAck->bytes.reserve(1 + lengthSize + 2 + codes.size());
+  subAck->bytes.push_back(static_cast<uint8_t>(kSubAck << 4));
+  subAck->bytes.insert(subAck->bytes.end(), lengthBytes, lengthBytes + lengthSize);
+  subAck->bytes.push_back(static_cast<uint8_t>(packetId >> 8));
+  subAck->bytes.push_back(static_cast<uint8_t>(packetId & 0xFF));
+  subAck->bytes.insert(subAck->bytes.end(), codes.begin(), codes.end());
+  if (!enqueue(slot, subAck, true)) {
+    return false;
+  }
+
+  // Retained messages go out after the SUBACK, sharing the stored packet.
+  for (const std::string &filter : accepted) {
+    for (const Retained &retained : retained_) {
+      if (TopicTrie::matches(filter, retained.topic.data(), retained.topic.size())) {
+        enqueue(slot, retained.packet, false);
+      }
+    }
+  }
+  return true;
+}
+
+bool MqttBroker::handleUnsubscribe(size_t slot, const uint8_t *body, size_t length) {
+  if (length < 2) {
+    return protocolError(slot, "short UNSUBSCRIBE");
+  }
+  const uint16_t packetId = readU16(body);
+  size_t pos = 2;
+  while (pos < length) {
+    const uint8_t *filter = nullptr;
+    size_t filterLength = 0;
+    if (!readField(body, length, pos, filter, filterLength)) {
+      return protocolError(slot, "bad UNSUBSCRIBE");
+    }
+    subscriptions_.unsubscribe(std::string(reinterpret_cast<const char *>(filter), filterLength),
+                               static_cast<uint8_t>(slot));
+  }
+  return enqueue(slot, controlPacket(kUnsubAck, packetId), true);
+}
+
+void MqttBroker::route(const PacketRef &packet, const char *topic, size_t topicLength, size_t payloadLength,
+                       bool retain) {
+  ++totalMessages_;
+  if (retain) {
+    storeRetained(topic, topicLength, packet, payloadLength);
+  }
+  TopicTrie::Mask mask = subscriptions_.match(topic, topicLength);
+  for (size_t slot = 0; mask != 0; ++slot, mask >>= 1) {
+    if ((mask & 1u) && clients_[slot].session) {
+      enqueue(slot, packet, false);
+    }
+  }
+}
+
+void MqttBroker::storeRetained(const char *topic, size_t topicLength, const PacketRef &packet,
+                               size_t payloadLength) {
+  auto it = std::find_if(retained_.begin(), retained_.end(), [&](const Retained &r) {
+    return r.topic.size() == topicLength && std::memcmp(r.topic.data(), topic, topicLength) == 0;
+  });
+  // An empty retained payload clears the topic.
+  if (payloadLength == 0) {
+    if (it != retained_.end()) {
+      retained_.erase(it);
+    }
+    return;
+  }
+  if (it == retained_.end() && retained_.size() >= static_cast<size_t>(kMaxTopics)) {
+    Serial.printf("[MQTT] Retained topic limit (%d) reached, not storing\n", kMaxTopics);
+    return;
+  }
+
+  // New subscribers must see RETAIN = 1, so the stored copy gets its own
+  // buffer. Retained topics are small status messages.
+  auto stored = std::make_shared<Packet>();
+  stored->bytes.assign(packet->data(), packet->data() + packet->size());
+  stored->bytes[0] |= 0x01;
+  stats_.bufferedBytes += stored->bytes.size();
+  if (it != retained_.end()) {
+    it->packet = stored;
+  } else {
+    retained_.push_back(Retained{std::string(topic, topicLength), stored});
+  }
+}
+
+bool MqttBroker::enqueue(size_t slot, const PacketRef &packet, bool control) {
+  Client &client = clients_[slot];
+  const size_t size = packet->size();
+  const auto full = [&]() {
+    return client.count >= kQueueDepth || (!control && client.queuedBytes + size > kMaxQueuedBytes);
+  };
+  while (full() && evictOldest(client)) {
+  }
+  if (full()) {
+    if (control) {
+      closeClient(slot, "outbound queue overflow");
+      return false;
+    }
+    ++client.dropped;
+    ++stats_.dropped;
+    return false;
+  }
+
+  const size_t index = (client.head + client.count) % kQueueDepth;
+  client.queue[index] = packet;
+  client.control[index] = control;
+  ++client.count;
+  client.queuedBytes += size;
+  return true;
+}
+
+bool MqttBroker::evictOldest(Client &client) {
+  // The head packet is never evicted once it is partly on the wire, and
+  // protocol replies are never evicted at all.
+  for (size_t i = client.headOffset > 0 ? 1 : 0; i < client.count; ++i) {
+    const size_t index = (client.head + i) % kQueueDepth;
+    if (client.control[index]) {
+      continue;
+    }
+    client.queuedBytes -= client.queue[index]->size();
+    for (size_t j = i; j + 1 < client.count; ++j) {
+      const size_t to = (client.head + j) % kQueueDepth;
+      const size_t from = (client.head + j + 1) % kQueueDepth;
+      client.queue[to] = std::move(client.queue[from]);
+      client.control[to] = client.control[from];
+    }
+    --client.count;
+    client.queue[(client.head + client.count) % kQueueDepth].reset();
+    ++client.dropped;
+    ++stats_.dropped;
+    return true;
+  }
+  return false;
+}
+
+void MqttBroker::popFront(Client &client) {
+  client.queuedBytes -= client.queue[client.head]->size();
+  client.queue[client.head].reset();
+  client.head = (client.head + 1) % kQueueDepth;
+  --client.count;
+  client.headOffset = 0;
+}
+
+void MqttBroker::flushClient(size_t slot, uint32_t nowMs) {
+  Client &client = clients_[slot];
+  if (client.count == 0) {
+    client.lastProgressMs = nowMs;
+    return;
+  }
+  while (client.count > 0) {
+    const Packet &packet = *client.queue[client.head];
+    const size_t written =
+        client.connection->write(packet.data() + client.headOffset, packet.size() - client.headOffset);
+    if (written == 0) {
+      break;
+    }
+    client.headOffset += written;
+    client.bytesSent += written;
+    stats_.bytesSent += written;
+    client.lastProgressMs = nowMs;
+    if (client.headOffset < packet.size()) {
+      break;  // socket buffer full
+    }
+    if (!client.control[client.head]) {
+      ++client.delivered;
+      ++stats_.deliveries;
+    }
+    popFront(client);
+  }
+  if (client.count > 0 && nowMs - client.lastProgressMs >= kStallTimeoutMs) {
+    ++stats_.slowClientsClosed;
+    closeClient(slot, "stalled");
+  }
+}
+
+void MqttBroker::closeClient(size_t slot, const char *reason) {
+  Client &client = clients_[slot];
+  if (!client.connection) {
+    return;
+  }
+  if (reason) {
+    Serial.printf("[MQTT] Client %u (%s) closed: %s\n", static_cast<unsigned>(slot), client.clientId.c_str(),
+                  reason);
+  }
+  client.connection->close();
+  subscriptions_.removeSubscriber(static_cast<uint8_t>(slot));
+  if (client.session) {
+    --connectedClients_;
+  }
+  client = Client();
+}
+
+MqttBroker::PacketRef MqttBroker::encodePublish(const char *topic, size_t topicLength, const uint8_t *payload,
+                                                size_t length, bool retain) {
+  uint8_t lengthBytes[4];
+  const size_t lengthSize = encodeLength(static_cast<uint32_t>(2 + topicLength + length), lengthBytes);
+  auto packet = std::make_shared<Packet>();
+  std::vector<uint8_t> &bytes = packet->bytes;
+  bytes.resize(1 + lengthSize + 2 + topicLength + length);
+  uint8_t *p = bytes.data();
+  *p++ = static_cast<uint8_t>((kPublish << 4) | (retain ? 0x01 : 0x00));
+  std::memcpy(p, lengthBytes, lengthSize);
+  p += lengthSize;
+  *p++ = static_cast<uint8_t>(topicLength >> 8);
+  *p++ = static_cast<uint8_t>(topicLength & 0xFF);
+  std::memcpy(p, topic, topicLength);
+  p += topicLength;
+  if (length > 0) {
+    std::memcpy(p, payload, length);
+  }
+  return packet;
+}
+
+MqttBroker::PacketRef MqttBroker::controlPacket(uint8_t type, uint16_t packetId) {
+  auto packet = std::make_shared<Packet>();
+  packet->bytes = {static_cast<uint8_t>(type << 4), 2, static_cast<uint8_t>(packetId >> 8),
+                   static_cast<uint8_t>(packetId & 0xFF)};
+  return packet;
+}
+
 MqttBroker::Stats MqttBroker::getStats() const {
-  return stats_;
+  Stats stats = stats_;
+  stats.connectedClients = connectedClients_;
+  stats.totalMessages = totalMessages_;
+  stats.activeTopics = static_cast<int>(retained_.size());
+  stats.subscriptions = static_cast<uint32_t>(subscriptions_.subscriptionCount());
+  stats.uptimeMs = brokerActive_ ? brokerMillis() - stats_.startTime : 0;
+  stats.queuedBytes = 0;
+  for (const Client &client : clients_) {
+    stats.queuedBytes += client.queuedBytes;
+  }
+  return stats;
+}
+
+bool MqttBroker::getClientStats(size_t slot, ClientStats &out) const {
+  if (slot >= clients_.size() || !clients_[slot].connection) {
+    return false;
+  }
+  const Client &client = clients_[slot];
+  out.connected = client.session;
+  out.clientId = client.clientId;
+  out.delivered = client.delivered;
+  out.dropped = client.dropped;
+  out.bytesSent = client.bytesSent;
+  out.queuedPackets = client.count;
+  out.queuedBytes = client.queuedBytes;
+  return true;
 }
 
 bool MqttBroker::publish(const char* topic, const char* payload, bool retain) {
-  if (!brokerActive_ || !topic || !payload) {
+  if (!payload) {
     return false;
   }
+  return publish(topic, reinterpret_cast<const uint8_t *>(payload), std::strlen(payload), retain);
+}
 
-  Serial.printf("[MQTT] Publish: %s = %s (retain: %s)\n", 
-                topic, payload, retain ? "true" : "false");
-  
-  totalMessages_++;
-  stats_.totalMessages = totalMessages_;
-  stats_.lastTopic = topic;
-  stats_.lastPayload = payload;
-  
+bool MqttBroker::publish(const char *topic, const uint8_t *payload, size_t length, bool retain) {
+  if (!brokerActive_ || !topic || (!payload && length > 0)) {
+    return false;
+  }
+  const size_t topicLength = std::strlen(topic);
+  if (!TopicTrie::isValidTopic(topic, topicLength) || topicLength > 0xFFFF ||
+      2 + topicLength + length > kMaxPacketBytes) {
+    return false;
+  }
+  const PacketRef packet = encodePublish(topic, topicLength, payload, length, false);
+  stats_.bufferedBytes += packet->size();
+  route(packet, topic, topicLength, length, retain);
   return true;
 }
 
-bool MqttBroker::publishJoystickState(float leftX, float leftY, float rightX, float rightY, 
+bool MqttBroker::publishJoystickState(float leftX, float leftY, float rightX, float rightY,
                                      bool buttonA, bool buttonB, bool leftClick, bool rightClick) {
   if (!brokerActive_) return false;
-  
+
   char payload[256];
-  snprintf(payload, sizeof(payload), 
+  snprintf(payload, sizeof(payload),
            "{\"leftX\":%.2f,\"leftY\":%.2f,\"rightX\":%.2f,\"rightY\":%.2f,"
            "\"buttonA\":%s,\"buttonB\":%s,\"leftClick\":%s,\"rightClick\":%s}",
            leftX, leftY, rightX, rightY,
            buttonA ? "true" : "false", buttonB ? "true" : "false",
            leftClick ? "true" : "false", rightClick ? "true" : "false");
-  
+
   return publish("joystick/state", payload, false);
 }
 
@@ -123,7 +872,7 @@ bool MqttBroker::publishSystemStatus(const char* status) {
 
 bool MqttBroker::publishWiFiClients(int clientCount) {
   if (!brokerActive_) return false;
-  
+
   char payload[64];
   snprintf(payload, sizeof(payload), "{\"clients\":%d}", clientCount);
   return publish("joystick/system/wifi_clients", payload, true);
@@ -5,7 +5,10 @@
 
 #include <cstring>
 
-MqttService::MqttService(SharedState &sharedState) : sharedState_(sharedState) {
+MqttService::MqttService(SharedState &sharedState)
+    : sharedState_(sharedState), imageFrames_(sharedState.imageFrames()) {
+  registerMetrics();
+
   client_.onConnect([this](bool /*sessionPresent*/) {
     connected_ = true;
     lastStatusMs_ = 0;  // publish immediately
@@ -38,31 +41,64 @@ MqttService::MqttService(SharedState &sharedState) : sharedState_(sharedState) {
     if (!topicEmergency_.empty()) {
       client_.subscribe(topicEmergency_.c_str(), 2);  // QoS 2 for emergency commands
     }
+
+    // Binary control: QoS 0, posture updates stream at joystick rate
+    for (const std::string *binaryTopic : {&topicUiBinary_, &topicUiIndividualBinary_, &topicUiAllBinary_}) {
+      if (!binaryTopic->empty()) {
+        client_.subscribe(binaryTopic->c_str(), 0);
+      }
+    }
+
+    // Image frames: QoS 0, a lost frame is superseded by the next one anyway
+    if (imageFrames_.isAllocated()) {
+      for (const std::string *imageTopic :
+           {&topicImage_, &topicImageIndividual_, &topicImageAll_, &topicLiveIndividual_, &topicLiveAll_}) {
+        if (!imageTopic->empty()) {
+          client_.subscribe(imageTopic->c_str(), 0);
+        }
+      }
+    }
     publishStatus();
+    if (connectionListener_) {
+      connectionListener_(true);
+    }
   });
 
   client_.onDisconnect([this](AsyncMqttClientDisconnectReason /*reason*/) {
     connected_ = false;
-    lastReconnectMs_ = millis();
+    if (connectionListener_) {
+      connectionListener_(false);
+    }
   });
 
   client_.onMessage([this](char *topic, char *payload, AsyncMqttClientMessageProperties /*properties*/, size_t len,
                            size_t index, size_t total) {
     if (index == 0) {
-      resetIncomingBuffer(total);
-      incomingTopic_.assign(topic ? topic : "");
+      beginIncomingMessage(topic, total);
     }
-    if (index + len > incomingBuffer_.size()) {
-      incomingBuffer_.resize(index + len);
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(payload);
+    if (incomingKind_ == IncomingKind::kImage) {
+      // Image fragments go straight into the frame slot; completion is
+      // signalled by ImageFrameBuffer when the last byte lands.
+      imageFrames_.writeFragment(index, bytes, len);
+      return;
+    }
+    if (incomingKind_ != IncomingKind::kControl) {
+      return;
+    }
+    if (index + len > incomingPayload_.size()) {
+      incomingKind_ = IncomingKind::kIgnored;
+      return;
     }
     if (payload != nullptr && len > 0) {
-      std::memcpy(incomingBuffer_.data() + index, payload, len);
+      std::memcpy(&incomingPayload_[index], payload, len);
     }
     if (index + len == total) {
-      std::string message(reinterpret_cast<char *>(incomingBuffer_.data()), total);
-      handleIncomingMessage(incomingTopic_.c_str(), message);
+      handleIncomingMessage(incomingRoute_, incomingPayload_);
     }
   });
+
+  incomingPayload_.reserve(kMaxControlPayloadBytes);
 }
 
 bool MqttService::applyConfig(const ConfigManager::Config &config) {
@@ -76,8 +112,7 @@ bool MqttService::applyConfig(const ConfigManager::Config &config) {
   bool newSettings = (!configured_) || broker_ != config.mqtt.broker || port_ != config.mqtt.port ||
                      topicUi_ != config.mqtt.topicUi || topicUiAll_ != config.mqtt.topicUiAll ||
                      topicStatus_ != config.mqtt.topicStatus || topicImage_ != config.mqtt.topicImage ||
-                     topicCommand_ != config.mqtt.topicCommand || topicCommandAll_ != config.mqtt.topicCommandAll ||
-                     wifiConfig_.ssid != config.wifi.ssid || wifiConfig_.password != config.wifi.password;
+                     topicCommand_ != config.mqtt.topicCommand || topicCommandAll_ != config.mqtt.topicCommandAll;
 
   broker_ = config.mqtt.broker;
   port_ = config.mqtt.port == 0 ? 1883 : config.mqtt.port;
@@ -100,19 +135,51 @@ bool MqttService::applyConfig(const ConfigManager::Config &config) {
   topicCommandAll_ = config.mqtt.topicCommandAll.empty() ? "sphere/all/command" : config.mqtt.topicCommandAll;
   topicSync_ = config.mqtt.topicSync.empty() ? "system/all/sync" : config.mqtt.topicSync;
   topicEmergency_ = config.mqtt.topicEmergency.empty() ? "system/all/emergency" : config.mqtt.topicEmergency;
-  wifiConfig_ = config.wifi;
+  topicUiBinary_ = topicUi_ + control::kBinaryTopicSuffix;
+  topicUiIndividualBinary_ = topicUiIndividual_ + control::kBinaryTopicSuffix;
+  topicUiAllBinary_ = topicUiAll_ + control::kBinaryTopicSuffix;
+  topicLiveIndividual_ = topicImageIndividual_ + live::kTopicSuffix;
+  topicLiveAll_ = topicImageAll_ + live::kTopicSuffix;
+  rebuildTopicRoutes();
+
+  uint32_t ledCount = 0;
+  for (std::uint16_t strip : config.led.ledsPerStrip) {
+    ledCount += strip;
+  }
+  if (ledCount == 0 || ledCount > 0xFFFF) {
+    ledCount = live::kDefaultLedCount;
+  }
+  if (liveDecoder_.ledCount() != ledCount) {
+    liveDecoder_ = live::Decoder(static_cast<uint16_t>(ledCount));
+  }
   clientId_ = config.system.name.empty() ? "isolation-sphere" : config.system.name;
 
+  if (syncConfig_.enabled != config.sync.enabled || syncConfig_.master != config.sync.master ||
+      syncConfig_.fps != config.sync.fps) {
+    syncClock_.reset();
+    syncTimebasePublished_ = false;
+  }
+  syncConfig_ = config.sync;
+
+  telemetryConfig_ = config.telemetry;
+  if (telemetryConfig_.intervalMs < kMinMetricsIntervalMs) {
+    telemetryConfig_.intervalMs = kMinMetricsIntervalMs;
+  }
+  topicMetrics_ = telemetryConfig_.topic.empty() ? topicStatus_ + "/metrics" : telemetryConfig_.topic;
+
   enabled_ = true;
 
+  if (!imageFrames_.isAllocated() && !imageFrames_.allocate(kImageSlotBytes)) {
+    Serial.printf("[MQTT] Failed to allocate image frame slots (%u bytes x %u)\n",
+                  static_cast<unsigned>(kImageSlotBytes), static_cast<unsigned>(ImageFrameBuffer::kSlotCount));
+  }
+
   if (newSettings) {
     stop();
     client_.setServer(broker_.c_str(), port_);
     client_.setClientId(clientId_.c_str());
     configured_ = true;
-    lastReconnectMs_ = 0;
     lastStatusMs_ = 0;
-    lastWifiAttemptMs_ = 0;
   }
 
   return true;
@@ -123,14 +190,15 @@ void MqttService::loop() {
     return;
   }
 
-  ensureWifi();
-  connectIfNeeded();
-
+  const uint32_t now = millis();
+  updateSync(now);
   if (connected_) {
-    const uint32_t now = millis();
     if (now - lastStatusMs_ >= kStatusIntervalMs) {
       publishStatus();
     }
+    if (telemetryConfig_.enabled && now - lastMetricsMs_ >= telemetryConfig_.intervalMs) {
+      publishMetrics();
+    }
   }
 }
 
@@ -139,7 +207,7 @@ bool MqttService::publishStatus() {
     return false;
   }
 
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<1024> doc;
   doc["status"] = "online";
   doc["uptime_ms"] = static_cast<uint32_t>(millis());
   doc["wifi_connected"] = WiFi.status() == WL_CONNECTED;
@@ -150,9 +218,53 @@ bool MqttService::publishStatus() {
   } else {
     doc["ui_mode"] = false;
   }
+  const SharedState::CommandQueueStats queues = sharedState_.getCommandQueueStats();
+  JsonObject queueStatus = doc.createNestedObject("queues");
+  queueStatus["ui_in_overflow"] = queues.uiIncomingOverflow;
+  queueStatus["ui_out_overflow"] = queues.uiOutgoingOverflow;
+  queueStatus["sys_in_overflow"] = queues.systemIncomingOverflow;
+  queueStatus["sys_out_overflow"] = queues.systemOutgoingOverflow;
+  queueStatus["oversize"] = queues.oversizeRejected;
+  queueStatus["ui_in_high_water"] = queues.uiIncomingHighWater;
+  queueStatus["sys_in_high_water"] = queues.systemIncomingHighWater;
+  const ImageFrameBuffer::Stats images = imageFrames_.stats();
+  JsonObject imageStatus = doc.createNestedObject("images");
+  imageStatus["completed"] = images.framesCompleted;
+  imageStatus["dropped"] = images.framesDropped;
+  imageStatus["oversize"] = images.framesOversize;
+  imageStatus["aborted"] = images.framesAborted;
+  const live::Decoder::Stats liveStats = this->liveStats();
+  JsonObject liveStatus = doc.createNestedObject("live");
+  liveStatus["frames"] = liveStats.frames;
+  liveStatus["keyframes"] = liveStats.keyframes;
+  liveStatus["lost"] = liveStats.lost;
+  liveStatus["missing_keyframe"] = liveStats.missingKeyframe;
+  liveStatus["invalid"] = liveStats.invalid;
+  liveStatus["keyframe_requests"] = keyframeRequests_.load(std::memory_order_relaxed);
+  // Protocol negotiation: controllers that see "binary" may switch to the
+  // "<ui topic>/bin" topics; JSON stays available.
+  JsonObject protocol = doc.createNestedObject("protocol");
+  protocol["json"] = 1;
+  protocol["binary"] = control::kVersion;
+  protocol["binary_suffix"] = control::kBinaryTopicSuffix;
+  protocol["binary_rx"] = binaryMessages_.load(std::memory_order_relaxed);
+  protocol["json_rx"] = jsonMessages_.load(std::memory_order_relaxed);
+  if (syncConfig_.enabled) {
+    const SyncClock::Stats sync = syncClock_.stats();
+    JsonObject syncStatus = doc.createNestedObject("sync");
+    syncStatus["role"] = syncConfig_.master ? "master" : "follower";
+    if (!syncConfig_.master) {
+      syncStatus["locked"] = syncClock_.locked(millis(), kSyncLockTimeoutMs);
+      syncStatus["offset_ms"] = syncClock_.timebase().offsetMs;
+      syncStatus["drift_ppm"] = sync.driftPpm;
+      syncStatus["beacons"] = sync.beacons;
+      syncStatus["outliers"] = sync.outliers;
+      syncStatus["resyncs"] = sync.resyncs;
+    }
+  }
 
   std::string payload;
-  payload.reserve(128);
+  payload.reserve(256);
   serializeJson(doc, payload);
 
   const auto packetId = client_.publish(topicStatus_.c_str(), 1, true, payload.c_str(), payload.size());
@@ -163,6 +275,67 @@ bool MqttService::publishStatus() {
   return false;
 }
 
+bool MqttService::publishMetrics() {
+  if (!enabled_ || !connected_ || topicMetrics_.empty()) {
+    return false;
+  }
+  const uint32_t now = millis();
+  sharedState_.metrics().serialize(metricsPayload_, now);
+  // The window is closed even if the publish fails; the next payload's "dt"
+  // tells the collector how long it covers.
+  lastMetricsMs_ = now;
+  const auto packetId =
+      client_.publish(topicMetrics_.c_str(), 0, false, metricsPayload_.c_str(), metricsPayload_.size());
+  return packetId != 0;
+}
+
+void MqttService::registerMetrics() {
+  // Image/live/queue stats are already kept by their owners; mirror them at
+  // publish time rather than touching the registry on the message path.
+  MetricsRegistry &metrics = sharedState_.metrics();
+  using Rate = MetricsRegistry::CounterRate;
+  MetricsRegistry::Counter *imageFrames = metrics.counter("img_frames", Rate::kPerSecond);
+  MetricsRegistry::Counter *imageDropped = metrics.counter("img_drop");
+  MetricsRegistry::Counter *imageRejected = metrics.counter("img_reject");
+  MetricsRegistry::Counter *liveFrames = metrics.counter("live_frames", Rate::kPerSecond);
+  MetricsRegistry::Counter *liveLost = metrics.counter("live_lost");
+  MetricsRegistry::Counter *liveNoKeyframe = metrics.counter("live_nokf");
+  MetricsRegistry::Counter *controlRx = metrics.counter("ctrl_rx", Rate::kPerSecond);
+  MetricsRegistry::Counter *queueOverflow = metrics.counter("queue_overflow");
+  MetricsRegistry::Gauge *uiQueue = metrics.gauge("queue_ui");
+  MetricsRegistry::Gauge *systemQueue = metrics.gauge("queue_sys");
+  MetricsRegistry::Gauge *rssi = metrics.gauge("wifi_rssi");
+
+  metrics.addSampler([=]() {
+    auto mirror = [](MetricsRegistry::Counter *counter, uint32_t value) {
+      if (counter != nullptr) {
+        counter->set(value);
+      }
+    };
+    auto level = [](MetricsRegistry::Gauge *gauge, float value) {
+      if (gauge != nullptr) {
+        gauge->set(value);
+      }
+    };
+    const ImageFrameBuffer::Stats images = imageFrames_.stats();
+    mirror(imageFrames, images.framesCompleted);
+    mirror(imageDropped, images.framesDropped);
+    mirror(imageRejected, images.framesOversize + images.framesAborted);
+    const live::Decoder::Stats liveStats = this->liveStats();
+    mirror(liveFrames, liveStats.frames);
+    mirror(liveLost, liveStats.lost);
+    mirror(liveNoKeyframe, liveStats.missingKeyframe);
+    mirror(controlRx,
+           binaryMessages_.load(std::memory_order_relaxed) + jsonMessages_.load(std::memory_order_relaxed));
+    const SharedState::CommandQueueStats queues = sharedState_.getCommandQueueStats();
+    mirror(queueOverflow, queues.uiIncomingOverflow + queues.uiOutgoingOverflow + queues.systemIncomingOverflow +
+                              queues.systemOutgoingOverflow + queues.oversizeRejected);
+    level(uiQueue, queues.uiIncomingDepth);
+    level(systemQueue, queues.systemIncomingDepth);
+    level(rssi, static_cast<float>(WiFi.RSSI()));
+  });
+}
+
 bool MqttService::publishImage(const uint8_t *data, size_t length, bool retain, uint8_t qos) {
   if (!enabled_ || !connected_ || topicImage_.empty() || data == nullptr || length == 0) {
     return false;
@@ -172,13 +345,13 @@ bool MqttService::publishImage(const uint8_t *data, size_t length, bool retain,
   return packetId != 0;
 }
 
-bool MqttService::publishUiEvent(const std::string &command, const char *source) {
-  if (!enabled_ || !connected_ || topicUi_.empty() || command.empty()) {
+bool MqttService::publishUiEvent(const char *command, const char *source) {
+  if (!enabled_ || !connected_ || topicUi_.empty() || command == nullptr || command[0] == '\0') {
     return false;
   }
 
   StaticJsonDocument<128> doc;
-  doc["command"] = command.c_str();
+  doc["command"] = command;
   doc["timestamp"] = static_cast<uint32_t>(millis());
   if (source != nullptr) {
     doc["source"] = source;
@@ -188,6 +361,21 @@ bool MqttService::publishUiEvent(const std::string &command, const char *source)
   serializeJson(doc, payload);
 
   const auto packetId = client_.publish(topicUi_.c_str(), 1, false, payload.c_str(), payload.size());
+
+  // Mirror onto the binary topic once a binary-capable controller is around
+  if (binaryPeerSeen_.load(std::memory_order_relaxed) && !topicUiBinary_.empty()) {
+    control::Message message;
+    message.type = control::MessageType::kUiEvent;
+    message.sequence = ++uiEventSequence_;
+    message.command = parseUiCommandType(command, std::strlen(command));
+    if (message.command != UiCommandType::kRaw) {
+      message.fields = control::kFieldCommand;
+    }
+    message.timestampMs = static_cast<uint32_t>(millis());
+    uint8_t frame[control::kMessageSize];
+    const size_t length = control::encode(message, frame, sizeof(frame));
+    client_.publish(topicUiBinary_.c_str(), 0, false, reinterpret_cast<const char *>(frame), length);
+  }
   return packetId != 0;
 }
 
@@ -198,85 +386,276 @@ void MqttService::stop() {
   connected_ = false;
 }
 
-void MqttService::ensureWifi() {
-  if (wifiConfig_.ssid.empty()) {
-    return;
+bool MqttService::connect() {
+  if (!enabled_ || !configured_ || connected_) {
+    return false;
   }
-  if (WiFi.status() == WL_CONNECTED) {
-    return;
+  client_.connect();
+  return true;
+}
+
+void MqttService::handleIncomingMessage(TopicRoute route, const std::string &payload) {
+  switch (route) {
+    case TopicRoute::kUiBinary:
+      // Hot path (joystick rate): no JSON and no logging
+      handleBinaryControl(payload);
+      return;
+    case TopicRoute::kUi:
+      if (shouldLog()) {
+        Serial.printf("[MQTT] UI message on %s: %s\n", incomingTopic_.c_str(), payload.c_str());
+      }
+      if (tryParseUiMessage(payload)) {
+        return;
+      }
+      if (!sharedState_.pushUiCommand(payload, true)) {
+        Serial.println("[MQTT] UI command dropped (queue full or too long)");
+      }
+      return;
+    case TopicRoute::kCommand:
+      if (shouldLog()) {
+        Serial.printf("[MQTT] System command on %s: %s\n", incomingTopic_.c_str(), payload.c_str());
+      }
+      pushSystemCommand(SystemCommandType::kCommand, payload);
+      return;
+    case TopicRoute::kSync:
+      if (tryParseSyncBeacon(payload)) {
+        return;
+      }
+      if (shouldLog()) {
+        Serial.printf("[MQTT] Sync command: %s\n", payload.c_str());
+      }
+      pushSystemCommand(SystemCommandType::kSync, payload);
+      return;
+    case TopicRoute::kEmergency:
+      // Always logged
+      Serial.printf("[MQTT] EMERGENCY command: %s\n", payload.c_str());
+      pushSystemCommand(SystemCommandType::kEmergency, payload);
+      return;
+    case TopicRoute::kLive:
+      // Hot path (up to 30 fps): no logging
+      handleLiveFrame(payload);
+      return;
+    case TopicRoute::kImage:
+    case TopicRoute::kUnhandled:
+      break;
   }
-  const uint32_t now = millis();
-  if (now - lastWifiAttemptMs_ < kWifiRetryIntervalMs) {
-    return;
+  if (shouldLog()) {
+    Serial.printf("[MQTT] Unhandled topic: %s\n", incomingTopic_.c_str());
   }
-  lastWifiAttemptMs_ = now;
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(wifiConfig_.ssid.c_str(), wifiConfig_.password.c_str());
 }
 
-void MqttService::connectIfNeeded() {
-  if (!enabled_ || WiFi.status() != WL_CONNECTED) {
-    return;
+bool MqttService::shouldLog() {
+  if (!logLimiter_.allow(millis())) {
+    return false;
   }
-  if (connected_) {
-    return;
+  const uint32_t suppressed = logLimiter_.takeSuppressed();
+  if (suppressed != 0) {
+    Serial.printf("[MQTT] (%lu log lines suppressed)\n", static_cast<unsigned long>(suppressed));
   }
-  const uint32_t now = millis();
-  if (now - lastReconnectMs_ < kReconnectIntervalMs) {
+  return true;
+}
+
+void MqttService::rebuildTopicRoutes() {
+  struct RouteSpec {
+    const std::string *topic;
+    TopicRoute route;
+    uint8_t tag;
+  };
+  const RouteSpec specs[] = {
+      {&topicUiBinary_, TopicRoute::kUiBinary, 0},
+      {&topicUiIndividualBinary_, TopicRoute::kUiBinary, 0},
+      {&topicUiAllBinary_, TopicRoute::kUiBinary, 0},
+      {&topicUi_, TopicRoute::kUi, 0},
+      {&topicUiIndividual_, TopicRoute::kUi, 0},
+      {&topicUiAll_, TopicRoute::kUi, 0},
+      {&topicCommand_, TopicRoute::kCommand, 0},
+      {&topicCommandIndividual_, TopicRoute::kCommand, 0},
+      {&topicCommandAll_, TopicRoute::kCommand, 0},
+      {&topicSync_, TopicRoute::kSync, 0},
+      {&topicEmergency_, TopicRoute::kEmergency, 0},
+      {&topicImage_, TopicRoute::kImage, static_cast<uint8_t>(ImageSource::kLegacy)},
+      {&topicImageIndividual_, TopicRoute::kImage, static_cast<uint8_t>(ImageSource::kIndividual)},
+      {&topicImageAll_, TopicRoute::kImage, static_cast<uint8_t>(ImageSource::kBroadcast)},
+      {&topicLiveIndividual_, TopicRoute::kLive, 0},
+      {&topicLiveAll_, TopicRoute::kLive, 0},
+  };
+
+  // Only rebuild when a routed topic actually changed
+  uint32_t signature = 0;
+  for (const RouteSpec &spec : specs) {
+    signature = signature * 31u + TopicRouter::hash(spec.topic->data(), spec.topic->size());
+  }
+  if (routesBuilt_ && signature == routeSignature_) {
     return;
   }
-  lastReconnectMs_ = now;
-  client_.connect();
+
+  topicRouter_.clear();
+  for (const RouteSpec &spec : specs) {
+    topicRouter_.add(*spec.topic, static_cast<uint8_t>(spec.route), spec.tag);
+  }
+  routeSignature_ = signature;
+  routesBuilt_ = true;
+  Serial.printf("[MQTT] Topic routes: %u exact, %u wildcard\n", static_cast<unsigned>(topicRouter_.exactCount()),
+                static_cast<unsigned>(topicRouter_.wildcardCount()));
 }
 
-void MqttService::handleIncomingMessage(const char *topic, const std::string &payload) {
-  if (topic == nullptr) {
-    return;
+void MqttService::pushSystemCommand(SystemCommandType type, const std::string &payload) {
+  if (!sharedState_.pushSystemCommand(type, payload.data(), payload.size(), true)) {
+    Serial.printf("[MQTT] System command dropped (queue full or %u bytes > %u)\n",
+                  static_cast<unsigned>(payload.size()), static_cast<unsigned>(SystemCommand::kArgCapacity));
   }
-  
-  Serial.printf("[MQTT] Received message on topic: %s\n", topic);
-  
-  // Handle UI topics (backward compatibility + individual + broadcast)
-  if ((!topicUi_.empty() && topicUi_ == topic) ||
-      (!topicUiIndividual_.empty() && topicUiIndividual_ == topic) ||
-      (!topicUiAll_.empty() && topicUiAll_ == topic)) {
-    Serial.printf("[MQTT] Processing UI command: %s\n", payload.c_str());
-    if (tryParseUiMessage(payload)) {
-      return;
+}
+
+bool MqttService::tryParseSyncBeacon(const std::string &payload) {
+  // Stamp before parsing so JSON time does not count as network delay
+  const uint32_t receivedMs = millis();
+  if (payload.empty() || payload[0] != '{') {
+    return false;
+  }
+  StaticJsonDocument<256> doc;
+  if (deserializeJson(doc, payload) != DeserializationError::Ok) {
+    return false;
+  }
+  const char *type = doc["type"];
+  if (type == nullptr || std::strcmp(type, "timebase") != 0) {
+    return false;
+  }
+  const char *master = doc["master"] | "";
+  if (!syncConfig_.enabled || syncConfig_.master || clientId_ == master) {
+    return true;
+  }
+
+  PendingBeacon pending;
+  pending.beacon.masterMs = doc["ms"] | 0u;
+  pending.beacon.frame = doc["frame"] | 0u;
+  pending.beacon.frameOffsetMs = doc["frame_ms"] | 0u;
+  pending.beacon.fps = doc["fps"] | syncConfig_.fps;
+  pending.beacon.sequence = doc["seq"] | 0u;
+  pending.receivedMs = receivedMs;
+  pending.serial = ++pendingBeaconSerial_;
+  pendingBeacon_.write(pending);
+  return true;
+}
+
+void MqttService::updateSync(uint32_t now) {
+  if (!syncConfig_.enabled || syncConfig_.master) {
+    // Standalone spheres and the master run on their own clock
+    if (!syncTimebasePublished_) {
+      sharedState_.updateSyncTimebase(SyncTimebase::local(0, syncConfig_.fps));
+      syncTimebasePublished_ = true;
+    }
+    if (syncConfig_.enabled && connected_ && now - lastBeaconSentMs_ >= syncConfig_.beaconIntervalMs) {
+      publishSyncBeacon(now);
     }
-    sharedState_.pushUiCommand(payload, true);
     return;
   }
-  
-  // Handle Command topics (backward compatibility + individual + broadcast)
-  if ((!topicCommand_.empty() && topicCommand_ == topic) ||
-      (!topicCommandIndividual_.empty() && topicCommandIndividual_ == topic) ||
-      (!topicCommandAll_.empty() && topicCommandAll_ == topic)) {
-    Serial.printf("[MQTT] Processing system command: %s\n", payload.c_str());
-    sharedState_.pushSystemCommand(payload, true);
+
+  PendingBeacon pending;
+  if (!pendingBeacon_.read(pending) || pending.serial == consumedBeaconSerial_) {
     return;
   }
-  
-  // Handle System Sync commands
-  if (!topicSync_.empty() && topicSync_ == topic) {
-    Serial.printf("[MQTT] Processing sync command: %s\n", payload.c_str());
-    sharedState_.pushSystemCommand(payload, true);
+  consumedBeaconSerial_ = pending.serial;
+  if (syncClock_.onBeacon(pending.beacon, pending.receivedMs)) {
+    sharedState_.updateSyncTimebase(syncClock_.timebase());
+    syncTimebasePublished_ = true;
+  }
+}
+
+bool MqttService::publishSyncBeacon(uint32_t now) {
+  lastBeaconSentMs_ = now;
+  if (topicSync_.empty()) {
+    return false;
+  }
+  const SyncClock::Beacon beacon =
+      SyncClock::makeBeacon(static_cast<uint32_t>(millis()), 0, syncConfig_.fps, ++beaconSequence_);
+
+  StaticJsonDocument<192> doc;
+  doc["type"] = "timebase";
+  doc["master"] = clientId_;
+  doc["ms"] = beacon.masterMs;
+  doc["frame"] = beacon.frame;
+  doc["frame_ms"] = beacon.frameOffsetMs;
+  doc["fps"] = beacon.fps;
+  doc["seq"] = beacon.sequence;
+  char payload[192];
+  const size_t length = serializeJson(doc, payload, sizeof(payload));
+
+  // QoS 0: a redelivered beacon carries a stale timestamp, and followers
+  // tolerate a lost one (the subscription's QoS 2 does not upgrade it).
+  return client_.publish(topicSync_.c_str(), 0, false, payload, length) != 0;
+}
+
+void MqttService::handleLiveFrame(const std::string &payload) {
+  const live::Decoder::Result result =
+      liveDecoder_.decode(reinterpret_cast<const uint8_t *>(payload.data()), payload.size());
+  liveStats_.write(liveDecoder_.stats());
+  if (result == live::Decoder::Result::kNeedKeyframe) {
+    requestLiveKeyframe();
     return;
   }
-  
-  // Handle Emergency commands
-  if (!topicEmergency_.empty() && topicEmergency_ == topic) {
-    Serial.printf("[MQTT] Processing EMERGENCY command: %s\n", payload.c_str());
-    sharedState_.pushSystemCommand(payload, true);
+  if (result != live::Decoder::Result::kFrame || !imageFrames_.isAllocated()) {
     return;
   }
-  
-  Serial.printf("[MQTT] Unhandled topic: %s\n", topic);
+  // Hand the reconstructed LED frame to the image consumer like any other
+  // frame; a frame it has not picked up yet is replaced (counted as dropped).
+  const size_t bytes = liveDecoder_.frameBytes();
+  if (imageFrames_.beginFrame(bytes, static_cast<uint8_t>(ImageSource::kLive))) {
+    imageFrames_.writeFragment(0, liveDecoder_.frame(), bytes);
+  }
+}
+
+live::Decoder::Stats MqttService::liveStats() const {
+  live::Decoder::Stats stats;
+  liveStats_.read(stats);  // stays zeroed until the first live frame
+  return stats;
 }
 
-void MqttService::resetIncomingBuffer(size_t totalLength) {
-  incomingBuffer_.clear();
-  incomingBuffer_.resize(totalLength);
+void MqttService::requestLiveKeyframe() {
+  const uint32_t now = millis();
+  if (keyframeRequests_.load(std::memory_order_relaxed) != 0 &&
+      now - lastKeyframeRequestMs_ < kKeyframeRequestIntervalMs) {
+    return;
+  }
+  lastKeyframeRequestMs_ = now;
+  keyframeRequests_.fetch_add(1, std::memory_order_relaxed);
+
+  // Reply on the topic the frame came from, so the sender of that stream
+  // (individual or broadcast) sees it.
+  const std::string topic = incomingTopic_ + live::kKeyframeRequestSuffix;
+  StaticJsonDocument<128> doc;
+  doc["client"] = clientId_;
+  doc["last"] = liveDecoder_.lastSequence();
+  char payload[128];
+  const size_t length = serializeJson(doc, payload, sizeof(payload));
+  client_.publish(topic.c_str(), 0, false, payload, length);
+}
+
+void MqttService::beginIncomingMessage(const char *topic, size_t totalLength) {
+  incomingTopic_.assign(topic ? topic : "");
+  incomingKind_ = IncomingKind::kIgnored;
+
+  TopicRouter::Match match;
+  incomingRoute_ = topicRouter_.match(topic, match) ? static_cast<TopicRoute>(match.route) : TopicRoute::kUnhandled;
+
+  if (incomingRoute_ == TopicRoute::kImage) {
+    if (imageFrames_.isAllocated() && imageFrames_.beginFrame(totalLength, match.tag)) {
+      incomingKind_ = IncomingKind::kImage;
+    } else if (shouldLog()) {
+      Serial.printf("[MQTT] Image frame dropped (%u bytes)\n", static_cast<unsigned>(totalLength));
+    }
+    return;
+  }
+
+  if (totalLength > kMaxControlPayloadBytes) {
+    if (shouldLog()) {
+      Serial.printf("[MQTT] Payload too large on %s (%u bytes), ignored\n", incomingTopic_.c_str(),
+                    static_cast<unsigned>(totalLength));
+    }
+    return;
+  }
+  // Stays within the reserved capacity, so this never reallocates
+  incomingPayload_.resize(totalLength);
+  incomingKind_ = IncomingKind::kControl;
 }
 
 bool MqttService::tryParseUiMessage(const std::string &payload) {
@@ -290,12 +669,61 @@ bool MqttService::tryParseUiMessage(const std::string &payload) {
     return false;
   }
 
+  jsonMessages_.fetch_add(1, std::memory_order_relaxed);
   const char *command = doc["command"];
-  if (command && command[0] != '\0') {
-    sharedState_.pushUiCommand(command, true);
+  if (command && command[0] != '\0' && !sharedState_.pushUiCommand(command, true)) {
+    Serial.printf("[MQTT] UI command dropped (queue full or too long): %s\n", command);
   }
 
-  // Additional settings (dim/overlay) can be parsed here in the future.
+  // Same optional fields as the binary format
+  const JsonDocument &fields = doc;
+  control::Message message;
+  JsonVariantConst latitude = fields["latitude_offset"];
+  JsonVariantConst longitude = fields["longitude_offset"];
+  if (!latitude.isNull() || !longitude.isNull()) {
+    message.fields |= control::kFieldPosture;
+    message.latitudeOffsetDeg = latitude.isNull() ? remoteControl_.latitudeOffsetDeg : latitude.as<float>();
+    message.longitudeOffsetDeg = longitude.isNull() ? remoteControl_.longitudeOffsetDeg : longitude.as<float>();
+  }
+  if (!fields["brightness"].isNull()) {
+    message.fields |= control::kFieldBrightness;
+    message.brightness = fields["brightness"].as<uint8_t>();
+  }
+  if (!fields["pattern"].isNull()) {
+    message.fields |= control::kFieldPattern;
+    message.patternId = fields["pattern"].as<uint8_t>();
+  }
+  if (message.fields != 0) {
+    message.sequence = fields["seq"] | 0;
+    applyControl(message);
+  }
 
   return true;
 }
+
+void MqttService::handleBinaryControl(const std::string &payload) {
+  control::Message message;
+  if (!control::decode(reinterpret_cast<const uint8_t *>(payload.data()), payload.size(), message) ||
+      message.type != control::MessageType::kControl) {
+    return;
+  }
+  binaryMessages_.fetch_add(1, std::memory_order_relaxed);
+  binaryPeerSeen_.store(true, std::memory_order_relaxed);
+
+  if (message.has(control::kFieldCommand)) {
+    const char *name = control::commandName(message.command);
+    if (name != nullptr) {
+      UiCommand record;
+      record.assign(message.command, name, std::strlen(name));
+      sharedState_.pushUiCommand(record, true);
+    }
+  }
+  applyControl(message);
+}
+
+void MqttService::applyControl(const control::Message &message) {
+  remoteControl_.source = ControlSource::kMqtt;
+  if (control::apply(message, remoteControl_, static_cast<uint32_t>(millis()))) {
+    sharedState_.updateRemoteControl(remoteControl_);
+  }
+}
@@ -0,0 +1,92 @@
+#include "mqtt/TopicRouter.h"
+
+#include <algorithm>
+#include <cstring>
+
+void TopicRouter::clear() {
+  exact_.clear();
+  wildcard_.clear();
+}
+
+uint32_t TopicRouter::hash(const char *data, size_t length) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    h ^= static_cast<uint8_t>(data[i]);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+bool TopicRouter::isWildcard(const std::string &filter) {
+  return filter.find_first_of("+#") != std::string::npos;
+}
+
+bool TopicRouter::add(const std::string &filter, uint8_t route, uint8_t tag) {
+  if (filter.empty()) {
+    return false;
+  }
+  Entry entry{hash(filter.data(), filter.size()), filter, Match{route, tag}};
+  if (isWildcard(filter)) {
+    wildcard_.push_back(std::move(entry));
+    return true;
+  }
+
+  auto it = std::lower_bound(exact_.begin(), exact_.end(), entry.hash,
+                             [](const Entry &e, uint32_t h) { return e.hash < h; });
+  for (auto scan = it; scan != exact_.end() && scan->hash == entry.hash; ++scan) {
+    if (scan->topic == filter) {
+      return false;
+    }
+  }
+  exact_.insert(it, std::move(entry));
+  return true;
+}
+
+bool TopicRouter::match(const char *topic, Match &out) const {
+  if (topic == nullptr) {
+    return false;
+  }
+  const size_t length = std::strlen(topic);
+  const uint32_t h = hash(topic, length);
+  auto it = std::lower_bound(exact_.begin(), exact_.end(), h, [](const Entry &e, uint32_t v) { return e.hash < v; });
+  for (; it != exact_.end() && it->hash == h; ++it) {
+    if (it->topic.size() == length && std::memcmp(it->topic.data(), topic, length) == 0) {
+      out = it->match;
+      return true;
+    }
+  }
+  for (const Entry &entry : wildcard_) {
+    if (matchesFilter(entry.topic, topic, length)) {
+      out = entry.match;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TopicRouter::matchesFilter(const std::string &filter, const char *topic, size_t topicLength) {
+  size_t f = 0;
+  size_t t = 0;
+  const size_t filterLength = filter.size();
+  while (f < filterLength) {
+    const char c = filter[f];
+    if (c == '#') {
+      // Matches the parent level too ("a/#" matches "a")
+      return true;
+    }
+    if (c == '+') {
+      while (t < topicLength && topic[t] != '/') {
+        ++t;
+      }
+      ++f;
+    } else {
+      if (t >= topicLength || topic[t] != c) {
+        // "a/#" against "a": the filter's "/#" tail may match nothing
+        return t == topicLength && c == '/' && f + 2 == filterLength && filter[f + 1] == '#';
+      }
+      ++f;
+      ++t;
+    }
+  }
+  return t == topicLength;
+}
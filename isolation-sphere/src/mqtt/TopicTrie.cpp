@@ -0,0 +1,253 @@
+#include "mqtt/TopicTrie.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mqtt/TopicRouter.h"
+
+namespace {
+
+bool isLevel(const char *level, size_t length, char wildcard) { return length == 1 && level[0] == wildcard; }
+
+TopicTrie::Mask bitOf(uint8_t subscriber) { return static_cast<TopicTrie::Mask>(1u) << subscriber; }
+
+}  // namespace
+
+TopicTrie::TopicTrie() { clear(); }
+
+void TopicTrie::clear() {
+  nodes_.clear();
+  free_.clear();
+  nodes_.emplace_back();
+  subscriptions_ = 0;
+}
+
+bool TopicTrie::isValidFilter(const char *filter, size_t length) {
+  if (filter == nullptr || length == 0) {
+    return false;
+  }
+  size_t start = 0;
+  while (start <= length) {
+    size_t end = start;
+    while (end < length && filter[end] != '/') {
+      ++end;
+    }
+    const char *level = filter + start;
+    const size_t levelLength = end - start;
+    for (size_t i = 0; i < levelLength; ++i) {
+      if ((level[i] == '+' || level[i] == '#') && levelLength != 1) {
+        return false;
+      }
+    }
+    if (isLevel(level, levelLength, '#') && end != length) {
+      return false;
+    }
+    start = end + 1;
+  }
+  return true;
+}
+
+bool TopicTrie::isValidTopic(const char *topic, size_t length) {
+  if (topic == nullptr || length == 0) {
+    return false;
+  }
+  for (size_t i = 0; i < length; ++i) {
+    if (topic[i] == '+' || topic[i] == '#' || topic[i] == '\0') {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TopicTrie::matches(const std::string &filter, const char *topic, size_t length) {
+  // Wildcards in the first level never match "$SYS"-style topics.
+  if (length > 0 && topic[0] == '$' && !filter.empty() && (filter[0] == '+' || filter[0] == '#')) {
+    return false;
+  }
+  return TopicRouter::matchesFilter(filter, topic, length);
+}
+
+uint16_t TopicTrie::allocateNode(uint16_t parent, const char *level, size_t length, uint32_t hash) {
+  uint16_t index;
+  if (!free_.empty()) {
+    index = free_.back();
+    free_.pop_back();
+    nodes_[index] = Node();
+  } else {
+    if (nodes_.size() >= kNone) {
+      return kNone;
+    }
+    index = static_cast<uint16_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  Node &node = nodes_[index];
+  node.parent = parent;
+  node.hash = hash;
+  node.level.assign(level, length);
+  return index;
+}
+
+uint16_t TopicTrie::findChild(uint16_t node, const char *level, size_t length, uint32_t hash) const {
+  for (uint16_t child : nodes_[node].children) {
+    const Node &candidate = nodes_[child];
+    if (candidate.hash == hash && candidate.level.size() == length &&
+        std::memcmp(candidate.level.data(), level, length) == 0) {
+      return child;
+    }
+  }
+  return kNone;
+}
+
+uint16_t TopicTrie::locate(const std::string &filter, bool create, bool &multiLevel) {
+  multiLevel = false;
+  uint16_t node = kRoot;
+  const char *text = filter.data();
+  const size_t length = filter.size();
+  size_t start = 0;
+  while (start <= length) {
+    size_t end = start;
+    while (end < length && text[end] != '/') {
+      ++end;
+    }
+    const char *level = text + start;
+    const size_t levelLength = end - start;
+    if (isLevel(level, levelLength, '#')) {
+      multiLevel = true;
+      return node;
+    }
+
+    uint16_t next;
+    if (isLevel(level, levelLength, '+')) {
+      next = nodes_[node].plus;
+      if (next == kNone && create) {
+        next = allocateNode(node, level, levelLength, 0);
+        if (next != kNone) {
+          nodes_[node].plus = next;
+        }
+      }
+    } else {
+      const uint32_t hash = TopicRouter::hash(level, levelLength);
+      next = findChild(node, level, levelLength, hash);
+      if (next == kNone && create) {
+        next = allocateNode(node, level, levelLength, hash);
+        if (next != kNone) {
+          nodes_[node].children.push_back(next);
+        }
+      }
+    }
+    if (next == kNone) {
+      return kNone;
+    }
+    node = next;
+    start = end + 1;
+  }
+  return node;
+}
+
+bool TopicTrie::subscribe(const std::string &filter, uint8_t subscriber) {
+  if (subscriber >= kMaxSubscribers || !isValidFilter(filter.data(), filter.size())) {
+    return false;
+  }
+  bool multiLevel = false;
+  const uint16_t node = locate(filter, true, multiLevel);
+  if (node == kNone) {
+    return false;
+  }
+  Mask &mask = multiLevel ? nodes_[node].rest : nodes_[node].exact;
+  if ((mask & bitOf(subscriber)) == 0) {
+    mask |= bitOf(subscriber);
+    ++subscriptions_;
+  }
+  return true;
+}
+
+bool TopicTrie::unsubscribe(const std::string &filter, uint8_t subscriber) {
+  if (subscriber >= kMaxSubscribers || !isValidFilter(filter.data(), filter.size())) {
+    return false;
+  }
+  bool multiLevel = false;
+  const uint16_t node = locate(filter, false, multiLevel);
+  if (node == kNone) {
+    return false;
+  }
+  Mask &mask = multiLevel ? nodes_[node].rest : nodes_[node].exact;
+  if ((mask & bitOf(subscriber)) == 0) {
+    return false;
+  }
+  mask &= ~bitOf(subscriber);
+  --subscriptions_;
+  prune(node);
+  return true;
+}
+
+void TopicTrie::removeSubscriber(uint8_t subscriber) {
+  if (subscriber >= kMaxSubscribers) {
+    return;
+  }
+  const Mask bit = bitOf(subscriber);
+  for (Node &node : nodes_) {
+    if (node.exact & bit) {
+      node.exact &= ~bit;
+      --subscriptions_;
+    }
+    if (node.rest & bit) {
+      node.rest &= ~bit;
+      --subscriptions_;
+    }
+  }
+  for (size_t i = nodes_.size(); i-- > 1;) {
+    if (nodes_[i].parent != kNone) {
+      prune(static_cast<uint16_t>(i));
+    }
+  }
+}
+
+void TopicTrie::prune(uint16_t index) {
+  while (index != kRoot) {
+    Node &node = nodes_[index];
+    if (node.exact != 0 || node.rest != 0 || node.plus != kNone || !node.children.empty()) {
+      return;
+    }
+    const uint16_t parent = node.parent;
+    Node &up = nodes_[parent];
+    if (up.plus == index) {
+      up.plus = kNone;
+    } else {
+      up.children.erase(std::remove(up.children.begin(), up.children.end(), index), up.children.end());
+    }
+    node = Node();
+    free_.push_back(index);
+    index = parent;
+  }
+}
+
+TopicTrie::Mask TopicTrie::match(const char *topic, size_t length) const {
+  Mask mask = 0;
+  if (topic != nullptr && length != 0) {
+    collect(kRoot, topic, length, 0, mask);
+  }
+  return mask;
+}
+
+void TopicTrie::collect(uint16_t index, const char *topic, size_t length, size_t start, Mask &mask) const {
+  const Node &node = nodes_[index];
+  const bool system = index == kRoot && topic[0] == '$';
+  if (!system) {
+    mask |= node.rest;  // "a/#" also matches "a" itself
+  }
+  if (start > length) {
+    mask |= node.exact;
+    return;
+  }
+  size_t end = start;
+  while (end < length && topic[end] != '/') {
+    ++end;
+  }
+  const uint16_t child = findChild(index, topic + start, end - start, TopicRouter::hash(topic + start, end - start));
+  if (child != kNone) {
+    collect(child, topic, length, end + 1, mask);
+  }
+  if (node.plus != kNone && !system) {
+    collect(node.plus, topic, length, end + 1, mask);
+  }
+}
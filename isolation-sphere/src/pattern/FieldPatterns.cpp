@@ -0,0 +1,95 @@
+/**
+ * @file FieldPatterns.cpp
+ * @brief LED毎フィールド評価方式のパターン実装（LCD非依存のためネイティブテスト可）
+ */
+
+#include "pattern/ProceduralPatternGenerator.h"
+#include "led/LEDSphereManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ProceduralPattern {
+
+namespace {
+
+constexpr float kPi = static_cast<float>(M_PI);
+constexpr float kDegToRad = kPi / 180.0f;
+
+float clamp01(float value) {
+    return std::max(0.0f, std::min(value, 1.0f));
+}
+
+CRGB hsvColor(float hue01, float value01) {
+    CRGB color;
+    color.setHSV(static_cast<uint8_t>(clamp01(hue01) * 255.0f), 255,
+                 static_cast<uint8_t>(clamp01(value01) * 255.0f));
+    return color;
+}
+
+} // namespace
+
+// ---- FieldPattern 実装 ----
+
+void FieldPattern::render(const PatternParams& params) {
+    if (!sphereManager_) return;  // LEDSphereManager必須
+
+    const FrameCtx ctx{params.progress, params.time, params.speed, params.brightness};
+    prepareFrame(ctx);
+    sphereManager_->fillByGeometry([&](const LEDSphere::LedGeom& led) { return eval(led, ctx); });
+    sphereManager_->show();
+}
+
+// ---- SpiralTrajectoryPattern 実装 ----
+
+SpiralTrajectoryPattern::SpiralTrajectoryPattern()
+    : speed_(1.0f), brightness_(1.0f), spiralTurns_(3.0f), trailLength_(20) {}
+
+void SpiralTrajectoryPattern::prepareFrame(const FrameCtx& ctx) {
+    headT_ = clamp01(ctx.progress * speed_ * ctx.speed);
+    trailT_ = static_cast<float>(std::max(trailLength_, 1)) / 180.0f;
+    scale_ = clamp01(brightness_ * ctx.brightness);
+}
+
+CRGB SpiralTrajectoryPattern::eval(const LEDSphere::LedGeom& led, const FrameCtx& /*ctx*/) const {
+    // 螺旋上の位置 t は緯度で決まる（南極0 → 北極1）
+    const float t = (led.latitudeDeg + 90.0f) / 180.0f;
+    const float behind = headT_ - t;
+    if (behind < 0.0f || behind > trailT_) {
+        return CRGB(0, 0, 0);
+    }
+
+    // 同緯度での螺旋の経度との差を球面上の距離に換算
+    const float curveLon = spiralTurns_ * 360.0f * t;
+    float diff = fmodf(led.longitudeDeg - curveLon, 360.0f);
+    if (diff > 180.0f) diff -= 360.0f;
+    if (diff < -180.0f) diff += 360.0f;
+    const float distance = fabsf(diff) * cosf(led.latitudeDeg * kDegToRad);
+    if (distance > kHalfWidthDeg) {
+        return CRGB(0, 0, 0);
+    }
+
+    const float value = (1.0f - distance / kHalfWidthDeg) * (1.0f - behind / trailT_) * scale_;
+    return hsvColor(t, value);
+}
+
+// ---- SphericalWavePattern 実装 ----
+
+SphericalWavePattern::SphericalWavePattern() : speed_(1.0f), brightness_(1.0f), waveCount_(3) {}
+
+void SphericalWavePattern::prepareFrame(const FrameCtx& ctx) {
+    phase_ = fmodf(ctx.time * speed_ * ctx.speed, 1.0f) * 2.0f * kPi;
+    scale_ = clamp01(brightness_ * ctx.brightness);
+}
+
+CRGB SphericalWavePattern::eval(const LEDSphere::LedGeom& led, const FrameCtx& /*ctx*/) const {
+    // 北極からの角距離 θ [0, π] に waveCount_ 周期、位相が進むと波面は南へ
+    const float theta = (90.0f - led.latitudeDeg) * kDegToRad;
+    const float wave = 0.5f + 0.5f * cosf(2.0f * static_cast<float>(waveCount_) * theta - phase_);
+    // 2乗で波面を細く（谷を暗く）する
+    const float value = wave * wave * scale_;
+    // シアン → 青 → 紫（極からの距離で色相をずらす）
+    const float hue = (140.0f + 60.0f * theta / kPi) / 255.0f;
+    return hsvColor(hue, value);
+}
+
+} // namespace ProceduralPattern
@@ -0,0 +1,192 @@
+/**
+ * @file PatternGenerator.cpp
+ * @brief パターンレジストリの実装（LCD描画はM5経由、ネイティブテストでは記録のみ）
+ */
+
+#include "pattern/ProceduralPatternGenerator.h"
+#include <algorithm>
+
+namespace ProceduralPattern {
+
+namespace {
+
+// PatternId はこの表の添字
+const char* const kPatternNames[] = {
+    "latitude_rings",
+    "ring_fall_opening",
+    "x_axis_half_green_rings",
+    "longitude_lines",
+    "coordinate_axis",
+    "spiral_trajectory",
+    "spherical_wave"
+};
+
+} // namespace
+
+PatternGenerator::PatternGenerator()
+    : currentPatternName_(""), currentPatternId_(kInvalidPatternId), sphereManager_(nullptr) {
+    static_assert(sizeof(kPatternNames) / sizeof(kPatternNames[0]) == kPatternCount,
+                  "kPatternCount must match kPatternNames");
+    defaultParams_.screenWidth = 128;
+    defaultParams_.screenHeight = 128;
+    defaultParams_.centerX = 64;
+    defaultParams_.centerY = 64;
+    defaultParams_.radius = 60;
+}
+
+PatternId PatternGenerator::findPatternId(const std::string& patternName) {
+    for (size_t i = 0; i < kPatternCount; ++i) {
+        if (patternName == kPatternNames[i]) {
+            return static_cast<PatternId>(i);
+        }
+    }
+    return kInvalidPatternId;
+}
+
+const char* PatternGenerator::patternName(PatternId id) {
+    return id < kPatternCount ? kPatternNames[id] : "";
+}
+
+std::unique_ptr<IPattern> PatternGenerator::instantiate(PatternId id) const {
+#ifdef UNIT_TEST
+    if (factoryForTest_) {
+        return factoryForTest_(id);
+    }
+#endif
+    switch (id) {
+#if !defined(UNIT_TEST)
+        // LCD描画を含むパターンは実機ビルドのみ
+        case 0: return std::unique_ptr<IPattern>(new LatitudeRingPattern());
+        case 1: return std::unique_ptr<IPattern>(new FallingRingOpeningPattern());
+        case 2: return std::unique_ptr<IPattern>(new YAxisRingPattern());
+        case 3: return std::unique_ptr<IPattern>(new LongitudeLinePattern());
+        case 4: return std::unique_ptr<IPattern>(new CoordinateAxisPattern());
+#endif
+        case 5: return std::unique_ptr<IPattern>(new SpiralTrajectoryPattern());
+        case 6: return std::unique_ptr<IPattern>(new SphericalWavePattern());
+        default: return nullptr;
+    }
+}
+
+std::unique_ptr<IPattern> PatternGenerator::createPattern(const std::string& patternName) {
+    auto pattern = instantiate(findPatternId(patternName));
+    if (pattern) {
+        pattern->setSphereManager(sphereManager_);
+    }
+    return pattern;
+}
+
+IPattern* PatternGenerator::getPattern(PatternId id) {
+    if (id >= kPatternCount) {
+        return nullptr;
+    }
+    if (!patterns_[id]) {
+        patterns_[id] = instantiate(id);
+        if (!patterns_[id]) {
+            return nullptr;
+        }
+        patterns_[id]->setSphereManager(sphereManager_);
+    }
+    return patterns_[id].get();
+}
+
+void PatternGenerator::setSphereManager(LEDSphere::LEDSphereManager* manager) {
+    sphereManager_ = manager;
+    for (auto& pattern : patterns_) {
+        if (pattern) {
+            pattern->setSphereManager(manager);
+        }
+    }
+}
+
+void PatternGenerator::clearDisplay() {
+#ifdef UNIT_TEST
+    ++screenClears_;
+#else
+    M5.Display.fillScreen(TFT_BLACK);
+#endif
+}
+
+void PatternGenerator::clearDisplayRect(const DisplayRect& rect) {
+    // 画面内にクリップ
+    const int x0 = std::max(rect.x, 0);
+    const int y0 = std::max(rect.y, 0);
+    const int x1 = std::min(rect.x + rect.w, defaultParams_.screenWidth);
+    const int y1 = std::min(rect.y + rect.h, defaultParams_.screenHeight);
+    if (x1 > x0 && y1 > y0) {
+#ifdef UNIT_TEST
+        DisplayRect clipped;
+        clipped.x = x0;
+        clipped.y = y0;
+        clipped.w = x1 - x0;
+        clipped.h = y1 - y0;
+        rectClears_.push_back(clipped);
+#else
+        M5.Display.fillRect(x0, y0, x1 - x0, y1 - y0, TFT_BLACK);
+#endif
+    }
+}
+
+void PatternGenerator::renderPattern(PatternId id, float progress, float time,
+                                   const PatternParams* customParams) {
+    IPattern* pattern = getPattern(id);
+    if (!pattern) {
+        return;
+    }
+
+    // カスタムパラメータまたはデフォルトパラメータを使用
+    PatternParams params = customParams ? *customParams : defaultParams_;
+    params.progress = progress;
+    params.time = time;
+
+    // 背景クリア: 前フレームで描いた領域のみ。切替時はLCDを使う側がいれば全消去
+    const DisplayRect footprint = pattern->displayFootprint(params);
+    if (id != currentPatternId_) {
+        if (!lastFootprint_.empty() || !footprint.empty()) {
+            clearDisplay();
+        }
+        currentPatternId_ = id;
+        currentPatternName_ = kPatternNames[id];
+    } else if (!lastFootprint_.empty()) {
+        clearDisplayRect(lastFootprint_);
+    }
+    lastFootprint_ = footprint;
+
+    // パターン描画
+    pattern->render(params);
+}
+
+void PatternGenerator::renderPattern(const std::string& patternName, float progress, float time,
+                                   const PatternParams* customParams) {
+    // 同じ名前が続く間は検索を省く
+    const PatternId id = (currentPatternId_ != kInvalidPatternId && patternName == currentPatternName_)
+                             ? currentPatternId_
+                             : findPatternId(patternName);
+    renderPattern(id, progress, time, customParams);
+}
+
+void PatternGenerator::renderPatternAt(PatternId id, float progress,
+                                       const SyncTimebase& timebase, uint32_t localMs,
+                                       const PatternParams* customParams) {
+    renderPattern(id, progress, timebase.animationTimeSec(localMs), customParams);
+}
+
+void PatternGenerator::renderPatternAt(const std::string& patternName, float progress,
+                                       const SyncTimebase& timebase, uint32_t localMs,
+                                       const PatternParams* customParams) {
+    renderPattern(patternName, progress, timebase.animationTimeSec(localMs), customParams);
+}
+
+std::vector<std::string> PatternGenerator::getAvailablePatterns() const {
+    return std::vector<std::string>(kPatternNames, kPatternNames + kPatternCount);
+}
+
+PatternParams PatternGenerator::getDefaultParams() const {
+    return defaultParams_;
+}
+
+void PatternGenerator::setDefaultParams(const PatternParams& params) {
+    defaultParams_ = params;
+}
+
+} // namespace ProceduralPattern
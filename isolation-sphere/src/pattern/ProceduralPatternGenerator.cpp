@@ -2,7 +2,6 @@
 #include "led/LEDSphereManager.h"
 #include <algorithm>
 #include <cmath>
-#include "pattern/TestStripPattern.h"
 
 namespace ProceduralPattern {
 
@@ -490,6 +489,17 @@ void CoordinateAxisPattern::render(const PatternParams& params) {
     }
 }
 
+DisplayRect CoordinateAxisPattern::displayFootprint(const PatternParams& params) const {
+    // 球体枠・グリッド・軸とその端のラベル（右に最大 5px + 1文字）
+    // 画面上下の説明文は毎フレーム同じ位置・同じ内容なので消去不要
+    DisplayRect rect;
+    rect.x = params.centerX - params.radius;
+    rect.y = params.centerY - params.radius;
+    rect.w = 2 * params.radius + 12;
+    rect.h = 2 * params.radius + 1;
+    return rect;
+}
+
 void CoordinateAxisPattern::drawAxis(const char* label, float x, float y, float z, uint16_t color, const PatternParams& params) {
     // 原点から指定座標への線分
     auto points = SphereCoordinateSystem::get3DLine(0.0f, 0.0f, 0.0f, x, y, z, 
@@ -603,82 +613,4 @@ void CoordinateAxisPattern::drawCoordinateLabels(const PatternParams& params) {
     }
 }
 
-// ---- PatternGenerator 実装 ----
-
-PatternGenerator::PatternGenerator() : currentPatternName_("") {
-    defaultParams_.screenWidth = 128;
-    defaultParams_.screenHeight = 128;
-    defaultParams_.centerX = 64;
-    defaultParams_.centerY = 64;
-    defaultParams_.radius = 60;
-}
-
-std::unique_ptr<IPattern> PatternGenerator::createPattern(const std::string& patternName) {
-    if (patternName == "latitude_rings") {
-        return std::unique_ptr<LatitudeRingPattern>(new LatitudeRingPattern());
-    } else if (patternName == "ring_fall_opening") {
-        return std::unique_ptr<FallingRingOpeningPattern>(new FallingRingOpeningPattern());
-    } else if (patternName == "x_axis_half_green_rings") {
-        return std::unique_ptr<YAxisRingPattern>(new YAxisRingPattern());
-    } else if (patternName == "longitude_lines") {
-        return std::unique_ptr<LongitudeLinePattern>(new LongitudeLinePattern());
-    } else if (patternName == "coordinate_axis") {
-        return std::unique_ptr<CoordinateAxisPattern>(new CoordinateAxisPattern());
-    } else if (patternName == "spiral_trajectory") {
-        return std::unique_ptr<SpiralTrajectoryPattern>(new SpiralTrajectoryPattern());
-    } else if (patternName == "spherical_wave") {
-        return std::unique_ptr<SphericalWavePattern>(new SphericalWavePattern());
-    }
-    return nullptr;
-}
-
-void PatternGenerator::renderPattern(const std::string& patternName, float progress, float time,
-                                   const PatternParams* customParams) {
-    auto pattern = createPattern(patternName);
-    if (pattern) {
-        // カスタムパラメータまたはデフォルトパラメータを使用
-        PatternParams params = customParams ? *customParams : defaultParams_;
-        params.progress = progress;
-        params.time = time;
-        
-        // 背景クリア
-        M5.Display.fillScreen(TFT_BLACK);
-        
-        // パターン描画
-        pattern->render(params);
-        currentPatternName_ = patternName;
-    }
-}
-
-std::vector<std::string> PatternGenerator::getAvailablePatterns() const {
-    return {
-        "latitude_rings",
-        "ring_fall_opening",
-        "x_axis_half_green_rings",
-        "longitude_lines", 
-        "coordinate_axis",
-        "spiral_trajectory",
-        "spherical_wave"
-    };
-}
-
-PatternParams PatternGenerator::getDefaultParams() const {
-    return defaultParams_;
-}
-
-void PatternGenerator::setDefaultParams(const PatternParams& params) {
-    defaultParams_ = params;
-}
-
-// 未実装クラスのプレースホルダー
-SpiralTrajectoryPattern::SpiralTrajectoryPattern() : speed_(1.0f), brightness_(1.0f), spiralTurns_(3.0f), trailLength_(20) {}
-void SpiralTrajectoryPattern::render(const PatternParams& params) {
-    // TODO: 実装予定
-}
-
-SphericalWavePattern::SphericalWavePattern() : speed_(1.0f), brightness_(1.0f), waveCount_(3) {}
-void SphericalWavePattern::render(const PatternParams& params) {
-    // TODO: 実装予定
-}
-
 } // namespace ProceduralPattern
@@ -0,0 +1,128 @@
+#include "wifi/ConnectionManager.h"
+
+namespace {
+
+bool isDue(uint32_t nowMs, uint32_t deadlineMs) {
+  return static_cast<int32_t>(nowMs - deadlineMs) >= 0;
+}
+
+}  // namespace
+
+ExponentialBackoff::ExponentialBackoff(uint32_t initialMs, uint32_t maxMs, uint32_t seed)
+    : initialMs_(initialMs == 0 ? 1 : initialMs), maxMs_(maxMs < initialMs ? initialMs : maxMs), rng_(1) {
+  this->seed(seed);
+}
+
+uint32_t ExponentialBackoff::next() {
+  uint32_t delay = initialMs_;
+  for (uint32_t i = 0; i < attempt_ && delay < maxMs_; ++i) {
+    delay = delay > maxMs_ / 2 ? maxMs_ : delay * 2;
+  }
+  ++attempt_;
+  // xorshift32
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 17;
+  rng_ ^= rng_ << 5;
+  const uint32_t half = delay / 2;
+  return delay - half + rng_ % (half + 1);
+}
+
+ConnectionManager::ConnectionManager()
+    : wifi_(kWifiBackoffInitialMs, kWifiBackoffMaxMs), mqtt_(kMqttBackoffInitialMs, kMqttBackoffMaxMs) {}
+
+void ConnectionManager::configure(const Options &options) {
+  options_ = options;
+  wifi_.backoff.seed(options.seed);
+  mqtt_.backoff.seed(options.seed * 2654435761u);
+  wifi_.state = LinkState::kDisabled;
+  mqtt_.state = LinkState::kDisabled;
+}
+
+void ConnectionManager::onWifiEvent(bool up) {
+  if (!up) {
+    wifiObserved_.downs.fetch_add(1, std::memory_order_relaxed);
+  }
+  wifiObserved_.up.store(up, std::memory_order_release);
+}
+
+void ConnectionManager::onMqttEvent(bool up) {
+  if (!up) {
+    mqttObserved_.downs.fetch_add(1, std::memory_order_relaxed);
+  }
+  mqttObserved_.up.store(up, std::memory_order_release);
+}
+
+bool ConnectionManager::step(Link &link, bool enabled, bool mayAttempt, const Observed &observed, uint32_t nowMs,
+                             uint32_t timeoutMs, uint32_t &drops) {
+  const uint32_t downs = observed.downs.load(std::memory_order_relaxed);
+  const bool up = observed.up.load(std::memory_order_acquire);
+  const bool wentDown = downs != link.seenDowns;
+  link.seenDowns = downs;
+
+  if (!enabled) {
+    link.state = LinkState::kDisabled;
+    return false;
+  }
+
+  switch (link.state) {
+    case LinkState::kDisabled:
+      link.state = LinkState::kWaiting;
+      link.backoff.reset();
+      link.deadlineMs = nowMs;
+      // The first attempt is due right away.
+      // fall through
+    case LinkState::kWaiting:
+      if (up && !wentDown) {
+        // Came up without us (driver, another service, or a late event)
+        link.state = LinkState::kUp;
+        link.backoff.reset();
+        return false;
+      }
+      if (mayAttempt && isDue(nowMs, link.deadlineMs)) {
+        link.state = LinkState::kConnecting;
+        link.deadlineMs = nowMs + timeoutMs;
+        return true;
+      }
+      return false;
+    case LinkState::kConnecting:
+      if (up && !wentDown) {
+        link.state = LinkState::kUp;
+        link.backoff.reset();
+      } else if (wentDown || isDue(nowMs, link.deadlineMs)) {
+        link.state = LinkState::kWaiting;
+        link.deadlineMs = nowMs + link.backoff.next();
+      }
+      return false;
+    case LinkState::kUp:
+      if (!up || wentDown) {
+        ++drops;
+        link.state = LinkState::kWaiting;
+        link.deadlineMs = nowMs + link.backoff.next();
+      }
+      return false;
+  }
+  return false;
+}
+
+uint32_t ConnectionManager::retryIn(const Link &link, uint32_t nowMs) {
+  if (link.state != LinkState::kWaiting || isDue(nowMs, link.deadlineMs)) {
+    return 0;
+  }
+  return link.deadlineMs - nowMs;
+}
+
+uint8_t ConnectionManager::poll(uint32_t nowMs) {
+  uint8_t actions = kNone;
+  if (step(wifi_, true, options_.manageWifi, wifiObserved_, nowMs, kWifiAttemptTimeoutMs, stats_.wifiDrops)) {
+    actions |= kStartWifi;
+    ++stats_.wifiAttempts;
+  }
+  // Leaving kUp disables MQTT, so it starts over with a fresh backoff (and
+  // an immediate attempt) once WiFi is back.
+  const bool mqttAllowed = options_.mqttEnabled && wifi_.state == LinkState::kUp;
+  if (step(mqtt_, mqttAllowed, true, mqttObserved_, nowMs, kMqttAttemptTimeoutMs, stats_.mqttDrops)) {
+    actions |= kStartMqtt;
+    ++stats_.mqttAttempts;
+  }
+  return actions;
+}
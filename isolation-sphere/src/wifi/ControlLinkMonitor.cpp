@@ -0,0 +1,84 @@
+#include "wifi/ControlLinkMonitor.h"
+
+void ControlLinkMonitor::reset() {
+  *this = ControlLinkMonitor();
+}
+
+ControlLinkMonitor::Verdict ControlLinkMonitor::onPacket(uint16_t sequence, uint32_t senderTimestampMs,
+                                                         uint32_t nowMs) {
+  if (started_) {
+    const int32_t diff = static_cast<int16_t>(static_cast<uint16_t>(sequence - lastSequence_));
+    if (diff == 0) {
+      ++duplicates_;
+      return Verdict::kDuplicate;
+    }
+    if (diff < 0 && diff > -kResyncDistance) {
+      ++reordered_;
+      if (lost_ > 0) {
+        --lost_;
+      }
+      return Verdict::kStale;
+    }
+    if (diff > 0) {
+      lost_ += static_cast<uint32_t>(diff - 1);
+    } else {
+      ++resyncs_;
+    }
+  }
+
+  started_ = true;
+  lastSequence_ = sequence;
+  lastAcceptMs_ = nowMs;
+  ++accepted_;
+  recordDelay(senderTimestampMs, nowMs);
+  return Verdict::kAccept;
+}
+
+void ControlLinkMonitor::recordDelay(uint32_t senderTimestampMs, uint32_t nowMs) {
+  // Includes the (unknown, roughly constant) clock offset between the peers
+  const int32_t transit = static_cast<int32_t>(nowMs - senderTimestampMs);
+
+  if (windowCount_ == 0 || transit < windowMinTransit_) {
+    windowMinTransit_ = transit;
+  }
+  if (!hasBaseline_ || transit < baselineTransit_) {
+    // Seed or tighten the baseline immediately; widening only happens at
+    // window boundaries so slow clock drift is tracked.
+    baselineTransit_ = transit;
+    hasBaseline_ = true;
+  }
+  const uint32_t excess = static_cast<uint32_t>(transit - baselineTransit_);
+  windowDelaySum_ += excess;
+  if (excess > windowDelayMax_) {
+    windowDelayMax_ = excess;
+  }
+  ++windowCount_;
+  delayAvgMs_ = static_cast<uint32_t>(windowDelaySum_ / windowCount_);
+  delayMaxMs_ = windowDelayMax_;
+
+  if (windowCount_ >= kDelayWindow) {
+    baselineTransit_ = windowMinTransit_;
+    windowCount_ = 0;
+    windowDelaySum_ = 0;
+    windowDelayMax_ = 0;
+  }
+}
+
+ControlLinkMonitor::Stats ControlLinkMonitor::stats() const {
+  Stats s;
+  s.accepted = accepted_;
+  s.duplicates = duplicates_;
+  s.reordered = reordered_;
+  s.lost = lost_;
+  s.resyncs = resyncs_;
+  s.delayAvgMs = delayAvgMs_;
+  s.delayMaxMs = delayMaxMs_;
+  s.lastAcceptMs = lastAcceptMs_;
+  s.lastSequence = lastSequence_;
+  return s;
+}
+
+float ControlLinkMonitor::lossRatio() const {
+  const uint32_t expected = accepted_ + lost_;
+  return expected == 0 ? 0.0f : static_cast<float>(lost_) / static_cast<float>(expected);
+}
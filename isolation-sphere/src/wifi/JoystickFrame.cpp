@@ -0,0 +1,114 @@
+#include "wifi/JoystickFrame.h"
+
+#include <cmath>
+
+namespace joystick {
+
+namespace {
+
+constexpr float kAxisMax = 32767.0f;
+
+void putU16(uint8_t *p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t getU16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint16_t crc16(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= static_cast<uint16_t>(data[i] << 8);
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+// Axis in [-1, 1] with the deadzone removed and the remaining travel rescaled.
+float axis(int16_t raw) {
+  float value = static_cast<float>(raw) / kAxisMax;
+  if (value > 1.0f) value = 1.0f;
+  if (value < -1.0f) value = -1.0f;
+  const float magnitude = std::fabs(value);
+  if (magnitude <= kDeadzone) {
+    return 0.0f;
+  }
+  return std::copysign((magnitude - kDeadzone) / (1.0f - kDeadzone), value);
+}
+
+float wrapLongitude(float degrees) {
+  degrees = std::fmod(degrees + 180.0f, 360.0f);
+  if (degrees < 0.0f) degrees += 360.0f;
+  return degrees - 180.0f;
+}
+
+}  // namespace
+
+size_t encode(const Frame &frame, uint8_t *out, size_t capacity) {
+  if (out == nullptr || capacity < kFrameSize) {
+    return 0;
+  }
+  out[0] = kMagic0;
+  out[1] = kMagic1;
+  out[2] = kVersion;
+  out[3] = frame.buttons;
+  putU16(out + 4, frame.sequence);
+  putU16(out + 6, frame.batteryMv);
+  putU16(out + 8, static_cast<uint16_t>(frame.timestampMs));
+  putU16(out + 10, static_cast<uint16_t>(frame.timestampMs >> 16));
+  putU16(out + 12, static_cast<uint16_t>(frame.leftX));
+  putU16(out + 14, static_cast<uint16_t>(frame.leftY));
+  putU16(out + 16, static_cast<uint16_t>(frame.rightX));
+  putU16(out + 18, static_cast<uint16_t>(frame.rightY));
+  putU16(out + 20, crc16(out, kFrameSize - 2));
+  return kFrameSize;
+}
+
+bool decode(const uint8_t *data, size_t length, Frame &out) {
+  if (!isFrame(data, length) || length < kFrameSize || data[2] != kVersion) {
+    return false;
+  }
+  if (getU16(data + 20) != crc16(data, kFrameSize - 2)) {
+    return false;
+  }
+  out.buttons = data[3];
+  out.sequence = getU16(data + 4);
+  out.batteryMv = getU16(data + 6);
+  out.timestampMs = static_cast<uint32_t>(getU16(data + 8)) | (static_cast<uint32_t>(getU16(data + 10)) << 16);
+  out.leftX = static_cast<int16_t>(getU16(data + 12));
+  out.leftY = static_cast<int16_t>(getU16(data + 14));
+  out.rightX = static_cast<int16_t>(getU16(data + 16));
+  out.rightY = static_cast<int16_t>(getU16(data + 18));
+  return true;
+}
+
+bool apply(const Frame &frame, uint32_t elapsedMs, RemoteControl &control, uint32_t nowMs) {
+  float latitude = control.latitudeOffsetDeg;
+  float longitude = control.longitudeOffsetDeg;
+  if (frame.buttons & kButtonLeftStick) {
+    latitude = 0.0f;
+    longitude = 0.0f;
+  } else {
+    const float step = kRateDegPerSec * static_cast<float>(elapsedMs < kMaxStepMs ? elapsedMs : kMaxStepMs) * 0.001f;
+    latitude += axis(frame.leftY) * step;
+    longitude = wrapLongitude(longitude + axis(frame.leftX) * step);
+    if (latitude > 90.0f) latitude = 90.0f;
+    if (latitude < -90.0f) latitude = -90.0f;
+  }
+  if (latitude == control.latitudeOffsetDeg && longitude == control.longitudeOffsetDeg &&
+      control.has(RemoteControl::kPosture)) {
+    return false;
+  }
+  control.latitudeOffsetDeg = latitude;
+  control.longitudeOffsetDeg = longitude;
+  control.fields |= RemoteControl::kPosture;
+  control.sequence = frame.sequence;
+  control.updatedMs = nowMs;
+  return true;
+}
+
+}  // namespace joystick
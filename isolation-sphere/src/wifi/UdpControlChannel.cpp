@@ -0,0 +1,117 @@
+#include "wifi/UdpControlChannel.h"
+
+#include <Arduino.h>
+
+#include <cstring>
+
+bool UdpControlChannel::begin(uint16_t port, uint16_t joystickPort) {
+  if (joystickPort == port) {
+    joystickPort = 0;
+  }
+  if (listening_ && port == port_ && joystickPort == joystickPort_) {
+    return true;
+  }
+  stop();
+  if (port == 0) {
+    return false;
+  }
+#ifdef ARDUINO
+  if (!udp_.listen(port)) {
+    Serial.printf("[UDP] Failed to listen on port %u\n", static_cast<unsigned>(port));
+    return false;
+  }
+  udp_.onPacket([this](AsyncUDPPacket &packet) {
+    handlePacket(packet.data(), packet.length(), millis());
+  });
+  if (joystickPort != 0) {
+    if (joystickUdp_.listen(joystickPort)) {
+      joystickUdp_.onPacket([this](AsyncUDPPacket &packet) {
+        handlePacket(packet.data(), packet.length(), millis());
+      });
+    } else {
+      Serial.printf("[UDP] Failed to listen for joystick frames on port %u\n", static_cast<unsigned>(joystickPort));
+    }
+  }
+#endif
+  port_ = port;
+  joystickPort_ = joystickPort;
+  listening_ = true;
+  Serial.printf("[UDP] Control channel listening on port %u (joystick %u)\n", static_cast<unsigned>(port),
+                static_cast<unsigned>(joystickPort));
+  return true;
+}
+
+void UdpControlChannel::stop() {
+  if (!listening_) {
+    return;
+  }
+#ifdef ARDUINO
+  udp_.close();
+  joystickUdp_.close();
+#endif
+  listening_ = false;
+}
+
+void UdpControlChannel::handlePacket(const uint8_t *data, size_t length, uint32_t nowMs) {
+  ++counters_.packets;
+  if (joystick::isFrame(data, length)) {
+    handleJoystick(data, length, nowMs);
+  } else {
+    handleControl(data, length, nowMs);
+  }
+  counters_.link = monitor_.stats();
+  counters_.joystick = joystickMonitor_.stats();
+  stats_.write(counters_);
+}
+
+void UdpControlChannel::handleControl(const uint8_t *data, size_t length, uint32_t nowMs) {
+  control::Message message;
+  if (!control::decode(data, length, message) || message.type != control::MessageType::kControl) {
+    ++counters_.malformed;
+    return;
+  }
+  if (monitor_.onPacket(message.sequence, message.timestampMs, nowMs) != ControlLinkMonitor::Verdict::kAccept) {
+    return;
+  }
+
+  if (message.has(control::kFieldCommand)) {
+    const char *name = control::commandName(message.command);
+    if (name != nullptr) {
+      UiCommand record;
+      record.assign(message.command, name, std::strlen(name));
+      sharedState_.pushUiCommand(record, true);
+      ++counters_.commands;
+    }
+  }
+  control_.source = ControlSource::kUdp;
+  if (control::apply(message, control_, nowMs)) {
+    sharedState_.updateRemoteControl(control_);
+  }
+}
+
+void UdpControlChannel::handleJoystick(const uint8_t *data, size_t length, uint32_t nowMs) {
+  joystick::Frame frame;
+  if (!joystick::decode(data, length, frame)) {
+    ++counters_.malformed;
+    return;
+  }
+  if (joystickMonitor_.onPacket(frame.sequence, frame.timestampMs, nowMs) != ControlLinkMonitor::Verdict::kAccept) {
+    return;
+  }
+  // Integrate over the sender's frame interval so network jitter does not
+  // change the steering speed.
+  const uint32_t elapsedMs = hasJoystickTime_ ? frame.timestampMs - lastJoystickMs_ : 0;
+  hasJoystickTime_ = true;
+  lastJoystickMs_ = frame.timestampMs;
+
+  control_.source = ControlSource::kUdp;
+  if (joystick::apply(frame, elapsedMs, control_, nowMs)) {
+    sharedState_.updateRemoteControl(control_);
+  }
+}
+
+UdpControlChannel::Stats UdpControlChannel::stats() const {
+  Stats s;
+  stats_.read(s);
+  return s;
+}
@@ -0,0 +1,132 @@
+#include <unity.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "core/CommandQueue.h"
+
+namespace {
+
+constexpr size_t kDepth = 16;
+
+UiCommand makeRecord(const char *text) {
+  UiCommand record;
+  makeUiCommand(text, std::strlen(text), record);
+  return record;
+}
+
+}  // namespace
+
+void test_ui_command_parses_known_commands() {
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kNextContent),
+                          static_cast<uint8_t>(makeRecord("ui:x_pos").type));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kPlayPause),
+                          static_cast<uint8_t>(makeRecord("ui:x_neg").type));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kModeOn),
+                          static_cast<uint8_t>(makeRecord("ui:mode:on").type));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kModeOff),
+                          static_cast<uint8_t>(makeRecord("ui:mode:off").type));
+
+  // 前方一致では判定しない
+  UiCommand raw = makeRecord("ui:mode:onx");
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kRaw), static_cast<uint8_t>(raw.type));
+  TEST_ASSERT_EQUAL_STRING("ui:mode:onx", raw.text());
+  TEST_ASSERT_EQUAL_UINT8(11, raw.length);
+}
+
+void test_command_record_rejects_oversize_text() {
+  std::string text(UiCommand::kArgCapacity, 'a');
+  UiCommand record;
+  TEST_ASSERT_TRUE(makeUiCommand(text.c_str(), text.size(), record));
+  TEST_ASSERT_EQUAL_UINT8(UiCommand::kArgCapacity, record.length);
+
+  // 収まらない場合は既存内容を変えない
+  text.push_back('b');
+  TEST_ASSERT_FALSE(makeUiCommand(text.c_str(), text.size(), record));
+  TEST_ASSERT_EQUAL_UINT8(UiCommand::kArgCapacity, record.length);
+
+  SystemCommand sys;
+  const std::string payload = "{\"cmd\":\"reboot\"}";
+  TEST_ASSERT_TRUE(sys.assign(SystemCommandType::kEmergency, payload.data(), payload.size()));
+  TEST_ASSERT_EQUAL_STRING(payload.c_str(), sys.text());
+}
+
+void test_ring_queue_delivers_burst_up_to_depth_without_loss() {
+  RingQueue<UiCommand, kDepth> queue;
+  char text[16];
+  for (size_t i = 0; i < kDepth; ++i) {
+    std::snprintf(text, sizeof(text), "cmd:%u", static_cast<unsigned>(i));
+    TEST_ASSERT_TRUE(queue.push(makeRecord(text)));
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, queue.overflowCount());
+  TEST_ASSERT_EQUAL(kDepth, queue.size());
+
+  UiCommand out;
+  for (size_t i = 0; i < kDepth; ++i) {
+    std::snprintf(text, sizeof(text), "cmd:%u", static_cast<unsigned>(i));
+    TEST_ASSERT_TRUE(queue.pop(out));
+    TEST_ASSERT_EQUAL_STRING(text, out.text());
+  }
+  TEST_ASSERT_FALSE(queue.pop(out));
+  TEST_ASSERT_EQUAL(kDepth, queue.highWater());
+}
+
+void test_ring_queue_counts_overflow_and_keeps_oldest() {
+  RingQueue<UiCommand, 4> queue;
+  const char *commands[] = {"a", "b", "c", "d", "e", "f"};
+  for (const char *command : commands) {
+    queue.push(makeRecord(command));
+  }
+  TEST_ASSERT_EQUAL_UINT32(2, queue.overflowCount());
+
+  // 溢れた分（e, f）だけが失われ、先着順は保たれる
+  UiCommand out;
+  std::string order;
+  while (queue.pop(out)) {
+    order += out.text();
+  }
+  TEST_ASSERT_EQUAL_STRING("abcd", order.c_str());
+}
+
+void test_ring_queue_wraps_around() {
+  RingQueue<UiCommand, 3> queue;
+  UiCommand out;
+  std::string order;
+  // push 2 / pop 1 を繰り返し、先頭位置が何周も回る状態を作る
+  char text[16];
+  int next = 0;
+  for (int round = 0; round < 10; ++round) {
+    std::snprintf(text, sizeof(text), "%d", next++);
+    queue.push(makeRecord(text));
+    if (queue.size() < queue.capacity()) {
+      std::snprintf(text, sizeof(text), "%d", next++);
+      queue.push(makeRecord(text));
+    }
+    TEST_ASSERT_TRUE(queue.pop(out));
+    order += out.text();
+    order += ',';
+  }
+  while (queue.pop(out)) {
+    order += out.text();
+    order += ',';
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, queue.overflowCount());
+  std::string expected;
+  for (int i = 0; i < next; ++i) {
+    expected += std::to_string(i) + ",";
+  }
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), order.c_str());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_ui_command_parses_known_commands);
+  RUN_TEST(test_command_record_rejects_oversize_text);
+  RUN_TEST(test_ring_queue_delivers_burst_up_to_depth_without_loss);
+  RUN_TEST(test_ring_queue_counts_overflow_and_keeps_oldest);
+  RUN_TEST(test_ring_queue_wraps_around);
+  return UNITY_END();
+}
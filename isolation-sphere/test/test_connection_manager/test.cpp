@@ -0,0 +1,218 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "wifi/ConnectionManager.h"
+#include "../../src/wifi/ConnectionManager.cpp"
+
+namespace {
+
+using Link = ConnectionManager::LinkState;
+
+ConnectionManager::Options managedOptions(uint32_t seed = 1) {
+  ConnectionManager::Options options;
+  options.manageWifi = true;
+  options.mqttEnabled = true;
+  options.seed = seed;
+  return options;
+}
+
+// 10ms周期でpollし、指定アクションが出た時刻を返す（出なければ0）
+uint32_t pollUntil(ConnectionManager &manager, uint32_t &now, uint32_t untilMs, uint8_t action) {
+  for (; now < untilMs; now += 10) {
+    if (manager.poll(now) & action) {
+      return now;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+// 遅延は [d/2, d]、dは倍々で上限まで、resetで初期値に戻る
+void test_backoff_doubles_with_jitter_and_caps() {
+  ExponentialBackoff backoff(1000, 30000, 7);
+  const uint32_t expected[] = {1000, 2000, 4000, 8000, 16000, 30000, 30000};
+  for (uint32_t d : expected) {
+    const uint32_t delay = backoff.next();
+    TEST_ASSERT_TRUE(delay >= d / 2);
+    TEST_ASSERT_TRUE(delay <= d);
+  }
+  backoff.reset();
+  TEST_ASSERT_TRUE(backoff.next() <= 1000);
+}
+
+// WiFi接続 → MQTT接続の順に1回ずつ試行し、接続中は何もしない
+void test_connects_wifi_then_mqtt_once() {
+  ConnectionManager manager;
+  manager.configure(managedOptions());
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kStartWifi, manager.poll(now));
+  TEST_ASSERT_TRUE(manager.wifiState() == Link::kConnecting);
+  TEST_ASSERT_TRUE(manager.mqttState() == Link::kDisabled);
+  // 接続待ちの間は再試行しない
+  for (now = 10; now < 3000; now += 10) {
+    TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kNone, manager.poll(now));
+  }
+
+  manager.onWifiEvent(true);
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kStartMqtt, manager.poll(now));
+  TEST_ASSERT_TRUE(manager.wifiUp());
+  manager.onMqttEvent(true);
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kNone, manager.poll(now + 10));
+  TEST_ASSERT_TRUE(manager.mqttUp());
+  TEST_ASSERT_EQUAL_UINT32(1, manager.stats().wifiAttempts);
+  TEST_ASSERT_EQUAL_UINT32(1, manager.stats().mqttAttempts);
+}
+
+// AP停止中: 失敗毎にバックオフし、1分間の試行回数は一桁に収まる
+void test_wifi_outage_backs_off() {
+  ConnectionManager manager;
+  manager.configure(managedOptions());
+  uint32_t now = 0;
+  manager.poll(now);
+  manager.onWifiEvent(true);
+  manager.poll(now += 10);
+  TEST_ASSERT_TRUE(manager.wifiUp());
+  const uint32_t mqttAttempts = manager.stats().mqttAttempts;
+
+  // APが再起動: 切断イベント、以後の試行はすべて失敗（切断イベント）
+  manager.onWifiEvent(false);
+  std::vector<uint32_t> attempts;
+  for (now += 10; now < 60000; now += 10) {
+    if (manager.poll(now) & ConnectionManager::kStartWifi) {
+      attempts.push_back(now);
+      manager.onWifiEvent(false);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, manager.stats().wifiDrops);
+  TEST_ASSERT_TRUE(attempts.size() >= 4);
+  TEST_ASSERT_TRUE(attempts.size() <= 8);
+  for (size_t i = 2; i < attempts.size(); ++i) {
+    // 間隔は（ジッタを除き）単調に伸びる
+    TEST_ASSERT_TRUE(attempts[i] - attempts[i - 1] >= (attempts[i - 1] - attempts[i - 2]) / 2);
+  }
+  TEST_ASSERT_TRUE(manager.mqttState() == Link::kDisabled);
+  TEST_ASSERT_EQUAL_UINT32(mqttAttempts, manager.stats().mqttAttempts);
+}
+
+// 応答の無い試行はタイムアウトで失敗扱い
+void test_attempt_timeout_schedules_retry() {
+  ConnectionManager manager;
+  manager.configure(managedOptions());
+  uint32_t now = 0;
+  manager.poll(now);
+  now = ConnectionManager::kWifiAttemptTimeoutMs - 10;
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kNone, manager.poll(now));
+  now = ConnectionManager::kWifiAttemptTimeoutMs;
+  manager.poll(now);
+  TEST_ASSERT_TRUE(manager.wifiState() == Link::kWaiting);
+  const uint32_t retryIn = manager.wifiRetryInMs(now);
+  TEST_ASSERT_TRUE(retryIn >= ConnectionManager::kWifiBackoffInitialMs / 2);
+  TEST_ASSERT_TRUE(retryIn <= ConnectionManager::kWifiBackoffInitialMs);
+  TEST_ASSERT_EQUAL_UINT32(now + retryIn, pollUntil(manager, now, now + 5000, ConnectionManager::kStartWifi));
+}
+
+// WiFi復帰時はMQTTを即座に（新しいバックオフで）再接続する
+void test_mqtt_restarts_fresh_after_wifi_returns() {
+  ConnectionManager manager;
+  manager.configure(managedOptions());
+  uint32_t now = 0;
+  manager.poll(now);
+  manager.onWifiEvent(true);
+  manager.poll(now += 10);
+  // ブローカー不在でMQTTが何度か失敗しバックオフが伸びる
+  for (int i = 0; i < 4; ++i) {
+    manager.onMqttEvent(false);
+    TEST_ASSERT_TRUE(pollUntil(manager, now, now + 60000, ConnectionManager::kStartMqtt) != 0);
+  }
+  manager.onWifiEvent(false);
+  manager.onMqttEvent(false);
+  manager.poll(now += 10);
+  TEST_ASSERT_TRUE(manager.mqttState() == Link::kDisabled);
+
+  const uint32_t wifiAttempt = pollUntil(manager, now, now + 5000, ConnectionManager::kStartWifi);
+  TEST_ASSERT_TRUE(wifiAttempt != 0);
+  manager.onWifiEvent(true);
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kStartMqtt, manager.poll(now += 10));
+}
+
+// 切断→再接続がpollの間に起きても取りこぼさない
+void test_bounce_between_polls_is_seen() {
+  ConnectionManager manager;
+  manager.configure(managedOptions());
+  uint32_t now = 0;
+  manager.poll(now);
+  manager.onWifiEvent(true);
+  manager.poll(now += 10);
+  manager.onMqttEvent(true);
+  manager.poll(now += 10);
+  TEST_ASSERT_TRUE(manager.mqttUp());
+
+  manager.onMqttEvent(false);
+  manager.onMqttEvent(true);
+  manager.poll(now += 10);
+  TEST_ASSERT_EQUAL_UINT32(1, manager.stats().mqttDrops);
+  // セッションは張り直されているので、次のpollで再びUp扱い
+  manager.poll(now += 10);
+  TEST_ASSERT_TRUE(manager.mqttUp());
+}
+
+// WiFiを管理しない設定: 試行はせず、外部で上がったリンクを検知してMQTTだけ張る
+void test_unmanaged_wifi_only_gates_mqtt() {
+  ConnectionManager manager;
+  ConnectionManager::Options options;
+  options.mqttEnabled = true;
+  manager.configure(options);
+  uint32_t now = 0;
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kNone, manager.poll(now));
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kNone, manager.poll(now += 60000));
+  manager.onWifiEvent(true);
+  TEST_ASSERT_EQUAL_UINT8(ConnectionManager::kStartMqtt, manager.poll(now += 10));
+  TEST_ASSERT_EQUAL_UINT32(0, manager.stats().wifiAttempts);
+}
+
+// 8台が同時にAP再起動を検知しても、再接続時刻はばらける
+void test_fleet_reconnects_are_spread() {
+  constexpr int kSpheres = 8;
+  ConnectionManager managers[kSpheres];
+  uint32_t firstRetry[kSpheres] = {};
+  uint32_t secondRetry[kSpheres] = {};
+  for (int i = 0; i < kSpheres; ++i) {
+    managers[i].configure(managedOptions(0x9E3779B9u * (i + 1)));
+    managers[i].poll(0);
+    managers[i].onWifiEvent(true);
+    managers[i].poll(10);
+    managers[i].onWifiEvent(false);
+    uint32_t now = 20;
+    firstRetry[i] = pollUntil(managers[i], now, 60000, ConnectionManager::kStartWifi);
+    managers[i].onWifiEvent(false);
+    now += 10;
+    secondRetry[i] = pollUntil(managers[i], now, 60000, ConnectionManager::kStartWifi);
+  }
+  uint32_t minRetry = secondRetry[0];
+  uint32_t maxRetry = secondRetry[0];
+  for (int i = 0; i < kSpheres; ++i) {
+    TEST_ASSERT_TRUE(firstRetry[i] != 0);
+    minRetry = secondRetry[i] < minRetry ? secondRetry[i] : minRetry;
+    maxRetry = secondRetry[i] > maxRetry ? secondRetry[i] : maxRetry;
+  }
+  // 2回目の遅延は [1000, 2000]ms: 少なくとも数百msに散らばる
+  TEST_ASSERT_TRUE(maxRetry - minRetry >= 300);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_backoff_doubles_with_jitter_and_caps);
+  RUN_TEST(test_connects_wifi_then_mqtt_once);
+  RUN_TEST(test_wifi_outage_backs_off);
+  RUN_TEST(test_attempt_timeout_schedules_retry);
+  RUN_TEST(test_mqtt_restarts_fresh_after_wifi_returns);
+  RUN_TEST(test_bounce_between_polls_is_seen);
+  RUN_TEST(test_unmanaged_wifi_only_gates_mqtt);
+  RUN_TEST(test_fleet_reconnects_are_spread);
+  return UNITY_END();
+}
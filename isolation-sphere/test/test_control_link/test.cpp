@@ -0,0 +1,79 @@
+#include <unity.h>
+
+#include <cstdint>
+
+#include "wifi/ControlLinkMonitor.h"
+#include "../../src/wifi/ControlLinkMonitor.cpp"
+
+namespace {
+using Verdict = ControlLinkMonitor::Verdict;
+}
+
+void test_link_counts_gaps_as_lost() {
+  ControlLinkMonitor monitor;
+  TEST_ASSERT_TRUE(monitor.onPacket(10, 0, 100) == Verdict::kAccept);
+  TEST_ASSERT_TRUE(monitor.onPacket(11, 33, 133) == Verdict::kAccept);
+  TEST_ASSERT_TRUE(monitor.onPacket(14, 132, 232) == Verdict::kAccept);
+
+  ControlLinkMonitor::Stats stats = monitor.stats();
+  TEST_ASSERT_EQUAL_UINT32(3, stats.accepted);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.lost);
+  TEST_ASSERT_EQUAL_UINT16(14, stats.lastSequence);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.4f, monitor.lossRatio());
+}
+
+void test_link_drops_duplicates_and_reordered_packets() {
+  ControlLinkMonitor monitor;
+  monitor.onPacket(100, 0, 0);
+  monitor.onPacket(102, 0, 0);
+  TEST_ASSERT_TRUE(monitor.onPacket(102, 0, 0) == Verdict::kDuplicate);
+  // 遅れて届いた101は姿勢を巻き戻さないよう破棄し、欠落から並び替えへ振り替える
+  TEST_ASSERT_TRUE(monitor.onPacket(101, 0, 0) == Verdict::kStale);
+
+  ControlLinkMonitor::Stats stats = monitor.stats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.duplicates);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.reordered);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.lost);
+  TEST_ASSERT_EQUAL_UINT16(102, stats.lastSequence);
+}
+
+void test_link_handles_sequence_wrap_and_sender_restart() {
+  ControlLinkMonitor monitor;
+  monitor.onPacket(65534, 0, 0);
+  TEST_ASSERT_TRUE(monitor.onPacket(65535, 0, 0) == Verdict::kAccept);
+  TEST_ASSERT_TRUE(monitor.onPacket(0, 0, 0) == Verdict::kAccept);
+  TEST_ASSERT_TRUE(monitor.onPacket(1, 0, 0) == Verdict::kAccept);
+  TEST_ASSERT_EQUAL_UINT32(0, monitor.stats().lost);
+
+  // 大きく巻き戻った番号は送信側の再起動とみなして受理
+  monitor.onPacket(30000, 0, 0);
+  TEST_ASSERT_TRUE(monitor.onPacket(5, 0, 0) == Verdict::kAccept);
+  TEST_ASSERT_EQUAL_UINT32(1, monitor.stats().resyncs);
+}
+
+void test_link_reports_delay_above_best_transit() {
+  ControlLinkMonitor monitor;
+  // 送信側時計は受信側より1000ms進んでいる（オフセットは結果に影響しない）
+  const uint32_t offset = 1000;
+  const uint32_t delays[] = {5, 5, 25, 5, 45};
+  uint32_t send = 50000;
+  uint16_t seq = 0;
+  for (uint32_t d : delays) {
+    monitor.onPacket(seq++, send + offset, send + d);
+    send += 33;
+  }
+  ControlLinkMonitor::Stats stats = monitor.stats();
+  TEST_ASSERT_EQUAL_UINT32(40, stats.delayMaxMs);
+  TEST_ASSERT_EQUAL_UINT32(12, stats.delayAvgMs);  // (0+0+20+0+40)/5
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_link_counts_gaps_as_lost);
+  RUN_TEST(test_link_drops_duplicates_and_reordered_packets);
+  RUN_TEST(test_link_handles_sequence_wrap_and_sender_restart);
+  RUN_TEST(test_link_reports_delay_above_best_transit);
+  return UNITY_END();
+}
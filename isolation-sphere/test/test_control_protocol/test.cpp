@@ -0,0 +1,185 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "mqtt/ControlProtocol.h"
+#include "wifi/JoystickFrame.h"
+#include "../../src/mqtt/ControlProtocol.cpp"
+#include "../../src/wifi/JoystickFrame.cpp"
+
+void test_control_message_round_trip() {
+  control::Message message;
+  message.type = control::MessageType::kControl;
+  message.sequence = 0xBEEF;
+  message.fields = control::kFieldCommand | control::kFieldPosture | control::kFieldBrightness |
+                   control::kFieldPattern;
+  message.command = UiCommandType::kModeOn;
+  message.latitudeOffsetDeg = -12.34f;
+  message.longitudeOffsetDeg = 179.99f;
+  message.brightness = 200;
+  message.patternId = 7;
+  message.timestampMs = 0x12345678;
+
+  uint8_t frame[control::kMessageSize];
+  TEST_ASSERT_EQUAL(control::kMessageSize, control::encode(message, frame, sizeof(frame)));
+  TEST_ASSERT_EQUAL_UINT8('S', frame[0]);
+  TEST_ASSERT_EQUAL_UINT8('C', frame[1]);
+  TEST_ASSERT_EQUAL_UINT8(control::kVersion, frame[2]);
+  // リトルエンディアン固定
+  TEST_ASSERT_EQUAL_UINT8(0xEF, frame[4]);
+  TEST_ASSERT_EQUAL_UINT8(0xBE, frame[5]);
+
+  control::Message decoded;
+  TEST_ASSERT_TRUE(control::decode(frame, sizeof(frame), decoded));
+  TEST_ASSERT_EQUAL_UINT16(0xBEEF, decoded.sequence);
+  TEST_ASSERT_EQUAL_UINT8(message.fields, decoded.fields);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kModeOn), static_cast<uint8_t>(decoded.command));
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, -12.34f, decoded.latitudeOffsetDeg);
+  TEST_ASSERT_FLOAT_WITHIN(0.005f, 179.99f, decoded.longitudeOffsetDeg);
+  TEST_ASSERT_EQUAL_UINT8(200, decoded.brightness);
+  TEST_ASSERT_EQUAL_UINT8(7, decoded.patternId);
+  TEST_ASSERT_EQUAL_UINT32(0x12345678, decoded.timestampMs);
+  TEST_ASSERT_TRUE(decoded.has(control::kFieldPosture));
+}
+
+void test_control_decode_rejects_malformed_frames() {
+  control::Message message;
+  uint8_t frame[control::kMessageSize + 4] = {};
+  TEST_ASSERT_EQUAL(0, control::encode(message, frame, control::kMessageSize - 1));
+  control::encode(message, frame, sizeof(frame));
+
+  control::Message decoded;
+  TEST_ASSERT_FALSE(control::decode(frame, control::kMessageSize - 1, decoded));
+  // 末尾の拡張バイトは無視して受理する
+  TEST_ASSERT_TRUE(control::decode(frame, sizeof(frame), decoded));
+
+  frame[2] = control::kVersion + 1;
+  TEST_ASSERT_FALSE(control::decode(frame, control::kMessageSize, decoded));
+  frame[2] = control::kVersion;
+  frame[0] = '{';
+  TEST_ASSERT_FALSE(control::decode(frame, control::kMessageSize, decoded));
+}
+
+void test_control_offsets_saturate_and_unknown_command_is_raw() {
+  control::Message message;
+  message.latitudeOffsetDeg = 1000.0f;
+  message.longitudeOffsetDeg = -1000.0f;
+  uint8_t frame[control::kMessageSize];
+  control::encode(message, frame, sizeof(frame));
+  frame[7] = 0xFF;
+
+  control::Message decoded;
+  TEST_ASSERT_TRUE(control::decode(frame, sizeof(frame), decoded));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 327.67f, decoded.latitudeOffsetDeg);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, -327.68f, decoded.longitudeOffsetDeg);
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(UiCommandType::kRaw), static_cast<uint8_t>(decoded.command));
+
+  TEST_ASSERT_EQUAL_STRING("ui:x_neg", control::commandName(UiCommandType::kPlayPause));
+  TEST_ASSERT_NULL(control::commandName(UiCommandType::kRaw));
+}
+
+// 値フィールドだけがRemoteControlへ反映され、コマンドのみのメッセージは変化なし
+void test_control_apply_merges_value_fields() {
+  RemoteControl remote;
+  control::Message message;
+  message.fields = control::kFieldCommand;
+  TEST_ASSERT_FALSE(control::apply(message, remote, 100));
+
+  message.fields = control::kFieldBrightness;
+  message.brightness = 80;
+  message.sequence = 5;
+  TEST_ASSERT_TRUE(control::apply(message, remote, 200));
+  message.fields = control::kFieldPosture;
+  message.latitudeOffsetDeg = 10.0f;
+  message.longitudeOffsetDeg = -20.0f;
+  message.brightness = 0;
+  TEST_ASSERT_TRUE(control::apply(message, remote, 300));
+  TEST_ASSERT_EQUAL_UINT8(80, remote.brightness);
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, remote.latitudeOffsetDeg);
+  TEST_ASSERT_TRUE(remote.has(RemoteControl::kPosture));
+  TEST_ASSERT_TRUE(remote.has(RemoteControl::kBrightness));
+  TEST_ASSERT_FALSE(remote.has(RemoteControl::kPattern));
+  TEST_ASSERT_EQUAL_UINT32(300, remote.updatedMs);
+}
+
+// Atomジョイスティックのフレーム（joystick_frame.hと同一形式）
+void test_joystick_frame_round_trip_and_crc() {
+  joystick::Frame frame;
+  frame.sequence = 0x1234;
+  frame.buttons = joystick::kButtonA;
+  frame.batteryMv = 4100;
+  frame.timestampMs = 0xA0B0C0D0;
+  frame.leftX = -32767;
+  frame.leftY = 12345;
+  frame.rightY = 1;
+  uint8_t data[joystick::kFrameSize + 2] = {};
+  TEST_ASSERT_EQUAL(joystick::kFrameSize, joystick::encode(frame, data, sizeof(data)));
+  TEST_ASSERT_TRUE(joystick::isFrame(data, sizeof(data)));
+  // CRC-16/CCITT-FALSE, little endian at offset 20
+  TEST_ASSERT_EQUAL_UINT8('J', data[0]);
+  TEST_ASSERT_EQUAL_UINT8(0xD0, data[8]);
+
+  joystick::Frame decoded;
+  TEST_ASSERT_TRUE(joystick::decode(data, sizeof(data), decoded));
+  TEST_ASSERT_EQUAL_UINT16(0x1234, decoded.sequence);
+  TEST_ASSERT_EQUAL_UINT32(0xA0B0C0D0, decoded.timestampMs);
+  TEST_ASSERT_EQUAL_INT16(-32767, decoded.leftX);
+  TEST_ASSERT_EQUAL_INT16(12345, decoded.leftY);
+
+  data[13] ^= 0x01;
+  TEST_ASSERT_FALSE(joystick::decode(data, sizeof(data), decoded));
+  data[13] ^= 0x01;
+  TEST_ASSERT_FALSE(joystick::decode(data, joystick::kFrameSize - 1, decoded));
+  data[2] = 2;
+  TEST_ASSERT_FALSE(joystick::decode(data, sizeof(data), decoded));
+
+  // 制御レコードとはマジックで区別する
+  uint8_t record[control::kMessageSize];
+  control::encode(control::Message(), record, sizeof(record));
+  TEST_ASSERT_FALSE(joystick::isFrame(record, sizeof(record)));
+}
+
+// 左スティックで姿勢オフセットを速度制御、押し込みで原点へ
+void test_joystick_steers_posture_offsets() {
+  RemoteControl remote;
+  joystick::Frame frame;
+  // 中立でも初回は姿勢フィールドを確定させる
+  TEST_ASSERT_TRUE(joystick::apply(frame, 0, remote, 10));
+  TEST_ASSERT_TRUE(remote.has(RemoteControl::kPosture));
+  frame.leftX = 1000;  // デッドゾーン内
+  TEST_ASSERT_FALSE(joystick::apply(frame, 33, remote, 43));
+
+  frame.leftX = 32767;
+  frame.leftY = -32767;
+  for (int i = 0; i < 30; ++i) {
+    TEST_ASSERT_TRUE(joystick::apply(frame, 100, remote, 100 + i * 100));
+  }
+  // 3秒 × 90°/s: 緯度は-90°で飽和、経度は270° → -90° に折り返す
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -90.0f, remote.latitudeOffsetDeg);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, -90.0f, remote.longitudeOffsetDeg);
+
+  // 送信間隔の飛び（パケット欠落後）は1ステップ分に制限
+  remote.longitudeOffsetDeg = 0.0f;
+  frame.leftY = 0;
+  joystick::apply(frame, 5000, remote, 4000);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 9.0f, remote.longitudeOffsetDeg);
+
+  frame.buttons = joystick::kButtonLeftStick;
+  TEST_ASSERT_TRUE(joystick::apply(frame, 33, remote, 4100));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, remote.latitudeOffsetDeg);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, remote.longitudeOffsetDeg);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_control_message_round_trip);
+  RUN_TEST(test_control_decode_rejects_malformed_frames);
+  RUN_TEST(test_control_offsets_saturate_and_unknown_command_is_raw);
+  RUN_TEST(test_control_apply_merges_value_fields);
+  RUN_TEST(test_joystick_frame_round_trip_and_crc);
+  RUN_TEST(test_joystick_steers_posture_offsets);
+  return UNITY_END();
+}
@@ -292,6 +292,66 @@ void test_core1_task_skips_buzzer_when_disabled() {
   TEST_ASSERT_FALSE(startupCalled);
 }
 
+void test_shared_state_config_snapshot_tracks_generation() {
+  SharedState shared;
+  SharedState::ConfigSnapshot snapshot;
+  TEST_ASSERT_EQUAL_UINT32(0, shared.configGeneration());
+  TEST_ASSERT_FALSE(shared.getConfigSnapshot(snapshot));
+
+  ConfigManager::Config cfg;
+  cfg.system.name = "sphere-gen";
+  shared.updateConfig(cfg);
+  std::uint32_t generation = 0;
+  TEST_ASSERT_TRUE(shared.getConfigSnapshot(snapshot, &generation));
+  TEST_ASSERT_EQUAL_UINT32(1, generation);
+  TEST_ASSERT_EQUAL_STRING("sphere-gen", snapshot->system.name.c_str());
+
+  // 取得済みスナップショットは更新後も不変で、再取得は同一オブジェクトを共有する
+  SharedState::ConfigSnapshot again;
+  TEST_ASSERT_TRUE(shared.getConfigSnapshot(again));
+  TEST_ASSERT_TRUE(again.get() == snapshot.get());
+
+  cfg.system.name = "sphere-gen2";
+  shared.updateConfig(cfg);
+  TEST_ASSERT_EQUAL_UINT32(2, shared.configGeneration());
+  TEST_ASSERT_EQUAL_STRING("sphere-gen", snapshot->system.name.c_str());
+  TEST_ASSERT_TRUE(shared.getConfigSnapshot(again));
+  TEST_ASSERT_EQUAL_STRING("sphere-gen2", again->system.name.c_str());
+}
+
+void test_core1_task_applies_config_only_when_generation_changes() {
+  SharedState shared;
+  ConfigManager::Config cfg;
+  cfg.system.name = "sphere-reload";
+  cfg.buzzer.enabled = false;
+  shared.updateConfig(cfg);
+
+  CoreTask::TaskConfig config;
+  config.name = "Core1";
+  config.loopIntervalMs = 0;
+  Core1Task task(config, shared);
+
+  int initCalls = 0;
+  BuzzerService::Hooks hooks;
+  hooks.init = [&](gpio_num_t) {
+    initCalls++;
+    return buzzer::Result::kOk;
+  };
+  hooks.playEffect = [](buzzer::Effect) { return buzzer::Result::kOk; };
+  hooks.stop = []() { return buzzer::Result::kOk; };
+  task.setBuzzerHooksForTest(hooks);
+
+  task.runOnceForTest();
+  task.runOnceForTest();
+  TEST_ASSERT_EQUAL(0, initCalls);
+
+  cfg.buzzer.enabled = true;
+  shared.updateConfig(cfg);
+  task.runOnceForTest();
+  task.runOnceForTest();
+  TEST_ASSERT_EQUAL(1, initCalls);
+}
+
 void setUp() {}
 void tearDown() {}
 
@@ -305,6 +365,8 @@ int runUnityTests() {
   RUN_TEST(test_core1_task_initializes_and_reads_imu_when_enabled);
   RUN_TEST(test_core1_task_initializes_buzzer_when_enabled);
   RUN_TEST(test_core1_task_skips_buzzer_when_disabled);
+  RUN_TEST(test_shared_state_config_snapshot_tracks_generation);
+  RUN_TEST(test_core1_task_applies_config_only_when_generation_changes);
   return UNITY_END();
 }
 
@@ -0,0 +1,190 @@
+#include <unity.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "led/LEDSphereManager.h"
+#include "pattern/ProceduralPatternGenerator.h"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/pattern/FieldPatterns.cpp"
+
+using LEDSphere::LEDPosition;
+using LEDSphere::LEDSphereManager;
+using LEDSphere::LedGeom;
+using ProceduralPattern::FieldPattern;
+using ProceduralPattern::FrameCtx;
+using ProceduralPattern::PatternParams;
+
+namespace {
+
+// 800LEDをフィボナッチ球面に配置した合成レイアウト
+std::vector<LEDPosition> makeFibonacciLayout(size_t count) {
+  std::vector<LEDPosition> positions;
+  positions.reserve(count);
+  const float golden = static_cast<float>(M_PI) * (3.0f - std::sqrt(5.0f));
+  for (size_t i = 0; i < count; ++i) {
+    float y = 1.0f - (2.0f * (static_cast<float>(i) + 0.5f)) / static_cast<float>(count);
+    float r = std::sqrt(1.0f - y * y);
+    float theta = golden * static_cast<float>(i);
+    positions.emplace_back(static_cast<uint16_t>(i), static_cast<uint8_t>(i / 200), static_cast<uint8_t>(i % 200),
+                           r * std::cos(theta), y, r * std::sin(theta));
+  }
+  return positions;
+}
+
+void initializeSphere(LEDSphereManager &manager, size_t layoutCount) {
+  std::vector<uint16_t> lengths{200, 200, 200, 200};
+  std::vector<uint8_t> pins{5, 6, 7, 8};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(static_cast<uint8_t>(lengths.size()), lengths, pins));
+  manager.setLayoutForTest(makeFibonacciLayout(layoutCount));
+  manager.resetOperationLogForTest();
+}
+
+bool isLit(const CRGB &color) {
+  return (color.r | color.g | color.b) != 0;
+}
+
+uint16_t valueOf(const CRGB &color) {
+  return std::max(color.r, std::max(color.g, color.b));
+}
+
+// 評価回数を数えるだけのフィールド（faceIDの偶奇で白/黒）
+class CountingField : public FieldPattern {
+public:
+  mutable size_t evalCount = 0;
+  size_t prepareCount = 0;
+
+  CRGB eval(const LedGeom &led, const FrameCtx &ctx) const override {
+    ++evalCount;
+    return (led.faceID % 2 == 0) ? CRGB(255, 255, 255) : CRGB(0, 0, 0);
+  }
+  const char *getName() const override { return "Counting"; }
+  const char *getDescription() const override { return "test"; }
+
+protected:
+  void prepareFrame(const FrameCtx &ctx) override { ++prepareCount; }
+};
+
+}  // namespace
+
+// 各LEDを1回だけ評価し、clearを挟まずに書き込んでshowする
+void test_field_evaluates_each_led_once() {
+  LEDSphereManager manager;
+  initializeSphere(manager, LEDSphereManager::LED_COUNT);
+  CountingField field;
+  field.setSphereManager(&manager);
+
+  PatternParams params;
+  field.render(params);
+  TEST_ASSERT_EQUAL_UINT32(LEDSphereManager::LED_COUNT, field.evalCount);
+  TEST_ASSERT_EQUAL_UINT32(1, field.prepareCount);
+  TEST_ASSERT_EQUAL_UINT32(LEDSphereManager::LED_COUNT / 2, manager.getActiveLEDCount());
+
+  const auto &ops = manager.operationsForTest();
+  TEST_ASSERT_EQUAL_UINT32(2, ops.size());
+  TEST_ASSERT_EQUAL_STRING("field", ops[0].c_str());
+  TEST_ASSERT_EQUAL_STRING("show", ops[1].c_str());
+
+  // 2フレーム目も同数（前フレームの内容は評価結果で上書き）
+  field.render(params);
+  TEST_ASSERT_EQUAL_UINT32(2 * LEDSphereManager::LED_COUNT, field.evalCount);
+  TEST_ASSERT_EQUAL_UINT32(LEDSphereManager::LED_COUNT / 2, manager.getActiveLEDCount());
+}
+
+// レイアウトに無いLEDは評価されないので消灯される
+void test_field_clears_leds_outside_layout() {
+  LEDSphereManager manager;
+  initializeSphere(manager, 100);
+  CRGB *frame = manager.frameBufferForTest();
+  for (size_t i = 0; i < manager.totalLedsForTest(); ++i) {
+    manager.setLED(static_cast<uint16_t>(i), CRGB(10, 10, 10));
+  }
+  CountingField field;
+  field.setSphereManager(&manager);
+  field.render(PatternParams());
+  TEST_ASSERT_EQUAL_UINT32(100, field.evalCount);
+  TEST_ASSERT_FALSE(isLit(frame[500]));
+  TEST_ASSERT_EQUAL_UINT32(50, manager.getActiveLEDCount());
+}
+
+// 螺旋: 点灯するのは先頭から尾の長さまでの緯度帯のみ
+void test_spiral_lights_only_the_trail_band() {
+  LEDSphereManager manager;
+  initializeSphere(manager, LEDSphereManager::LED_COUNT);
+  ProceduralPattern::SpiralTrajectoryPattern spiral;
+  spiral.setTrailLength(30);
+  spiral.setSphereManager(&manager);
+
+  PatternParams params;
+  params.progress = 0.5f;  // 先頭は赤道
+  spiral.render(params);
+
+  const CRGB *frame = manager.frameBufferForTest();
+  const auto &geometry = manager.ledGeometry();
+  size_t lit = 0;
+  for (const LedGeom &led : geometry) {
+    if (isLit(frame[led.faceID])) {
+      ++lit;
+      TEST_ASSERT_TRUE(led.latitudeDeg <= 0.5f);
+      TEST_ASSERT_TRUE(led.latitudeDeg >= -30.5f);
+    }
+  }
+  TEST_ASSERT_TRUE(lit > 0);
+
+  // 開始時点は何も点灯しない
+  params.progress = 0.0f;
+  spiral.render(params);
+  TEST_ASSERT_TRUE(manager.getActiveLEDCount() <= 2);
+}
+
+// 球面波: 同緯度は同色、t=0で北極が山・θ=π/(2n)が谷
+void test_spherical_wave_is_concentric() {
+  LEDSphereManager manager;
+  initializeSphere(manager, LEDSphereManager::LED_COUNT);
+  ProceduralPattern::SphericalWavePattern wave;
+  wave.setWaveCount(3);
+  wave.setSphereManager(&manager);
+  wave.render(PatternParams());
+
+  const CRGB *frame = manager.frameBufferForTest();
+  const auto &geometry = manager.ledGeometry();
+  uint16_t northValue = 0;
+  uint16_t troughValue = 255;
+  for (const LedGeom &led : geometry) {
+    if (led.latitudeDeg > 85.0f) {
+      northValue = std::max(northValue, valueOf(frame[led.faceID]));
+    }
+    if (std::fabs(led.latitudeDeg - 60.0f) < 1.0f) {
+      troughValue = std::min(troughValue, valueOf(frame[led.faceID]));
+    }
+  }
+  TEST_ASSERT_TRUE(northValue > 200);
+  TEST_ASSERT_TRUE(troughValue < 10);
+
+  // 時間が進むと波面は南へ移動（北極は暗くなる）
+  PatternParams later;
+  later.time = 0.5f;
+  wave.render(later);
+  for (const LedGeom &led : geometry) {
+    if (led.latitudeDeg > 85.0f) {
+      TEST_ASSERT_TRUE(valueOf(frame[led.faceID]) < northValue / 2);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_field_evaluates_each_led_once);
+  RUN_TEST(test_field_clears_leds_outside_layout);
+  RUN_TEST(test_spiral_lights_only_the_trail_band);
+  RUN_TEST(test_spherical_wave_is_concentric);
+  return UNITY_END();
+}
@@ -0,0 +1,239 @@
+#include <unity.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "led/FramePack.h"
+#include "led/FramePackPlayer.h"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/FramePack.cpp"
+#include "../../src/led/FramePackPlayer.cpp"
+#include "../../src/led/LayerCompositor.cpp"
+
+using LEDSphere::FrameEncoding;
+using LEDSphere::FramePackHeader;
+using LEDSphere::FramePackIndexEntry;
+using LEDSphere::FramePackPlayer;
+using LEDSphere::FramePackWriter;
+using LEDSphere::LEDSphereManager;
+namespace FramePack = LEDSphere::FramePack;
+
+namespace {
+
+constexpr uint16_t kLedCount = 800;
+
+// 背景は静止グラデーション、frame番号に応じて一部LEDだけが動くフレーム
+std::vector<uint8_t> makeFrame(uint32_t frame) {
+  std::vector<uint8_t> rgb(kLedCount * 3, 0);
+  for (uint16_t i = 0; i < kLedCount; ++i) {
+    rgb[i * 3 + 2] = static_cast<uint8_t>(i);
+  }
+  for (uint16_t k = 0; k < 20; ++k) {
+    uint16_t led = static_cast<uint16_t>((frame * 7 + k * 37) % kLedCount);
+    rgb[led * 3 + 0] = static_cast<uint8_t>(frame * 13 + k);
+    rgb[led * 3 + 1] = static_cast<uint8_t>(255 - k);
+  }
+  return rgb;
+}
+
+std::vector<uint8_t> buildPack(uint32_t frames, uint16_t fps, uint32_t keyframeInterval, bool compression = true) {
+  FramePackWriter writer(kLedCount, fps, keyframeInterval);
+  writer.setCompressionEnabled(compression);
+  for (uint32_t f = 0; f < frames; ++f) {
+    auto rgb = makeFrame(f);
+    writer.addFrame(rgb.data());
+  }
+  std::vector<uint8_t> pack;
+  writer.finish(pack);
+  return pack;
+}
+
+}  // namespace
+
+void test_rle_and_delta_roundtrip() {
+  auto a = makeFrame(3);
+  auto b = makeFrame(4);
+  std::vector<uint8_t> encoded;
+  std::vector<uint8_t> decoded(kLedCount * 3, 0xAA);
+
+  FramePack::encodeRle(a.data(), kLedCount, encoded);
+  TEST_ASSERT_TRUE(FramePack::decodeFrame(FrameEncoding::kRle, encoded.data(), encoded.size(), decoded.data(), kLedCount));
+  TEST_ASSERT_EQUAL_INT(0, std::memcmp(a.data(), decoded.data(), a.size()));
+
+  FramePack::encodeDelta(a.data(), b.data(), kLedCount, encoded);
+  TEST_ASSERT_TRUE(FramePack::decodeFrame(FrameEncoding::kDelta, encoded.data(), encoded.size(), decoded.data(), kLedCount));
+  TEST_ASSERT_EQUAL_INT(0, std::memcmp(b.data(), decoded.data(), b.size()));
+
+  // 途中で切れた入力は拒否
+  TEST_ASSERT_FALSE(FramePack::decodeFrame(FrameEncoding::kDelta, encoded.data(), encoded.size() - 1, decoded.data(), kLedCount));
+}
+
+void test_writer_emits_valid_header_and_keyframes() {
+  auto pack = buildPack(10, 30, 4);
+  FramePackHeader header;
+  std::memcpy(&header, pack.data(), sizeof(header));
+  TEST_ASSERT_TRUE(FramePack::validateHeader(header, pack.size()));
+  TEST_ASSERT_EQUAL_UINT32(10, header.frameCount);
+  TEST_ASSERT_EQUAL_UINT16(kLedCount, header.ledCount);
+  TEST_ASSERT_EQUAL_UINT16(30, header.fps);
+
+  const auto *index = reinterpret_cast<const LEDSphere::FramePackIndexEntry *>(pack.data() + header.indexOffset);
+  for (uint32_t f = 0; f < header.frameCount; ++f) {
+    if (f % 4 == 0) {
+      TEST_ASSERT_EQUAL_UINT8(1, index[f].keyframe);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(FrameEncoding::kDelta), index[1].encoding);
+
+  const size_t rawSize = static_cast<size_t>(kLedCount) * 3 * 10;
+  char msg[80];
+  std::snprintf(msg, sizeof(msg), "pack %zu bytes vs raw %zu bytes", pack.size(), rawSize);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(pack.size() < rawSize / 2);
+
+  // 壊れたマジックは拒否
+  header.magic[0] = 'X';
+  TEST_ASSERT_FALSE(FramePack::validateHeader(header, pack.size()));
+}
+
+void test_player_plays_frames_on_schedule_and_loops() {
+  const uint32_t frames = 6;
+  auto pack = buildPack(frames, 10, 3);
+  FramePackPlayer player;
+  TEST_ASSERT_TRUE(player.open(FramePackPlayer::makeMemorySource(pack.data(), pack.size())));
+  TEST_ASSERT_TRUE(player.start(1000));
+
+  uint32_t now = 1000;
+  for (uint32_t shown = 0; shown < frames * 2; ++shown) {
+    TEST_ASSERT_TRUE(player.update(now));
+    const uint32_t expectedFrame = shown % frames;
+    TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(expectedFrame), player.currentFrame());
+    auto expected = makeFrame(expectedFrame);
+    TEST_ASSERT_EQUAL_INT(0, std::memcmp(expected.data(), player.frontFrame(), expected.size()));
+    // 次の表示時刻までは切り替わらない
+    TEST_ASSERT_FALSE(player.update(now + 50));
+    now += 100;
+  }
+  TEST_ASSERT_EQUAL_UINT32(frames * 2, player.stats().framesShown);
+  TEST_ASSERT_EQUAL_UINT32(0, player.stats().lateFrames);
+  TEST_ASSERT_EQUAL_UINT32(0, player.stats().readErrors);
+}
+
+void test_player_stops_without_loop_and_applies_to_manager() {
+  auto pack = buildPack(3, 30, 0);
+  FramePackPlayer player;
+  TEST_ASSERT_TRUE(player.open(FramePackPlayer::makeMemorySource(pack.data(), pack.size())));
+  player.setLoop(false);
+  TEST_ASSERT_TRUE(player.start(0));
+
+  uint32_t now = 0;
+  int shown = 0;
+  while (!player.finished() && shown < 10) {
+    if (player.update(now)) {
+      ++shown;
+    }
+    now += 40;
+  }
+  TEST_ASSERT_EQUAL_INT(3, shown);
+  TEST_ASSERT_EQUAL_INT32(2, player.currentFrame());
+
+  LEDSphereManager manager;
+  std::vector<uint16_t> lengths{200, 200, 200, 200};
+  std::vector<uint8_t> pins{5, 6, 7, 8};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(4, lengths, pins));
+  player.applyTo(manager);
+  auto expected = makeFrame(2);
+  const CRGB *leds = manager.frameBufferForTest();
+  for (uint16_t i = 0; i < kLedCount; ++i) {
+    TEST_ASSERT_EQUAL_UINT8(expected[i * 3 + 0], leds[i].r);
+    TEST_ASSERT_EQUAL_UINT8(expected[i * 3 + 1], leds[i].g);
+    TEST_ASSERT_EQUAL_UINT8(expected[i * 3 + 2], leds[i].b);
+  }
+}
+
+void test_player_show_frame_follows_external_timebase() {
+  // キーフレーム間隔5: 差分フレームへのジャンプはキーフレームから展開される
+  const uint32_t frames = 20;
+  auto pack = buildPack(frames, 30, 5);
+  FramePackPlayer player;
+  TEST_ASSERT_TRUE(player.open(FramePackPlayer::makeMemorySource(pack.data(), pack.size())));
+
+  const uint32_t sequence[] = {0, 1, 2, 7, 8, 8, 13, 11, 19, 23};
+  for (uint32_t target : sequence) {
+    player.showFrame(target);
+    const uint32_t expectedFrame = target % frames;
+    TEST_ASSERT_EQUAL_INT32(static_cast<int32_t>(expectedFrame), player.currentFrame());
+    auto expected = makeFrame(expectedFrame);
+    TEST_ASSERT_EQUAL_INT(0, std::memcmp(expected.data(), player.frontFrame(), expected.size()));
+  }
+  TEST_ASSERT_EQUAL_UINT32(9, player.stats().framesShown);
+  TEST_ASSERT_EQUAL_UINT32(0, player.stats().readErrors);
+  // 1, 2, 8 は先読み済みの次フレーム、それ以外（初回・前後へのジャンプ）はシーク
+  TEST_ASSERT_EQUAL_UINT32(6, player.stats().seeks);
+}
+
+void test_player_rejects_truncated_pack() {
+  auto pack = buildPack(4, 10, 2);
+  FramePackPlayer player;
+  TEST_ASSERT_FALSE(player.open(FramePackPlayer::makeMemorySource(pack.data(), pack.size() - 10)));
+  TEST_ASSERT_FALSE(player.isOpen());
+  TEST_ASSERT_FALSE(player.open(FramePackPlayer::makeMemorySource(pack.data(), 16)));
+}
+
+// ファイル由来のサイズ値を信用しない: 非圧縮フレームの長さ不一致・過大なmaxFrameSizeは開かない
+void test_player_rejects_malformed_sizes() {
+  const auto pack = buildPack(4, 10, 2, false);
+  FramePackHeader header;
+  std::memcpy(&header, pack.data(), sizeof(header));
+  const size_t frameBytes = kLedCount * 3;
+  TEST_ASSERT_EQUAL_UINT32(frameBytes, header.maxFrameSize);
+
+  // 非圧縮フレームのサイズをフレーム長より大きく偽装（範囲内に収まるよう最終フレーム以外）
+  auto oversized = pack;
+  FramePackIndexEntry entry;
+  std::memcpy(&entry, oversized.data() + header.indexOffset, sizeof(entry));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(FrameEncoding::kRaw), entry.encoding);
+  entry.size = static_cast<uint32_t>(frameBytes + 64);
+  std::memcpy(oversized.data() + header.indexOffset, &entry, sizeof(entry));
+  FramePackHeader bigHeader = header;
+  bigHeader.maxFrameSize = entry.size;
+  std::memcpy(oversized.data(), &bigHeader, sizeof(bigHeader));
+  FramePackPlayer player;
+  TEST_ASSERT_FALSE(player.open(FramePackPlayer::makeMemorySource(oversized.data(), oversized.size())));
+  TEST_ASSERT_FALSE(player.isOpen());
+
+  // 短すぎる非圧縮フレームも拒否
+  auto undersized = pack;
+  entry.size = static_cast<uint32_t>(frameBytes - 3);
+  std::memcpy(undersized.data() + header.indexOffset, &entry, sizeof(entry));
+  TEST_ASSERT_FALSE(player.open(FramePackPlayer::makeMemorySource(undersized.data(), undersized.size())));
+
+  // 読み出しバッファ確保量はLED数から決まる上限を超えられない
+  auto hugeBuffer = pack;
+  bigHeader = header;
+  bigHeader.maxFrameSize = 0x7FFFFFFF;
+  std::memcpy(hugeBuffer.data(), &bigHeader, sizeof(bigHeader));
+  TEST_ASSERT_FALSE(FramePack::validateHeader(bigHeader, hugeBuffer.size()));
+  TEST_ASSERT_FALSE(player.open(FramePackPlayer::makeMemorySource(hugeBuffer.data(), hugeBuffer.size())));
+
+  TEST_ASSERT_TRUE(player.open(FramePackPlayer::makeMemorySource(pack.data(), pack.size())));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_rle_and_delta_roundtrip);
+  RUN_TEST(test_writer_emits_valid_header_and_keyframes);
+  RUN_TEST(test_player_plays_frames_on_schedule_and_loops);
+  RUN_TEST(test_player_stops_without_loop_and_applies_to_manager);
+  RUN_TEST(test_player_show_frame_follows_external_timebase);
+  RUN_TEST(test_player_rejects_truncated_pack);
+  RUN_TEST(test_player_rejects_malformed_sizes);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "core/ImageFrameBuffer.h"
+#include "../../src/core/ImageFrameBuffer.cpp"
+
+namespace {
+
+std::vector<uint8_t> makePayload(size_t size, uint8_t seed) {
+  std::vector<uint8_t> payload(size);
+  for (size_t i = 0; i < size; ++i) {
+    payload[i] = static_cast<uint8_t>(seed + i * 7);
+  }
+  return payload;
+}
+
+// AsyncMqttClient と同じく、先頭から順に断片を渡す
+void deliver(ImageFrameBuffer &buffer, const std::vector<uint8_t> &payload, size_t fragment, uint8_t source = 0) {
+  TEST_ASSERT_TRUE(buffer.beginFrame(payload.size(), source));
+  for (size_t offset = 0; offset < payload.size(); offset += fragment) {
+    const size_t length = payload.size() - offset < fragment ? payload.size() - offset : fragment;
+    TEST_ASSERT_TRUE(buffer.writeFragment(offset, payload.data() + offset, length));
+  }
+}
+
+}  // namespace
+
+void test_fragments_land_in_slot_and_notify_once() {
+  ImageFrameBuffer buffer;
+  TEST_ASSERT_TRUE(buffer.allocate(32 * 1024));
+
+  int notifications = 0;
+  ImageFrameBuffer::Frame notified;
+  buffer.setFrameListener([&](const ImageFrameBuffer::Frame &frame) {
+    ++notifications;
+    notified = frame;
+  });
+
+  const std::vector<uint8_t> payload = makePayload(30 * 1024, 3);
+  deliver(buffer, payload, 1436, 2);
+  TEST_ASSERT_EQUAL(1, notifications);
+  TEST_ASSERT_EQUAL_UINT32(1, notified.sequence);
+  TEST_ASSERT_EQUAL_UINT8(2, notified.source);
+
+  ImageFrameBuffer::Frame frame;
+  TEST_ASSERT_TRUE(buffer.acquire(frame));
+  TEST_ASSERT_EQUAL(payload.size(), frame.size);
+  TEST_ASSERT_TRUE(frame.data == notified.data);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(payload.data(), frame.data, payload.size());
+  buffer.release(frame);
+
+  TEST_ASSERT_FALSE(buffer.acquire(frame));
+  const ImageFrameBuffer::Stats stats = buffer.stats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.framesCompleted);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.framesConsumed);
+  TEST_ASSERT_EQUAL_UINT32(payload.size(), stats.bytesReceived);
+}
+
+void test_newer_frame_replaces_unconsumed_one() {
+  ImageFrameBuffer buffer;
+  TEST_ASSERT_TRUE(buffer.allocate(1024));
+
+  deliver(buffer, makePayload(100, 1), 64);
+  deliver(buffer, makePayload(200, 2), 64);
+
+  ImageFrameBuffer::Frame frame;
+  TEST_ASSERT_TRUE(buffer.acquire(frame));
+  TEST_ASSERT_EQUAL_UINT32(2, frame.sequence);
+  TEST_ASSERT_EQUAL(200, frame.size);
+  buffer.release(frame);
+  TEST_ASSERT_FALSE(buffer.acquire(frame));
+  TEST_ASSERT_EQUAL_UINT32(1, buffer.stats().framesDropped);
+}
+
+void test_slot_being_read_is_never_overwritten() {
+  ImageFrameBuffer buffer;
+  TEST_ASSERT_TRUE(buffer.allocate(1024));
+
+  const std::vector<uint8_t> first = makePayload(300, 10);
+  deliver(buffer, first, 100);
+  ImageFrameBuffer::Frame reading;
+  TEST_ASSERT_TRUE(buffer.acquire(reading));
+
+  // 読み出し中に2フレーム届いても、読み出し中スロットの内容は変わらない
+  deliver(buffer, makePayload(300, 20), 100);
+  deliver(buffer, makePayload(300, 30), 100);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(first.data(), reading.data, first.size());
+
+  buffer.release(reading);
+  ImageFrameBuffer::Frame latest;
+  TEST_ASSERT_TRUE(buffer.acquire(latest));
+  TEST_ASSERT_EQUAL_UINT32(3, latest.sequence);
+  TEST_ASSERT_EQUAL_UINT8(30, latest.data[0]);
+  buffer.release(latest);
+}
+
+void test_oversize_and_broken_frames_are_rejected() {
+  ImageFrameBuffer buffer;
+  TEST_ASSERT_TRUE(buffer.allocate(256));
+
+  TEST_ASSERT_FALSE(buffer.beginFrame(257));
+  TEST_ASSERT_EQUAL_UINT32(1, buffer.stats().framesOversize);
+
+  // 断片の欠落（オフセット不一致）はフレームを破棄する
+  const std::vector<uint8_t> payload = makePayload(200, 5);
+  TEST_ASSERT_TRUE(buffer.beginFrame(payload.size()));
+  TEST_ASSERT_TRUE(buffer.writeFragment(0, payload.data(), 50));
+  TEST_ASSERT_FALSE(buffer.writeFragment(100, payload.data() + 100, 100));
+  TEST_ASSERT_FALSE(buffer.receiving());
+
+  // 最終断片が来ないまま次のフレームが始まった場合も破棄
+  TEST_ASSERT_TRUE(buffer.beginFrame(payload.size()));
+  TEST_ASSERT_TRUE(buffer.writeFragment(0, payload.data(), 50));
+  deliver(buffer, payload, 80);
+
+  ImageFrameBuffer::Frame frame;
+  TEST_ASSERT_TRUE(buffer.acquire(frame));
+  TEST_ASSERT_EQUAL_UINT32(1, frame.sequence);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(payload.data(), frame.data, payload.size());
+  buffer.release(frame);
+  TEST_ASSERT_EQUAL_UINT32(2, buffer.stats().framesAborted);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_fragments_land_in_slot_and_notify_once);
+  RUN_TEST(test_newer_frame_replaces_unconsumed_one);
+  RUN_TEST(test_slot_being_read_is_never_overwritten);
+  RUN_TEST(test_oversize_and_broken_frames_are_rejected);
+  return UNITY_END();
+}
@@ -105,6 +105,30 @@ void test_shared_state_ui_command() {
   TEST_ASSERT_FALSE(state.popUiCommand(command, false));
 }
 
+void test_shared_state_ui_command_burst_is_not_overwritten() {
+  SharedState state;
+  const char *burst[] = {"ui:x_pos", "ui:x_neg", "ui:mode:on"};
+  for (const char *command : burst) {
+    TEST_ASSERT_TRUE(state.pushUiCommand(command, true));
+  }
+
+  UiCommand record;
+  TEST_ASSERT_TRUE(state.popUiCommand(record, true));
+  TEST_ASSERT_EQUAL(static_cast<int>(UiCommandType::kNextContent), static_cast<int>(record.type));
+  TEST_ASSERT_TRUE(state.popUiCommand(record, true));
+  TEST_ASSERT_EQUAL(static_cast<int>(UiCommandType::kPlayPause), static_cast<int>(record.type));
+  TEST_ASSERT_TRUE(state.popUiCommand(record, true));
+  TEST_ASSERT_EQUAL(static_cast<int>(UiCommandType::kModeOn), static_cast<int>(record.type));
+  TEST_ASSERT_FALSE(state.popUiCommand(record, true));
+
+  for (size_t i = 0; i < SharedState::kUiQueueDepth + 2; ++i) {
+    state.pushUiCommand("ui:x_pos", true);
+  }
+  SharedState::CommandQueueStats stats = state.getCommandQueueStats();
+  TEST_ASSERT_EQUAL_UINT32(2, stats.uiIncomingOverflow);
+  TEST_ASSERT_EQUAL_UINT32(SharedState::kUiQueueDepth, stats.uiIncomingDepth);
+}
+
 void setUp() {}
 void tearDown() {}
 
@@ -116,6 +140,7 @@ int runUnityTests() {
   RUN_TEST(test_shared_state_stores_imu_reading);
   RUN_TEST(test_shared_state_ui_mode);
   RUN_TEST(test_shared_state_ui_command);
+  RUN_TEST(test_shared_state_ui_command_burst_is_not_overwritten);
   return UNITY_END();
 }
 
@@ -0,0 +1,201 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "led/JpegLedDecoder.h"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/JpegLedDecoder.cpp"
+
+using LEDSphere::JpegLedDecoder;
+using LEDSphere::LEDPosition;
+using LEDSphere::LEDSphereManager;
+using LEDSphere::PanoramaTexture;
+using LEDSphere::TextureFilter;
+
+namespace {
+
+std::vector<LEDPosition> makeFibonacciLayout(size_t count) {
+  std::vector<LEDPosition> positions;
+  positions.reserve(count);
+  const float golden = static_cast<float>(M_PI) * (3.0f - std::sqrt(5.0f));
+  for (size_t i = 0; i < count; ++i) {
+    float y = 1.0f - (2.0f * (static_cast<float>(i) + 0.5f)) / static_cast<float>(count);
+    float r = std::sqrt(1.0f - y * y);
+    float theta = golden * static_cast<float>(i);
+    positions.emplace_back(static_cast<uint16_t>(i), static_cast<uint8_t>(i / 200), static_cast<uint8_t>(i % 200),
+                           r * std::cos(theta), y, r * std::sin(theta));
+  }
+  return positions;
+}
+
+void initializeManager(LEDSphereManager &manager, const std::vector<LEDPosition> &layout) {
+  std::vector<uint16_t> lengths{static_cast<uint16_t>(layout.size())};
+  std::vector<uint8_t> pins{5};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(1, lengths, pins));
+  manager.setLayoutForTest(layout);
+}
+
+// RGB565のテスト画像（グラデーション + 市松）
+std::vector<uint16_t> makeRGB565Image(uint16_t width, uint16_t height) {
+  std::vector<uint16_t> pixels(static_cast<size_t>(width) * height);
+  for (uint16_t y = 0; y < height; ++y) {
+    for (uint16_t x = 0; x < width; ++x) {
+      uint16_t r = static_cast<uint16_t>((x * 31) / (width - 1));
+      uint16_t g = static_cast<uint16_t>((y * 63) / (height - 1));
+      uint16_t b = ((x / 2 + y / 2) & 1) ? 31 : 0;
+      pixels[static_cast<size_t>(y) * width + x] = static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> expandToRGB888(const std::vector<uint16_t> &src) {
+  std::vector<uint8_t> out(src.size() * 3);
+  for (size_t i = 0; i < src.size(); ++i) {
+    uint32_t r, g, b;
+    LEDSphere::expandRGB565(src[i], r, g, b);
+    out[i * 3 + 0] = static_cast<uint8_t>(r);
+    out[i * 3 + 1] = static_cast<uint8_t>(g);
+    out[i * 3 + 2] = static_cast<uint8_t>(b);
+  }
+  return out;
+}
+
+// TJpgDecと同じ順序（MCU単位・ラスタ順）でブロックを供給
+void feedBlocks(JpegLedDecoder &decoder, const std::vector<uint16_t> &image, uint16_t width, uint16_t height,
+                uint16_t mcuW, uint16_t mcuH) {
+  std::vector<uint16_t> block(static_cast<size_t>(mcuW) * mcuH);
+  for (uint16_t by = 0; by < height; by += mcuH) {
+    for (uint16_t bx = 0; bx < width; bx += mcuW) {
+      uint16_t w = static_cast<uint16_t>(std::min<int>(mcuW, width - bx));
+      uint16_t h = static_cast<uint16_t>(std::min<int>(mcuH, height - by));
+      for (uint16_t y = 0; y < h; ++y) {
+        for (uint16_t x = 0; x < w; ++x) {
+          block[static_cast<size_t>(y) * w + x] = image[static_cast<size_t>(by + y) * width + bx + x];
+        }
+      }
+      if (!decoder.consumeBlock(static_cast<int16_t>(bx), static_cast<int16_t>(by), w, h, block.data())) {
+        return;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void test_select_scale_keeps_min_height() {
+  TEST_ASSERT_EQUAL_UINT8(1, JpegLedDecoder::selectScale(160, 160));
+  TEST_ASSERT_EQUAL_UINT8(2, JpegLedDecoder::selectScale(320, 160));
+  TEST_ASSERT_EQUAL_UINT8(4, JpegLedDecoder::selectScale(1000, 160));
+  TEST_ASSERT_EQUAL_UINT8(8, JpegLedDecoder::selectScale(4096, 160));
+  TEST_ASSERT_EQUAL_UINT8(1, JpegLedDecoder::selectScale(100, 160));
+}
+
+void test_streaming_matches_texture_bilinear() {
+  const uint16_t w = 128, h = 64;
+  auto image = makeRGB565Image(w, h);
+  auto rgb888 = expandToRGB888(image);
+  auto layout = makeFibonacciLayout(LEDSphereManager::LED_COUNT);
+
+  // 参照: 展開済みテクスチャからのバイリニアサンプリング
+  LEDSphereManager reference;
+  initializeManager(reference, layout);
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(rgb888.data(), w, h));
+  reference.setPanoramaTexture(&texture, TextureFilter::kBilinear);
+  reference.updateAllLEDsFromImage();
+
+  LEDSphereManager manager;
+  initializeManager(manager, layout);
+  JpegLedDecoder decoder(manager);
+  TEST_ASSERT_TRUE(decoder.preparePlan(w, h));
+  decoder.beginFrame();
+  feedBlocks(decoder, image, w, h, 16, 16);
+  decoder.finishFrame();
+
+  const CRGB *expected = reference.frameBufferForTest();
+  const CRGB *actual = manager.frameBufferForTest();
+  for (size_t i = 0; i < layout.size(); ++i) {
+    TEST_ASSERT_EQUAL_UINT8(expected[i].r, actual[i].r);
+    TEST_ASSERT_EQUAL_UINT8(expected[i].g, actual[i].g);
+    TEST_ASSERT_EQUAL_UINT8(expected[i].b, actual[i].b);
+  }
+  TEST_ASSERT_GREATER_THAN(0, decoder.stats().blocksConsumed);
+}
+
+void test_skips_untouched_blocks_and_terminates_early() {
+  const uint16_t w = 256, h = 128;
+  auto image = makeRGB565Image(w, h);
+
+  // 北半球上部のみのレイアウト（画像下半分は不要）
+  std::vector<LEDPosition> layout;
+  layout.emplace_back(0, 0, 0, 0.0f, 0.95f, 0.31f);
+  layout.emplace_back(1, 0, 1, 0.31f, 0.95f, 0.0f);
+  layout.emplace_back(2, 0, 2, 0.0f, 0.7f, -0.71f);
+  LEDSphereManager manager;
+  initializeManager(manager, layout);
+
+  JpegLedDecoder decoder(manager);
+  TEST_ASSERT_TRUE(decoder.preparePlan(w, h));
+  TEST_ASSERT_TRUE(decoder.lastReferencedRow() < h / 2);
+  decoder.beginFrame();
+  feedBlocks(decoder, image, w, h, 16, 8);
+  decoder.finishFrame();
+
+  const auto &stats = decoder.stats();
+  const uint32_t totalBlocks = (w / 16) * (h / 8);
+  char msg[96];
+  std::snprintf(msg, sizeof(msg), "blocks consumed=%u skipped=%u of %u", stats.blocksConsumed, stats.blocksSkipped,
+                totalBlocks);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(stats.terminatedEarly);
+  TEST_ASSERT_TRUE(stats.blocksConsumed <= 3 * 4);
+  TEST_ASSERT_TRUE(stats.blocksConsumed + stats.blocksSkipped < totalBlocks / 2);
+}
+
+void test_plan_reused_until_posture_changes() {
+  auto layout = makeFibonacciLayout(64);
+  LEDSphereManager manager;
+  initializeManager(manager, layout);
+  JpegLedDecoder decoder(manager);
+
+  TEST_ASSERT_TRUE(decoder.preparePlan(64, 32));
+  const uint32_t taps = manager.texelTapComputeCount();
+  TEST_ASSERT_TRUE(decoder.preparePlan(64, 32));
+  TEST_ASSERT_EQUAL_UINT32(1, decoder.planBuildCount());
+  // 再利用時はタップも再計算しない
+  TEST_ASSERT_EQUAL_UINT32(taps, manager.texelTapComputeCount());
+
+  // 解像度変更で再構築
+  TEST_ASSERT_TRUE(decoder.preparePlan(32, 16));
+  TEST_ASSERT_EQUAL_UINT32(2, decoder.planBuildCount());
+  TEST_ASSERT_EQUAL_UINT32(taps + 1, manager.texelTapComputeCount());
+
+  // 姿勢変更で再構築
+  LEDSphere::PostureParams posture;
+  posture.quaternionW = 0.9238795f;
+  posture.quaternionY = 0.3826834f;
+  manager.setPostureParams(posture);
+  TEST_ASSERT_TRUE(decoder.preparePlan(32, 16));
+  TEST_ASSERT_EQUAL_UINT32(3, decoder.planBuildCount());
+  TEST_ASSERT_EQUAL_UINT32(taps + 2, manager.texelTapComputeCount());
+  TEST_ASSERT_TRUE(decoder.preparePlan(32, 16));
+  TEST_ASSERT_EQUAL_UINT32(taps + 2, manager.texelTapComputeCount());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_select_scale_keeps_min_height);
+  RUN_TEST(test_streaming_matches_texture_bilinear);
+  RUN_TEST(test_skips_untouched_blocks_and_terminates_early);
+  RUN_TEST(test_plan_reused_until_posture_changes);
+  return UNITY_END();
+}
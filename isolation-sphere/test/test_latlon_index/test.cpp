@@ -0,0 +1,131 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "led/LatLonIndex.h"
+#include "../../src/led/LatLonIndex.cpp"
+
+using LEDSphere::LatLonIndex;
+
+namespace {
+
+struct Layout {
+  std::vector<float> lat;
+  std::vector<float> lon;
+  std::vector<uint16_t> ids;
+};
+
+// フィボナッチ球面の緯度・経度（IDは逆順にして添字と区別する）
+Layout makeLayout(size_t count) {
+  Layout layout;
+  const float golden = static_cast<float>(M_PI) * (3.0f - std::sqrt(5.0f));
+  for (size_t i = 0; i < count; ++i) {
+    const float y = 1.0f - (2.0f * (static_cast<float>(i) + 0.5f)) / static_cast<float>(count);
+    const float r = std::sqrt(1.0f - y * y);
+    const float theta = golden * static_cast<float>(i);
+    layout.lat.push_back(std::asin(y) * 180.0f / static_cast<float>(M_PI));
+    layout.lon.push_back(std::atan2(r * std::sin(theta), r * std::cos(theta)) * 180.0f / static_cast<float>(M_PI));
+    layout.ids.push_back(static_cast<uint16_t>(count - 1 - i));
+  }
+  return layout;
+}
+
+// 旧実装（全LED走査）の判定
+std::vector<uint16_t> bruteLatitude(const Layout &layout, float latitude, float tolerance) {
+  std::vector<uint16_t> result;
+  for (size_t i = 0; i < layout.ids.size(); ++i) {
+    if (std::fabs(layout.lat[i] - latitude) <= tolerance) result.push_back(layout.ids[i]);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<uint16_t> bruteLongitude(const Layout &layout, float longitude, float tolerance) {
+  std::vector<uint16_t> result;
+  for (size_t i = 0; i < layout.ids.size(); ++i) {
+    const float diff = std::fabs(std::fmod(layout.lon[i] - longitude + 540.0f, 360.0f) - 180.0f);
+    if (diff <= tolerance) result.push_back(layout.ids[i]);
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<uint16_t> sorted(std::vector<uint16_t> ids) {
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+void assertSameIds(const std::vector<uint16_t> &expected, const std::vector<uint16_t> &actual) {
+  TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    TEST_ASSERT_EQUAL_UINT16(expected[i], actual[i]);
+  }
+}
+
+}  // namespace
+
+// 緯度帯: 全LED走査と同じ集合、結果は緯度順
+void test_latitude_band_matches_linear_scan() {
+  const Layout layout = makeLayout(800);
+  LatLonIndex index;
+  index.build(layout.lat.data(), layout.lon.data(), layout.ids.data(), layout.ids.size());
+  TEST_ASSERT_EQUAL_UINT32(800, index.size());
+
+  const float latitudes[] = {-90.0f, -61.3f, -30.0f, 0.0f, 12.5f, 45.0f, 89.0f, 90.0f};
+  const float tolerances[] = {1.0f, 2.0f, 4.0f, 10.0f};
+  for (float lat : latitudes) {
+    for (float tol : tolerances) {
+      const std::vector<uint16_t> band = index.latitudeBand(lat, tol);
+      assertSameIds(bruteLatitude(layout, lat, tol), sorted(band));
+      // 南から北へ緯度順に列挙される（IDは北から振ってあるので昇順になる）
+      for (size_t i = 1; i < band.size(); ++i) {
+        TEST_ASSERT_TRUE(band[i] > band[i - 1]);
+      }
+    }
+  }
+}
+
+// 経度帯: ±180度をまたぐ帯も含めて全LED走査と一致
+void test_longitude_band_wraps_at_antimeridian() {
+  const Layout layout = makeLayout(800);
+  LatLonIndex index;
+  index.build(layout.lat.data(), layout.lon.data(), layout.ids.data(), layout.ids.size());
+
+  const float longitudes[] = {-180.0f, -178.5f, -90.0f, 0.0f, 30.0f, 177.0f, 180.0f, 330.0f, -540.0f};
+  const float tolerances[] = {2.0f, 4.0f, 8.0f, 45.0f};
+  for (float lon : longitudes) {
+    for (float tol : tolerances) {
+      assertSameIds(bruteLongitude(layout, lon, tol), sorted(index.longitudeBand(lon, tol)));
+    }
+  }
+  // 半周以上の許容幅は全LED
+  TEST_ASSERT_EQUAL_UINT32(800, index.longitudeBand(10.0f, 180.0f).size());
+}
+
+void test_normalize_longitude() {
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, LatLonIndex::normalizeLongitude(360.0f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, -30.0f, LatLonIndex::normalizeLongitude(330.0f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, -180.0f, LatLonIndex::normalizeLongitude(180.0f));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 170.0f, LatLonIndex::normalizeLongitude(-190.0f));
+}
+
+void test_empty_index_returns_nothing() {
+  LatLonIndex index;
+  TEST_ASSERT_TRUE(index.empty());
+  TEST_ASSERT_EQUAL_UINT32(0, index.latitudeBand(0.0f, 90.0f).size());
+  TEST_ASSERT_EQUAL_UINT32(0, index.longitudeBand(0.0f, 180.0f).size());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_latitude_band_matches_linear_scan);
+  RUN_TEST(test_longitude_band_wraps_at_antimeridian);
+  RUN_TEST(test_normalize_longitude);
+  RUN_TEST(test_empty_index_returns_nothing);
+  return UNITY_END();
+}
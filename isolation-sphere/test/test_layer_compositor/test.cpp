@@ -0,0 +1,152 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "led/LayerCompositor.h"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/LayerCompositor.cpp"
+
+using LEDSphere::BlendMode;
+using LEDSphere::LayerCompositor;
+using LEDSphere::LEDSphereManager;
+
+namespace {
+
+void assertColor(uint8_t r, uint8_t g, uint8_t b, const CRGB &actual) {
+  TEST_ASSERT_EQUAL_UINT8(r, actual.r);
+  TEST_ASSERT_EQUAL_UINT8(g, actual.g);
+  TEST_ASSERT_EQUAL_UINT8(b, actual.b);
+}
+
+// 下地（dst）1色の上に1画素を指定モードで重ねた結果
+CRGB blendOne(BlendMode mode, CRGB dst, CRGB src, uint8_t alpha, uint8_t opacity = 255) {
+  LayerCompositor compositor(1);
+  const auto base = compositor.addLayer(LayerCompositor::Storage::kDense);
+  const auto top = compositor.addLayer(LayerCompositor::Storage::kSparse, mode, opacity);
+  compositor.setPixel(base, 0, dst);
+  compositor.setPixel(top, 0, src, alpha);
+  compositor.compose();
+  return compositor.output()[0];
+}
+
+}  // namespace
+
+void test_blend_modes() {
+  const CRGB dst(200, 100, 0);
+  const CRGB src(100, 200, 255);
+  assertColor(100, 200, 255, blendOne(BlendMode::kAlphaOver, dst, src, 255));
+  assertColor(150, 150, 128, blendOne(BlendMode::kAlphaOver, dst, src, 128));
+  assertColor(255, 255, 255, blendOne(BlendMode::kAdd, dst, src, 255));
+  assertColor(250, 200, 128, blendOne(BlendMode::kAdd, dst, src, 128));
+  // screen: 255 - (255-d)(255-s)/255
+  assertColor(222, 222, 255, blendOne(BlendMode::kScreen, dst, src, 255));
+  // multiply: d×s/255
+  assertColor(78, 78, 0, blendOne(BlendMode::kMultiply, dst, src, 255));
+  // 透明な画素とレイヤー不透明度0は下地をそのまま通す
+  assertColor(200, 100, 0, blendOne(BlendMode::kAlphaOver, dst, src, 0));
+  assertColor(200, 100, 0, blendOne(BlendMode::kAdd, dst, src, 255, 0));
+  // レイヤー不透明度は画素アルファに掛かる
+  assertColor(150, 150, 128, blendOne(BlendMode::kAlphaOver, dst, src, 255, 128));
+}
+
+// オーバーレイだけが変わるフレームでは動画レイヤーを再ブレンドしない
+void test_only_dirty_layers_are_reblended() {
+  LayerCompositor compositor(4);
+  const auto movie = compositor.addLayer(LayerCompositor::Storage::kDense);
+  const auto overlay = compositor.addLayer(LayerCompositor::Storage::kSparse);
+  const uint8_t frame[12] = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120};
+  compositor.setRGB(movie, frame, 4);
+  TEST_ASSERT_TRUE(compositor.compose());
+  TEST_ASSERT_EQUAL_UINT32(2, compositor.stats().layersBlended);
+  TEST_ASSERT_FALSE(compositor.compose());
+
+  compositor.setPixel(overlay, 2, CRGB(255, 0, 0));
+  TEST_ASSERT_FALSE(compositor.isDirty(movie));
+  TEST_ASSERT_TRUE(compositor.compose());
+  TEST_ASSERT_EQUAL_UINT32(3, compositor.stats().layersBlended);
+  TEST_ASSERT_EQUAL_UINT32(1, compositor.stats().layersReused);
+  assertColor(255, 0, 0, compositor.output()[2]);
+  assertColor(40, 50, 60, compositor.output()[1]);
+
+  // マーカー移動: 消去後の画素は動画に戻る
+  compositor.clearLayer(overlay);
+  compositor.setPixel(overlay, 3, CRGB(0, 0, 255));
+  compositor.compose();
+  assertColor(70, 80, 90, compositor.output()[2]);
+  assertColor(0, 0, 255, compositor.output()[3]);
+
+  // 動画の次フレームではオーバーレイがその上に残る
+  const uint8_t next[12] = {};
+  compositor.setRGB(movie, next, 4);
+  compositor.compose();
+  assertColor(0, 0, 0, compositor.output()[0]);
+  assertColor(0, 0, 255, compositor.output()[3]);
+
+  compositor.setVisible(overlay, false);
+  compositor.compose();
+  assertColor(0, 0, 0, compositor.output()[3]);
+  TEST_ASSERT_EQUAL_UINT32(5, compositor.stats().composes);
+}
+
+// present()は変化時のみ1回の一括書き込みでフレームバッファへ出力する
+void test_present_writes_frame_buffer_once() {
+  LEDSphereManager manager;
+  std::vector<uint16_t> lengths{200, 200, 200, 200};
+  std::vector<uint8_t> pins{5, 6, 7, 8};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(static_cast<uint8_t>(lengths.size()), lengths, pins));
+
+  LayerCompositor compositor;
+  const auto base = compositor.addLayer(LayerCompositor::Storage::kDense);
+  const auto markers = compositor.addLayer(LayerCompositor::Storage::kSparse, BlendMode::kAdd);
+  std::vector<uint8_t> frame(LEDSphereManager::LED_COUNT * 3, 0);
+  frame[0] = 100;
+  compositor.setRGB(base, frame.data(), LEDSphereManager::LED_COUNT);
+  compositor.setPixel(markers, 0, CRGB(100, 0, 0));
+  compositor.setPixel(markers, 799, CRGB(0, 0, 50));
+
+  TEST_ASSERT_TRUE(compositor.present(manager));
+  const CRGB *buffer = manager.frameBufferForTest();
+  assertColor(200, 0, 0, buffer[0]);
+  assertColor(0, 0, 50, buffer[799]);
+  assertColor(0, 0, 0, buffer[400]);
+  TEST_ASSERT_EQUAL_UINT16(2, manager.getActiveLEDCount());
+
+  // 変化が無ければ書き込まない（他の描画を上書きしない）、forceで再出力
+  manager.clearAllLEDs();
+  TEST_ASSERT_FALSE(compositor.present(manager));
+  assertColor(0, 0, 0, buffer[0]);
+  TEST_ASSERT_TRUE(compositor.present(manager, true));
+  assertColor(200, 0, 0, buffer[0]);
+}
+
+void test_layer_limits_and_invalid_ids() {
+  LayerCompositor compositor(2);
+  TEST_ASSERT_NULL(compositor.output());
+  TEST_ASSERT_FALSE(compositor.compose());
+  for (size_t i = 0; i < LayerCompositor::kMaxLayers; ++i) {
+    TEST_ASSERT_EQUAL_UINT8(i, compositor.addLayer(LayerCompositor::Storage::kSparse));
+  }
+  TEST_ASSERT_EQUAL_UINT8(LayerCompositor::kInvalidLayer, compositor.addLayer(LayerCompositor::Storage::kDense));
+  compositor.compose();
+  // 範囲外のレイヤー・LEDは無視
+  compositor.setPixel(LayerCompositor::kInvalidLayer, 0, CRGB(1, 2, 3));
+  compositor.setPixel(0, 2, CRGB(1, 2, 3));
+  TEST_ASSERT_FALSE(compositor.compose());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_blend_modes);
+  RUN_TEST(test_only_dirty_layers_are_reblended);
+  RUN_TEST(test_present_writes_frame_buffer_once);
+  RUN_TEST(test_layer_limits_and_invalid_ids);
+  return UNITY_END();
+}
@@ -1,10 +1,66 @@
 #include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <vector>
 
 #include "led/LEDSphereManager.h"
 #include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
 
 using LEDSphere::LEDSphereManager;
+using LEDSphere::LEDPosition;
+
+namespace {
+
+// 800LEDをフィボナッチ球面に配置した合成レイアウト
+std::vector<LEDPosition> makeFibonacciLayout(size_t count) {
+  std::vector<LEDPosition> positions;
+  positions.reserve(count);
+  const float golden = static_cast<float>(M_PI) * (3.0f - std::sqrt(5.0f));
+  for (size_t i = 0; i < count; ++i) {
+    float y = 1.0f - (2.0f * (static_cast<float>(i) + 0.5f)) / static_cast<float>(count);
+    float r = std::sqrt(1.0f - y * y);
+    float theta = golden * static_cast<float>(i);
+    positions.emplace_back(static_cast<uint16_t>(i), static_cast<uint8_t>(i / 200), static_cast<uint8_t>(i % 200),
+                           r * std::cos(theta), y, r * std::sin(theta));
+  }
+  return positions;
+}
+
+void initializeFullSphere(LEDSphereManager &manager) {
+  std::vector<uint16_t> lengths{200, 200, 200, 200};
+  std::vector<uint8_t> pins{5, 6, 7, 8};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(static_cast<uint8_t>(lengths.size()), lengths, pins));
+  manager.setLayoutForTest(makeFibonacciLayout(LEDSphereManager::LED_COUNT));
+}
+
+// 旧実装（LED毎にクォータニオン正規化・回転・UV変換）の再現
+void legacyUpdateAllLEDsFromImage(const LEDSphereManager &manager, const std::vector<LEDPosition> &layout,
+                                  const LEDSphere::PostureParams &posture, CRGB *out) {
+  for (const auto &pos : layout) {
+    float qw = posture.quaternionW, qx = posture.quaternionX;
+    float qy = posture.quaternionY, qz = posture.quaternionZ;
+    float norm = fast_sqrt(qw * qw + qx * qx + qy * qy + qz * qz);
+    if (norm > 0.0001f) {
+      qw /= norm; qx /= norm; qy /= norm; qz /= norm;
+    }
+    float qw2 = qw * qw, qx2 = qx * qx, qy2 = qy * qy, qz2 = qz * qz;
+    float rx = (qw2 + qx2 - qy2 - qz2) * pos.x + 2.0f * (qx * qy - qw * qz) * pos.y + 2.0f * (qx * qz + qw * qy) * pos.z;
+    float ry = 2.0f * (qx * qy + qw * qz) * pos.x + (qw2 - qx2 + qy2 - qz2) * pos.y + 2.0f * (qy * qz - qw * qx) * pos.z;
+    float rz = 2.0f * (qx * qz - qw * qy) * pos.x + 2.0f * (qy * qz + qw * qx) * pos.y + (qw2 - qx2 - qy2 + qz2) * pos.z;
+    float u = fast_atan2(fast_sqrt(rx * rx + rz * rz), ry);
+    float v = fast_atan2(rx, rz);
+    out[pos.faceID] = manager.extractColorFromImageUV(u, v);
+  }
+}
+
+}  // namespace
 
 void test_initialize_led_hardware_allocates_buffer() {
   std::vector<uint16_t> lengths{3, 2};
@@ -44,6 +100,416 @@ void test_show_sets_flag_under_unit_test() {
   TEST_ASSERT_TRUE(manager.wasShowCalledForTest());
 }
 
+void test_image_pipeline_matches_legacy_per_led_path() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+
+  LEDSphere::PostureParams posture;
+  posture.quaternionW = 0.9f;
+  posture.quaternionX = 0.3f;
+  posture.quaternionY = -0.2f;
+  posture.quaternionZ = 0.25f;
+  manager.setPostureParams(posture);
+  manager.updateAllLEDsFromImage();
+
+  std::vector<CRGB> expected(LEDSphereManager::LED_COUNT);
+  legacyUpdateAllLEDsFromImage(manager, makeFibonacciLayout(LEDSphereManager::LED_COUNT), posture, expected.data());
+
+  const CRGB *actual = manager.frameBufferForTest();
+  for (size_t i = 0; i < LEDSphereManager::LED_COUNT; ++i) {
+    TEST_ASSERT_UINT8_WITHIN(1, expected[i].r, actual[i].r);
+    TEST_ASSERT_UINT8_WITHIN(1, expected[i].g, actual[i].g);
+    TEST_ASSERT_UINT8_WITHIN(1, expected[i].b, actual[i].b);
+  }
+}
+
+void test_image_pipeline_benchmark_per_frame_us() {
+  using Clock = std::chrono::steady_clock;
+  const int frames = 200;
+
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  const auto layout = makeFibonacciLayout(LEDSphereManager::LED_COUNT);
+  std::vector<CRGB> legacyOut(LEDSphereManager::LED_COUNT);
+
+  LEDSphere::PostureParams posture;
+  auto legacyStart = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    posture.quaternionW = std::cos(0.01f * f);
+    posture.quaternionY = std::sin(0.01f * f);
+    legacyUpdateAllLEDsFromImage(manager, layout, posture, legacyOut.data());
+  }
+  auto legacyEnd = Clock::now();
+
+  auto pipelineStart = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    posture.quaternionW = std::cos(0.01f * f);
+    posture.quaternionY = std::sin(0.01f * f);
+    manager.setPostureParams(posture);
+    manager.updateAllLEDsFromImage();
+  }
+  auto pipelineEnd = Clock::now();
+
+  double legacyUs = std::chrono::duration<double, std::micro>(legacyEnd - legacyStart).count() / frames;
+  double pipelineUs = std::chrono::duration<double, std::micro>(pipelineEnd - pipelineStart).count() / frames;
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "updateAllLEDsFromImage per frame: before=%.1fus after=%.1fus (%.2fx)",
+                legacyUs, pipelineUs, pipelineUs > 0.0 ? legacyUs / pipelineUs : 0.0);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(LEDSphereManager::LED_COUNT, manager.uvUForTest().size());
+}
+
+void test_uv_cache_reused_for_resting_posture() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  manager.setUVCacheEpsilonDegrees(0.5f);
+
+  manager.setIMUPosture(1.0f, 0.0f, 0.0f, 0.0f);
+  manager.updateAllLEDsFromImage();
+  // 閾値未満の微小なIMUノイズ
+  manager.setIMUPosture(0.99999f, 0.001f, -0.001f, 0.0f);
+  manager.updateAllLEDsFromImage();
+  manager.updateAllLEDsFromImage();
+
+  TEST_ASSERT_EQUAL_UINT32(1, manager.getUVCacheStats().rebuilds);
+  TEST_ASSERT_EQUAL_UINT32(2, manager.getUVCacheStats().hits);
+
+  // 閾値を超える回転で再計算
+  manager.setIMUPosture(0.9659f, 0.0f, 0.2588f, 0.0f);
+  manager.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_UINT32(2, manager.getUVCacheStats().rebuilds);
+}
+
+void test_uv_cache_longitude_offset_shifts_without_rebuild() {
+  LEDSphereManager cached;
+  initializeFullSphere(cached);
+  cached.setIMUPosture(0.9f, 0.1f, 0.3f, -0.2f);
+  cached.updateAllLEDsFromImage();
+  cached.setUIOffset(0.0f, 135.0f);
+  cached.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_UINT32(1, cached.getUVCacheStats().rebuilds);
+  TEST_ASSERT_EQUAL_UINT32(1, cached.getUVCacheStats().shifts);
+
+  LEDSphereManager fresh;
+  initializeFullSphere(fresh);
+  fresh.setIMUPosture(0.9f, 0.1f, 0.3f, -0.2f);
+  fresh.setUIOffset(0.0f, 135.0f);
+  fresh.updateAllLEDsFromImage();
+
+  const auto &shiftedU = cached.uvUForTest();
+  const auto &shiftedV = cached.uvVForTest();
+  const auto &expectedU = fresh.uvUForTest();
+  const auto &expectedV = fresh.uvVForTest();
+  for (size_t i = 0; i < shiftedV.size(); ++i) {
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, expectedU[i], shiftedU[i]);
+    float diff = std::fabs(expectedV[i] - shiftedV[i]);
+    diff = std::fmin(diff, 2.0f * static_cast<float>(M_PI) - diff);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, diff);
+  }
+}
+
+void test_uv_cache_latitude_offset_forces_rebuild() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  manager.updateAllLEDsFromImage();
+  manager.setUIOffset(20.0f, 0.0f);
+  manager.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_UINT32(2, manager.getUVCacheStats().rebuilds);
+  TEST_ASSERT_EQUAL_UINT32(0, manager.getUVCacheStats().shifts);
+}
+
+void test_texel_lookup_matches_direct_sampling_and_rebakes_on_posture() {
+  const uint16_t w = 320, h = 160;
+  std::vector<uint8_t> pixels(static_cast<size_t>(w) * h * 3);
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    pixels[i] = static_cast<uint8_t>((i * 37) & 0xFF);
+  }
+  LEDSphere::PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+  TEST_ASSERT_TRUE(texture.buildMipChain());
+
+  LEDSphereManager direct;
+  initializeFullSphere(direct);
+  direct.setPanoramaTexture(&texture);
+  direct.setTexelLookupEnabled(false);
+
+  LEDSphereManager baked;
+  initializeFullSphere(baked);
+  baked.setPanoramaTexture(&texture);
+
+  direct.setIMUPosture(0.9f, 0.1f, 0.3f, -0.2f);
+  baked.setIMUPosture(0.9f, 0.1f, 0.3f, -0.2f);
+  direct.updateAllLEDsFromImage();
+  baked.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_MEMORY(direct.frameBufferForTest(), baked.frameBufferForTest(),
+                           sizeof(CRGB) * LEDSphereManager::LED_COUNT);
+  TEST_ASSERT_EQUAL_UINT32(1, baked.texelLookupBakeCount());
+
+  // 画像内容の更新（同解像度）では再焼き込みしない
+  pixels[0] ^= 0xFF;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+  TEST_ASSERT_TRUE(texture.buildMipChain());
+  baked.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_UINT32(1, baked.texelLookupBakeCount());
+
+  // 経度オフセット変更では再焼き込み
+  baked.setUIOffset(0.0f, 30.0f);
+  baked.updateAllLEDsFromImage();
+  TEST_ASSERT_EQUAL_UINT32(2, baked.texelLookupBakeCount());
+}
+
+void test_texel_lookup_benchmark_per_frame_us() {
+  using Clock = std::chrono::steady_clock;
+  const int frames = 300;
+  const uint16_t w = 320, h = 160;
+  std::vector<uint8_t> pixels(static_cast<size_t>(w) * h * 3, 128);
+  LEDSphere::PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  manager.setPanoramaTexture(&texture, LEDSphere::TextureFilter::kBilinear);
+
+  manager.setTexelLookupEnabled(false);
+  manager.updateAllLEDsFromImage();
+  auto directStart = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    manager.updateAllLEDsFromImage();
+  }
+  auto directEnd = Clock::now();
+
+  manager.setTexelLookupEnabled(true);
+  manager.updateAllLEDsFromImage();
+  auto bakedStart = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    manager.updateAllLEDsFromImage();
+  }
+  auto bakedEnd = Clock::now();
+
+  double directUs = std::chrono::duration<double, std::micro>(directEnd - directStart).count() / frames;
+  double bakedUs = std::chrono::duration<double, std::micro>(bakedEnd - bakedStart).count() / frames;
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "fixed pose frame: direct sample=%.1fus texel lookup=%.1fus", directUs, bakedUs);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(1, manager.texelLookupBakeCount());
+}
+
+void test_performance_stats_percentiles_and_dropped_frames() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  uint32_t fakeNow = 1000;
+  manager.setPerformanceClock([&fakeNow]() { return fakeNow; });
+  manager.setTargetFPS(30);
+
+  // 合成段階に i*100us かかるフレームを 33.333ms 周期で100回
+  const uint32_t periodUs = 33333;
+  for (uint32_t i = 1; i <= 100; ++i) {
+    manager.frameStart();
+    manager.beginStage(LEDSphere::FrameStage::kComposite);
+    fakeNow += i * 100;
+    manager.endStage(LEDSphere::FrameStage::kComposite);
+    manager.frameEnd();
+    fakeNow += periodUs - i * 100;
+  }
+
+  LEDSphere::PerformanceStats stats = manager.getPerformanceStats();
+  TEST_ASSERT_EQUAL_UINT32(100, stats.frameCount);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.droppedFrames);
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, 30.0f, stats.currentFPS);
+  TEST_ASSERT_EQUAL_UINT32(100, stats.frameTime.minUs);
+  TEST_ASSERT_EQUAL_UINT32(5050, stats.frameTime.avgUs);
+  TEST_ASSERT_EQUAL_UINT32(9500, stats.frameTime.p95Us);
+  TEST_ASSERT_EQUAL_UINT32(9900, stats.frameTime.p99Us);
+  TEST_ASSERT_EQUAL_UINT32(10000, stats.frameTime.maxUs);
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.05f, stats.averageRenderTime);
+  const auto &composite = stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kComposite)];
+  TEST_ASSERT_EQUAL_UINT32(9900, composite.p99Us);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kShow)].maxUs);
+
+  // 100msの停止 → 30fps換算で2フレーム取りこぼし
+  fakeNow += 100000 - periodUs;
+  manager.frameStart();
+  manager.frameEnd();
+  TEST_ASSERT_EQUAL_UINT32(2, manager.getPerformanceStats().droppedFrames);
+}
+
+void test_pipeline_stages_are_timed_internally() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  // 呼び出し毎に7us進む時刻源
+  uint32_t fakeNow = 0;
+  manager.setPerformanceClock([&fakeNow]() { return fakeNow += 7; });
+
+  manager.frameStart();
+  manager.updateAllLEDsFromImage();
+  manager.show();
+  manager.frameEnd();
+
+  LEDSphere::PerformanceStats stats = manager.getPerformanceStats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.frameCount);
+  TEST_ASSERT_EQUAL_UINT32(7, stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kTransform)].maxUs);
+  TEST_ASSERT_EQUAL_UINT32(7, stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kSample)].maxUs);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kComposite)].maxUs);
+  TEST_ASSERT_EQUAL_UINT32(7, stats.stageTime[static_cast<size_t>(LEDSphere::FrameStage::kShow)].maxUs);
+
+  // フレーム外で計測した段階は記録されない
+  manager.show();
+  TEST_ASSERT_EQUAL_UINT32(1, manager.getPerformanceStats().frameCount);
+}
+
+void test_frame_timings_feed_metrics_registry() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  MetricsRegistry registry;
+  manager.attachMetrics(registry);
+  uint32_t fakeNow = 0;
+  manager.setPerformanceClock([&fakeNow]() { return fakeNow; });
+
+  // 10ms描画を33ms周期で3回、その後100ms停止（2フレーム取りこぼし）
+  const uint32_t starts[] = {0, 33333, 66666, 166666};
+  for (uint32_t start : starts) {
+    fakeNow = start;
+    manager.frameStart();
+    manager.beginStage(LEDSphere::FrameStage::kComposite);
+    fakeNow += 10000;
+    manager.endStage(LEDSphere::FrameStage::kComposite);
+    manager.frameEnd();
+  }
+
+  const MetricsRegistry::Histogram::Summary frame = registry.histogram("frame_us")->drain();
+  TEST_ASSERT_EQUAL_UINT32(4, frame.count);
+  TEST_ASSERT_EQUAL_UINT32(10000, frame.max);
+  TEST_ASSERT_EQUAL_UINT32(4, registry.histogram("comp_us")->drain().count);
+  TEST_ASSERT_EQUAL_UINT32(0, registry.histogram("show_us")->drain().max);
+  TEST_ASSERT_EQUAL_UINT32(4, registry.counter("frames")->value());
+  TEST_ASSERT_EQUAL_UINT32(2, registry.counter("frame_drops")->value());
+}
+
+void test_active_led_count_tracks_framebuffer_writes() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  TEST_ASSERT_EQUAL_UINT16(0, manager.getActiveLEDCount());
+
+  manager.setLED(10, CRGB(255, 0, 0));
+  manager.setLED(11, CRGB(0, 1, 0));
+  manager.setLED(10, CRGB(0, 0, 9));  // 点灯→点灯は増減なし
+  TEST_ASSERT_EQUAL_UINT16(2, manager.getActiveLEDCount());
+  manager.setLED(11, CRGB(0, 0, 0));
+  TEST_ASSERT_EQUAL_UINT16(1, manager.getActiveLEDCount());
+  manager.clearAllLEDs();
+  TEST_ASSERT_EQUAL_UINT16(0, manager.getActiveLEDCount());
+
+  manager.updateAllLEDsFromImage();
+  const CRGB *leds = manager.frameBufferForTest();
+  uint16_t expected = 0;
+  for (size_t i = 0; i < manager.totalLedsForTest(); ++i) {
+    if (leds[i].r || leds[i].g || leds[i].b) ++expected;
+  }
+  TEST_ASSERT_TRUE(expected > 0);
+  TEST_ASSERT_EQUAL_UINT16(expected, manager.getActiveLEDCount());
+  TEST_ASSERT_EQUAL_UINT16(expected, manager.getPerformanceStats().activeLEDCount);
+}
+
+// 緯度線・経度線はインデックス経由でも全LED走査と同じLEDを点灯する（極・日付変更線付近含む）
+void test_latitude_longitude_lines_match_linear_scan() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  const auto &geometry = manager.ledGeometry();
+  const CRGB *leds = manager.frameBufferForTest();
+
+  const float latitudes[] = {-88.0f, -30.0f, 0.0f, 60.0f, 85.0f};
+  for (float latitude : latitudes) {
+    manager.clearAllLEDs();
+    manager.drawLatitudeLine(latitude, CRGB(255, 0, 0), 2);  // 許容 ±4度
+    for (const auto &led : geometry) {
+      const bool expected = std::fabs(led.latitudeDeg - latitude) <= 4.0f;
+      TEST_ASSERT_EQUAL(expected, leds[led.faceID].r != 0);
+    }
+  }
+
+  const float longitudes[] = {-179.0f, -90.0f, 0.0f, 178.0f, 300.0f};
+  for (float longitude : longitudes) {
+    manager.clearAllLEDs();
+    manager.drawLongitudeLine(longitude, CRGB(0, 0, 255), 1);  // 許容 ±4度
+    for (const auto &led : geometry) {
+      const float diff = std::fabs(std::fmod(led.longitudeDeg - longitude + 540.0f, 360.0f) - 180.0f);
+      TEST_ASSERT_EQUAL(diff <= 4.0f, leds[led.faceID].b != 0);
+    }
+  }
+}
+
+// LED毎のフットプリント（最近傍LEDとの角距離）は全ペア走査と一致する
+void test_footprint_matches_pairwise_scan() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  const auto layout = makeFibonacciLayout(LEDSphereManager::LED_COUNT);
+  const auto &footprint = manager.footprintRadForTest();
+  TEST_ASSERT_EQUAL_UINT32(layout.size(), footprint.size());
+  for (size_t i = 0; i < layout.size(); ++i) {
+    float bestDot = -1.0f;
+    for (size_t j = 0; j < layout.size(); ++j) {
+      if (j == i) continue;
+      const float dot = layout[i].x * layout[j].x + layout[i].y * layout[j].y + layout[i].z * layout[j].z;
+      bestDot = std::max(bestDot, dot);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, std::acos(std::min(bestDot, 1.0f)), footprint[i]);
+  }
+}
+
+// UV指定の検索・点灯は測地距離: 極では経度によらず同じLED、範囲は中心角で判定
+void test_uv_queries_use_geodesic_distance() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  const auto &geometry = manager.ledGeometry();
+
+  // v=1 は北極: u が何であっても最北のLED
+  uint16_t northmost = 0;
+  for (const auto &led : geometry) {
+    if (led.latitudeDeg > geometry[northmost].latitudeDeg) northmost = led.faceID;
+  }
+  TEST_ASSERT_EQUAL_UINT16(northmost, manager.findClosestLED(0.0f, 1.0f));
+  TEST_ASSERT_EQUAL_UINT16(northmost, manager.findClosestLED(0.73f, 1.0f));
+  // u は周回する
+  TEST_ASSERT_EQUAL_UINT16(manager.findClosestLED(0.25f, 0.4f), manager.findClosestLED(1.25f, 0.4f));
+
+  // 半径0.05 = 中心角9度
+  const float radiusRad = 0.05f * static_cast<float>(M_PI);
+  const std::vector<uint16_t> inRange = manager.findLEDsInRange(0.5f, 0.5f, 0.05f);  // 緯度0・経度0
+  size_t expected = 0;
+  for (const auto &led : geometry) {
+    const float len = std::sqrt(led.x * led.x + led.y * led.y + led.z * led.z);
+    if (std::acos(std::min(1.0f, led.x / len)) <= radiusRad) ++expected;
+  }
+  TEST_ASSERT_TRUE(expected > 1);
+  TEST_ASSERT_EQUAL_UINT32(expected, inRange.size());
+
+  manager.clearAllLEDs();
+  manager.setLEDByUV(0.5f, 0.5f, CRGB(0, 255, 0), 0.05f);
+  TEST_ASSERT_EQUAL_UINT16(expected, manager.getActiveLEDCount());
+  // 範囲内にLEDが無い小半径でも最寄りの1個は点灯する
+  manager.clearAllLEDs();
+  manager.setLEDByUV(0.5f, 0.5f, CRGB(0, 255, 0), 0.0001f);
+  TEST_ASSERT_EQUAL_UINT16(1, manager.getActiveLEDCount());
+}
+
+// transformToUV()（極角・方位角）の結果は toLatLonUV() を通せば検索と同じ位置を指す
+void test_transform_to_uv_converts_to_query_uv() {
+  LEDSphereManager manager;
+  initializeFullSphere(manager);
+  const auto &geometry = manager.ledGeometry();
+  size_t rawMatches = 0;
+  for (size_t i = 0; i < geometry.size(); i += 37) {
+    const auto &led = geometry[i];
+    const LEDSphere::UVCoordinate polar = manager.transformToUV(led.x, led.y, led.z);
+    const LEDSphere::UVCoordinate uv = LEDSphereManager::toLatLonUV(polar);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, (led.latitudeDeg + 90.0f) / 180.0f, uv.v);
+    TEST_ASSERT_EQUAL_UINT16(led.faceID, manager.findClosestLED(uv.u, uv.v));
+    if (manager.findClosestLED(polar.u, polar.v) == led.faceID) ++rawMatches;
+  }
+  // 変換せずに渡すと別の位置を検索してしまう
+  TEST_ASSERT_TRUE(rawMatches < 3);
+}
+
 int main(int argc, char **argv) {
   (void)argc;
   (void)argv;
@@ -51,5 +517,20 @@ int main(int argc, char **argv) {
   RUN_TEST(test_initialize_led_hardware_allocates_buffer);
   RUN_TEST(test_set_led_updates_framebuffer);
   RUN_TEST(test_show_sets_flag_under_unit_test);
+  RUN_TEST(test_image_pipeline_matches_legacy_per_led_path);
+  RUN_TEST(test_image_pipeline_benchmark_per_frame_us);
+  RUN_TEST(test_uv_cache_reused_for_resting_posture);
+  RUN_TEST(test_uv_cache_longitude_offset_shifts_without_rebuild);
+  RUN_TEST(test_uv_cache_latitude_offset_forces_rebuild);
+  RUN_TEST(test_texel_lookup_matches_direct_sampling_and_rebakes_on_posture);
+  RUN_TEST(test_texel_lookup_benchmark_per_frame_us);
+  RUN_TEST(test_performance_stats_percentiles_and_dropped_frames);
+  RUN_TEST(test_pipeline_stages_are_timed_internally);
+  RUN_TEST(test_frame_timings_feed_metrics_registry);
+  RUN_TEST(test_active_led_count_tracks_framebuffer_writes);
+  RUN_TEST(test_latitude_longitude_lines_match_linear_scan);
+  RUN_TEST(test_uv_queries_use_geodesic_distance);
+  RUN_TEST(test_footprint_matches_pairwise_scan);
+  RUN_TEST(test_transform_to_uv_converts_to_query_uv);
   return UNITY_END();
 }
@@ -0,0 +1,244 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "mqtt/LiveFrameProtocol.h"
+#include "../../src/led/FramePack.cpp"
+#include "../../src/mqtt/LiveFrameProtocol.cpp"
+
+namespace {
+
+constexpr uint16_t kLeds = live::kDefaultLedCount;
+
+// ゆっくり変化するシーン: 固定グラデーション背景の上を光点が1フレーム1LEDずつ移動
+std::vector<uint8_t> slowScene(uint32_t frame) {
+  std::vector<uint8_t> rgb(kLeds * 3);
+  for (uint32_t i = 0; i < kLeds; ++i) {
+    rgb[i * 3 + 0] = static_cast<uint8_t>(i / 40);
+    rgb[i * 3 + 1] = 8;
+    rgb[i * 3 + 2] = static_cast<uint8_t>(20 - i / 40);
+  }
+  for (uint32_t k = 0; k < 5; ++k) {
+    const uint32_t led = (frame + k) % kLeds;
+    rgb[led * 3 + 0] = 255;
+    rgb[led * 3 + 1] = static_cast<uint8_t>(200 - k * 30);
+    rgb[led * 3 + 2] = 40;
+  }
+  return rgb;
+}
+
+// 全LEDが毎回変わるフレーム（シーンチェンジ）
+std::vector<uint8_t> noiseFrame(uint32_t seed) {
+  std::vector<uint8_t> rgb(kLeds * 3);
+  uint32_t state = seed * 2654435761u + 1;
+  for (uint8_t &value : rgb) {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<uint8_t>(state >> 24);
+  }
+  return rgb;
+}
+
+}  // namespace
+
+void test_live_header_round_trip_and_validation() {
+  live::Header header;
+  header.encoding = LEDSphere::FrameEncoding::kDelta;
+  header.sequence = 0x1234;
+  header.keyframe = 0x1200;
+  header.ledCount = kLeds;
+  uint8_t bytes[live::kHeaderSize];
+  TEST_ASSERT_EQUAL(live::kHeaderSize, live::writeHeader(header, bytes, sizeof(bytes)));
+  TEST_ASSERT_EQUAL_UINT8('L', bytes[0]);
+  TEST_ASSERT_EQUAL_UINT8('V', bytes[1]);
+  // リトルエンディアン固定
+  TEST_ASSERT_EQUAL_UINT8(0x34, bytes[4]);
+  TEST_ASSERT_EQUAL_UINT8(0x12, bytes[5]);
+
+  live::Header parsed;
+  TEST_ASSERT_TRUE(live::readHeader(bytes, sizeof(bytes), parsed));
+  TEST_ASSERT_EQUAL_UINT16(0x1234, parsed.sequence);
+  TEST_ASSERT_EQUAL_UINT16(0x1200, parsed.keyframe);
+  TEST_ASSERT_EQUAL_UINT16(kLeds, parsed.ledCount);
+  TEST_ASSERT_FALSE(parsed.isKeyframe());
+
+  TEST_ASSERT_FALSE(live::readHeader(bytes, live::kHeaderSize - 1, parsed));
+  // キーフレームがデルタを名乗るのは不正
+  header.keyframe = header.sequence;
+  live::writeHeader(header, bytes, sizeof(bytes));
+  TEST_ASSERT_FALSE(live::readHeader(bytes, sizeof(bytes), parsed));
+  bytes[3] = 7;  // 未知の符号化
+  TEST_ASSERT_FALSE(live::readHeader(bytes, sizeof(bytes), parsed));
+}
+
+void test_live_slow_scene_streams_small_deltas() {
+  live::Encoder encoder(kLeds, 30);
+  live::Decoder decoder(kLeds);
+  std::vector<uint8_t> message;
+  size_t keyframes = 0;
+  size_t keyframeBytes = 0;
+  size_t deltaBytes = 0;
+  size_t maxDelta = 0;
+  constexpr uint32_t kFrames = 90;  // 30fpsで3秒
+
+  for (uint32_t frame = 0; frame < kFrames; ++frame) {
+    const std::vector<uint8_t> rgb = slowScene(frame);
+    const bool keyframe = encoder.encode(rgb.data(), message);
+    if (keyframe) {
+      ++keyframes;
+      keyframeBytes += message.size();
+    } else {
+      deltaBytes += message.size();
+      maxDelta = std::max(maxDelta, message.size());
+    }
+    TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kFrame);
+    TEST_ASSERT_EQUAL_MEMORY(rgb.data(), decoder.frame(), rgb.size());
+  }
+
+  // 先頭と30フレーム毎のキーフレームのみ
+  TEST_ASSERT_EQUAL_UINT32(3, keyframes);
+  // キーフレーム基準のデルタは、キーフレームから離れるほど大きくなるが数十バイトに収まる
+  TEST_ASSERT_TRUE(maxDelta < 200);
+  const size_t average = (keyframeBytes + deltaBytes) / kFrames;
+  TEST_ASSERT_TRUE(average < 300);
+  char msg[128];
+  std::snprintf(msg, sizeof(msg), "raw %u B/frame -> average %u B (keyframe %u B, max delta %u B)",
+                static_cast<unsigned>(kLeds * 3), static_cast<unsigned>(average),
+                static_cast<unsigned>(keyframeBytes / keyframes), static_cast<unsigned>(maxDelta));
+  TEST_MESSAGE(msg);
+
+  const live::Decoder::Stats stats = decoder.stats();
+  TEST_ASSERT_EQUAL_UINT32(kFrames, stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.lost);
+}
+
+void test_live_lost_deltas_do_not_need_a_keyframe() {
+  live::Encoder encoder(kLeds, 0);
+  live::Decoder decoder(kLeds);
+  std::vector<uint8_t> message;
+  for (uint32_t frame = 0; frame < 20; ++frame) {
+    const std::vector<uint8_t> rgb = slowScene(frame);
+    encoder.encode(rgb.data(), message);
+    // QoS 0 で 3フレームに1つ失われる（先頭のキーフレームは届く）
+    if (frame % 3 == 2) {
+      continue;
+    }
+    TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kFrame);
+    TEST_ASSERT_EQUAL_MEMORY(rgb.data(), decoder.frame(), rgb.size());
+  }
+  // 失われたデルタは後続フレームに影響しない
+  TEST_ASSERT_EQUAL_UINT32(6, decoder.stats().lost);
+  TEST_ASSERT_EQUAL_UINT32(0, decoder.stats().missingKeyframe);
+}
+
+void test_live_lost_keyframe_is_requested_and_recovered() {
+  live::Encoder encoder(kLeds, 10);
+  live::Decoder decoder(kLeds);
+  std::vector<uint8_t> message;
+  uint32_t frame = 0;
+  for (; frame < 10; ++frame) {
+    const std::vector<uint8_t> rgb = slowScene(frame);
+    encoder.encode(rgb.data(), message);
+    decoder.decode(message.data(), message.size());
+  }
+
+  // 定期キーフレーム（frame 10）を落とす
+  std::vector<uint8_t> rgb = slowScene(frame++);
+  TEST_ASSERT_TRUE(encoder.encode(rgb.data(), message));
+
+  // 以降のデルタは参照先が無いのでキーフレーム要求になる
+  rgb = slowScene(frame++);
+  TEST_ASSERT_FALSE(encoder.encode(rgb.data(), message));
+  TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kNeedKeyframe);
+  TEST_ASSERT_EQUAL_UINT32(1, decoder.stats().lost);
+  TEST_ASSERT_EQUAL_UINT32(1, decoder.stats().missingKeyframe);
+
+  // 送信側が要求に応じて次をキーフレームにする
+  encoder.requestKeyframe();
+  rgb = slowScene(frame++);
+  TEST_ASSERT_TRUE(encoder.encode(rgb.data(), message));
+  TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_EQUAL_MEMORY(rgb.data(), decoder.frame(), rgb.size());
+
+  rgb = slowScene(frame++);
+  encoder.encode(rgb.data(), message);
+  TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_EQUAL_MEMORY(rgb.data(), decoder.frame(), rgb.size());
+}
+
+void test_live_scene_cut_sends_keyframe() {
+  live::Encoder encoder(kLeds, 0);
+  std::vector<uint8_t> message;
+  std::vector<uint8_t> rgb = slowScene(0);
+  TEST_ASSERT_TRUE(encoder.encode(rgb.data(), message));
+  rgb = slowScene(1);
+  TEST_ASSERT_FALSE(encoder.encode(rgb.data(), message));
+
+  // 全LEDが変わるとデルタはキーフレームより大きくなるので、キーフレームに切り替わる
+  rgb = noiseFrame(1);
+  TEST_ASSERT_TRUE(encoder.encode(rgb.data(), message));
+  TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(LEDSphere::FrameEncoding::kRaw), message[3]);
+  TEST_ASSERT_EQUAL(live::kHeaderSize + kLeds * 3, message.size());
+
+  live::Decoder decoder(kLeds);
+  TEST_ASSERT_TRUE(decoder.decode(message.data(), message.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_EQUAL_MEMORY(rgb.data(), decoder.frame(), rgb.size());
+}
+
+void test_live_rejects_stale_corrupt_and_mismatched_frames() {
+  live::Encoder encoder(kLeds, 0);
+  live::Decoder decoder(kLeds);
+  std::vector<uint8_t> keyframe;
+  std::vector<uint8_t> delta;
+  const std::vector<uint8_t> first = slowScene(0);
+  encoder.encode(first.data(), keyframe);
+  const std::vector<uint8_t> second = slowScene(1);
+  encoder.encode(second.data(), delta);
+
+  TEST_ASSERT_TRUE(decoder.decode(keyframe.data(), keyframe.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_TRUE(decoder.decode(delta.data(), delta.size()) == live::Decoder::Result::kFrame);
+  // 重複・遅延したフレームは捨てる
+  TEST_ASSERT_TRUE(decoder.decode(delta.data(), delta.size()) == live::Decoder::Result::kStale);
+  TEST_ASSERT_TRUE(decoder.decode(keyframe.data(), keyframe.size()) == live::Decoder::Result::kStale);
+  TEST_ASSERT_EQUAL_UINT32(2, decoder.stats().stale);
+
+  // 壊れたデルタは不正扱い。次のフレームはキーフレームから復元されるので影響しない
+  std::vector<uint8_t> next;
+  const std::vector<uint8_t> third = slowScene(2);
+  encoder.encode(third.data(), next);
+  std::vector<uint8_t> truncated(next.begin(), next.end() - 1);
+  TEST_ASSERT_TRUE(decoder.decode(truncated.data(), truncated.size()) == live::Decoder::Result::kInvalid);
+  const std::vector<uint8_t> fourth = slowScene(3);
+  encoder.encode(fourth.data(), next);
+  TEST_ASSERT_TRUE(decoder.decode(next.data(), next.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_EQUAL_MEMORY(fourth.data(), decoder.frame(), fourth.size());
+
+  // LED数の異なるストリーム
+  live::Decoder small(400);
+  TEST_ASSERT_TRUE(small.decode(keyframe.data(), keyframe.size()) == live::Decoder::Result::kInvalid);
+
+  // 送信側の再起動（番号が0に戻る）は受け入れる
+  for (uint32_t i = 0; i < 1500; ++i) {
+    encoder.encode(fourth.data(), next);
+    decoder.decode(next.data(), next.size());
+  }
+  live::Encoder restarted(kLeds, 0);
+  restarted.encode(first.data(), next);
+  TEST_ASSERT_TRUE(decoder.decode(next.data(), next.size()) == live::Decoder::Result::kFrame);
+  TEST_ASSERT_EQUAL_MEMORY(first.data(), decoder.frame(), first.size());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_live_header_round_trip_and_validation);
+  RUN_TEST(test_live_slow_scene_streams_small_deltas);
+  RUN_TEST(test_live_lost_deltas_do_not_need_a_keyframe);
+  RUN_TEST(test_live_lost_keyframe_is_requested_and_recovered);
+  RUN_TEST(test_live_scene_cut_sends_keyframe);
+  RUN_TEST(test_live_rejects_stale_corrupt_and_mismatched_frames);
+  return UNITY_END();
+}
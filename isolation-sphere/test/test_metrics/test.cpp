@@ -0,0 +1,150 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "core/MetricsRegistry.h"
+#include "../../src/core/MetricsRegistry.cpp"
+
+// 同名・同種の登録は同じ実体を返し、種類違いや不正な名前は拒否する
+void test_registration_is_idempotent_and_validated() {
+  MetricsRegistry registry;
+  MetricsRegistry::Counter *frames = registry.counter("frames");
+  TEST_ASSERT_NOT_NULL(frames);
+  TEST_ASSERT_TRUE(frames == registry.counter("frames"));
+  TEST_ASSERT_NULL(registry.gauge("frames"));
+  TEST_ASSERT_NULL(registry.counter("Frames"));
+  TEST_ASSERT_NULL(registry.counter("has space"));
+  TEST_ASSERT_NULL(registry.counter("name_is_far_too_long"));
+  TEST_ASSERT_NOT_NULL(registry.counter("exactly_15_char"));
+  TEST_ASSERT_EQUAL_UINT32(2, registry.metricCount());
+
+  for (size_t i = 0; i < MetricsRegistry::kMaxHistograms; ++i) {
+    std::string name = "h" + std::to_string(i);
+    TEST_ASSERT_NOT_NULL(registry.histogram(name.c_str()));
+  }
+  TEST_ASSERT_NULL(registry.histogram("one_more"));
+}
+
+// バケット境界: 8未満は厳密、それ以上は1オクターブ4分割
+void test_histogram_buckets_are_log_linear() {
+  using H = MetricsRegistry::Histogram;
+  for (uint32_t v = 0; v < 8; ++v) {
+    TEST_ASSERT_EQUAL_UINT32(v, H::bucketIndex(v));
+  }
+  TEST_ASSERT_EQUAL_UINT32(8, H::bucketIndex(8));
+  TEST_ASSERT_EQUAL_UINT32(8, H::bucketIndex(9));
+  TEST_ASSERT_EQUAL_UINT32(9, H::bucketIndex(10));
+  TEST_ASSERT_EQUAL_UINT32(H::kBucketCount - 1, H::bucketIndex(H::kRangeLimit - 1));
+  TEST_ASSERT_EQUAL_UINT32(H::kBucketCount - 1, H::bucketIndex(0xFFFFFFFFu));
+
+  // 各値は自分のバケット上限以下、かつ上限は値の1.25倍以内
+  for (uint32_t v = 1; v < H::kRangeLimit; v += 37) {
+    const uint32_t bound = H::bucketUpperBound(H::bucketIndex(v));
+    TEST_ASSERT_TRUE(bound >= v);
+    TEST_ASSERT_TRUE(bound <= v + v / 4);
+  }
+}
+
+// 33ms周期のフレームに時々の遅延: p95/p99で遅いフレームが見える、drainで窓がリセット
+void test_histogram_summary_and_drain() {
+  MetricsRegistry registry;
+  MetricsRegistry::Histogram *frameUs = registry.histogram("frame_us");
+  for (int i = 0; i < 95; ++i) {
+    frameUs->record(20000);
+  }
+  for (int i = 0; i < 5; ++i) {
+    frameUs->record(60000);
+  }
+  const MetricsRegistry::Histogram::Summary summary = frameUs->drain();
+  TEST_ASSERT_EQUAL_UINT32(100, summary.count);
+  TEST_ASSERT_EQUAL_UINT32(22000, summary.avg);
+  TEST_ASSERT_UINT32_WITHIN(20000 / 4, 20000, summary.p50);
+  TEST_ASSERT_UINT32_WITHIN(20000 / 4, 20000, summary.p95);
+  TEST_ASSERT_EQUAL_UINT32(60000, summary.p99);
+  TEST_ASSERT_EQUAL_UINT32(60000, summary.max);
+
+  const MetricsRegistry::Histogram::Summary empty = frameUs->drain();
+  TEST_ASSERT_EQUAL_UINT32(0, empty.count);
+  TEST_ASSERT_EQUAL_UINT32(0, empty.max);
+}
+
+// 1回のserializeで全種類がまとまり、samplerが直前に値を反映する
+void test_serialize_batches_all_metrics() {
+  MetricsRegistry registry;
+  MetricsRegistry::Counter *imuReads = registry.counter("imu_reads", MetricsRegistry::CounterRate::kPerSecond);
+  MetricsRegistry::Counter *dropped = registry.counter("img_drop");
+  MetricsRegistry::Gauge *heap = registry.gauge("heap_free");
+  MetricsRegistry::Gauge *fps = registry.gauge("fps");
+  MetricsRegistry::Histogram *showUs = registry.histogram("show_us");
+  uint32_t externalDrops = 3;
+  TEST_ASSERT_TRUE(registry.addSampler([&]() {
+    dropped->set(externalDrops);
+    heap->set(123456.0f);
+  }));
+
+  std::string payload;
+  imuReads->add(10);
+  fps->set(29.75f);
+  registry.serialize(payload, 1000);
+  // 初回は窓長が無いのでrateは出さない、空のヒストグラムも件数0で出る
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"t\":1000,\"dt\":0,\"c\":{\"imu_reads\":10,\"img_drop\":3},"
+      "\"g\":{\"heap_free\":123456,\"fps\":29.75},\"h\":{\"show_us\":[0,0,0,0,0,0]}}",
+      payload.c_str());
+
+  imuReads->add(500);
+  externalDrops = 7;
+  showUs->record(1500);
+  registry.serialize(payload, 6000);
+  TEST_ASSERT_EQUAL_STRING(
+      "{\"t\":6000,\"dt\":5000,\"c\":{\"imu_reads\":510,\"img_drop\":7},\"r\":{\"imu_reads\":100},"
+      "\"g\":{\"heap_free\":123456,\"fps\":29.75},\"h\":{\"show_us\":[1,1500,1500,1500,1500,1500]}}",
+      payload.c_str());
+}
+
+void test_empty_registry_serializes_header_only() {
+  MetricsRegistry registry;
+  std::string payload;
+  registry.serialize(payload, 42);
+  TEST_ASSERT_EQUAL_STRING("{\"t\":42,\"dt\":0}", payload.c_str());
+}
+
+// 別スレッドからの更新は失われない（更新側はロックを取らない）
+void test_concurrent_updates_are_not_lost() {
+  MetricsRegistry registry;
+  MetricsRegistry::Counter *packets = registry.counter("packets");
+  MetricsRegistry::Histogram *latency = registry.histogram("latency_us");
+  constexpr int kPerThread = 20000;
+  auto worker = [&](uint32_t base) {
+    for (int i = 0; i < kPerThread; ++i) {
+      packets->add();
+      latency->record(base + static_cast<uint32_t>(i % 100));
+    }
+  };
+  std::thread a(worker, 100);
+  std::thread b(worker, 5000);
+  uint32_t drained = 0;
+  for (int i = 0; i < 50; ++i) {
+    drained += latency->drain().count;
+  }
+  a.join();
+  b.join();
+  drained += latency->drain().count;
+  TEST_ASSERT_EQUAL_UINT32(2 * kPerThread, packets->value());
+  TEST_ASSERT_EQUAL_UINT32(2 * kPerThread, drained);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_registration_is_idempotent_and_validated);
+  RUN_TEST(test_histogram_buckets_are_log_linear);
+  RUN_TEST(test_histogram_summary_and_drain);
+  RUN_TEST(test_serialize_batches_all_metrics);
+  RUN_TEST(test_empty_registry_serializes_header_only);
+  RUN_TEST(test_concurrent_updates_are_not_lost);
+  return UNITY_END();
+}
@@ -0,0 +1,596 @@
+#include <unity.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mqtt/MqttBroker.h"
+#include "mqtt/TopicTrie.h"
+#include "../../src/mqtt/TopicRouter.cpp"
+#include "../../src/mqtt/TopicTrie.cpp"
+#include "../../src/mqtt/MqttBroker.cpp"
+
+namespace {
+
+// 画像1フレーム相当（sphere/+/image）
+constexpr size_t kImageBytes = 96 * 1024;
+constexpr size_t kUnlimited = static_cast<size_t>(-1);
+
+// ブローカーが所有するソケットとテストの間で共有する回線状態
+struct Wire {
+  std::vector<uint8_t> inbound;  // クライアント→ブローカー
+  size_t readPos = 0;
+  std::vector<uint8_t> outbound;  // ブローカー→クライアント
+  size_t writeBudget = kUnlimited;  // 残り書き込み可能バイト（0で輻輳）
+  bool open = true;
+  bool closed = false;
+};
+
+class FakeSocket : public MqttBroker::Connection {
+ public:
+  explicit FakeSocket(std::shared_ptr<Wire> wire) : wire_(std::move(wire)) {}
+
+  size_t available() override { return wire_->inbound.size() - wire_->readPos; }
+  size_t read(uint8_t *buffer, size_t length) override {
+    const size_t n = std::min(length, available());
+    std::memcpy(buffer, wire_->inbound.data() + wire_->readPos, n);
+    wire_->readPos += n;
+    return n;
+  }
+  size_t write(const uint8_t *data, size_t length) override {
+    const size_t n = std::min(length, wire_->writeBudget);
+    if (wire_->writeBudget != kUnlimited) {
+      wire_->writeBudget -= n;
+    }
+    wire_->outbound.insert(wire_->outbound.end(), data, data + n);
+    return n;
+  }
+  bool connected() override { return wire_->open; }
+  void close() override {
+    wire_->open = false;
+    wire_->closed = true;
+  }
+
+ private:
+  std::shared_ptr<Wire> wire_;
+};
+
+// --- クライアント側パケット生成 ---------------------------------------
+
+void putLength(std::vector<uint8_t> &out, size_t value) {
+  do {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value) byte |= 0x80;
+    out.push_back(byte);
+  } while (value);
+}
+
+void putString(std::vector<uint8_t> &out, const std::string &text) {
+  out.push_back(static_cast<uint8_t>(text.size() >> 8));
+  out.push_back(static_cast<uint8_t>(text.size() & 0xFF));
+  out.insert(out.end(), text.begin(), text.end());
+}
+
+void putPacket(std::vector<uint8_t> &out, uint8_t first, const std::vector<uint8_t> &body) {
+  out.push_back(first);
+  putLength(out, body.size());
+  out.insert(out.end(), body.begin(), body.end());
+}
+
+void connectPacket(std::vector<uint8_t> &out, const std::string &clientId, uint16_t keepAlive = 60) {
+  std::vector<uint8_t> body;
+  putString(body, "MQTT");
+  body.push_back(4);     // protocol level
+  body.push_back(0x02);  // clean session
+  body.push_back(static_cast<uint8_t>(keepAlive >> 8));
+  body.push_back(static_cast<uint8_t>(keepAlive & 0xFF));
+  putString(body, clientId);
+  putPacket(out, 0x10, body);
+}
+
+void subscribePacket(std::vector<uint8_t> &out, uint16_t packetId, const std::vector<std::string> &filters) {
+  std::vector<uint8_t> body = {static_cast<uint8_t>(packetId >> 8), static_cast<uint8_t>(packetId & 0xFF)};
+  for (const std::string &filter : filters) {
+    putString(body, filter);
+    body.push_back(1);  // 要求QoS（ブローカーはQoS 0で許可）
+  }
+  putPacket(out, 0x82, body);
+}
+
+void publishPacket(std::vector<uint8_t> &out, const std::string &topic, const std::vector<uint8_t> &payload,
+                   uint8_t qos = 0, bool retain = false, uint16_t packetId = 1) {
+  std::vector<uint8_t> body;
+  putString(body, topic);
+  if (qos > 0) {
+    body.push_back(static_cast<uint8_t>(packetId >> 8));
+    body.push_back(static_cast<uint8_t>(packetId & 0xFF));
+  }
+  body.insert(body.end(), payload.begin(), payload.end());
+  putPacket(out, static_cast<uint8_t>(0x30 | (qos << 1) | (retain ? 1 : 0)), body);
+}
+
+// 先頭4バイトにフレーム番号を埋めた画像ペイロード
+std::vector<uint8_t> imagePayload(uint32_t frame, size_t bytes = kImageBytes) {
+  std::vector<uint8_t> payload(bytes);
+  for (size_t i = 0; i < bytes; ++i) {
+    payload[i] = static_cast<uint8_t>(i * 31 + frame);
+  }
+  std::memcpy(payload.data(), &frame, sizeof(frame));
+  return payload;
+}
+
+// --- ブローカー→クライアントのストリーム解析 --------------------------
+
+struct Received {
+  uint8_t type = 0;
+  uint8_t flags = 0;
+  std::string topic;
+  size_t payloadSize = 0;
+  uint32_t marker = 0;  // 先頭4バイト
+  std::vector<uint8_t> body;
+};
+
+// 受信済みバイトから完全なパケットを取り出す（不完全な末尾は残す）
+struct StreamDecoder {
+  std::vector<uint8_t> pending;
+  std::vector<Received> packets;
+  bool keepBodies = true;
+  bool malformed = false;
+
+  void drain(Wire &wire) {
+    pending.insert(pending.end(), wire.outbound.begin(), wire.outbound.end());
+    wire.outbound.clear();
+    size_t pos = 0;
+    while (pos < pending.size()) {
+      size_t lengthPos = pos + 1;
+      size_t remaining = 0;
+      size_t shift = 0;
+      bool complete = false;
+      while (lengthPos < pending.size() && lengthPos - pos <= 4) {
+        const uint8_t byte = pending[lengthPos++];
+        remaining |= static_cast<size_t>(byte & 0x7F) << shift;
+        shift += 7;
+        if ((byte & 0x80) == 0) {
+          complete = true;
+          break;
+        }
+      }
+      if (!complete || lengthPos + remaining > pending.size()) {
+        break;
+      }
+      Received packet;
+      packet.type = pending[pos] >> 4;
+      packet.flags = pending[pos] & 0x0F;
+      const uint8_t *body = pending.data() + lengthPos;
+      if (packet.type == 3) {
+        const size_t topicLength = (body[0] << 8) | body[1];
+        if (topicLength + 2 > remaining) {
+          malformed = true;
+          return;
+        }
+        packet.topic.assign(reinterpret_cast<const char *>(body + 2), topicLength);
+        packet.payloadSize = remaining - 2 - topicLength;
+        if (packet.payloadSize >= 4) {
+          std::memcpy(&packet.marker, body + 2 + topicLength, 4);
+        }
+        if (keepBodies) {
+          packet.body.assign(body + 2 + topicLength, body + remaining);
+        }
+      } else {
+        packet.body.assign(body, body + remaining);
+      }
+      packets.push_back(std::move(packet));
+      pos = lengthPos + remaining;
+    }
+    pending.erase(pending.begin(), pending.begin() + pos);
+  }
+
+  size_t count(uint8_t type) const {
+    size_t n = 0;
+    for (const Received &packet : packets) {
+      if (packet.type == type) ++n;
+    }
+    return n;
+  }
+};
+
+struct TestClient {
+  std::shared_ptr<Wire> wire = std::make_shared<Wire>();
+  StreamDecoder decoder;
+};
+
+void attach(MqttBroker &broker, TestClient &client, uint32_t nowMs) {
+  broker.acceptConnection(std::unique_ptr<MqttBroker::Connection>(new FakeSocket(client.wire)), nowMs);
+}
+
+// 接続して購読まで済ませる
+void connectAndSubscribe(MqttBroker &broker, TestClient &client, const std::string &id,
+                         const std::vector<std::string> &filters, uint32_t nowMs) {
+  attach(broker, client, nowMs);
+  connectPacket(client.wire->inbound, id);
+  if (!filters.empty()) {
+    subscribePacket(client.wire->inbound, 1, filters);
+  }
+  broker.service(nowMs);
+  client.decoder.drain(*client.wire);
+}
+
+}  // namespace
+
+void test_trie_matches_wildcards_once_per_subscriber() {
+  TopicTrie trie;
+  TEST_ASSERT_TRUE(trie.subscribe("sphere/001/image", 0));
+  TEST_ASSERT_TRUE(trie.subscribe("sphere/+/image", 1));
+  TEST_ASSERT_TRUE(trie.subscribe("sphere/#", 2));
+  TEST_ASSERT_TRUE(trie.subscribe("#", 3));
+  TEST_ASSERT_TRUE(trie.subscribe("+/+/ui", 4));
+  TEST_ASSERT_TRUE(trie.subscribe("$SYS/#", 5));
+  // 同じ購読者が複数フィルタで一致しても1回だけ
+  TEST_ASSERT_TRUE(trie.subscribe("sphere/001/+", 0));
+  TEST_ASSERT_EQUAL_UINT32(7, trie.subscriptionCount());
+
+  TEST_ASSERT_EQUAL_UINT32(0x0F, trie.match("sphere/001/image"));
+  TEST_ASSERT_EQUAL_UINT32(0x0E, trie.match("sphere/002/image"));
+  TEST_ASSERT_EQUAL_UINT32(0x1C, trie.match("sphere/002/ui"));
+  // "sphere/#" は親レベル "sphere" にも一致
+  TEST_ASSERT_EQUAL_UINT32(0x0C, trie.match("sphere"));
+  TEST_ASSERT_EQUAL_UINT32(0x08, trie.match("system/all/sync"));
+  // '$'始まりのトピックは先頭のワイルドカードに一致しない
+  TEST_ASSERT_EQUAL_UINT32(0x20, trie.match("$SYS/broker/clients"));
+  TEST_ASSERT_EQUAL_UINT32(0, trie.match(""));
+
+  TEST_ASSERT_FALSE(trie.subscribe("", 6));
+  TEST_ASSERT_FALSE(trie.subscribe("sphere/#/image", 6));
+  TEST_ASSERT_FALSE(trie.subscribe("sphere/0+", 6));
+  TEST_ASSERT_FALSE(trie.subscribe("sphere/#x", 6));
+  TEST_ASSERT_FALSE(trie.subscribe("sphere/ui", TopicTrie::kMaxSubscribers));
+  TEST_ASSERT_FALSE(TopicTrie::isValidTopic("sphere/+/ui", 11));
+  TEST_ASSERT_TRUE(TopicTrie::matches("sphere/+/ui", "sphere/001/ui", 13));
+  TEST_ASSERT_FALSE(TopicTrie::matches("#", "$SYS/uptime", 11));
+}
+
+void test_trie_unsubscribe_prunes_empty_branches() {
+  TopicTrie trie;
+  trie.subscribe("sphere/001/image", 0);
+  trie.subscribe("sphere/+/ui", 1);
+  trie.subscribe("sphere/+/ui", 2);
+  trie.subscribe("joystick/#", 2);
+  const size_t nodes = trie.nodeCount();
+
+  TEST_ASSERT_TRUE(trie.unsubscribe("sphere/+/ui", 1));
+  TEST_ASSERT_FALSE(trie.unsubscribe("sphere/+/ui", 1));
+  TEST_ASSERT_FALSE(trie.unsubscribe("sphere/002/image", 0));
+  TEST_ASSERT_EQUAL_UINT32(0x04, trie.match("sphere/003/ui"));
+  TEST_ASSERT_EQUAL_UINT32(nodes, trie.nodeCount());
+
+  // 切断時の一括削除で、使われなくなった枝は回収される
+  trie.removeSubscriber(2);
+  TEST_ASSERT_EQUAL_UINT32(0, trie.match("sphere/003/ui"));
+  TEST_ASSERT_EQUAL_UINT32(0, trie.match("joystick/state"));
+  TEST_ASSERT_EQUAL_UINT32(1, trie.subscriptionCount());
+  TEST_ASSERT_EQUAL_UINT32(4, trie.nodeCount());  // root, sphere, 001, image
+
+  TEST_ASSERT_TRUE(trie.unsubscribe("sphere/001/image", 0));
+  TEST_ASSERT_EQUAL_UINT32(1, trie.nodeCount());
+  // 解放したノードは再利用される
+  TEST_ASSERT_TRUE(trie.subscribe("a/b/c", 3));
+  TEST_ASSERT_EQUAL_UINT32(0x08, trie.match("a/b/c"));
+  TEST_ASSERT_EQUAL_UINT32(4, trie.nodeCount());
+}
+
+void test_broker_connect_subscribe_publish_roundtrip() {
+  MqttBroker broker;
+  TEST_ASSERT_TRUE(broker.start());
+  TestClient sphere;
+  TestClient joystick;
+  connectAndSubscribe(broker, sphere, "sphere-001", {"sphere/+/ui", "bad/#/filter"}, 0);
+  connectAndSubscribe(broker, joystick, "joystick", {}, 0);
+
+  // CONNACK + SUBACK（2つ目のフィルタは不正で0x80）
+  TEST_ASSERT_EQUAL_UINT32(2, sphere.decoder.packets.size());
+  TEST_ASSERT_EQUAL_UINT8(2, sphere.decoder.packets[0].type);
+  TEST_ASSERT_EQUAL_UINT8(0, sphere.decoder.packets[0].body[1]);
+  TEST_ASSERT_EQUAL_UINT8(9, sphere.decoder.packets[1].type);
+  TEST_ASSERT_EQUAL_UINT32(4, sphere.decoder.packets[1].body.size());
+  TEST_ASSERT_EQUAL_UINT8(0x00, sphere.decoder.packets[1].body[2]);
+  TEST_ASSERT_EQUAL_UINT8(0x80, sphere.decoder.packets[1].body[3]);
+  TEST_ASSERT_EQUAL_INT(2, broker.getConnectedClients());
+
+  // QoS 0 と QoS 1。QoS 1 は残り長128→126でヘッダが1バイト縮む境界
+  const std::vector<uint8_t> small = {'{', '}'};
+  const std::vector<uint8_t> boundary = imagePayload(7, 111);
+  publishPacket(joystick.wire->inbound, "sphere/001/ui", small);
+  publishPacket(joystick.wire->inbound, "sphere/001/ui", boundary, 1, false, 0x1234);
+  publishPacket(joystick.wire->inbound, "sphere/001/image", small);  // 購読外
+  joystick.wire->inbound.push_back(0xC0);  // PINGREQ
+  joystick.wire->inbound.push_back(0x00);
+  broker.service(10);
+  sphere.decoder.drain(*sphere.wire);
+  joystick.decoder.drain(*joystick.wire);
+
+  TEST_ASSERT_FALSE(sphere.decoder.malformed);
+  TEST_ASSERT_EQUAL_UINT32(4, sphere.decoder.packets.size());
+  const Received &first = sphere.decoder.packets[2];
+  const Received &second = sphere.decoder.packets[3];
+  TEST_ASSERT_EQUAL_UINT8(3, first.type);
+  TEST_ASSERT_EQUAL_UINT8(0, first.flags);
+  TEST_ASSERT_EQUAL_STRING("sphere/001/ui", first.topic.c_str());
+  TEST_ASSERT_TRUE(first.body == small);
+  TEST_ASSERT_EQUAL_UINT8(0, second.flags);  // QoS 0で配信
+  TEST_ASSERT_TRUE(second.body == boundary);
+
+  // 送信側には CONNACK, PUBACK(0x1234), PINGRESP
+  TEST_ASSERT_EQUAL_UINT32(3, joystick.decoder.packets.size());
+  TEST_ASSERT_EQUAL_UINT8(4, joystick.decoder.packets[1].type);
+  TEST_ASSERT_EQUAL_UINT8(0x12, joystick.decoder.packets[1].body[0]);
+  TEST_ASSERT_EQUAL_UINT8(0x34, joystick.decoder.packets[1].body[1]);
+  TEST_ASSERT_EQUAL_UINT8(13, joystick.decoder.packets[2].type);
+
+  const MqttBroker::Stats stats = broker.getStats();
+  TEST_ASSERT_EQUAL_INT(3, stats.totalMessages);
+  TEST_ASSERT_EQUAL_UINT32(2, stats.deliveries);
+  TEST_ASSERT_EQUAL_UINT32(1, stats.subscriptions);
+}
+
+void test_broker_retained_messages() {
+  MqttBroker broker;
+  broker.start();
+  TEST_ASSERT_TRUE(broker.publishSystemStatus("{\"state\":\"ready\"}"));
+  TEST_ASSERT_TRUE(broker.publishWiFiClients(3));
+  TEST_ASSERT_EQUAL_INT(2, broker.getStats().activeTopics);
+
+  // 後から購読したクライアントにも RETAIN=1 で届く
+  TestClient monitor;
+  connectAndSubscribe(broker, monitor, "monitor", {"joystick/system/+"}, 0);
+  TEST_ASSERT_EQUAL_UINT32(2, monitor.decoder.count(3));
+  TEST_ASSERT_EQUAL_UINT8(1, monitor.decoder.packets[2].flags);
+  TEST_ASSERT_EQUAL_STRING("joystick/system/status", monitor.decoder.packets[2].topic.c_str());
+
+  // 既存購読者へのライブ配信は RETAIN=0
+  broker.publishSystemStatus("{\"state\":\"busy\"}");
+  broker.service(1);
+  monitor.decoder.drain(*monitor.wire);
+  TEST_ASSERT_EQUAL_UINT8(0, monitor.decoder.packets.back().flags);
+  TEST_ASSERT_EQUAL_INT(2, broker.getStats().activeTopics);
+
+  // 空ペイロードの retained で削除
+  broker.publish("joystick/system/status", "", true);
+  TEST_ASSERT_EQUAL_INT(1, broker.getStats().activeTopics);
+}
+
+void test_broker_fanout_shares_one_buffer_per_image() {
+  constexpr size_t kSubscribers = 6;
+  constexpr uint32_t kFrames = 60;
+  MqttBroker broker;
+  broker.start();
+
+  TestClient subscribers[kSubscribers];
+  for (size_t i = 0; i < kSubscribers; ++i) {
+    subscribers[i].decoder.keepBodies = false;
+    connectAndSubscribe(broker, subscribers[i], "sphere-" + std::to_string(i), {"sphere/+/image"}, 0);
+  }
+  TestClient publisher;
+  connectAndSubscribe(broker, publisher, "ui", {}, 0);
+  for (uint32_t frame = 0; frame < kFrames; ++frame) {
+    publishPacket(publisher.wire->inbound, "sphere/all/image", imagePayload(frame));
+  }
+  const MqttBroker::Stats before = broker.getStats();
+
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  uint32_t passes = 0;
+  while (publisher.wire->readPos < publisher.wire->inbound.size() || broker.getStats().queuedBytes > 0) {
+    broker.service(++passes);
+    for (TestClient &subscriber : subscribers) {
+      subscriber.decoder.drain(*subscriber.wire);
+    }
+    if (passes > 100000) break;
+  }
+  const auto end = Clock::now();
+
+  const MqttBroker::Stats stats = broker.getStats();
+  const size_t packetBytes = 1 + 3 + 2 + std::strlen("sphere/all/image") + kImageBytes;
+  for (TestClient &subscriber : subscribers) {
+    TEST_ASSERT_FALSE(subscriber.decoder.malformed);
+    TEST_ASSERT_EQUAL_UINT32(kFrames, subscriber.decoder.count(3));
+    uint32_t expected = 0;
+    for (const Received &packet : subscriber.decoder.packets) {
+      if (packet.type != 3) continue;
+      TEST_ASSERT_EQUAL_UINT32(kImageBytes, packet.payloadSize);
+      TEST_ASSERT_EQUAL_UINT32(expected++, packet.marker);
+    }
+  }
+  // 受信した画像は1回だけバッファへコピーされ、6クライアントで共有される
+  TEST_ASSERT_EQUAL_UINT64(kFrames * packetBytes, stats.bufferedBytes - before.bufferedBytes);
+  TEST_ASSERT_EQUAL_UINT64(kFrames * packetBytes * kSubscribers, stats.bytesSent - before.bytesSent);
+  TEST_ASSERT_EQUAL_UINT32(kFrames * kSubscribers, stats.deliveries);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.dropped);
+
+  const double seconds = std::chrono::duration<double>(end - start).count();
+  const double megabytes = static_cast<double>(stats.bytesSent - before.bytesSent) / (1024.0 * 1024.0);
+  char msg[160];
+  std::snprintf(msg, sizeof(msg), "fan-out %u x %u KB -> %u subscribers: %.1f MB out in %.2f ms (%.0f MB/s, %u passes)",
+                static_cast<unsigned>(kFrames), static_cast<unsigned>(kImageBytes / 1024),
+                static_cast<unsigned>(kSubscribers), megabytes, seconds * 1000.0, megabytes / seconds,
+                static_cast<unsigned>(passes));
+  TEST_MESSAGE(msg);
+}
+
+void test_broker_slow_subscriber_drops_oldest_frames() {
+  MqttBroker broker;
+  broker.start();
+  TestClient fast[2];
+  TestClient slow;
+  connectAndSubscribe(broker, fast[0], "fast-0", {"sphere/+/image"}, 0);
+  connectAndSubscribe(broker, fast[1], "fast-1", {"sphere/+/image"}, 0);
+  connectAndSubscribe(broker, slow, "slow", {"sphere/+/image"}, 0);
+  slow.wire->writeBudget = 0;
+
+  uint32_t now = 0;
+  auto send = [&](uint32_t frame) {
+    const std::vector<uint8_t> payload = imagePayload(frame);
+    broker.publish("sphere/all/image", payload.data(), payload.size());
+    broker.service(++now);
+  };
+
+  // 詰まったクライアントのキューはバイト上限（画像2枚分）で古い順に捨てる
+  for (uint32_t frame = 0; frame < 6; ++frame) {
+    send(frame);
+  }
+  MqttBroker::ClientStats slowStats;
+  TEST_ASSERT_TRUE(broker.getClientStats(2, slowStats));
+  TEST_ASSERT_EQUAL_UINT32(2, slowStats.queuedPackets);
+  TEST_ASSERT_EQUAL_UINT32(4, slowStats.dropped);
+
+  // 送信途中の先頭パケット（frame 4）は捨てずに最後まで送る
+  slow.wire->writeBudget = 50000;
+  broker.service(++now);
+  slow.wire->writeBudget = 0;
+  for (uint32_t frame = 6; frame < 10; ++frame) {
+    send(frame);
+  }
+
+  slow.wire->writeBudget = kUnlimited;
+  broker.service(++now);
+  slow.decoder.drain(*slow.wire);
+  TEST_ASSERT_FALSE(slow.decoder.malformed);
+  TEST_ASSERT_EQUAL_UINT32(2, slow.decoder.count(3));
+  TEST_ASSERT_EQUAL_UINT32(4, slow.decoder.packets[2].marker);
+  TEST_ASSERT_EQUAL_UINT32(9, slow.decoder.packets[3].marker);
+  TEST_ASSERT_TRUE(broker.getClientStats(2, slowStats));
+  TEST_ASSERT_EQUAL_UINT32(8, slowStats.dropped);
+
+  // 速いクライアントは影響を受けない
+  for (TestClient &client : fast) {
+    client.decoder.drain(*client.wire);
+    TEST_ASSERT_EQUAL_UINT32(10, client.decoder.count(3));
+  }
+  TEST_ASSERT_EQUAL_UINT32(8, broker.getStats().dropped);
+  TEST_ASSERT_EQUAL_UINT32(0, broker.getStats().queuedBytes);
+}
+
+void test_broker_disconnects_stalled_subscriber() {
+  MqttBroker broker;
+  broker.start();
+  TestClient slow;
+  connectAndSubscribe(broker, slow, "slow", {"sphere/#"}, 1000);
+  slow.wire->writeBudget = 0;
+
+  const std::vector<uint8_t> payload = imagePayload(0);
+  broker.publish("sphere/all/image", payload.data(), payload.size());
+  broker.service(1000 + MqttBroker::kStallTimeoutMs - 1);
+  TEST_ASSERT_FALSE(slow.wire->closed);
+  broker.service(1000 + MqttBroker::kStallTimeoutMs);
+  TEST_ASSERT_TRUE(slow.wire->closed);
+
+  const MqttBroker::Stats stats = broker.getStats();
+  TEST_ASSERT_EQUAL_UINT32(1, stats.slowClientsClosed);
+  TEST_ASSERT_EQUAL_INT(0, stats.connectedClients);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.subscriptions);
+  TEST_ASSERT_EQUAL_UINT32(0, stats.queuedBytes);
+}
+
+void test_broker_rejects_protocol_violations() {
+  MqttBroker broker;
+  broker.start();
+
+  // CONNECT 前の PUBLISH
+  TestClient early;
+  attach(broker, early, 0);
+  publishPacket(early.wire->inbound, "sphere/001/ui", {'x'});
+  broker.service(0);
+  TEST_ASSERT_TRUE(early.wire->closed);
+
+  // 上限を超える残り長
+  TestClient huge;
+  connectAndSubscribe(broker, huge, "huge", {}, 0);
+  std::vector<uint8_t> header = {0x30};
+  putLength(header, MqttBroker::kMaxPacketBytes + 1);
+  huge.wire->inbound.insert(huge.wire->inbound.end(), header.begin(), header.end());
+  broker.service(1);
+  TEST_ASSERT_TRUE(huge.wire->closed);
+
+  // フラグの不正な PUBREL
+  TestClient badRel;
+  connectAndSubscribe(broker, badRel, "bad-rel", {}, 0);
+  putPacket(badRel.wire->inbound, 0x60, {0x00, 0x01});
+  broker.service(2);
+  TEST_ASSERT_TRUE(badRel.wire->closed);
+
+  // CONNECT が来ないまま放置された接続
+  TestClient idle;
+  attach(broker, idle, 10);
+  broker.service(10 + MqttBroker::kConnectTimeoutMs);
+  TEST_ASSERT_TRUE(idle.wire->closed);
+
+  TEST_ASSERT_EQUAL_UINT32(3, broker.getStats().protocolErrors);
+  TEST_ASSERT_EQUAL_INT(0, broker.getConnectedClients());
+}
+
+// QoS 2 の PUBLISH は受信時に配信し、PUBREC/PUBREL/PUBCOMP で完了する
+void test_broker_completes_qos2_publish() {
+  MqttBroker broker;
+  broker.start();
+  TestClient sphere;
+  TestClient controller;
+  connectAndSubscribe(broker, sphere, "sphere-001", {"system/all/emergency"}, 0);
+  connectAndSubscribe(broker, controller, "controller", {}, 0);
+
+  const std::vector<uint8_t> stop = {'{', '}'};
+  publishPacket(controller.wire->inbound, "system/all/emergency", stop, 2, false, 0x0102);
+  broker.service(1);
+  sphere.decoder.drain(*sphere.wire);
+  controller.decoder.drain(*controller.wire);
+  TEST_ASSERT_FALSE(controller.wire->closed);
+  TEST_ASSERT_EQUAL_UINT32(1, sphere.decoder.count(3));
+  TEST_ASSERT_EQUAL_UINT8(0, sphere.decoder.packets.back().flags);  // QoS 0で配信
+  TEST_ASSERT_TRUE(sphere.decoder.packets.back().body == stop);
+  const Received &pubRec = controller.decoder.packets.back();
+  TEST_ASSERT_EQUAL_UINT8(5, pubRec.type);
+  TEST_ASSERT_EQUAL_UINT8(0x01, pubRec.body[0]);
+  TEST_ASSERT_EQUAL_UINT8(0x02, pubRec.body[1]);
+
+  // PUBREC を取りこぼした送信側の再送（DUP=1）は再度 PUBREC だけ返し、二重配信しない
+  std::vector<uint8_t> resend;
+  publishPacket(resend, "system/all/emergency", stop, 2, false, 0x0102);
+  resend[0] |= 0x08;
+  controller.wire->inbound.insert(controller.wire->inbound.end(), resend.begin(), resend.end());
+  broker.service(2);
+  sphere.decoder.drain(*sphere.wire);
+  controller.decoder.drain(*controller.wire);
+  TEST_ASSERT_EQUAL_UINT32(1, sphere.decoder.count(3));
+  TEST_ASSERT_EQUAL_UINT32(2, controller.decoder.count(5));
+
+  // PUBREL → PUBCOMP。以後は同じIDでも新しいメッセージとして配信する
+  putPacket(controller.wire->inbound, 0x62, {0x01, 0x02});
+  publishPacket(controller.wire->inbound, "system/all/emergency", stop, 2, false, 0x0102);
+  broker.service(3);
+  sphere.decoder.drain(*sphere.wire);
+  controller.decoder.drain(*controller.wire);
+  TEST_ASSERT_EQUAL_UINT32(1, controller.decoder.count(7));
+  TEST_ASSERT_EQUAL_UINT32(3, controller.decoder.count(5));
+  TEST_ASSERT_EQUAL_UINT32(2, sphere.decoder.count(3));
+  TEST_ASSERT_FALSE(controller.wire->closed);
+  TEST_ASSERT_EQUAL_UINT32(0, broker.getStats().protocolErrors);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_trie_matches_wildcards_once_per_subscriber);
+  RUN_TEST(test_trie_unsubscribe_prunes_empty_branches);
+  RUN_TEST(test_broker_connect_subscribe_publish_roundtrip);
+  RUN_TEST(test_broker_retained_messages);
+  RUN_TEST(test_broker_fanout_shares_one_buffer_per_image);
+  RUN_TEST(test_broker_slow_subscriber_drops_oldest_frames);
+  RUN_TEST(test_broker_disconnects_stalled_subscriber);
+  RUN_TEST(test_broker_rejects_protocol_violations);
+  RUN_TEST(test_broker_completes_qos2_publish);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include <unity.h>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "led/PanoramaTexture.h"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+
+using LEDSphere::PanoramaTexture;
+using LEDSphere::TextureFilter;
+
+namespace {
+
+// 位置に依存したグラデーション + 高周波成分を持つテスト画像
+std::vector<uint8_t> makeTestImage(uint16_t width, uint16_t height) {
+  std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 3);
+  for (uint16_t y = 0; y < height; ++y) {
+    for (uint16_t x = 0; x < width; ++x) {
+      uint8_t *p = &pixels[(static_cast<size_t>(y) * width + x) * 3];
+      p[0] = static_cast<uint8_t>((x * 255) / (width - 1));
+      p[1] = static_cast<uint8_t>((y * 255) / (height - 1));
+      p[2] = static_cast<uint8_t>(((x ^ y) & 1) ? 255 : 0);
+    }
+  }
+  return pixels;
+}
+
+// 浮動小数点によるバイリニア参照実装（u折り返し・vクランプ）
+void referenceBilinear(const std::vector<uint8_t> &pixels, uint16_t width, uint16_t height,
+                       float u, float v, float out[3]) {
+  float x = (u - std::floor(u)) * width - 0.5f;
+  float y = v * height - 0.5f;
+  if (y < 0.0f) y = 0.0f;
+  if (y > height - 1) y = static_cast<float>(height - 1);
+  int x0 = static_cast<int>(std::floor(x));
+  float fx = x - x0;
+  int y0 = static_cast<int>(std::floor(y));
+  float fy = y - y0;
+  int x0w = (x0 % width + width) % width;
+  int x1w = (x0w + 1) % width;
+  int y1 = y0 + 1 < height ? y0 + 1 : y0;
+  for (int c = 0; c < 3; ++c) {
+    float p00 = pixels[(y0 * width + x0w) * 3 + c];
+    float p10 = pixels[(y0 * width + x1w) * 3 + c];
+    float p01 = pixels[(y1 * width + x0w) * 3 + c];
+    float p11 = pixels[(y1 * width + x1w) * 3 + c];
+    out[c] = p00 * (1 - fx) * (1 - fy) + p10 * fx * (1 - fy) + p01 * (1 - fx) * fy + p11 * fx * fy;
+  }
+}
+
+}  // namespace
+
+void test_nearest_matches_texel_lookup() {
+  const uint16_t w = 32, h = 16;
+  auto pixels = makeTestImage(w, h);
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+
+  for (uint16_t y = 0; y < h; ++y) {
+    for (uint16_t x = 0; x < w; ++x) {
+      float u = (x + 0.5f) / w;
+      float v = (y + 0.5f) / h;
+      CRGB c = texture.sample(u, v, TextureFilter::kNearest);
+      const uint8_t *p = &pixels[(y * w + x) * 3];
+      TEST_ASSERT_EQUAL_UINT8(p[0], c.r);
+      TEST_ASSERT_EQUAL_UINT8(p[1], c.g);
+      TEST_ASSERT_EQUAL_UINT8(p[2], c.b);
+    }
+  }
+}
+
+void test_bilinear_fixed_point_matches_float_reference() {
+  const uint16_t w = 64, h = 32;
+  auto pixels = makeTestImage(w, h);
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+
+  int maxError = 0;
+  for (int i = 0; i < 4000; ++i) {
+    float u = static_cast<float>((i * 7919) % 10007) / 10007.0f;
+    float v = static_cast<float>((i * 104729) % 9973) / 9973.0f;
+    float expected[3];
+    referenceBilinear(pixels, w, h, u, v, expected);
+    CRGB c = texture.sample(u, v, TextureFilter::kBilinear);
+    int err[3] = {std::abs(c.r - static_cast<int>(std::lround(expected[0]))),
+                  std::abs(c.g - static_cast<int>(std::lround(expected[1]))),
+                  std::abs(c.b - static_cast<int>(std::lround(expected[2])))};
+    for (int e : err) {
+      if (e > maxError) maxError = e;
+    }
+  }
+  char msg[64];
+  std::snprintf(msg, sizeof(msg), "bilinear Q8 max error vs float: %d", maxError);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_OR_EQUAL(2, maxError);
+}
+
+void test_bilinear_wraps_across_longitude_seam() {
+  const uint16_t w = 4, h = 2;
+  std::vector<uint8_t> pixels(w * h * 3, 0);
+  // 左端列のみ赤にしてシームを跨ぐ補間を確認
+  for (uint16_t y = 0; y < h; ++y) {
+    pixels[(y * w + 0) * 3 + 0] = 200;
+  }
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+
+  // u=0 は左端テクセル中心と右端テクセル中心のちょうど中間
+  CRGB seam = texture.sample(0.0f, 0.25f, TextureFilter::kBilinear);
+  TEST_ASSERT_UINT8_WITHIN(1, 100, seam.r);
+  CRGB seamWrapped = texture.sample(1.0f, 0.25f, TextureFilter::kBilinear);
+  TEST_ASSERT_EQUAL_UINT8(seam.r, seamWrapped.r);
+}
+
+void test_mip_chain_box_filters_levels() {
+  const uint16_t w = 64, h = 32;
+  auto pixels = makeTestImage(w, h);
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+  TEST_ASSERT_TRUE(texture.buildMipChain());
+
+  TEST_ASSERT_EQUAL_UINT8(7, texture.mipLevelCount());  // 64x32 → ... → 1x1
+  const auto &l1 = texture.level(1);
+  TEST_ASSERT_EQUAL_UINT16(32, l1.width);
+  TEST_ASSERT_EQUAL_UINT16(16, l1.height);
+  // 市松模様の青チャンネルは1段目で平均（≈128）になる
+  TEST_ASSERT_UINT8_WITHIN(1, 128, l1.pixels[2]);
+  const auto &last = texture.level(6);
+  TEST_ASSERT_EQUAL_UINT16(1, last.width);
+  TEST_ASSERT_EQUAL_UINT16(1, last.height);
+}
+
+void test_select_mip_level_by_footprint() {
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.allocate(2048, 1024));
+  // ミップ未構築ならレベル0
+  TEST_ASSERT_EQUAL_UINT8(0, texture.selectMipLevel(0.125f));
+  TEST_ASSERT_TRUE(texture.buildMipChain());
+
+  // 800LED球体の平均間隔 ≈ 0.125rad → 1024/π*0.125 ≈ 40.7テクセル → レベル5
+  TEST_ASSERT_EQUAL_UINT8(5, texture.selectMipLevel(0.125f));
+  // 1テクセル未満ならベースレベル
+  TEST_ASSERT_EQUAL_UINT8(0, texture.selectMipLevel(0.001f));
+}
+
+void test_manager_samples_bound_texture() {
+  using LEDSphere::LEDPosition;
+  using LEDSphere::LEDSphereManager;
+
+  const uint16_t w = 64, h = 32;
+  std::vector<uint8_t> pixels(w * h * 3, 0);
+  // 上半分（北半球）を赤、下半分を青
+  for (uint16_t y = 0; y < h; ++y) {
+    for (uint16_t x = 0; x < w; ++x) {
+      pixels[(y * w + x) * 3 + (y < h / 2 ? 0 : 2)] = 255;
+    }
+  }
+  PanoramaTexture texture;
+  TEST_ASSERT_TRUE(texture.loadRGB888(pixels.data(), w, h));
+  TEST_ASSERT_TRUE(texture.buildMipChain(2));
+
+  LEDSphereManager manager;
+  std::vector<uint16_t> lengths{2};
+  std::vector<uint8_t> pins{5};
+  TEST_ASSERT_TRUE(manager.initializeLedHardware(1, lengths, pins));
+  std::vector<LEDPosition> layout;
+  layout.emplace_back(0, 0, 0, 0.0f, 0.95f, 0.3f);   // 北極付近
+  layout.emplace_back(1, 0, 1, 0.0f, -0.95f, 0.3f);  // 南極付近
+  manager.setLayoutForTest(layout);
+  manager.setPanoramaTexture(&texture, TextureFilter::kBilinear);
+  manager.updateAllLEDsFromImage();
+
+  const CRGB *leds = manager.frameBufferForTest();
+  TEST_ASSERT_EQUAL_UINT8(255, leds[0].r);
+  TEST_ASSERT_EQUAL_UINT8(0, leds[0].b);
+  TEST_ASSERT_EQUAL_UINT8(0, leds[1].r);
+  TEST_ASSERT_EQUAL_UINT8(255, leds[1].b);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_nearest_matches_texel_lookup);
+  RUN_TEST(test_bilinear_fixed_point_matches_float_reference);
+  RUN_TEST(test_bilinear_wraps_across_longitude_seam);
+  RUN_TEST(test_mip_chain_box_filters_levels);
+  RUN_TEST(test_select_mip_level_by_footprint);
+  RUN_TEST(test_manager_samples_bound_texture);
+  return UNITY_END();
+}
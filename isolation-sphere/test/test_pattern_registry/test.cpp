@@ -0,0 +1,177 @@
+#include <unity.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "led/LEDSphereManager.h"
+#include "pattern/ProceduralPatternGenerator.h"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/pattern/FieldPatterns.cpp"
+#include "../../src/pattern/PatternGenerator.cpp"
+
+using ProceduralPattern::DisplayRect;
+using ProceduralPattern::IPattern;
+using ProceduralPattern::PatternGenerator;
+using ProceduralPattern::PatternId;
+using ProceduralPattern::PatternParams;
+using ProceduralPattern::kInvalidPatternId;
+
+namespace {
+
+// 生成回数・描画回数を記録するパターン。footprintが空でなければLCDに描く扱い
+class RecordingPattern : public IPattern {
+public:
+  explicit RecordingPattern(DisplayRect footprint) : footprint_(footprint) {}
+
+  void render(const PatternParams &params) override {
+    ++renderCount;
+    lastTime = params.time;
+  }
+  const char *getName() const override { return "Recording"; }
+  const char *getDescription() const override { return "records calls"; }
+  DisplayRect displayFootprint(const PatternParams & /*params*/) const override { return footprint_; }
+  void setSpeed(float value) override { speed = value; }
+
+  int renderCount = 0;
+  float lastTime = 0.0f;
+  float speed = 1.0f;
+
+private:
+  DisplayRect footprint_;
+};
+
+struct Factory {
+  std::vector<int> created = std::vector<int>(8, 0);
+
+  // id 0 はLCD中央に描き、それ以外はLEDのみ
+  void install(PatternGenerator &generator) {
+    generator.setFactoryForTest([this](PatternId id) -> std::unique_ptr<IPattern> {
+      if (id >= created.size()) return nullptr;
+      ++created[id];
+      DisplayRect rect;
+      if (id == 0) {
+        rect.x = 32;
+        rect.y = 32;
+        rect.w = 64;
+        rect.h = 64;
+      }
+      return std::unique_ptr<IPattern>(new RecordingPattern(rect));
+    });
+  }
+};
+
+}  // namespace
+
+void test_pattern_id_name_round_trip() {
+  PatternGenerator generator;
+  const auto names = generator.getAvailablePatterns();
+  TEST_ASSERT_EQUAL_UINT32(7, names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    const PatternId id = PatternGenerator::findPatternId(names[i]);
+    TEST_ASSERT_EQUAL_UINT8(i, id);
+    TEST_ASSERT_EQUAL_STRING(names[i].c_str(), PatternGenerator::patternName(id));
+  }
+  TEST_ASSERT_EQUAL_UINT8(kInvalidPatternId, PatternGenerator::findPatternId("no_such_pattern"));
+  TEST_ASSERT_EQUAL_STRING("", PatternGenerator::patternName(kInvalidPatternId));
+  TEST_ASSERT_NULL(generator.getPattern("no_such_pattern"));
+}
+
+// 毎フレーム描画しても各パターンは1度だけ生成される
+void test_each_pattern_is_created_once() {
+  PatternGenerator generator;
+  Factory factory;
+  factory.install(generator);
+
+  IPattern *first = generator.getPattern(2);
+  for (int frame = 0; frame < 10; ++frame) {
+    generator.renderPattern(static_cast<PatternId>(frame % 3), 0.0f, frame * 0.1f);
+  }
+  generator.renderPattern("longitude_lines", 0.0f);
+  generator.renderPattern("longitude_lines", 0.0f);
+  TEST_ASSERT_TRUE(first == generator.getPattern(2));
+  TEST_ASSERT_EQUAL_INT(1, factory.created[0]);
+  TEST_ASSERT_EQUAL_INT(1, factory.created[1]);
+  TEST_ASSERT_EQUAL_INT(1, factory.created[2]);
+  TEST_ASSERT_EQUAL_INT(1, factory.created[3]);
+  TEST_ASSERT_EQUAL_INT(0, factory.created[4]);
+  TEST_ASSERT_EQUAL_STRING("longitude_lines", generator.getCurrentPatternName().c_str());
+
+  // createPattern()はレジストリを介さず毎回新規に生成する
+  auto fresh = generator.createPattern("longitude_lines");
+  TEST_ASSERT_NOT_NULL(fresh.get());
+  TEST_ASSERT_TRUE(fresh.get() != generator.getPattern(3));
+  TEST_ASSERT_EQUAL_INT(2, factory.created[3]);
+}
+
+// 設定・状態はパターン切替を挟んでも保持される
+void test_pattern_state_persists_across_frames() {
+  PatternGenerator generator;
+  Factory factory;
+  factory.install(generator);
+
+  auto *pattern = static_cast<RecordingPattern *>(generator.getPattern(1));
+  pattern->setSpeed(2.5f);
+  generator.renderPattern(1, 0.0f, 0.5f);
+  generator.renderPattern(3, 0.0f, 0.6f);
+  generator.renderPattern(1, 0.0f, 0.7f);
+  TEST_ASSERT_EQUAL_INT(2, pattern->renderCount);
+  TEST_ASSERT_EQUAL_FLOAT(2.5f, pattern->speed);
+  TEST_ASSERT_EQUAL_FLOAT(0.7f, pattern->lastTime);
+}
+
+// 切替時はLCDを使う側がいれば全消去、同じパターンの間は前フレームの領域のみ消去
+void test_display_cleared_on_pattern_switch() {
+  PatternGenerator generator;
+  Factory factory;
+  factory.install(generator);
+
+  // LEDのみのパターン同士の切替ではLCDに触れない
+  generator.renderPattern(1, 0.0f);
+  generator.renderPattern(2, 0.0f);
+  generator.renderPattern(2, 0.0f);
+  TEST_ASSERT_EQUAL_UINT32(0, generator.screenClearsForTest());
+  TEST_ASSERT_EQUAL_UINT32(0, generator.rectClearsForTest().size());
+
+  generator.renderPattern(0, 0.0f);
+  TEST_ASSERT_EQUAL_UINT32(1, generator.screenClearsForTest());
+  generator.renderPattern(0, 0.0f);
+  TEST_ASSERT_EQUAL_UINT32(1, generator.screenClearsForTest());
+  TEST_ASSERT_EQUAL_UINT32(1, generator.rectClearsForTest().size());
+  TEST_ASSERT_EQUAL_INT(32, generator.rectClearsForTest()[0].x);
+  TEST_ASSERT_EQUAL_INT(64, generator.rectClearsForTest()[0].w);
+
+  // LCDを使っていたパターンから離れるときも前の描画を消す
+  generator.renderPattern(2, 0.0f);
+  TEST_ASSERT_EQUAL_UINT32(2, generator.screenClearsForTest());
+  generator.renderPattern(2, 0.0f);
+  TEST_ASSERT_EQUAL_UINT32(2, generator.screenClearsForTest());
+  TEST_ASSERT_EQUAL_UINT32(1, generator.rectClearsForTest().size());
+}
+
+// ネイティブビルドではフィールドパターンのみ生成される
+void test_field_patterns_register_without_factory() {
+  PatternGenerator generator;
+  IPattern *spiral = generator.getPattern("spiral_trajectory");
+  TEST_ASSERT_NOT_NULL(spiral);
+  TEST_ASSERT_TRUE(spiral == generator.getPattern(PatternGenerator::findPatternId("spiral_trajectory")));
+  TEST_ASSERT_NOT_NULL(generator.getPattern("spherical_wave"));
+  TEST_ASSERT_NULL(generator.getPattern("latitude_rings"));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_pattern_id_name_round_trip);
+  RUN_TEST(test_each_pattern_is_created_once);
+  RUN_TEST(test_pattern_state_persists_across_frames);
+  RUN_TEST(test_display_cleared_on_pattern_switch);
+  RUN_TEST(test_field_patterns_register_without_factory);
+  return UNITY_END();
+}
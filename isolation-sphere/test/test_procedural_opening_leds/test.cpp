@@ -7,6 +7,11 @@
 #include "led/LEDSphereManager.h"
 #include "boot/ProceduralOpeningSequence.h"
 #include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
 #include "../../src/boot/ProceduralOpeningSequence.cpp"
 
 using LEDSphere::LEDSphereManager;
@@ -0,0 +1,373 @@
+#include <unity.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "core/RenderLoop.h"
+#include "../../src/core/RenderLoop.cpp"
+#include "../../src/core/SharedState.cpp"
+#include "../../src/core/ImageFrameBuffer.cpp"
+#include "../../src/core/MetricsRegistry.cpp"
+#include "../../src/led/LEDSphereManager.cpp"
+#include "../../src/led/LatLonIndex.cpp"
+#include "../../src/led/SphereIndex.cpp"
+#include "../../src/led/FrameProfiler.cpp"
+#include "../../src/led/PanoramaTexture.cpp"
+#include "../../src/led/JpegLedDecoder.cpp"
+#include "../../src/led/FramePack.cpp"
+#include "../../src/led/FramePackPlayer.cpp"
+#include "../../src/led/LayerCompositor.cpp"
+#include "../../src/pattern/FieldPatterns.cpp"
+#include "../../src/pattern/PatternGenerator.cpp"
+
+using ImageSource = SharedState::ImageSource;
+using LEDSphere::FramePackPlayer;
+using LEDSphere::FramePackWriter;
+using ProceduralPattern::PatternGenerator;
+using Content = RenderLoop::Content;
+
+namespace {
+
+constexpr size_t kLeds = 8;
+
+ConfigManager::Config makeConfig() {
+  ConfigManager::Config cfg;
+  cfg.led.numStrips = 2;
+  cfg.led.ledsPerStrip = {5, 3};
+  cfg.led.stripGpios = {1, 2};
+  return cfg;
+}
+
+// MQTTタスクと同じく1フレームを1断片で書き込む
+void publish(SharedState &state, const std::vector<uint8_t> &payload, ImageSource source) {
+  ImageFrameBuffer &images = state.imageFrames();
+  TEST_ASSERT_TRUE(images.beginFrame(payload.size(), static_cast<uint8_t>(source)));
+  TEST_ASSERT_TRUE(images.writeFragment(0, payload.data(), payload.size()));
+}
+
+std::vector<uint8_t> liveFrame(uint8_t seed) {
+  std::vector<uint8_t> rgb(kLeds * 3);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<uint8_t>(seed + i);
+  }
+  return rgb;
+}
+
+// LED0の赤 = フレーム番号のムービー
+std::vector<uint8_t> buildMovie(uint16_t ledCount, uint32_t frames, uint16_t fps) {
+  FramePackWriter writer(ledCount, fps, 4);
+  for (uint32_t f = 0; f < frames; ++f) {
+    std::vector<uint8_t> rgb(ledCount * 3, 0);
+    rgb[0] = static_cast<uint8_t>(f);
+    writer.addFrame(rgb.data());
+  }
+  std::vector<uint8_t> pack;
+  writer.finish(pack);
+  return pack;
+}
+
+}  // namespace
+
+// LED未設定の間は何もしない（スロットも消費しない）
+void test_idle_until_leds_configured() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_FALSE(loop.begin(ConfigManager::Config{}));
+  TEST_ASSERT_FALSE(loop.ready());
+
+  publish(state, liveFrame(0), ImageSource::kLive);
+  loop.tick(0);
+  TEST_ASSERT_TRUE(state.imageFrames().hasReadyFrame());
+  TEST_ASSERT_EQUAL_UINT32(0, loop.stats().framesShown);
+}
+
+// ライブフレームはLED順のままフレームバッファへ書かれ、スロットは返却される
+void test_live_frame_is_shown_and_released() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+  TEST_ASSERT_EQUAL_UINT32(kLeds, loop.sphere().ledCount());
+
+  const std::vector<uint8_t> rgb = liveFrame(10);
+  publish(state, rgb, ImageSource::kLive);
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(0);
+
+  TEST_ASSERT_TRUE(loop.sphere().wasShowCalledForTest());
+  const CRGB *leds = loop.sphere().frameBufferForTest();
+  for (size_t i = 0; i < kLeds; ++i) {
+    TEST_ASSERT_EQUAL_UINT8(rgb[i * 3], leds[i].r);
+    TEST_ASSERT_EQUAL_UINT8(rgb[i * 3 + 1], leds[i].g);
+    TEST_ASSERT_EQUAL_UINT8(rgb[i * 3 + 2], leds[i].b);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().framesShown);
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().liveFrames);
+  TEST_ASSERT_EQUAL_UINT32(1, state.imageFrames().stats().framesConsumed);
+  TEST_ASSERT_FALSE(state.imageFrames().hasReadyFrame());
+
+  // 新しいフレームが無いtickでは再表示しない
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(0);
+  TEST_ASSERT_FALSE(loop.sphere().wasShowCalledForTest());
+}
+
+// LED数と合わないライブフレームは表示せずに返却する
+void test_mismatched_live_frame_is_rejected() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+
+  publish(state, std::vector<uint8_t>((kLeds + 1) * 3, 0x40), ImageSource::kLive);
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(0);
+
+  TEST_ASSERT_FALSE(loop.sphere().wasShowCalledForTest());
+  TEST_ASSERT_EQUAL_UINT8(0, loop.sphere().frameBufferForTest()[0].r);
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().rejectedFrames);
+  TEST_ASSERT_EQUAL_UINT32(1, state.imageFrames().stats().framesConsumed);
+}
+
+// 何も届いていない間は既定パターンを毎tick描画する（show()はパターン側）
+void test_default_pattern_runs_until_content_arrives() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(100);
+  TEST_ASSERT_TRUE(loop.content() == Content::kPattern);
+  TEST_ASSERT_EQUAL_UINT8(PatternGenerator::findPatternId(RenderLoop::kDefaultPattern), loop.patternId());
+  TEST_ASSERT_TRUE(loop.sphere().wasShowCalledForTest());
+
+  // 30fpsのタイムベース上で同じフレームの間は描き直さない
+  loop.tick(133);
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().patternFrames);
+  loop.tick(134);
+  TEST_ASSERT_EQUAL_UINT32(2, loop.stats().patternFrames);
+}
+
+// millis()が7秒ずれた2台が同じマスター時刻で同じムービーフレームを表示する
+void test_movie_follows_sync_timebase() {
+  const std::vector<uint8_t> pack = buildMovie(kLeds, 50, 10);
+  SharedState stateA;
+  SharedState stateB;
+  RenderLoop a(stateA);
+  RenderLoop b(stateB);
+  TEST_ASSERT_TRUE(a.begin(makeConfig()));
+  TEST_ASSERT_TRUE(b.begin(makeConfig()));
+  TEST_ASSERT_TRUE(a.openMovie(FramePackPlayer::makeMemorySource(pack.data(), pack.size()), true));
+  TEST_ASSERT_TRUE(b.openMovie(FramePackPlayer::makeMemorySource(pack.data(), pack.size()), true));
+
+  SyncTimebase timebase = SyncTimebase::local(0, 30);
+  stateA.updateSyncTimebase(timebase);
+  timebase.offsetMs = 7000;
+  stateB.updateSyncTimebase(timebase);
+
+  // マスター12300ms = 10fpsで123フレーム目、50フレームでループして23
+  a.tick(12300);
+  b.tick(5300);
+  TEST_ASSERT_TRUE(a.content() == Content::kMovie);
+  TEST_ASSERT_EQUAL_UINT8(23, a.sphere().frameBufferForTest()[0].r);
+  TEST_ASSERT_EQUAL_UINT8(23, b.sphere().frameBufferForTest()[0].r);
+
+  // 同じフレームの間は再表示しない
+  a.tick(12399);
+  TEST_ASSERT_EQUAL_UINT32(1, a.stats().movieFrames);
+  a.tick(12400);
+  TEST_ASSERT_EQUAL_UINT32(2, a.stats().movieFrames);
+  TEST_ASSERT_EQUAL_UINT8(24, a.sphere().frameBufferForTest()[0].r);
+
+  // LED数の合わないパックは開かない
+  const std::vector<uint8_t> other = buildMovie(kLeds + 1, 5, 10);
+  RenderLoop c(stateA);
+  TEST_ASSERT_TRUE(c.begin(makeConfig()));
+  TEST_ASSERT_FALSE(c.openMovie(FramePackPlayer::makeMemorySource(other.data(), other.size()), true));
+}
+
+// リモート制御: 新しいレコードだけを適用し、パターンはID変更時のみ切り替える
+void test_remote_control_selects_content() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+  const uint32_t uvBefore = loop.sphere().refreshUV();
+
+  RemoteControl control;
+  control.source = ControlSource::kMqtt;
+  control.latitudeOffsetDeg = 30.0f;
+  control.brightness = 80;
+  control.patternId = PatternGenerator::findPatternId("spiral_trajectory");
+  control.fields = RemoteControl::kPosture | RemoteControl::kBrightness | RemoteControl::kPattern;
+  control.sequence = 1;
+  control.updatedMs = 10;
+  state.updateRemoteControl(control);
+  loop.tick(10);
+  loop.tick(20);
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().controlUpdates);
+  TEST_ASSERT_TRUE(loop.content() == Content::kPattern);
+  TEST_ASSERT_EQUAL_UINT8(control.patternId, loop.patternId());
+  // 姿勢オフセットがUVに反映されている
+  TEST_ASSERT_TRUE(loop.sphere().refreshUV() != uvBefore);
+
+  // 後から届いたフレームが優先される
+  publish(state, liveFrame(1), ImageSource::kLive);
+  loop.tick(30);
+  TEST_ASSERT_TRUE(loop.content() == Content::kImage);
+
+  // ジョイスティック（UDP）の姿勢更新ではパターンに戻らない
+  RemoteControl joystick;
+  joystick.source = ControlSource::kUdp;
+  joystick.longitudeOffsetDeg = 45.0f;
+  joystick.fields = RemoteControl::kPosture;
+  joystick.sequence = 7;
+  joystick.updatedMs = 40;
+  state.updateRemoteControl(joystick);
+  loop.tick(40);
+  TEST_ASSERT_EQUAL_UINT32(2, loop.stats().controlUpdates);
+  TEST_ASSERT_TRUE(loop.content() == Content::kImage);
+
+  // 同じパターンIDのままのMQTT更新も同様
+  control.sequence = 2;
+  control.updatedMs = 50;
+  state.updateRemoteControl(control);
+  loop.tick(50);
+  TEST_ASSERT_TRUE(loop.content() == Content::kImage);
+
+  // IDが変われば切り替わる
+  control.patternId = PatternGenerator::findPatternId("spherical_wave");
+  control.sequence = 3;
+  control.updatedMs = 60;
+  state.updateRemoteControl(control);
+  loop.tick(60);
+  TEST_ASSERT_TRUE(loop.content() == Content::kPattern);
+  TEST_ASSERT_EQUAL_UINT8(control.patternId, loop.patternId());
+}
+
+// LEDパイプラインの計測値がSharedStateのメトリクスに載る。画像の間隔はドロップに数えない
+void test_metrics_attached_to_led_pipeline() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  loop.attachMetrics(state.metrics());
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+  uint32_t clockUs = 0;
+  loop.sphere().setPerformanceClock([&clockUs]() { return clockUs; });
+
+  // 既定パターンを30fpsで2フレーム
+  loop.tick(0);
+  clockUs = 34000;
+  loop.tick(34);
+
+  // ライブフレームは数秒おきでもドロップ扱いしない
+  clockUs = 60000;
+  publish(state, liveFrame(1), ImageSource::kLive);
+  loop.tick(60);
+  clockUs = 5000000;
+  publish(state, liveFrame(2), ImageSource::kLive);
+  loop.tick(5000);
+
+  // パターンへ戻った直後の空白も数えない
+  RemoteControl control;
+  control.patternId = PatternGenerator::findPatternId("spiral_trajectory");
+  control.fields = RemoteControl::kPattern;
+  control.updatedMs = 9000;
+  state.updateRemoteControl(control);
+  clockUs = 9000000;
+  loop.tick(9000);
+
+  MetricsRegistry::Counter *frames = state.metrics().counter("frames", MetricsRegistry::CounterRate::kPerSecond);
+  MetricsRegistry::Counter *drops = state.metrics().counter("frame_drops");
+  TEST_ASSERT_NOT_NULL(frames);
+  TEST_ASSERT_NOT_NULL(drops);
+  TEST_ASSERT_EQUAL_UINT32(5, frames->value());
+  TEST_ASSERT_EQUAL_UINT32(0, drops->value());
+
+  // パターン表示中に3フレーム分空けば2フレームのドロップ
+  clockUs += 100000;
+  loop.tick(9100);
+  TEST_ASSERT_EQUAL_UINT32(2, drops->value());
+}
+
+// tickごとにシステムキューを空にするので、深さを超える件数でも取りこぼさない
+void test_system_queue_drained_every_tick() {
+  SharedState state;
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+
+  const char kCommand[] = "{\"action\":\"save_config\"}";
+  const size_t total = SharedState::kSystemQueueDepth * 4;
+  uint32_t now = 0;
+  for (size_t i = 0; i < total; ++i) {
+    TEST_ASSERT_TRUE(state.pushSystemCommand(SystemCommandType::kCommand, kCommand, sizeof(kCommand) - 1, true));
+    if ((i + 1) % SharedState::kSystemQueueDepth == 0) {
+      loop.tick(now += 10);
+    }
+  }
+
+  const SharedState::CommandQueueStats queue = state.getCommandQueueStats();
+  TEST_ASSERT_EQUAL_UINT32(0, queue.systemIncomingOverflow);
+  TEST_ASSERT_EQUAL_UINT8(0, queue.systemIncomingDepth);
+  TEST_ASSERT_EQUAL_UINT32(total, loop.stats().systemCommands);
+}
+
+// 緊急停止でLEDを消灯し、resumeまでフレームもパターンも表示しない
+void test_emergency_stop_blanks_until_resume() {
+  SharedState state;
+  state.imageFrames().allocate(256);
+  RenderLoop loop(state);
+  TEST_ASSERT_TRUE(loop.begin(makeConfig()));
+  publish(state, liveFrame(10), ImageSource::kLive);
+  loop.tick(0);
+  TEST_ASSERT_EQUAL_UINT8(10, loop.sphere().frameBufferForTest()[0].r);
+
+  // キューを埋めた後の緊急停止も届く
+  const char kCommand[] = "{\"action\":\"restart\"}";
+  for (size_t i = 0; i + 1 < SharedState::kSystemQueueDepth; ++i) {
+    state.pushSystemCommand(SystemCommandType::kCommand, kCommand, sizeof(kCommand) - 1, true);
+  }
+  const char kStop[] = "{\"action\":\"stop\"}";
+  TEST_ASSERT_TRUE(state.pushSystemCommand(SystemCommandType::kEmergency, kStop, sizeof(kStop) - 1, true));
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(10);
+  TEST_ASSERT_TRUE(loop.emergencyStopped());
+  TEST_ASSERT_EQUAL_UINT32(1, loop.stats().emergencyStops);
+  TEST_ASSERT_TRUE(loop.sphere().wasShowCalledForTest());
+  for (size_t i = 0; i < kLeds; ++i) {
+    TEST_ASSERT_EQUAL_UINT8(0, loop.sphere().frameBufferForTest()[i].r);
+  }
+
+  // 停止中のフレームは表示せずにスロットを返す
+  publish(state, liveFrame(20), ImageSource::kLive);
+  loop.sphere().resetShowFlagForTest();
+  loop.tick(20);
+  TEST_ASSERT_FALSE(loop.sphere().wasShowCalledForTest());
+  TEST_ASSERT_FALSE(state.imageFrames().hasReadyFrame());
+  TEST_ASSERT_EQUAL_UINT8(0, loop.sphere().frameBufferForTest()[0].r);
+
+  const char kResume[] = "{\"action\":\"resume\"}";
+  state.pushSystemCommand(SystemCommandType::kEmergency, kResume, sizeof(kResume) - 1, true);
+  publish(state, liveFrame(30), ImageSource::kLive);
+  loop.tick(30);
+  TEST_ASSERT_FALSE(loop.emergencyStopped());
+  TEST_ASSERT_EQUAL_UINT8(30, loop.sphere().frameBufferForTest()[0].r);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_until_leds_configured);
+  RUN_TEST(test_live_frame_is_shown_and_released);
+  RUN_TEST(test_mismatched_live_frame_is_rejected);
+  RUN_TEST(test_default_pattern_runs_until_content_arrives);
+  RUN_TEST(test_remote_control_selects_content);
+  RUN_TEST(test_movie_follows_sync_timebase);
+  RUN_TEST(test_metrics_attached_to_led_pipeline);
+  RUN_TEST(test_system_queue_drained_every_tick);
+  RUN_TEST(test_emergency_stop_blanks_until_resume);
+  return UNITY_END();
+}
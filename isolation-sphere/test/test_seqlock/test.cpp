@@ -0,0 +1,171 @@
+#include <unity.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "core/SeqLock.h"
+#include "imu/ImuService.h"
+
+namespace {
+
+using Reading = ImuService::Reading;
+using Clock = std::chrono::steady_clock;
+
+// 全フィールドを通し番号から導出し、読み出し側で整合性を検証できるようにする
+Reading makeReading(std::uint32_t n) {
+  Reading r;
+  r.qw = static_cast<float>(n);
+  r.qx = static_cast<float>(n) + 1.0f;
+  r.qy = static_cast<float>(n) + 2.0f;
+  r.qz = static_cast<float>(n) + 3.0f;
+  r.ax = static_cast<float>(n) + 4.0f;
+  r.ay = static_cast<float>(n) + 5.0f;
+  r.az = static_cast<float>(n) + 6.0f;
+  r.accelMagnitudeMps2 = static_cast<float>(n) + 7.0f;
+  r.timestampMs = n;
+  return r;
+}
+
+bool isConsistent(const Reading &r) {
+  const float n = static_cast<float>(r.timestampMs);
+  return r.qw == n && r.qx == n + 1.0f && r.qy == n + 2.0f && r.qz == n + 3.0f && r.ax == n + 4.0f &&
+         r.ay == n + 5.0f && r.az == n + 6.0f && r.accelMagnitudeMps2 == n + 7.0f;
+}
+
+// 従来のSharedState相当（全アクセスでmutex）
+class MutexMailbox {
+ public:
+  void write(const Reading &r) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    value_ = r;
+    has_ = true;
+  }
+  bool read(Reading &out) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (has_) out = value_;
+    return has_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  Reading value_{};
+  bool has_ = false;
+};
+
+struct StressResult {
+  std::uint64_t writes = 0;
+  std::uint64_t reads = 0;
+  std::uint64_t torn = 0;
+  std::uint64_t regressions = 0;
+  double seconds = 0.0;
+};
+
+// float で厳密に表現できる範囲（2^24未満）で通し番号を回す
+constexpr std::uint32_t kWriteCount = 2000000;
+
+template <typename Channel>
+StressResult runStress(Channel &channel) {
+  StressResult result;
+  std::atomic<bool> done{false};
+
+  auto start = Clock::now();
+  std::thread writer([&]() {
+    for (std::uint32_t n = 1; n <= kWriteCount; ++n) {
+      channel.write(makeReading(n));
+    }
+    done.store(true, std::memory_order_release);
+  });
+  std::thread reader([&]() {
+    std::uint32_t last = 0;
+    Reading r;
+    while (!done.load(std::memory_order_acquire)) {
+      if (!channel.read(r)) continue;
+      ++result.reads;
+      if (!isConsistent(r)) ++result.torn;
+      if (r.timestampMs < last) ++result.regressions;
+      last = r.timestampMs;
+    }
+  });
+  writer.join();
+  reader.join();
+  result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  result.writes = kWriteCount;
+  return result;
+}
+
+// 計測値は -v 指定時だけ表示する
+bool gVerbose = false;
+
+void report(const char *name, const StressResult &r) {
+  if (!gVerbose) {
+    return;
+  }
+  char msg[160];
+  std::snprintf(msg, sizeof(msg), "%s: %.1f Mwrites/s, %.1f Mreads/s, torn=%llu, regressions=%llu", name,
+                r.writes / r.seconds / 1e6, r.reads / r.seconds / 1e6, static_cast<unsigned long long>(r.torn),
+                static_cast<unsigned long long>(r.regressions));
+  TEST_MESSAGE(msg);
+}
+
+}  // namespace
+
+void test_seqlock_reports_empty_until_first_write() {
+  SeqLock<Reading> channel;
+  Reading r;
+  TEST_ASSERT_FALSE(channel.read(r));
+  TEST_ASSERT_FALSE(channel.hasValue());
+
+  channel.write(makeReading(42));
+  TEST_ASSERT_TRUE(channel.read(r));
+  TEST_ASSERT_TRUE(isConsistent(r));
+  TEST_ASSERT_EQUAL_UINT32(42, r.timestampMs);
+  TEST_ASSERT_EQUAL_UINT32(1, channel.version());
+
+  channel.write(makeReading(43));
+  TEST_ASSERT_TRUE(channel.read(r));
+  TEST_ASSERT_EQUAL_UINT32(43, r.timestampMs);
+  TEST_ASSERT_EQUAL_UINT32(2, channel.version());
+}
+
+void test_seqlock_two_thread_stress_has_no_torn_readings() {
+  SeqLock<Reading> channel;
+  StressResult seq = runStress(channel);
+  report("seqlock", seq);
+  TEST_ASSERT_EQUAL_UINT64(0, seq.torn);
+  TEST_ASSERT_EQUAL_UINT64(0, seq.regressions);
+  TEST_ASSERT_TRUE(seq.reads > 0);
+
+  // 最後に読めるのは必ず最終値
+  Reading last;
+  TEST_ASSERT_TRUE(channel.read(last));
+  TEST_ASSERT_EQUAL_UINT32(kWriteCount, last.timestampMs);
+
+  MutexMailbox mailbox;
+  StressResult mutex = runStress(mailbox);
+  report("mutex", mutex);
+  TEST_ASSERT_EQUAL_UINT64(0, mutex.torn);
+
+  if (gVerbose) {
+    char msg[96];
+    std::snprintf(msg, sizeof(msg), "writer throughput seqlock/mutex = %.2fx (reader retries %u)",
+                  mutex.seconds / seq.seconds, channel.readRetries());
+    TEST_MESSAGE(msg);
+  }
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "-v") == 0) {
+      gVerbose = true;
+    }
+  }
+  UNITY_BEGIN();
+  RUN_TEST(test_seqlock_reports_empty_until_first_write);
+  RUN_TEST(test_seqlock_two_thread_stress_has_no_torn_readings);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "led/SphereIndex.h"
+#include "../../src/led/SphereIndex.cpp"
+
+using LEDSphere::SphereIndex;
+
+namespace {
+
+struct Points {
+  std::vector<float> x, y, z;
+  std::vector<uint16_t> ids;
+};
+
+// フィボナッチ球面（半径0.9: 正規化されることも確認する）
+Points makePoints(size_t count) {
+  Points points;
+  const float golden = static_cast<float>(M_PI) * (3.0f - std::sqrt(5.0f));
+  for (size_t i = 0; i < count; ++i) {
+    const float y = 1.0f - (2.0f * (static_cast<float>(i) + 0.5f)) / static_cast<float>(count);
+    const float r = std::sqrt(1.0f - y * y);
+    const float theta = golden * static_cast<float>(i);
+    points.x.push_back(0.9f * r * std::cos(theta));
+    points.y.push_back(0.9f * y);
+    points.z.push_back(0.9f * r * std::sin(theta));
+    points.ids.push_back(static_cast<uint16_t>(1000 + i));
+  }
+  return points;
+}
+
+float angleTo(const Points &points, size_t i, float qx, float qy, float qz) {
+  const float len = std::sqrt(points.x[i] * points.x[i] + points.y[i] * points.y[i] + points.z[i] * points.z[i]);
+  const float qlen = std::sqrt(qx * qx + qy * qy + qz * qz);
+  float dot = (points.x[i] * qx + points.y[i] * qy + points.z[i] * qz) / (len * qlen);
+  dot = std::max(-1.0f, std::min(1.0f, dot));
+  return std::acos(dot);
+}
+
+// 決定的な問い合わせ方向（極・日付変更線付近を含む）
+std::vector<std::vector<float>> queryDirections() {
+  std::vector<std::vector<float>> directions = {
+      {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {-1.0f, 0.0f, 0.001f}, {-1.0f, 0.0f, -0.001f}, {0.3f, 0.95f, 0.1f}};
+  uint32_t state = 12345;
+  for (int i = 0; i < 200; ++i) {
+    std::vector<float> d(3);
+    for (float &c : d) {
+      state = state * 1664525u + 1013904223u;
+      c = static_cast<float>(state >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f;
+    }
+    directions.push_back(d);
+  }
+  return directions;
+}
+
+}  // namespace
+
+// 最近傍・k近傍は全点走査と同じ中心角
+void test_nearest_matches_brute_force() {
+  const Points points = makePoints(800);
+  SphereIndex index;
+  index.build(points.x.data(), points.y.data(), points.z.data(), points.ids.data(), points.ids.size());
+  TEST_ASSERT_EQUAL_UINT32(800, index.size());
+
+  std::vector<SphereIndex::Neighbor> neighbors;
+  for (const auto &d : queryDirections()) {
+    std::vector<float> angles(points.ids.size());
+    for (size_t i = 0; i < points.ids.size(); ++i) angles[i] = angleTo(points, i, d[0], d[1], d[2]);
+    std::vector<float> sortedAngles = angles;
+    std::sort(sortedAngles.begin(), sortedAngles.end());
+
+    const uint16_t nearest = index.nearest(d[0], d[1], d[2]);
+    TEST_ASSERT_TRUE(nearest >= 1000 && nearest < 1800);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, sortedAngles[0], angles[nearest - 1000]);
+
+    TEST_ASSERT_EQUAL_UINT32(6, index.nearestK(d[0], d[1], d[2], 6, neighbors));
+    for (size_t k = 0; k < neighbors.size(); ++k) {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, sortedAngles[k], neighbors[k].distanceRad);
+      TEST_ASSERT_FLOAT_WITHIN(1e-3f, angles[neighbors[k].id - 1000], neighbors[k].distanceRad);
+    }
+  }
+}
+
+// 半径検索は全点走査と同じ集合（境界のごく近くは判定誤差を許す）
+void test_within_matches_brute_force() {
+  const Points points = makePoints(800);
+  SphereIndex index;
+  index.build(points.x.data(), points.y.data(), points.z.data(), points.ids.data(), points.ids.size());
+
+  std::vector<uint16_t> found;
+  const float radii[] = {0.02f, 0.1f, 0.35f, 1.5f};
+  for (const auto &d : queryDirections()) {
+    for (float radius : radii) {
+      index.within(d[0], d[1], d[2], radius, found);
+      std::sort(found.begin(), found.end());
+      for (size_t i = 0; i < points.ids.size(); ++i) {
+        const float angle = angleTo(points, i, d[0], d[1], d[2]);
+        if (std::fabs(angle - radius) < 1e-4f) continue;
+        const bool inFound = std::binary_search(found.begin(), found.end(), points.ids[i]);
+        TEST_ASSERT_EQUAL(angle <= radius, inFound);
+      }
+    }
+  }
+  // 半周以上は全点
+  TEST_ASSERT_EQUAL_UINT32(800, index.within(1.0f, 0.0f, 0.0f, static_cast<float>(M_PI), found));
+}
+
+// 極付近でも経度方向に歪まない: 北極周りの半径検索は同じ緯度帯の全周を含む
+void test_within_is_isotropic_at_pole() {
+  const Points points = makePoints(800);
+  SphereIndex index;
+  index.build(points.x.data(), points.y.data(), points.z.data(), points.ids.data(), points.ids.size());
+  std::vector<uint16_t> found;
+  const float radius = 20.0f * static_cast<float>(M_PI) / 180.0f;
+  index.within(0.0f, 1.0f, 0.0f, radius, found);
+  size_t expected = 0;
+  for (size_t i = 0; i < points.ids.size(); ++i) {
+    if (std::asin(points.y[i] / 0.9f) >= static_cast<float>(M_PI) / 2.0f - radius) ++expected;
+  }
+  TEST_ASSERT_TRUE(expected > 10);
+  TEST_ASSERT_EQUAL_UINT32(expected, found.size());
+}
+
+// 原点の点は除外、空のインデックスはkNone
+void test_degenerate_inputs() {
+  SphereIndex index;
+  TEST_ASSERT_EQUAL_UINT16(SphereIndex::kNone, index.nearest(1.0f, 0.0f, 0.0f));
+
+  const float x[] = {0.0f, 1.0f};
+  const float y[] = {0.0f, 0.0f};
+  const float z[] = {0.0f, 0.0f};
+  const uint16_t ids[] = {7, 8};
+  index.build(x, y, z, ids, 2);
+  TEST_ASSERT_EQUAL_UINT32(1, index.size());
+  TEST_ASSERT_EQUAL_UINT16(8, index.nearest(-1.0f, 0.0f, 0.0f));
+  TEST_ASSERT_EQUAL_UINT16(SphereIndex::kNone, index.nearest(0.0f, 0.0f, 0.0f));
+
+  std::vector<SphereIndex::Neighbor> neighbors;
+  TEST_ASSERT_EQUAL_UINT32(1, index.nearestK(0.0f, 1.0f, 0.0f, 5, neighbors));
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, static_cast<float>(M_PI) / 2.0f, neighbors[0].distanceRad);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_nearest_matches_brute_force);
+  RUN_TEST(test_within_matches_brute_force);
+  RUN_TEST(test_within_is_isotropic_at_pole);
+  RUN_TEST(test_degenerate_inputs);
+  return UNITY_END();
+}
@@ -0,0 +1,203 @@
+#include <unity.h>
+
+#include <cmath>
+#include <cstdint>
+
+#include "core/SyncClock.h"
+#include "../../src/core/SyncClock.cpp"
+
+namespace {
+
+// 決定的な疑似乱数（ネットワーク遅延ジッタ用）
+struct Lcg {
+  std::uint32_t state;
+  std::uint32_t next() {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+  }
+  // [0, range) ms
+  double uniform(double range) { return (next() % 100000u) / 100000.0 * range; }
+};
+
+// 真の時刻t[ms]から各機の millis() を作る: clock(t) = t * (1 + skew) + start
+struct SimClock {
+  double skew;
+  double startMs;
+  std::uint32_t at(double t) const { return static_cast<std::uint32_t>(std::floor(t * (1.0 + skew) + startMs)); }
+};
+
+constexpr std::uint16_t kFps = 30;
+constexpr double kBeaconIntervalMs = 1000.0;
+// ドリフト推定が揃うまで（kBlockSize * kBlockCount ビーコン）
+constexpr double kWarmupMs = SyncClock::kBlockSize * SyncClock::kBlockCount * kBeaconIntervalMs;
+
+// マスターが1秒毎にビーコンを送り、baseDelay + [0, jitter)の遅延で届く
+void runBeacons(SyncClock &clock, const SimClock &master, const SimClock &local, Lcg &rng, double fromMs,
+                double toMs, double baseDelayMs, double jitterMs, std::uint16_t &seq) {
+  for (double t = fromMs; t < toMs; t += kBeaconIntervalMs) {
+    const SyncClock::Beacon beacon = SyncClock::makeBeacon(master.at(t), 0, kFps, seq++);
+    const double arrival = t + baseDelayMs + rng.uniform(jitterMs);
+    clock.onBeacon(beacon, local.at(arrival));
+  }
+}
+
+// 真の時刻tにおける推定アニメーション時刻とマスターの実際の値の差[ms]
+// 片方向の時刻配信では最小遅延（baseDelay）分は原理的に補正できず、誤差に含まれる
+double timebaseErrorMs(const SyncClock &clock, const SimClock &master, const SimClock &local, double t) {
+  const std::int32_t estimated = static_cast<std::int32_t>(clock.timebase().elapsedMs(local.at(t)));
+  const std::int32_t actual = static_cast<std::int32_t>(master.at(t));
+  return static_cast<double>(estimated - actual);
+}
+
+}  // namespace
+
+void test_beacon_carries_exact_epoch() {
+  // フレーム番号だけでは最大1フレームずれるが、frame_ms込みならエポックを厳密に復元できる
+  for (std::uint32_t now = 5000; now < 6000; now += 7) {
+    const SyncClock::Beacon beacon = SyncClock::makeBeacon(now, 1234, kFps, 0);
+    TEST_ASSERT_EQUAL_UINT32(1234, beacon.epochMs());
+    TEST_ASSERT_EQUAL_UINT32((now - 1234) * kFps / 1000, beacon.frame);
+    TEST_ASSERT_TRUE(beacon.frameOffsetMs < 34);
+  }
+}
+
+void test_local_timebase_is_plain_millis() {
+  const SyncTimebase timebase = SyncTimebase::local(0, kFps);
+  TEST_ASSERT_EQUAL_UINT32(123456, timebase.masterTimeMs(123456));
+  TEST_ASSERT_EQUAL_UINT32(30, timebase.frameAt(1000));
+  TEST_ASSERT_EQUAL_UINT32(60, timebase.frameAt(1000, 60));
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.5f, timebase.animationTimeSec(2500));
+}
+
+// 長時間稼働してもアニメーション時間はミリ秒分解能を保つ
+void test_animation_time_keeps_ms_resolution() {
+  const SyncTimebase timebase = SyncTimebase::local(0, kFps);
+  const std::uint32_t tenHours = 10u * 3600u * 1000u;
+  TEST_ASSERT_EQUAL_UINT32(1234, timebase.animationTimeMs(tenHours + 1234));
+  for (std::uint32_t t = tenHours + 1000; t < tenHours + 1010; ++t) {
+    const float step = timebase.animationTimeSec(t + 1) - timebase.animationTimeSec(t);
+    TEST_ASSERT_FLOAT_WITHIN(0.0003f, 0.001f, step);
+  }
+  // 折り返し直前まで単調増加
+  TEST_ASSERT_TRUE(timebase.animationTimeSec(SyncTimebase::kAnimationWrapMs - 1) >
+                   timebase.animationTimeSec(SyncTimebase::kAnimationWrapMs - 2));
+  TEST_ASSERT_EQUAL_UINT32(0, timebase.animationTimeMs(SyncTimebase::kAnimationWrapMs));
+}
+
+void test_not_published_before_min_samples() {
+  SyncClock clock;
+  SyncClock::Beacon beacon = SyncClock::makeBeacon(1000, 0, kFps, 0);
+  for (std::size_t i = 1; i < SyncClock::kMinSamples; ++i) {
+    TEST_ASSERT_FALSE(clock.onBeacon(beacon, 500 + i * 1000));
+    beacon.masterMs += 1000;
+  }
+  TEST_ASSERT_FALSE(clock.timebase().valid);
+  TEST_ASSERT_TRUE(clock.onBeacon(beacon, 500 + SyncClock::kMinSamples * 1000));
+  TEST_ASSERT_TRUE(clock.timebase().valid);
+}
+
+void test_follower_tracks_skewed_master_through_jitter() {
+  // マスターは+150ppm、フォロワーは-80ppmの水晶誤差、起動時刻も大きく異なる
+  const SimClock master{150e-6, 7200000.0};
+  const SimClock local{-80e-6, 1500.0};
+  Lcg rng{42};
+  SyncClock clock;
+  std::uint16_t seq = 0;
+
+  runBeacons(clock, master, local, rng, 0.0, kWarmupMs, 2.0, 30.0, seq);
+  TEST_ASSERT_TRUE(clock.timebase().valid);
+  // フォロワーの1msあたりマスター時計の進み: 1.00015 / 0.99992 - 1 = 230ppm
+  TEST_ASSERT_FLOAT_WITHIN(60.0f, 230.0f, clock.stats().driftPpm);
+
+  // 以降もビーコンを受けながら、各描画時刻での誤差を確認（30fpsで1フレーム=33ms）
+  double worst = 0.0;
+  for (double t = kWarmupMs; t < kWarmupMs + 120000.0; t += kBeaconIntervalMs) {
+    runBeacons(clock, master, local, rng, t, t + kBeaconIntervalMs, 2.0, 30.0, seq);
+    for (double frameT = t; frameT < t + kBeaconIntervalMs; frameT += 16.0) {
+      worst = std::fmax(worst, std::fabs(timebaseErrorMs(clock, master, local, frameT)));
+    }
+  }
+  TEST_ASSERT_TRUE_MESSAGE(worst <= 6.0, "follower strayed more than 6 ms from the master timebase");
+}
+
+void test_free_runs_on_drift_estimate_when_beacons_stop() {
+  const SimClock master{200e-6, 0.0};
+  const SimClock local{0.0, 50000.0};
+  Lcg rng{7};
+  SyncClock clock;
+  std::uint16_t seq = 0;
+  runBeacons(clock, master, local, rng, 0.0, kWarmupMs, 3.0, 20.0, seq);
+
+  // 30秒間ビーコンが途絶してもドリフト補正で追従する（補正なしなら+6msずれる）
+  const double silentUntil = kWarmupMs + 30000.0;
+  TEST_ASSERT_FALSE(clock.locked(local.at(silentUntil), 10000));
+  TEST_ASSERT_TRUE(std::fabs(timebaseErrorMs(clock, master, local, silentUntil)) <= 6.0);
+}
+
+void test_two_followers_show_same_frame() {
+  const SimClock master{-120e-6, 300000.0};
+  const SimClock sphereA{90e-6, 0.0};
+  const SimClock sphereB{-60e-6, 2000000.0};
+  Lcg rngA{1};
+  Lcg rngB{2};
+  SyncClock clockA;
+  SyncClock clockB;
+  std::uint16_t seqA = 0;
+  std::uint16_t seqB = 0;
+  runBeacons(clockA, master, sphereA, rngA, 0.0, kWarmupMs, 2.0, 40.0, seqA);
+  runBeacons(clockB, master, sphereB, rngB, 0.0, kWarmupMs, 8.0, 15.0, seqB);
+
+  std::uint32_t mismatches = 0;
+  std::uint32_t samples = 0;
+  double worst = 0.0;
+  for (double t = kWarmupMs; t < kWarmupMs + 30000.0; t += 7.0) {
+    const std::int32_t a = static_cast<std::int32_t>(clockA.timebase().elapsedMs(sphereA.at(t)));
+    const std::int32_t b = static_cast<std::int32_t>(clockB.timebase().elapsedMs(sphereB.at(t)));
+    worst = std::fmax(worst, std::fabs(static_cast<double>(a - b)));
+    if (clockA.timebase().frameAt(sphereA.at(t)) != clockB.timebase().frameAt(sphereB.at(t))) {
+      ++mismatches;
+    }
+    ++samples;
+  }
+  TEST_ASSERT_TRUE_MESSAGE(worst <= 8.0, "spheres disagree by more than 8 ms");
+  // フレーム境界付近（誤差ms / 33ms）以外は同じフレームを表示している
+  TEST_ASSERT_TRUE(mismatches * 4 < samples);
+}
+
+void test_late_beacon_is_dropped_and_master_restart_resyncs() {
+  SyncClock clock;
+  std::uint16_t seq = 0;
+  for (std::uint32_t i = 0; i < 10; ++i) {
+    clock.onBeacon(SyncClock::makeBeacon(100000 + i * 1000, 0, kFps, seq++), 5000 + i * 1000 + 3);
+  }
+  const std::int32_t offset = clock.timebase().offsetMs;
+
+  // 再送で600ms遅れたビーコン1つは推定に影響しない
+  TEST_ASSERT_FALSE(clock.onBeacon(SyncClock::makeBeacon(110000, 0, kFps, seq++), 15000 + 600));
+  TEST_ASSERT_EQUAL_INT32(offset, clock.timebase().offsetMs);
+  TEST_ASSERT_EQUAL_UINT32(1, clock.stats().outliers);
+
+  // マスター再起動: 時計もエポックも変わり、連続した外れ値で追従し直す
+  for (std::uint32_t i = 0; i < SyncClock::kResyncAfterOutliers; ++i) {
+    clock.onBeacon(SyncClock::makeBeacon(2000 + i * 1000, 1500, kFps, i), 20000 + i * 1000 + 3);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, clock.stats().resyncs);
+  TEST_ASSERT_TRUE(clock.timebase().valid);
+  TEST_ASSERT_EQUAL_UINT32(1500, clock.timebase().epochMasterMs);
+  TEST_ASSERT_INT32_WITHIN(1, 4000 - 1500, static_cast<std::int32_t>(clock.timebase().elapsedMs(22003)));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_beacon_carries_exact_epoch);
+  RUN_TEST(test_local_timebase_is_plain_millis);
+  RUN_TEST(test_animation_time_keeps_ms_resolution);
+  RUN_TEST(test_not_published_before_min_samples);
+  RUN_TEST(test_follower_tracks_skewed_master_through_jitter);
+  RUN_TEST(test_free_runs_on_drift_estimate_when_beacons_stop);
+  RUN_TEST(test_two_followers_show_same_frame);
+  RUN_TEST(test_late_beacon_is_dropped_and_master_restart_resyncs);
+  return UNITY_END();
+}
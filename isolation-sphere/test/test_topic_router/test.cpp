@@ -0,0 +1,108 @@
+#include <unity.h>
+
+#include <cstdint>
+
+#include "core/LogRateLimiter.h"
+#include "mqtt/TopicRouter.h"
+#include "../../src/mqtt/TopicRouter.cpp"
+
+namespace {
+
+enum Route : uint8_t { kUi = 1, kCommand, kSync, kImage, kAnyUi, kSystem };
+
+TopicRouter makeRouter() {
+  TopicRouter router;
+  router.add("sphere/ui", kUi);
+  router.add("sphere/001/ui", kUi);
+  router.add("sphere/001/command", kCommand);
+  router.add("system/all/sync", kSync);
+  router.add("sphere/001/image", kImage, 1);
+  router.add("sphere/all/image", kImage, 2);
+  router.add("sphere/+/ui", kAnyUi);
+  router.add("system/#", kSystem);
+  router.add("", kUi);  // 未設定トピックは無視
+  return router;
+}
+
+uint8_t routeOf(const TopicRouter &router, const char *topic) {
+  TopicRouter::Match match;
+  return router.match(topic, match) ? match.route : 0;
+}
+
+}  // namespace
+
+void test_router_matches_exact_topics_with_tags() {
+  TopicRouter router = makeRouter();
+  TEST_ASSERT_EQUAL_UINT32(6, router.exactCount());
+  TEST_ASSERT_EQUAL_UINT32(2, router.wildcardCount());
+
+  TEST_ASSERT_EQUAL_UINT8(kUi, routeOf(router, "sphere/ui"));
+  TEST_ASSERT_EQUAL_UINT8(kCommand, routeOf(router, "sphere/001/command"));
+
+  TopicRouter::Match match;
+  TEST_ASSERT_TRUE(router.match("sphere/all/image", match));
+  TEST_ASSERT_EQUAL_UINT8(kImage, match.route);
+  TEST_ASSERT_EQUAL_UINT8(2, match.tag);
+
+  // 前方一致・部分一致はしない
+  TEST_ASSERT_EQUAL_UINT8(0, routeOf(router, "sphere/001/comman"));
+  TEST_ASSERT_EQUAL_UINT8(0, routeOf(router, "sphere/001/commandx"));
+  TEST_ASSERT_FALSE(router.match(nullptr, match));
+}
+
+void test_router_exact_topics_take_precedence_over_wildcards() {
+  TopicRouter router = makeRouter();
+  TEST_ASSERT_EQUAL_UINT8(kUi, routeOf(router, "sphere/001/ui"));
+  TEST_ASSERT_EQUAL_UINT8(kAnyUi, routeOf(router, "sphere/002/ui"));
+  TEST_ASSERT_EQUAL_UINT8(kSync, routeOf(router, "system/all/sync"));
+  TEST_ASSERT_EQUAL_UINT8(kSystem, routeOf(router, "system/all/emergency"));
+}
+
+void test_router_wildcard_rules_follow_mqtt() {
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("sphere/+/ui", "sphere/abc/ui", 13));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("sphere/+/ui", "sphere//ui", 10));
+  TEST_ASSERT_FALSE(TopicRouter::matchesFilter("sphere/+/ui", "sphere/a/b/ui", 13));
+  TEST_ASSERT_FALSE(TopicRouter::matchesFilter("sphere/+/ui", "sphere/a/ui/bin", 15));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("sphere/+/ui/bin", "sphere/a/ui/bin", 15));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("system/#", "system/a/b/c", 12));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("system/#", "system", 6));
+  TEST_ASSERT_FALSE(TopicRouter::matchesFilter("system/#", "systems/a", 9));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("+", "abc", 3));
+  TEST_ASSERT_FALSE(TopicRouter::matchesFilter("+", "a/b", 3));
+  TEST_ASSERT_TRUE(TopicRouter::matchesFilter("#", "a/b", 3));
+}
+
+void test_router_ignores_duplicate_exact_topics() {
+  TopicRouter router;
+  TEST_ASSERT_TRUE(router.add("a/b", kUi));
+  TEST_ASSERT_FALSE(router.add("a/b", kCommand));
+  TEST_ASSERT_EQUAL_UINT8(kUi, routeOf(router, "a/b"));
+  router.clear();
+  TEST_ASSERT_EQUAL_UINT8(0, routeOf(router, "a/b"));
+}
+
+void test_log_rate_limiter_counts_suppressed_lines() {
+  LogRateLimiter limiter(3, 1000);
+  int allowed = 0;
+  for (int i = 0; i < 10; ++i) {
+    allowed += limiter.allow(100 + i) ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL(3, allowed);
+  TEST_ASSERT_EQUAL_UINT32(7, limiter.takeSuppressed());
+  TEST_ASSERT_EQUAL_UINT32(0, limiter.takeSuppressed());
+
+  // 次の窓で再び許可
+  TEST_ASSERT_TRUE(limiter.allow(1100));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_router_matches_exact_topics_with_tags);
+  RUN_TEST(test_router_exact_topics_take_precedence_over_wildcards);
+  RUN_TEST(test_router_wildcard_rules_follow_mqtt);
+  RUN_TEST(test_router_ignores_duplicate_exact_topics);
+  RUN_TEST(test_log_rate_limiter_counts_suppressed_lines);
+  return UNITY_END();
+}
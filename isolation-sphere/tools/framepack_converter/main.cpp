@@ -0,0 +1,236 @@
+/**
+ * @file main.cpp
+ * @brief 動画フレーム → フレームパック（.lfp）オフライン変換ツール
+ *
+ * 正距円筒パノラマ画像（PPM P6）を実機と同じサンプラー
+ * （LEDSphereManager + PanoramaTexture、ミップマップ）でLED順RGBへ変換し、
+ * FramePackWriterで1ファイルにまとめる。
+ *
+ * ビルド・実行:
+ *   pio run -e framepack_tool
+ *   ffmpeg -i data/images/opening/%03d.jpg /tmp/opening/%03d.ppm
+ *   .pio/build/framepack_tool/program --layout data/led_layout.csv --fps 10 \
+ *       --out data/movies/opening.lfp /tmp/opening/0*.ppm
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "led/FramePack.h"
+#include "led/LEDSphereManager.h"
+#include "led/PanoramaTexture.h"
+
+using LEDSphere::FramePackWriter;
+using LEDSphere::LEDPosition;
+using LEDSphere::LEDSphereManager;
+using LEDSphere::PanoramaTexture;
+using LEDSphere::TextureFilter;
+
+namespace {
+
+struct Options {
+    std::string layoutPath = "data/led_layout.csv";
+    std::string outputPath;
+    uint16_t fps = 10;
+    uint32_t keyframeInterval = 30;
+    bool compression = true;
+    float latitudeOffset = 0.0f;
+    float longitudeOffset = 0.0f;
+    std::vector<std::string> inputs;
+};
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+                 "Usage: %s --out <pack.lfp> [--layout <csv>] [--fps N] [--keyframe N] [--raw]\n"
+                 "          [--lat DEG] [--lon DEG] frame0.ppm frame1.ppm ...\n",
+                 argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "missing value for %s\n", name);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        if (arg == "--out") {
+            const char* v = next("--out");
+            if (!v) return false;
+            options.outputPath = v;
+        } else if (arg == "--layout") {
+            const char* v = next("--layout");
+            if (!v) return false;
+            options.layoutPath = v;
+        } else if (arg == "--fps") {
+            const char* v = next("--fps");
+            if (!v) return false;
+            options.fps = static_cast<uint16_t>(std::atoi(v));
+        } else if (arg == "--keyframe") {
+            const char* v = next("--keyframe");
+            if (!v) return false;
+            options.keyframeInterval = static_cast<uint32_t>(std::atoi(v));
+        } else if (arg == "--lat") {
+            const char* v = next("--lat");
+            if (!v) return false;
+            options.latitudeOffset = static_cast<float>(std::atof(v));
+        } else if (arg == "--lon") {
+            const char* v = next("--lon");
+            if (!v) return false;
+            options.longitudeOffset = static_cast<float>(std::atof(v));
+        } else if (arg == "--raw") {
+            options.compression = false;
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "unknown option: %s\n", arg.c_str());
+            return false;
+        } else {
+            options.inputs.push_back(arg);
+        }
+    }
+    return !options.outputPath.empty() && !options.inputs.empty();
+}
+
+// led_layout.csv（FaceID,strip,strip_num,x,y,z）
+bool loadLayout(const std::string& path, std::vector<LEDPosition>& layout) {
+    FILE* fp = std::fopen(path.c_str(), "r");
+    if (!fp) {
+        std::fprintf(stderr, "failed to open layout: %s\n", path.c_str());
+        return false;
+    }
+    char line[256];
+    bool header = true;
+    while (std::fgets(line, sizeof(line), fp)) {
+        if (header) {
+            header = false;
+            continue;
+        }
+        unsigned faceID = 0, strip = 0, stripNum = 0;
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        if (std::sscanf(line, "%u,%u,%u,%f,%f,%f", &faceID, &strip, &stripNum, &x, &y, &z) == 6) {
+            layout.emplace_back(static_cast<uint16_t>(faceID), static_cast<uint8_t>(strip),
+                                static_cast<uint8_t>(stripNum), x, y, z);
+        }
+    }
+    std::fclose(fp);
+    return !layout.empty();
+}
+
+bool readPPMToken(FILE* fp, char* token, size_t size) {
+    int c = std::fgetc(fp);
+    while (c != EOF) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') c = std::fgetc(fp);
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            c = std::fgetc(fp);
+        } else {
+            break;
+        }
+    }
+    size_t n = 0;
+    while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && n + 1 < size) {
+        token[n++] = static_cast<char>(c);
+        c = std::fgetc(fp);
+    }
+    token[n] = '\0';
+    return n > 0;
+}
+
+// バイナリPPM（P6, maxval 255）読み込み
+bool loadPPM(const std::string& path, PanoramaTexture& texture) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) {
+        std::fprintf(stderr, "failed to open %s\n", path.c_str());
+        return false;
+    }
+    char magic[8], w[16], h[16], maxval[16];
+    bool ok = readPPMToken(fp, magic, sizeof(magic)) && std::strcmp(magic, "P6") == 0 &&
+              readPPMToken(fp, w, sizeof(w)) && readPPMToken(fp, h, sizeof(h)) &&
+              readPPMToken(fp, maxval, sizeof(maxval)) && std::atoi(maxval) == 255;
+    if (ok) {
+        const uint16_t width = static_cast<uint16_t>(std::atoi(w));
+        const uint16_t height = static_cast<uint16_t>(std::atoi(h));
+        ok = texture.allocate(width, height) &&
+             std::fread(texture.data(), 1, texture.stride() * height, fp) == texture.stride() * height;
+        if (ok) {
+            texture.markBaseModified();
+            ok = texture.buildMipChain();
+        }
+    }
+    std::fclose(fp);
+    if (!ok) {
+        std::fprintf(stderr, "unsupported or truncated PPM (P6/255 only): %s\n", path.c_str());
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<LEDPosition> layout;
+    if (!loadLayout(options.layoutPath, layout)) {
+        return 1;
+    }
+    uint16_t ledCount = 0;
+    for (const LEDPosition& pos : layout) {
+        if (pos.faceID + 1 > ledCount) {
+            ledCount = static_cast<uint16_t>(pos.faceID + 1);
+        }
+    }
+
+    LEDSphereManager manager;
+    std::vector<uint16_t> lengths{ledCount};
+    std::vector<uint8_t> pins{0};
+    if (!manager.initializeLedHardware(1, lengths, pins)) {
+        std::fprintf(stderr, "failed to allocate frame buffer\n");
+        return 1;
+    }
+    manager.setLayoutForTest(layout);
+    manager.setUIOffset(options.latitudeOffset, options.longitudeOffset);
+
+    FramePackWriter writer(ledCount, options.fps, options.keyframeInterval);
+    writer.setCompressionEnabled(options.compression);
+    PanoramaTexture texture;
+    std::vector<uint8_t> rgb(static_cast<size_t>(ledCount) * 3);
+
+    for (const std::string& input : options.inputs) {
+        if (!loadPPM(input, texture)) {
+            return 1;
+        }
+        manager.clearAllLEDs();
+        manager.setPanoramaTexture(&texture, TextureFilter::kMipmap);
+        manager.updateAllLEDsFromImage();
+        const CRGB* leds = manager.frameBufferForTest();
+        for (uint16_t i = 0; i < ledCount; ++i) {
+            rgb[i * 3 + 0] = leds[i].r;
+            rgb[i * 3 + 1] = leds[i].g;
+            rgb[i * 3 + 2] = leds[i].b;
+        }
+        writer.addFrame(rgb.data());
+    }
+
+    std::vector<uint8_t> pack;
+    writer.finish(pack);
+    FILE* out = std::fopen(options.outputPath.c_str(), "wb");
+    if (!out || std::fwrite(pack.data(), 1, pack.size(), out) != pack.size()) {
+        std::fprintf(stderr, "failed to write %s\n", options.outputPath.c_str());
+        if (out) std::fclose(out);
+        return 1;
+    }
+    std::fclose(out);
+
+    const size_t rawSize = static_cast<size_t>(ledCount) * 3 * writer.frameCount();
+    std::printf("%s: %u frames, %u LEDs, %u fps, %zu bytes (raw %zu)\n", options.outputPath.c_str(),
+                writer.frameCount(), ledCount, options.fps, pack.size(), rawSize);
+    return 0;
+}